@@ -0,0 +1,69 @@
+//
+// BroadPhaseBenchmark.cpp - 扫描与裁剪宽阶段
+// 1k/10k/50k个盒子在地面上方下落，每步输出宽阶段耗时和候选碰撞对数
+//
+
+#include "JFMEngine/Physics/Physics3D.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int WarmupSteps = 5;
+    constexpr int MeasuredSteps = 30;
+
+    void RunScene(int boxCount) {
+        PhysicsWorld3D world;
+        world.SetBroadPhaseType(BroadPhaseType::SweepAndPrune);
+
+        auto ground = std::make_shared<Rigidbody3D>();
+        ground->SetMass(0.0f);
+        ground->SetCollider(std::make_shared<BoxCollider>(glm::vec3(1000.0f, 1.0f, 1000.0f)));
+        ground->SetPosition(glm::vec3(0.0f, -0.5f, 0.0f));
+        world.AddRigidbody(ground);
+
+        // 盒子的密度与数量无关，每个盒子平均有少量邻居
+        std::mt19937 rng(1);
+        const float extent = std::cbrt(static_cast<float>(boxCount)) * 3.0f;
+        std::uniform_real_distribution<float> position(-extent, extent);
+        std::uniform_real_distribution<float> size(0.5f, 1.5f);
+        for (int i = 0; i < boxCount; ++i) {
+            auto box = std::make_shared<Rigidbody3D>();
+            box->SetCollider(std::make_shared<BoxCollider>(glm::vec3(size(rng))));
+            box->SetPosition(glm::vec3(position(rng), 2.0f + extent + position(rng), position(rng)));
+            world.AddRigidbody(box);
+        }
+
+        for (int step = 0; step < WarmupSteps; ++step) {
+            world.Step();
+        }
+
+        double broadPhaseMs = 0.0;
+        uint64_t pairs = 0;
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int step = 0; step < MeasuredSteps; ++step) {
+            world.Step();
+            broadPhaseMs += world.GetStats().BroadPhaseMs;
+            pairs += world.GetStats().BroadPhasePairs;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double stepMs = std::chrono::duration<double, std::milli>(end - begin).count() / MeasuredSteps;
+
+        std::printf("  boxes %6d: broadphase %8.3f ms  pairs %8llu  (whole step %8.3f ms)\n",
+                    boxCount, broadPhaseMs / MeasuredSteps,
+                    static_cast<unsigned long long>(pairs / MeasuredSteps), stepMs);
+    }
+
+}
+
+int main() {
+    std::printf("BroadPhaseBenchmark: sweep-and-prune, %d steps per scene\n", MeasuredSteps);
+    for (int boxes : {1000, 10000, 50000}) {
+        RunScene(boxes);
+    }
+    return 0;
+}
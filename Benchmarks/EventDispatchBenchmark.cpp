@@ -0,0 +1,182 @@
+//
+// EventDispatchBenchmark.cpp - 事件分发吞吐量
+// 比较1个与N个工作线程分发同一批事件的速度，同时有一个线程不断注册/注销处理器，
+// 验证写时复制分发表下工作线程之间没有锁争用，且旧快照能被回收；
+// 另外让N个线程直接同步分发，与改动前分发时持有互斥锁的处理器表对比
+//
+
+#include "JFMEngine/Core/EventSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr uint64_t EventCount = 1000000;
+
+    double RunDispatch(size_t workerCount) {
+        EventSystem& events = EventSystem::GetInstance();
+        events.Initialize(workerCount);
+
+        std::atomic<uint64_t> checksum{0};
+        events.RegisterHandler<KeyPressedEvent>([&checksum](KeyPressedEvent& e) {
+            checksum.fetch_add(static_cast<uint64_t>(e.GetKeyCode()), std::memory_order_relaxed);
+            return false;
+        });
+
+        // 处理器变更线程：每次注销后旧快照和处理器都应被释放
+        std::atomic<bool> churning{true};
+        std::thread churn([&events, &churning] {
+            while (churning.load(std::memory_order_relaxed)) {
+                auto handler = std::make_shared<EventHandler<KeyPressedEvent>>([](KeyPressedEvent&) { return false; }, -1);
+                events.RegisterHandler(handler);
+                events.UnregisterHandler(handler);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+
+        const uint64_t processedBefore = events.GetStats().EventsProcessed.load();
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (uint64_t i = 0; i < EventCount; ++i) {
+            while (!events.PostEvent<KeyPressedEvent>(static_cast<int>(i & 0xFF), 0)) {
+                std::this_thread::yield();
+            }
+        }
+        while (events.GetStats().EventsProcessed.load() - processedBefore < EventCount) {
+            std::this_thread::yield();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        churning.store(false);
+        churn.join();
+        events.Shutdown();
+
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // 基线：与改动前的EventSystem相同，分发时持有保护处理器表的互斥锁
+    class MutexDispatcher {
+    public:
+        void RegisterHandler(std::shared_ptr<IEventHandler> handler) {
+            std::lock_guard<std::mutex> lock(m_HandlersMutex);
+            auto& handlers = m_Handlers[handler->GetHandledEventType()];
+            handlers.push_back(std::move(handler));
+            std::stable_sort(handlers.begin(), handlers.end(),
+                [](const std::shared_ptr<IEventHandler>& a, const std::shared_ptr<IEventHandler>& b) {
+                    return a->GetPriority() > b->GetPriority();
+                });
+        }
+
+        void UnregisterHandler(std::shared_ptr<IEventHandler> handler) {
+            std::lock_guard<std::mutex> lock(m_HandlersMutex);
+            auto& handlers = m_Handlers[handler->GetHandledEventType()];
+            handlers.erase(std::remove(handlers.begin(), handlers.end(), handler), handlers.end());
+        }
+
+        void ProcessEvent(Event& event) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+
+            std::lock_guard<std::mutex> lock(m_HandlersMutex);
+            auto it = m_Handlers.find(event.GetEventType());
+            if (it != m_Handlers.end()) {
+                for (auto& handler : it->second) {
+                    if (handler && handler->Handle(event)) {
+                        break;
+                    }
+                }
+            }
+
+            m_Stats.EventsProcessed.fetch_add(1);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            m_Stats.TotalProcessingTime.fetch_add(
+                std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count());
+        }
+
+    private:
+        std::unordered_map<EventType, std::vector<std::shared_ptr<IEventHandler>>> m_Handlers;
+        std::mutex m_HandlersMutex;
+        EventStats m_Stats;
+    };
+
+    // threadCount个线程同时同步分发，共EventCount个事件，期间一个线程不断注册/注销处理器
+    template<typename Dispatcher>
+    double RunDirectDispatch(Dispatcher& dispatcher, size_t threadCount) {
+        std::atomic<uint64_t> checksum{0};
+        auto handler = std::make_shared<EventHandler<KeyPressedEvent>>([&checksum](KeyPressedEvent& e) {
+            checksum.fetch_add(static_cast<uint64_t>(e.GetKeyCode()), std::memory_order_relaxed);
+            return false;
+        });
+        dispatcher.RegisterHandler(handler);
+
+        std::atomic<bool> churning{true};
+        std::thread churn([&dispatcher, &churning] {
+            while (churning.load(std::memory_order_relaxed)) {
+                auto temporary = std::make_shared<EventHandler<KeyPressedEvent>>([](KeyPressedEvent&) { return false; }, -1);
+                dispatcher.RegisterHandler(temporary);
+                dispatcher.UnregisterHandler(temporary);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&dispatcher, threadCount] {
+                for (uint64_t i = 0; i < EventCount / threadCount; ++i) {
+                    KeyPressedEvent event(static_cast<int>(i & 0xFF), 0);
+                    dispatcher.ProcessEvent(event);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        churning.store(false);
+        churn.join();
+        dispatcher.UnregisterHandler(handler);
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+}
+
+int main() {
+    const size_t maxWorkers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> workerCounts{1};
+    for (size_t workers = 2; workers <= maxWorkers; workers *= 2) {
+        workerCounts.push_back(workers);
+    }
+    if (workerCounts.back() != maxWorkers) {
+        workerCounts.push_back(maxWorkers);
+    }
+
+    std::printf("EventDispatchBenchmark: %llu events\n", static_cast<unsigned long long>(EventCount));
+    double baseline = 0.0;
+    for (size_t workers : workerCounts) {
+        double seconds = RunDispatch(workers);
+        if (workers == 1) {
+            baseline = seconds;
+        }
+        std::printf("  workers %2zu: %8.2f ms  %12.0f events/s  speedup %.2fx\n",
+                    workers, seconds * 1000.0, EventCount / seconds, baseline / seconds);
+    }
+
+    std::printf("Direct dispatch from N threads: mutex baseline vs lock-free snapshots\n");
+    MutexDispatcher mutexDispatcher;
+    for (size_t threads : workerCounts) {
+        double mutexSeconds = RunDirectDispatch(mutexDispatcher, threads);
+        double snapshotSeconds = RunDirectDispatch(EventSystem::GetInstance(), threads);
+        std::printf("  threads %2zu: mutex %8.2f ms  snapshot %8.2f ms  speedup %.2fx\n",
+                    threads, mutexSeconds * 1000.0, snapshotSeconds * 1000.0, mutexSeconds / snapshotSeconds);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+//
+// LockFreeQueueBenchmark.cpp - MPMC和MPSC队列吞吐量
+// 分别以逐个和批量接口在1/2/4/8个生产者与同样数量的消费者（MPSC为1个消费者）之间传递固定数量的元素，输出items/s
+//
+
+#include "JFMEngine/Core/LockFreeQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr uint64_t ItemCount = 4000000;
+    constexpr size_t BatchSize = 32;
+
+    using MPMCQueue = LockFreeQueue<uint64_t, 4096, ProducerPolicy::Multi, ConsumerPolicy::Multi>;
+    using MPSCQueue = LockFreeQueue<uint64_t, 4096, ProducerPolicy::Multi, ConsumerPolicy::Single>;
+
+    template<typename Queue>
+    double RunQueue(size_t threadCount, size_t consumerCount, bool bulk) {
+        auto queue = std::make_unique<Queue>();
+        std::atomic<uint64_t> consumed{0};
+        std::atomic<uint64_t> checksum{0};
+        std::atomic<bool> start{false};
+        std::vector<std::thread> threads;
+
+        // 生产者：第p个生产者负责 p, p+N, p+2N ...
+        for (size_t p = 0; p < threadCount; ++p) {
+            threads.emplace_back([&, p] {
+                while (!start.load(std::memory_order_acquire)) {}
+                uint64_t batch[BatchSize];
+                uint64_t next = p;
+                while (next < ItemCount) {
+                    if (bulk) {
+                        size_t count = 0;
+                        for (uint64_t v = next; count < BatchSize && v < ItemCount; v += threadCount) {
+                            batch[count++] = v;
+                        }
+                        size_t pushed = queue->EnqueueBulk(batch, count);
+                        next += pushed * threadCount;
+                        if (pushed == 0) {
+                            std::this_thread::yield();
+                        }
+                    } else if (queue->Enqueue(next)) {
+                        next += threadCount;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (size_t c = 0; c < consumerCount; ++c) {
+            threads.emplace_back([&] {
+                while (!start.load(std::memory_order_acquire)) {}
+                uint64_t batch[BatchSize];
+                uint64_t sum = 0;
+                while (consumed.load(std::memory_order_relaxed) < ItemCount) {
+                    size_t count = bulk ? queue->DequeueBulk(batch, BatchSize) : (queue->Dequeue(batch[0]) ? 1 : 0);
+                    if (count == 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        sum += batch[i];
+                    }
+                    consumed.fetch_add(count, std::memory_order_relaxed);
+                }
+                checksum.fetch_add(sum);
+            });
+        }
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        start.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (checksum.load() != ItemCount * (ItemCount - 1) / 2) {
+            std::printf("  checksum mismatch!\n");
+        }
+        return std::chrono::duration<double>(end - begin).count();
+    }
+
+}
+
+int main() {
+    std::printf("LockFreeQueueBenchmark: %llu items, MPMC (N producers + N consumers)\n",
+                static_cast<unsigned long long>(ItemCount));
+    for (size_t threads : {1, 2, 4, 8}) {
+        double single = RunQueue<MPMCQueue>(threads, threads, false);
+        double bulk = RunQueue<MPMCQueue>(threads, threads, true);
+        std::printf("  threads %zu: single %12.0f items/s  bulk(%zu) %12.0f items/s\n",
+                    threads, ItemCount / single, BatchSize, ItemCount / bulk);
+    }
+
+    std::printf("MPSC (N producers + 1 consumer)\n");
+    for (size_t threads : {1, 2, 4, 8}) {
+        double single = RunQueue<MPSCQueue>(threads, 1, false);
+        double bulk = RunQueue<MPSCQueue>(threads, 1, true);
+        std::printf("  producers %zu: single %12.0f items/s  bulk(%zu) %12.0f items/s\n",
+                    threads, ItemCount / single, BatchSize, ItemCount / bulk);
+    }
+    return 0;
+}
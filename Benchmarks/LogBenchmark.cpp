@@ -0,0 +1,72 @@
+//
+// LogBenchmark.cpp - 调用线程上每次写日志的耗时
+// 1个和8个线程同时写日志，输出调用线程的ns/log-call；工作线程把消息交给只计数的空输出目标
+//
+
+#include "JFMEngine/Utils/Log.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int CallsPerThread = 200000;
+
+    class NullSink : public LogSink {
+    public:
+        void log(const LogMessage&) override { m_Count.fetch_add(1, std::memory_order_relaxed); }
+        uint64_t GetCount() const { return m_Count.load(); }
+
+    private:
+        std::atomic<uint64_t> m_Count{0};
+    };
+
+    void RunLogging(int threadCount, LogOverflowPolicy policy) {
+        auto sink = std::make_shared<NullSink>();
+        uint64_t dropped = 0;
+        std::atomic<long long> totalNanoseconds{0};
+        {
+            AsyncLogger logger("Benchmark");
+            logger.add_sink(sink);
+            logger.set_overflow_policy(policy);
+
+            std::vector<std::thread> threads;
+            const std::string name = "entity";
+            for (int t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t] {
+                    auto begin = std::chrono::steady_clock::now();
+                    for (int i = 0; i < CallsPerThread; ++i) {
+                        logger.info("{} {} moved to {} in {} ms", name, t, i * 0.5f, i);
+                    }
+                    auto end = std::chrono::steady_clock::now();
+                    totalNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            dropped = logger.get_dropped_count();
+        }
+
+        const double calls = static_cast<double>(CallsPerThread) * threadCount;
+        std::printf("  %s threads %d: %8.1f ns/log-call  delivered %llu  dropped %llu\n",
+                    policy == LogOverflowPolicy::Block ? "block" : "drop ", threadCount,
+                    totalNanoseconds.load() / calls,
+                    static_cast<unsigned long long>(sink->GetCount()), static_cast<unsigned long long>(dropped));
+    }
+
+}
+
+int main() {
+    std::printf("LogBenchmark: %d calls per thread\n", CallsPerThread);
+    for (int threads : {1, 8}) {
+        RunLogging(threads, LogOverflowPolicy::Block);
+        RunLogging(threads, LogOverflowPolicy::Drop);
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+//
+// MemoryPoolBenchmark.cpp - 对象池分配速度
+// 对比slab+线程缓存的MemoryPool与原先互斥锁+std::stack的实现，输出allocs/s；
+// Linux下通过perf_event_open统计缓存未命中次数，无权限时显示n/a
+//
+
+#include "JFMEngine/Core/MemoryPool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stack>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace JFM;
+
+namespace {
+
+    constexpr size_t OpsPerThread = 2000000;
+    constexpr size_t HeldPerThread = 64;
+
+    struct PooledObject {
+        uint64_t Data[8];
+    };
+
+    // 原先的实现：每个对象单独分配，空闲链表由互斥锁保护
+    template<typename T, size_t PoolSize = 1024>
+    class MutexStackPool {
+    public:
+        MutexStackPool() {
+            m_Pool.reserve(PoolSize);
+            for (size_t i = 0; i < PoolSize; ++i) {
+                m_Pool.emplace_back(std::make_unique<T>());
+                m_FreeList.push(m_Pool.back().get());
+            }
+        }
+
+        T* Acquire() {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_FreeList.empty()) {
+                size_t currentSize = m_Pool.size();
+                for (size_t i = currentSize; i < currentSize + PoolSize / 2; ++i) {
+                    m_Pool.emplace_back(std::make_unique<T>());
+                    m_FreeList.push(m_Pool.back().get());
+                }
+            }
+            T* obj = m_FreeList.top();
+            m_FreeList.pop();
+            m_AllocatedCount.fetch_add(1);
+            return obj;
+        }
+
+        void Release(T* obj) {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_FreeList.push(obj);
+            m_AllocatedCount.fetch_sub(1);
+        }
+
+    private:
+        std::vector<std::unique_ptr<T>> m_Pool;
+        std::stack<T*> m_FreeList;
+        std::mutex m_Mutex;
+        std::atomic<size_t> m_AllocatedCount{0};
+    };
+
+    // 统计本进程及之后创建的线程的缓存未命中
+    class CacheMissCounter {
+    public:
+        CacheMissCounter() {
+#ifdef __linux__
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_Fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (m_Fd >= 0) {
+                ioctl(m_Fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(m_Fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        ~CacheMissCounter() {
+#ifdef __linux__
+            if (m_Fd >= 0) {
+                close(m_Fd);
+            }
+#endif
+        }
+
+        // 返回-1表示不可用
+        long long Stop() {
+#ifdef __linux__
+            if (m_Fd >= 0) {
+                ioctl(m_Fd, PERF_EVENT_IOC_DISABLE, 0);
+                long long count = 0;
+                if (read(m_Fd, &count, sizeof(count)) == sizeof(count)) {
+                    return count;
+                }
+            }
+#endif
+            return -1;
+        }
+
+    private:
+        int m_Fd = -1;
+    };
+
+    struct Result {
+        double Seconds;
+        long long CacheMisses;
+    };
+
+    // 每个线程反复取出一批对象、写入、再全部归还
+    template<typename Pool>
+    Result RunPool(size_t threadCount) {
+        Pool pool;
+        CacheMissCounter counter;
+        std::vector<std::thread> threads;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&pool, t] {
+                PooledObject* held[HeldPerThread];
+                for (size_t op = 0; op < OpsPerThread; op += HeldPerThread) {
+                    for (size_t i = 0; i < HeldPerThread; ++i) {
+                        held[i] = pool.Acquire();
+                        held[i]->Data[0] = t + i;
+                    }
+                    for (size_t i = 0; i < HeldPerThread; ++i) {
+                        pool.Release(held[i]);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        return {std::chrono::duration<double>(end - begin).count(), counter.Stop()};
+    }
+
+    void PrintResult(const char* name, size_t threadCount, const Result& result) {
+        double allocs = static_cast<double>(OpsPerThread * threadCount);
+        std::printf("  %-16s threads %zu: %12.0f allocs/s", name, threadCount, allocs / result.Seconds);
+        if (result.CacheMisses >= 0) {
+            std::printf("  cache misses %lld (%.3f/alloc)\n", result.CacheMisses, result.CacheMisses / allocs);
+        } else {
+            std::printf("  cache misses n/a\n");
+        }
+    }
+
+}
+
+int main() {
+    std::printf("MemoryPoolBenchmark: %zu acquire/release pairs per thread\n", OpsPerThread);
+    for (size_t threads : {1, 2, 4, 8}) {
+        PrintResult("MutexStackPool", threads, RunPool<MutexStackPool<PooledObject>>(threads));
+        PrintResult("MemoryPool", threads, RunPool<MemoryPool<PooledObject>>(threads));
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+//
+// RenderQueueMergeBenchmark.cpp - 多线程提交与EndScene的归并记录
+// 10万个物体按线程数分到各自的提交列表，经Renderer3D::Submit在JobSystem上并行提交，
+// EndScene并行排序、分段归并并记录命令，交给RecordingRendererAPI执行；
+// 按1/2/4/8/16个工作线程重新初始化JobSystem，输出提交和EndScene的耗时
+//
+
+#include "JFMEngine/Core/FrameArena.h"
+#include "JFMEngine/Core/JobSystem.h"
+#include "JFMEngine/Renderer/Camera.h"
+#include "JFMEngine/Renderer/Material.h"
+#include "JFMEngine/Renderer/Model.h"
+#include "JFMEngine/Renderer/NullRendererAPI.h"
+#include "JFMEngine/Renderer/RenderCommand.h"
+#include "JFMEngine/Renderer/Renderer3D.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr size_t ObjectCount = 100000;
+    constexpr size_t ModelCount = 200;
+    constexpr size_t MaterialCount = 64;
+    constexpr int WarmupFrames = 3;
+    constexpr int MeasuredFrames = 20;
+
+    struct SceneObject {
+        uint32_t Model;
+        uint32_t Material;
+        glm::mat4 Transform;
+    };
+
+}
+
+int main() {
+    // 不创建图形资源，执行的命令只保存在RecordingRendererAPI中
+    RendererAPI::SetAPI(RendererAPI::API::None);
+    RenderCommand::SetRendererAPI(std::make_unique<RecordingRendererAPI>());
+    auto* recorder = static_cast<RecordingRendererAPI*>(RenderCommand::GetRendererAPI());
+    Renderer3D::Init();
+
+    std::vector<std::shared_ptr<Model>> models;
+    for (size_t i = 0; i < ModelCount; ++i) {
+        auto mesh = std::make_shared<Mesh>(MeshGenerator::GenerateCubeVertices(), MeshGenerator::GenerateCubeIndices());
+        models.push_back(std::make_shared<Model>(std::vector<std::shared_ptr<Mesh>>{mesh}));
+    }
+    std::vector<std::shared_ptr<Material>> materials;
+    for (size_t i = 0; i < MaterialCount; ++i) {
+        materials.push_back(std::make_shared<Material>());
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::vector<SceneObject> objects(ObjectCount);
+    for (SceneObject& object : objects) {
+        object.Model = static_cast<uint32_t>(rng() % ModelCount);
+        object.Material = static_cast<uint32_t>(rng() % MaterialCount);
+        object.Transform = glm::mat4(1.0f);
+        object.Transform[3] = glm::vec4(position(rng), position(rng), position(rng), 1.0f);
+    }
+
+    const Camera camera(45.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    std::printf("RenderQueueMergeBenchmark: %zu objects, %zu models, %zu materials\n",
+                ObjectCount, ModelCount, MaterialCount);
+
+    for (size_t threadCount : {1, 2, 4, 8, 16}) {
+        JobSystem& jobs = JobSystem::GetInstance();
+        jobs.Initialize(threadCount);
+
+        double submitMs = 0.0;
+        double endSceneMs = 0.0;
+        for (int frame = 0; frame < WarmupFrames + MeasuredFrames; ++frame) {
+            FrameArena::GetInstance().BeginFrame();
+            recorder->Reset();
+
+            auto begin = std::chrono::high_resolution_clock::now();
+            Renderer3D::BeginScene(camera);
+            // 每个线程写自己的提交列表
+            Renderer3D::PrepareCommandLists(static_cast<uint32_t>(threadCount));
+            jobs.ParallelFor(threadCount, 1, [&](size_t first, size_t last) {
+                for (size_t t = first; t < last; ++t) {
+                    RenderCommandList& list = Renderer3D::GetCommandList(static_cast<uint32_t>(t));
+                    for (size_t i = t; i < ObjectCount; i += threadCount) {
+                        const SceneObject& object = objects[i];
+                        Renderer3D::Submit(list, models[object.Model], object.Transform, materials[object.Material]);
+                    }
+                }
+            });
+            auto submitted = std::chrono::high_resolution_clock::now();
+            Renderer3D::EndScene();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            if (frame >= WarmupFrames) {
+                submitMs += std::chrono::duration<double, std::milli>(submitted - begin).count();
+                endSceneMs += std::chrono::duration<double, std::milli>(end - submitted).count();
+            }
+        }
+
+        std::printf("  %2zu threads  submit %8.3f ms  EndScene %8.3f ms  segments %u  draws %u  commands %6.2f MB\n",
+                    threadCount, submitMs / MeasuredFrames, endSceneMs / MeasuredFrames,
+                    Renderer3D::GetCommandBufferCount(), Renderer3D::GetStats().DrawCalls,
+                    static_cast<double>(recorder->GetCommands().size() * sizeof(uint64_t)) / (1024.0 * 1024.0));
+
+        jobs.Shutdown();
+    }
+
+    Renderer3D::Shutdown();
+    return 0;
+}
@@ -5,13 +5,6 @@
 #ifndef CORE_H
 #define CORE_H
 
-// 前置声明和包含
-#ifdef JFM_DEBUG
-    // 在Debug模式下需要OpenGL和日志系统
-    #include <glad/glad.h>
-    #include "JFMEngine/Utils/Log.h"
-#endif
-
 // 跨平台 API 导出宏定义
 #ifdef _WIN32
     #ifdef JFM_BUILD_DLL
@@ -28,6 +21,14 @@
     #endif
 #endif
 
+// 前置声明和包含
+// 放在JFM_API之后：Log.h间接包含的头文件同样依赖JFM_API
+#ifdef JFM_DEBUG
+    // 在Debug模式下需要OpenGL和日志系统
+    #include <glad/glad.h>
+    #include "JFMEngine/Utils/Log.h"
+#endif
+
 // 断言宏定义
 #ifdef JFM_DEBUG
     #define JFM_ENABLE_ASSERTS
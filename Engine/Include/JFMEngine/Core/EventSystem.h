@@ -8,20 +8,61 @@
 
 #include "JFMEngine/Core/Core.h"
 #include "JFMEngine/Events/Event.h"
+#include "JFMEngine/Events/ApplicationEvent.h"
+#include "JFMEngine/Events/KeyEvent.h"
+#include "JFMEngine/Events/MouseEvent.h"
 #include "JFMEngine/Core/LockFreeQueue.h"
 #include "JFMEngine/Core/MemoryPool.h"
 #include <vector>
+#include <array>
 #include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
-#include <unordered_map>
 #include <chrono>
 #include <functional>
+#include <variant>
+#include <type_traits>
 
 namespace JFM {
 
+    // 事件类型数量，分发表按EventType直接索引
+    constexpr size_t EventTypeCount = static_cast<size_t>(EventType::MouseScrolled) + 1;
+
+    // 通过指针投递的事件：指针 + 对应的释放函数（EventMemoryManager池或delete）
+    struct PooledEvent {
+        Event* Ptr = nullptr;
+        void (*Release)(Event*) = nullptr;
+    };
+
+    // 投递队列的槽位类型
+    // 引擎内置的小型事件直接在队列槽位中构造，投递不产生任何堆分配；
+    // 其余事件类型退化为PooledEvent
+    using PostedEvent = std::variant<std::monostate, PooledEvent,
+        WindowResizeEvent, WindowCloseEvent, AppTickEvent, AppUpdateEvent, AppRenderEvent,
+        KeyPressedEvent, KeyReleasedEvent, KeyTypedEvent,
+        MouseMovedEvent, MouseScrolledEvent, MouseButtonPressedEvent, MouseButtonReleasedEvent>;
+
+    static_assert(sizeof(PostedEvent) <= 64, "PostedEvent slot should stay within one cache line");
+
+    template<typename T, typename Variant>
+    struct IsVariantAlternative : std::false_type {};
+
+    template<typename T, typename... Ts>
+    struct IsVariantAlternative<T, std::variant<Ts...>> : std::disjunction<std::is_same<T, Ts>...> {};
+
+    // 事件类型能否直接存放在投递队列槽位中
+    template<typename EventT>
+    constexpr bool IsInlineEvent = IsVariantAlternative<EventT, PostedEvent>::value;
+
+    // 投递事件的无锁队列
+    // PostEvent可在任意线程调用，工作线程与主线程的ProcessEvents同时消费，因此保持MPMC
+    using EventQueue = LockFreeQueue<PostedEvent, 8192>;
+
+    // 每次批量出队的最大事件数
+    constexpr size_t EventBatchSize = 32;
+
     // 事件处理器接口
     class JFM_API IEventHandler {
     public:
@@ -86,6 +127,29 @@ namespace JFM {
         // 投递事件（异步处理）
         bool PostEvent(std::unique_ptr<Event> event);
 
+        // 投递事件（异步处理，零堆分配）
+        // 内置小型事件在队列槽位中原地构造，其他事件类型从EventMemoryManager池中分配
+        template<typename EventT, typename... Args>
+        bool PostEvent(Args&&... args) {
+            static_assert(std::is_base_of_v<Event, EventT>, "EventT must derive from Event");
+
+            if constexpr (IsInlineEvent<EventT>) {
+                // 先在栈上构造并过滤，只有通过过滤的事件才占用队列槽位
+                EventT event(std::forward<Args>(args)...);
+                if (!PassesFilter(event)) {
+                    return true; // 事件被过滤，但不算错误
+                }
+                return PostInline(std::move(event));
+            } else {
+                EventT* event = EventMemoryManager::GetInstance().AllocateEvent<EventT>(std::forward<Args>(args)...);
+                if (!event) {
+                    m_Stats.EventsDropped.fetch_add(1);
+                    return false;
+                }
+                return PostPooled(event, &ReleasePooledEvent<EventT>);
+            }
+        }
+
         // 注册事件处理器
         template<typename EventT>
         void RegisterHandler(std::function<bool(EventT&)> handler, int priority = 0) {
@@ -114,8 +178,10 @@ namespace JFM {
         }
 
     private:
-        EventSystem() = default;
-        ~EventSystem() { Shutdown(); }
+        using HandlerList = std::vector<std::shared_ptr<IEventHandler>>;
+
+        EventSystem();
+        ~EventSystem();
 
         // 禁止拷贝和赋值
         EventSystem(const EventSystem&) = delete;
@@ -127,6 +193,33 @@ namespace JFM {
         // 处理单个事件的内部函数
         void ProcessEventInternal(Event& event);
 
+        // 分发一个从队列取出的槽位，并释放池化事件
+        void DispatchPostedEvent(PostedEvent& posted);
+
+        // 把已通过过滤的内置事件移入槽位，写入槽位期间不执行任何用户代码
+        template<typename EventT>
+        bool PostInline(EventT&& event) {
+            bool queued = m_EventQueue->EnqueueWith([&](PostedEvent& slot) {
+                slot.emplace<EventT>(std::move(event));
+            });
+            return OnEnqueued(queued);
+        }
+
+        bool PostPooled(Event* event, void (*release)(Event*));
+        bool PassesFilter(const Event& event);
+        bool OnEnqueued(bool queued);
+
+        template<typename EventT>
+        static void ReleasePooledEvent(Event* event) {
+            EventMemoryManager::GetInstance().DeallocateEvent(static_cast<EventT*>(event));
+        }
+
+        // 发布某个事件类型的新处理器快照（调用方需持有m_HandlersMutex）
+        void PublishHandlers(EventType eventType, HandlerList handlers);
+
+        // 每种事件类型一个原子替换的快照指针和读者计数，定义在EventSystem.cpp中
+        struct HandlerTables;
+
         // 事件队列
         std::unique_ptr<EventQueue> m_EventQueue;
 
@@ -136,9 +229,12 @@ namespace JFM {
         std::condition_variable m_WorkerCV;
         std::mutex m_WorkerMutex;
 
-        // 事件处理器管理
-        std::unordered_map<JFM::EventType, std::vector<std::shared_ptr<IEventHandler>>> m_Handlers;
-        std::mutex m_HandlersMutex;
+        // 事件处理器管理（写时复制分发表）
+        // 每种事件类型对应一份不可变的处理器快照，注册/注销时发布新快照，
+        // 分发时登记为读者后原子地读取快照指针，不加锁；
+        // 旧快照在没有分发线程可能仍在遍历它之后释放，注销的处理器随之析构
+        std::unique_ptr<HandlerTables> m_HandlerTables;
+        std::mutex m_HandlersMutex; // 只串行化写者
 
         // 事件过滤器
         std::function<bool(const Event&)> m_EventFilter;
@@ -161,7 +257,7 @@ namespace JFM {
 
     // 投递事件的便捷宏
     #define POST_EVENT(eventType, ...) \
-        EVENT_SYSTEM().PostEvent(std::make_unique<eventType>(__VA_ARGS__))
+        EVENT_SYSTEM().PostEvent<eventType>(__VA_ARGS__)
 
 }
 
@@ -0,0 +1,143 @@
+//
+// FrameArena.h - 每帧线性分配器
+// 用于存放只在一帧内有效的临时数据，Application::Run在每帧开始时重置
+//
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include "JFMEngine/Core/Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace JFM {
+
+    // 帧分配器统计信息
+    struct FrameArenaStats {
+        size_t UsedBytes = 0;         // 当前帧已分配字节数
+        size_t PeakBytes = 0;         // 历史单帧最大分配字节数
+        size_t CapacityBytes = 0;     // 所有帧缓冲的总容量
+        size_t ChunkAllocations = 0;  // 累计向系统申请内存块的次数，稳定后应不再增长
+    };
+
+    // 多缓冲的线性分配器
+    // 每个在途帧拥有独立的内存块，BeginFrame只重置最早的那一帧，
+    // 因此上一帧分配的数据在本帧内仍然有效（例如仍被GPU或渲染线程使用）
+    // 仅供主线程使用
+    class JFM_API FrameArena {
+    public:
+        static constexpr uint32_t MaxFramesInFlight = 3;
+        static constexpr size_t DefaultChunkSize = 256 * 1024; // 256KB
+
+        static FrameArena& GetInstance() {
+            static FrameArena instance;
+            return instance;
+        }
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // 开始新的一帧：切换到下一个帧缓冲并重置它
+        void BeginFrame();
+
+        // 设置在途帧数量（1~MaxFramesInFlight）
+        void SetFramesInFlight(uint32_t count);
+        uint32_t GetFramesInFlight() const { return m_FramesInFlight; }
+
+        // 分配原始内存，本帧结束后的第FramesInFlight帧开始时失效
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            FrameBuffer& frame = m_Frames[m_CurrentFrame];
+            if (frame.Current < frame.Chunks.size()) {
+                Chunk& chunk = frame.Chunks[frame.Current];
+                uintptr_t base = reinterpret_cast<uintptr_t>(chunk.Data.get());
+                uintptr_t aligned = (base + chunk.Offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+                size_t end = static_cast<size_t>(aligned - base) + size;
+                if (end <= chunk.Size) {
+                    frame.Used += end - chunk.Offset;
+                    chunk.Offset = end;
+                    return reinterpret_cast<void*>(aligned);
+                }
+            }
+            return AllocateSlow(size, alignment);
+        }
+
+        // 在帧内存上构造对象，不会调用析构函数，仅适用于无需析构的数据
+        template<typename T, typename... Args>
+        T* New(Args&&... args) {
+            return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        template<typename T>
+        T* AllocateArray(size_t count) {
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        FrameArenaStats GetStats() const;
+
+    private:
+        FrameArena();
+
+        struct Chunk {
+            std::unique_ptr<uint8_t[]> Data;
+            size_t Size = 0;
+            size_t Offset = 0;
+        };
+
+        struct FrameBuffer {
+            std::vector<Chunk> Chunks;
+            size_t Current = 0; // 正在使用的块
+            size_t Used = 0;    // 本帧已分配字节数
+        };
+
+        void* AllocateSlow(size_t size, size_t alignment);
+        void ResetFrame(FrameBuffer& frame);
+        void AddChunk(FrameBuffer& frame, size_t size);
+
+        FrameBuffer m_Frames[MaxFramesInFlight];
+        uint32_t m_FramesInFlight = 2;
+        uint32_t m_CurrentFrame = 0;
+        size_t m_PeakBytes = 0;
+        size_t m_ChunkAllocations = 0;
+    };
+
+    // STL分配器适配器，使标准容器可以把元素放在帧内存上
+    // deallocate为空操作，内存在帧重置时统一回收
+    template<typename T>
+    class FrameAllocator {
+    public:
+        using value_type = T;
+
+        FrameAllocator() noexcept : m_Arena(&FrameArena::GetInstance()) {}
+        explicit FrameAllocator(FrameArena& arena) noexcept : m_Arena(&arena) {}
+
+        template<typename U>
+        FrameAllocator(const FrameAllocator<U>& other) noexcept : m_Arena(other.GetArena()) {}
+
+        T* allocate(size_t count) {
+            return m_Arena->AllocateArray<T>(count);
+        }
+
+        void deallocate(T*, size_t) noexcept {}
+
+        FrameArena* GetArena() const noexcept { return m_Arena; }
+
+        template<typename U>
+        bool operator==(const FrameAllocator<U>& other) const noexcept { return m_Arena == other.GetArena(); }
+        template<typename U>
+        bool operator!=(const FrameAllocator<U>& other) const noexcept { return m_Arena != other.GetArena(); }
+
+    private:
+        FrameArena* m_Arena;
+    };
+
+    // 每帧临时容器
+    template<typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+}
+
+#endif //FRAMEARENA_H
@@ -0,0 +1,87 @@
+//
+// JobSystem.h - 并行任务系统
+// 固定数量的工作线程执行数据并行任务，供物理、渲染等模块拆分每帧的计算
+//
+
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include "JFMEngine/Core/Core.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace JFM {
+
+    class JFM_API JobSystem {
+    public:
+        static JobSystem& GetInstance() {
+            static JobSystem instance;
+            return instance;
+        }
+
+        // 启动工作线程，调用ParallelFor的线程也会参与执行，因此默认比核心数少一个
+        void Initialize(size_t workerThreads = DefaultWorkerCount());
+        void Shutdown();
+
+        size_t GetWorkerCount() const { return m_WorkerThreads.size(); }
+
+        // 把[0, count)按grainSize切块，调用func(begin, end)，返回时所有块都已执行完
+        // 未初始化、只有一块或在任务内部嵌套调用时直接在当前线程顺序执行
+        // 块的划分与线程数无关，但执行顺序不确定，func对不同块的写入不能重叠
+        template<typename Func>
+        void ParallelFor(size_t count, size_t grainSize, Func&& func) {
+            using FuncType = std::remove_reference_t<Func>;
+            Run([](void* context, size_t begin, size_t end) {
+                (*static_cast<FuncType*>(context))(begin, end);
+            }, const_cast<void*>(static_cast<const void*>(&func)), count, grainSize);
+        }
+
+        static size_t DefaultWorkerCount() {
+            unsigned int cores = std::thread::hardware_concurrency();
+            return cores > 1 ? cores - 1 : 0;
+        }
+
+    private:
+        using JobFunction = void (*)(void* context, size_t begin, size_t end);
+
+        struct Job {
+            JobFunction Function = nullptr;
+            void* Context = nullptr;
+            size_t Count = 0;
+            size_t GrainSize = 1;
+            size_t ChunkCount = 0;
+        };
+
+        JobSystem() = default;
+        ~JobSystem() { Shutdown(); }
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void Run(JobFunction function, void* context, size_t count, size_t grainSize);
+        void ExecuteChunks(const Job& job);
+        void WorkerThreadFunc();
+
+        std::vector<std::thread> m_WorkerThreads;
+        bool m_Running = false;
+
+        std::mutex m_SubmitMutex;           // 同一时间只执行一个并行任务
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkCV;
+        std::condition_variable m_DoneCV;
+
+        Job m_Job;
+        uint64_t m_Generation = 0;          // 每提交一个任务加一，工作线程据此发现新任务
+        size_t m_ActiveWorkers = 0;         // 持有当前任务副本的工作线程数
+        std::atomic<size_t> m_NextChunk{0};
+        std::atomic<size_t> m_PendingChunks{0};
+    };
+
+}
+
+#endif //JOBSYSTEM_H
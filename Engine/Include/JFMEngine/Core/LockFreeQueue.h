@@ -9,14 +9,37 @@
 #include "JFMEngine/Core/Core.h"
 #include <atomic>
 #include <memory>
+#include <algorithm>
 
 namespace JFM {
 
+    // 生产者并发策略
+    enum class ProducerPolicy {
+        Single, // 只有一个生产者线程，入队无需CAS
+        Multi   // 多个生产者线程并发入队
+    };
+
+    // 消费者并发策略
+    enum class ConsumerPolicy {
+        Single, // 只有一个消费者线程，出队无需CAS
+        Multi   // 多个消费者线程并发出队
+    };
+
     // 无锁环形缓冲区
-    template<typename T, size_t Size = 4096>
+    // 默认为Vyukov MPMC设计；单生产者/单消费者一侧退化为普通的load/store，
+    // SPSC时完全不读取槽位序号，两端各自缓存对方的位置，只在看起来满/空时才跨核读取；
+    // MPSC时生产者同样凭缓存的消费者位置判断剩余空间，不读取消费者刚归还的槽位序号
+    template<typename T, size_t Size = 4096,
+             ProducerPolicy Producers = ProducerPolicy::Multi,
+             ConsumerPolicy Consumers = ConsumerPolicy::Multi>
     class JFM_API LockFreeQueue {
         static_assert((Size & (Size - 1)) == 0, "Size must be power of 2");
 
+        static constexpr bool IsSPSC =
+            Producers == ProducerPolicy::Single && Consumers == ConsumerPolicy::Single;
+        static constexpr bool IsMPSC =
+            Producers == ProducerPolicy::Multi && Consumers == ConsumerPolicy::Single;
+
     public:
         LockFreeQueue() : m_Head(0), m_Tail(0) {
             // 初始化环形缓冲区
@@ -27,64 +50,65 @@ namespace JFM {
 
         // 生产者 - 入队操作
         bool Enqueue(const T& item) {
-            Node* node = nullptr;
-            size_t pos = m_Head.load(std::memory_order_relaxed);
-
-            while (true) {
-                node = &m_Buffer[pos & (Size - 1)];
-                size_t seq = node->sequence.load(std::memory_order_acquire);
-                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
-
-                if (diff == 0) {
-                    // 位置可用，尝试占据
-                    if (m_Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
-                        break;
-                    }
-                } else if (diff < 0) {
-                    // 队列已满
-                    return false;
-                } else {
-                    // 其他线程在操作，重试
-                    pos = m_Head.load(std::memory_order_relaxed);
-                }
+            return EnqueueWith([&item](T& slot) { slot = item; });
+        }
+
+        // 生产者 - 原地入队：占据槽位后直接调用writer(T&)写入槽位，再发布
+        // 适合在槽位中直接构造对象，避免临时对象和额外拷贝
+        template<typename Writer>
+        bool EnqueueWith(Writer&& writer) {
+            size_t pos = 0;
+            if (ClaimWrite(1, pos) == 0) {
+                // 队列已满
+                return false;
             }
 
             // 写入数据
-            node->data = item;
-            node->sequence.store(pos + 1, std::memory_order_release);
+            writer(m_Buffer[pos & (Size - 1)].data);
+            PublishWrite(pos, 1);
             return true;
         }
 
         // 消费者 - 出队操作
         bool Dequeue(T& item) {
-            Node* node = nullptr;
-            size_t pos = m_Tail.load(std::memory_order_relaxed);
-
-            while (true) {
-                node = &m_Buffer[pos & (Size - 1)];
-                size_t seq = node->sequence.load(std::memory_order_acquire);
-                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
-
-                if (diff == 0) {
-                    // 数据可用，尝试读取
-                    if (m_Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
-                        break;
-                    }
-                } else if (diff < 0) {
-                    // 队列为空
-                    return false;
-                } else {
-                    // 其他线程在操作，重试
-                    pos = m_Tail.load(std::memory_order_relaxed);
-                }
+            size_t pos = 0;
+            if (ClaimRead(1, pos) == 0) {
+                // 队列为空
+                return false;
             }
 
             // 读取数据
-            item = node->data;
-            node->sequence.store(pos + Size, std::memory_order_release);
+            item = m_Buffer[pos & (Size - 1)].data;
+            PublishRead(pos, 1);
             return true;
         }
 
+        // 批量入队：一次CAS占据连续的一段槽位，再逐个发布槽位序号
+        // 返回实际入队的数量（队列剩余空间不足时可能小于count）
+        size_t EnqueueBulk(const T* items, size_t count) {
+            size_t pos = 0;
+            size_t claimed = ClaimWrite(count, pos);
+
+            for (size_t i = 0; i < claimed; ++i) {
+                m_Buffer[(pos + i) & (Size - 1)].data = items[i];
+            }
+            PublishWrite(pos, claimed);
+            return claimed;
+        }
+
+        // 批量出队：一次CAS认领连续的一段已发布槽位
+        // 返回实际出队的数量，0表示队列为空
+        size_t DequeueBulk(T* items, size_t maxCount) {
+            size_t pos = 0;
+            size_t claimed = ClaimRead(maxCount, pos);
+
+            for (size_t i = 0; i < claimed; ++i) {
+                items[i] = m_Buffer[(pos + i) & (Size - 1)].data;
+            }
+            PublishRead(pos, claimed);
+            return claimed;
+        }
+
         // 获取队列大小（近似值）
         size_t GetSize() const {
             return m_Head.load() - m_Tail.load();
@@ -94,23 +118,185 @@ namespace JFM {
             return m_Head.load() == m_Tail.load();
         }
 
+        // 生产者已占据的位置，即累计入队数（含正在写入的槽位）
+        // 消费者累计出队数追上该值时，此前入队的元素都已被取走
+        size_t GetWritePosition() const {
+            return m_Head.load(std::memory_order_acquire);
+        }
+
     private:
         struct Node {
             std::atomic<size_t> sequence;
             T data;
         };
 
+        // 占据最多maxCount个可写槽位，返回占据数量并通过pos返回起始位置
+        size_t ClaimWrite(size_t maxCount, size_t& pos) {
+            if (maxCount == 0) {
+                return 0;
+            }
+
+            pos = m_Head.load(std::memory_order_relaxed);
+
+            if constexpr (IsSPSC) {
+                // 先用缓存的消费者位置判断，不够时才读取m_Tail
+                size_t cachedTail = m_CachedTail.load(std::memory_order_relaxed);
+                size_t available = Size - (pos - cachedTail);
+                if (available < maxCount) {
+                    cachedTail = m_Tail.load(std::memory_order_acquire);
+                    m_CachedTail.store(cachedTail, std::memory_order_relaxed);
+                    available = Size - (pos - cachedTail);
+                }
+                return std::min(available, maxCount);
+            } else if constexpr (IsMPSC) {
+                // 生产者共享一份缓存的消费者位置，空间不够时才读取m_Tail
+                // 缓存以release/acquire传递，保证消费者读完槽位先于其他生产者覆写
+                size_t cachedTail = m_CachedTail.load(std::memory_order_acquire);
+                while (true) {
+                    size_t available = Size - (pos - cachedTail);
+                    if (available < maxCount) {
+                        cachedTail = m_Tail.load(std::memory_order_acquire);
+                        m_CachedTail.store(cachedTail, std::memory_order_release);
+                        available = Size - (pos - cachedTail);
+                        if (available == 0) {
+                            // 队列已满
+                            return 0;
+                        }
+                    }
+
+                    size_t claimed = std::min(available, maxCount);
+                    if (m_Head.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                        return claimed;
+                    }
+                }
+            } else if constexpr (Producers == ProducerPolicy::Single) {
+                return CountReady(pos, maxCount, 0);
+            } else {
+                while (true) {
+                    // 统计从pos开始连续可写的槽位
+                    size_t claimed = CountReady(pos, maxCount, 0);
+
+                    if (claimed == 0) {
+                        size_t seq = m_Buffer[pos & (Size - 1)].sequence.load(std::memory_order_acquire);
+                        if ((intptr_t)seq - (intptr_t)pos < 0) {
+                            // 队列已满
+                            return 0;
+                        }
+                        // 其他生产者已经推进了m_Head，重试
+                        pos = m_Head.load(std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (m_Head.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                        return claimed;
+                    }
+                }
+            }
+        }
+
+        // 发布已写入的槽位
+        void PublishWrite(size_t pos, size_t count) {
+            if (count == 0) {
+                return;
+            }
+
+            if constexpr (IsSPSC) {
+                m_Head.store(pos + count, std::memory_order_release);
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    m_Buffer[(pos + i) & (Size - 1)].sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                if constexpr (Producers == ProducerPolicy::Single) {
+                    m_Head.store(pos + count, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // 认领最多maxCount个可读槽位，返回认领数量并通过pos返回起始位置
+        size_t ClaimRead(size_t maxCount, size_t& pos) {
+            if (maxCount == 0) {
+                return 0;
+            }
+
+            pos = m_Tail.load(std::memory_order_relaxed);
+
+            if constexpr (IsSPSC) {
+                // 先用缓存的生产者位置判断，不够时才读取m_Head
+                size_t available = m_CachedHead - pos;
+                if (available < maxCount) {
+                    m_CachedHead = m_Head.load(std::memory_order_acquire);
+                    available = m_CachedHead - pos;
+                }
+                return std::min(available, maxCount);
+            } else if constexpr (Consumers == ConsumerPolicy::Single) {
+                return CountReady(pos, maxCount, 1);
+            } else {
+                while (true) {
+                    // 统计从pos开始连续可读的槽位
+                    size_t claimed = CountReady(pos, maxCount, 1);
+
+                    if (claimed == 0) {
+                        size_t seq = m_Buffer[pos & (Size - 1)].sequence.load(std::memory_order_acquire);
+                        if ((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+                            // 队列为空
+                            return 0;
+                        }
+                        // 其他消费者已经推进了m_Tail，重试
+                        pos = m_Tail.load(std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (m_Tail.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+                        return claimed;
+                    }
+                }
+            }
+        }
+
+        // 归还已读取的槽位
+        void PublishRead(size_t pos, size_t count) {
+            if (count == 0) {
+                return;
+            }
+
+            if constexpr (IsSPSC || IsMPSC) {
+                // 生产者只凭m_Tail判断槽位是否空闲，不再写回槽位序号；
+                // 下一轮的可读序号pos+Size+1与本轮残留的pos+1不同，消费者不会误读
+                m_Tail.store(pos + count, std::memory_order_release);
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    m_Buffer[(pos + i) & (Size - 1)].sequence.store(pos + i + Size, std::memory_order_release);
+                }
+                if constexpr (Consumers == ConsumerPolicy::Single) {
+                    m_Tail.store(pos + count, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // 从pos开始统计最多maxCount个序号等于 位置+offset 的连续槽位
+        // offset为0表示可写，为1表示可读
+        size_t CountReady(size_t pos, size_t maxCount, size_t offset) const {
+            size_t count = 0;
+            while (count < maxCount && count < Size) {
+                const Node& node = m_Buffer[(pos + count) & (Size - 1)];
+                if (node.sequence.load(std::memory_order_acquire) != pos + count + offset) {
+                    break;
+                }
+                ++count;
+            }
+            return count;
+        }
+
         static constexpr size_t CACHE_LINE_SIZE = 64;
 
-        // 使用缓存行对齐避免伪共享
+        // 使用缓存行对齐避免伪共享，各端的缓存位置与自己的索引放在同一缓存行
         alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Head;
+        std::atomic<size_t> m_CachedTail{0}; // 生产者缓存的消费者位置（SPSC和MPSC）
         alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Tail;
+        size_t m_CachedHead = 0; // 消费者缓存的生产者位置（仅SPSC）
         alignas(CACHE_LINE_SIZE) Node m_Buffer[Size];
     };
 
-    // 事件指针的无锁队列
-    using EventQueue = LockFreeQueue<class Event*, 8192>;
-
 }
 
 #endif //LOCKFREEQUEUE_H
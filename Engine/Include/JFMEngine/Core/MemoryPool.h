@@ -8,76 +8,243 @@
 
 #include "JFMEngine/Core/Core.h"
 #include <memory>
+#include <new>
+#include <array>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 #include <queue>
 #include <chrono>
 
 namespace JFM {
 
+    namespace Detail {
+        // 线程缓存槽位数量上限，超出的线程直接访问共享空闲链表
+        constexpr uint32_t MaxThreadCaches = 64;
+        constexpr uint32_t InvalidThreadCache = UINT32_MAX;
+
+        // 当前线程的缓存槽位索引：首次调用时分配，线程退出时归还给后来的线程复用
+        JFM_API uint32_t GetThreadCacheIndex();
+    }
+
     // 线程安全的内存池
+    // 对象按PoolSize个一组连续存放在slab中，空闲对象通过带ABA标记的无锁Treiber栈串联；
+    // 每个线程另有一个小弹匣（magazine）缓存空闲对象，常见路径不触碰任何共享缓存行
     //模版参数可带默认值
     template<typename T, size_t PoolSize = 1024>
     class JFM_API MemoryPool {
+        static_assert(PoolSize > 0, "PoolSize must be positive");
+
     public:
         MemoryPool() {
-            // 预分配内存块
-            m_Pool.reserve(PoolSize);
-            for (size_t i = 0; i < PoolSize; ++i) {
-                //所有权分离
-                m_Pool.emplace_back(std::make_unique<T>());
-                m_FreeList.push(m_Pool.back().get());
+            // 预分配第一个slab
+            AddSlab();
+        }
+
+        ~MemoryPool() {
+            for (uint32_t i = 0; i < m_SlabCount.load(); ++i) {
+                for (size_t j = 0; j < PoolSize; ++j) {
+                    m_Slabs[i][j].Object()->~T();
+                }
+                delete[] m_Slabs[i];
             }
         }
 
-        // 获取对象（线程安全）
+        MemoryPool(const MemoryPool&) = delete;
+        MemoryPool& operator=(const MemoryPool&) = delete;
+
+        // 获取对象（线程安全），超出容量上限时返回nullptr
         T* Acquire() {
-            std::lock_guard<std::mutex> lock(m_Mutex);
-            if (m_FreeList.empty()) {
-                // 动态扩展池
-                ExpandPool();
+            uint32_t cache = Detail::GetThreadCacheIndex();
+            if (cache == Detail::InvalidThreadCache) {
+                // 没有线程缓存可用，直接访问共享空闲链表
+                uint32_t index = PopShared();
+                if (index == InvalidIndex) {
+                    return nullptr;
+                }
+                m_SharedOutstanding.fetch_add(1, std::memory_order_relaxed);
+                return GetSlot(index)->Object();
             }
 
-            T* obj = m_FreeList.top();
-            m_FreeList.pop();
-            m_AllocatedCount.fetch_add(1);
-            return obj;
+            Magazine& magazine = m_Magazines[cache];
+            if (magazine.Count == 0 && !Refill(magazine)) {
+                return nullptr;
+            }
+
+            uint32_t index = magazine.Items[--magazine.Count];
+            magazine.Outstanding.store(magazine.Outstanding.load(std::memory_order_relaxed) + 1,
+                                       std::memory_order_relaxed);
+            return GetSlot(index)->Object();
         }
 
         // 释放对象（线程安全）
         void Release(T* obj) {
             if (!obj) return;
 
-            std::lock_guard<std::mutex> lock(m_Mutex);
-            m_FreeList.push(obj);
-            m_AllocatedCount.fetch_sub(1);
+            uint32_t index = reinterpret_cast<Slot*>(obj)->Index;
+            uint32_t cache = Detail::GetThreadCacheIndex();
+            if (cache == Detail::InvalidThreadCache) {
+                PushChain(index, index);
+                m_SharedOutstanding.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+
+            Magazine& magazine = m_Magazines[cache];
+            if (magazine.Count == MagazineSize) {
+                Flush(magazine);
+            }
+
+            magazine.Items[magazine.Count++] = index;
+            magazine.Outstanding.store(magazine.Outstanding.load(std::memory_order_relaxed) - 1,
+                                       std::memory_order_relaxed);
         }
 
-        // 获取统计信息
-        size_t GetAllocatedCount() const { return m_AllocatedCount.load(); }
-        size_t GetPoolSize() const { return m_Pool.size(); }
+        // 获取统计信息（近似值）
+        size_t GetAllocatedCount() const {
+            int64_t total = m_SharedOutstanding.load(std::memory_order_relaxed);
+            for (const Magazine& magazine : m_Magazines) {
+                total += magazine.Outstanding.load(std::memory_order_relaxed);
+            }
+            return total > 0 ? static_cast<size_t>(total) : 0;
+        }
+        size_t GetPoolSize() const { return m_SlabCount.load() * PoolSize; }
 
     private:
-        void ExpandPool() {
-            size_t currentSize = m_Pool.size();
-            size_t newSize = currentSize + PoolSize / 2; // 扩展50%
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+        static constexpr uint32_t MaxSlabs = 1024;
+        static constexpr uint32_t MagazineSize = 32;
+
+        static_assert(PoolSize * MaxSlabs < InvalidIndex, "PoolSize too large for 32-bit slot indices");
+
+        // 对象槽位：对象存储在首成员，因此T*可以直接转换回Slot*
+        struct Slot {
+            alignas(T) unsigned char Storage[sizeof(T)];
+            std::atomic<uint32_t> Next{InvalidIndex};
+            uint32_t Index = 0;
+
+            T* Object() { return std::launder(reinterpret_cast<T*>(Storage)); }
+        };
+
+        // 线程私有的空闲对象缓存，独占一个缓存行
+        struct alignas(64) Magazine {
+            uint32_t Count = 0;
+            uint32_t Items[MagazineSize];
+            std::atomic<int64_t> Outstanding{0}; // 本线程获取数 - 释放数，仅本线程写入
+        };
+
+        Slot* GetSlot(uint32_t index) const {
+            // 索引只会在slab发布之后出现，m_Slabs的写入与读取由空闲链表的release/acquire同步
+            return &m_Slabs[index / PoolSize][index % PoolSize];
+        }
+
+        static uint64_t Pack(uint32_t index, uint32_t tag) {
+            return (static_cast<uint64_t>(tag) << 32) | index;
+        }
+
+        // 从共享空闲链表弹出一个对象，必要时扩展
+        uint32_t PopShared() {
+            while (true) {
+                uint64_t head = m_FreeHead.load(std::memory_order_acquire);
+                while (static_cast<uint32_t>(head) != InvalidIndex) {
+                    uint32_t index = static_cast<uint32_t>(head);
+                    uint32_t next = GetSlot(index)->Next.load(std::memory_order_relaxed);
+                    // 每次修改都递增标记，防止ABA
+                    uint64_t newHead = Pack(next, static_cast<uint32_t>(head >> 32) + 1);
+                    if (m_FreeHead.compare_exchange_weak(head, newHead,
+                            std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        return index;
+                    }
+                }
+
+                if (!ExpandPool()) {
+                    return InvalidIndex;
+                }
+            }
+        }
 
-            for (size_t i = currentSize; i < newSize; ++i) {
-                m_Pool.emplace_back(std::make_unique<T>());
-                m_FreeList.push(m_Pool.back().get());
+        // 把已经首尾相连的一串槽位压回共享空闲链表，只需一次CAS
+        void PushChain(uint32_t first, uint32_t last) {
+            uint64_t head = m_FreeHead.load(std::memory_order_relaxed);
+            do {
+                GetSlot(last)->Next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            } while (!m_FreeHead.compare_exchange_weak(head, Pack(first, static_cast<uint32_t>(head >> 32) + 1),
+                        std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // 从共享链表补充半个弹匣
+        bool Refill(Magazine& magazine) {
+            while (magazine.Count < MagazineSize / 2) {
+                uint32_t index = PopShared();
+                if (index == InvalidIndex) {
+                    break;
+                }
+                magazine.Items[magazine.Count++] = index;
+            }
+            return magazine.Count > 0;
+        }
+
+        // 弹匣满时把后一半归还共享链表
+        void Flush(Magazine& magazine) {
+            uint32_t begin = MagazineSize / 2;
+            for (uint32_t i = begin; i + 1 < magazine.Count; ++i) {
+                GetSlot(magazine.Items[i])->Next.store(magazine.Items[i + 1], std::memory_order_relaxed);
+            }
+            PushChain(magazine.Items[begin], magazine.Items[magazine.Count - 1]);
+            magazine.Count = begin;
+        }
+
+        // 动态扩展池：追加一个slab
+        bool ExpandPool() {
+            std::lock_guard<std::mutex> lock(m_GrowMutex);
+
+            // 等锁期间其他线程可能已经扩展过
+            if (static_cast<uint32_t>(m_FreeHead.load(std::memory_order_acquire)) != InvalidIndex) {
+                return true;
+            }
+            return AddSlab();
+        }
+
+        bool AddSlab() {
+            uint32_t slabIndex = m_SlabCount.load(std::memory_order_relaxed);
+            if (slabIndex >= MaxSlabs) {
+                return false;
+            }
+
+            Slot* slab = new Slot[PoolSize];
+            uint32_t base = slabIndex * static_cast<uint32_t>(PoolSize);
+            for (size_t i = 0; i < PoolSize; ++i) {
+                new (slab[i].Storage) T();
+                slab[i].Index = base + static_cast<uint32_t>(i);
+                slab[i].Next.store(base + static_cast<uint32_t>(i) + 1, std::memory_order_relaxed);
             }
+
+            m_Slabs[slabIndex] = slab;
+            m_SlabCount.store(slabIndex + 1, std::memory_order_release);
+
+            PushChain(base, base + static_cast<uint32_t>(PoolSize) - 1);
+            return true;
         }
 
-        std::vector<std::unique_ptr<T>> m_Pool;
-        std::stack<T*> m_FreeList;
-        std::mutex m_Mutex;
-        std::atomic<size_t> m_AllocatedCount{0};//用于线程安全地跟踪内存池中已分配对象的数量。
+        Slot* m_Slabs[MaxSlabs] = {};
+        std::atomic<uint32_t> m_SlabCount{0};
+        std::mutex m_GrowMutex; // 仅在扩展时使用
+
+        alignas(64) std::atomic<uint64_t> m_FreeHead{Pack(InvalidIndex, 0)};
+        alignas(64) std::atomic<int64_t> m_SharedOutstanding{0};
+        Magazine m_Magazines[Detail::MaxThreadCaches];
     };
 
     // 事件内存管理器
+    // 16~512字节的请求按大小分级，每个级别独占若干64KB对齐的内存块并维护自己的空闲链表，
+    // 分配/释放均为O(1)；释放时通过地址掩码找到所属块，无需查表。更大的对象直接使用operator new
     class JFM_API EventMemoryManager {
     public:
+        static constexpr size_t Alignment = 16;       // 分配对齐
+        static constexpr size_t MaxSmallSize = 512;   // 分级分配的最大尺寸
+        static constexpr size_t SizeClassCount = 16;  // 尺寸级别数量
+
         static EventMemoryManager& GetInstance() {
             static EventMemoryManager instance;
             return instance;
@@ -85,12 +252,16 @@ namespace JFM {
 
         template<typename T, typename... Args>
         T* AllocateEvent(Args&&... args) {
+            static_assert(alignof(T) <= Alignment, "EventMemoryManager only supports 16-byte alignment");
+
             // 使用placement new在预分配内存上构造对象
             void* memory = AllocateRawMemory(sizeof(T));
             if (!memory) return nullptr;
 
-            // 记录分配信息用于释放时的类型安全检查
-            RegisterAllocation(memory, sizeof(T), typeid(T).hash_code());
+            // 调试模式下记录分配信息用于释放时的类型安全检查
+            if (m_TrackAllocations.load(std::memory_order_relaxed)) {
+                RegisterAllocation(memory, sizeof(T), typeid(T).hash_code());
+            }
 
             return new(memory) T(std::forward<Args>(args)...);
         }
@@ -116,7 +287,7 @@ namespace JFM {
 
         MemoryStats GetStats();
 
-        // 内存压缩整理
+        // 内存压缩整理：归还完全空闲的内存块
         void Compact();
 
         // 设置释放策略
@@ -125,9 +296,17 @@ namespace JFM {
             Deferred,     // 延迟释放
             BatchDeferred // 批量延迟释放
         };
-        void SetReleasePolicy(ReleasePolicy policy) { m_ReleasePolicy = policy; }
+        void SetReleasePolicy(ReleasePolicy policy);
+
+        // 开启/关闭分配追踪（调试用，开启后每次分配都会写入哈希表）
+        void SetAllocationTracking(bool enabled);
+        bool IsAllocationTrackingEnabled() const { return m_TrackAllocations.load(std::memory_order_relaxed); }
+
+        ~EventMemoryManager();
 
     private:
+        EventMemoryManager() = default;
+
         void* AllocateRawMemory(size_t size);
         void DeallocateRawMemory(void* ptr, size_t size);
 
@@ -140,19 +319,35 @@ namespace JFM {
         void RegisterAllocation(void* ptr, size_t size, size_t typeHash);
         void UnregisterAllocation(void* ptr);
 
-        // 延迟释放处理
+        // 延迟释放处理（调用方需持有m_DeferredMutex）
         void ProcessDeferredDeallocations();
+        void FlushDeferredDeallocations();
+
+        // 内存块头部，定义在MemoryPool.cpp中
+        struct BlockHeader;
+
+        // 单个尺寸级别的分配状态
+        struct alignas(64) SizeClassBin {
+            std::mutex Mutex;
+            void* FreeList{nullptr};           // 已释放的空闲槽位链表
+            BlockHeader* Current{nullptr};     // 正在顺序切分的内存块
+            std::vector<BlockHeader*> Blocks;  // 本级别拥有的所有内存块
+        };
+
+        std::array<SizeClassBin, SizeClassCount> m_Bins;
 
-        std::mutex m_Mutex;
-        std::vector<std::unique_ptr<uint8_t[]>> m_MemoryBlocks;
-        ReleasePolicy m_ReleasePolicy{ReleasePolicy::Deferred};
+        std::atomic<ReleasePolicy> m_ReleasePolicy{ReleasePolicy::Immediate};
+        std::atomic<bool> m_TrackAllocations{false};
+        std::atomic<size_t> m_LargeAllocations{0};
+        std::atomic<size_t> m_LargeBytes{0};
 
-        // 分配追踪信息
+        // 分配追踪信息（仅在开启追踪时使用）
         struct AllocationInfo {
             size_t size;
             size_t typeHash;
             std::chrono::steady_clock::time_point allocTime;
         };
+        std::mutex m_TrackingMutex;
         std::unordered_map<void*, AllocationInfo> m_Allocations;
 
         // 延迟释放队列
@@ -161,6 +356,7 @@ namespace JFM {
             size_t size;
             std::chrono::steady_clock::time_point deallocTime;
         };
+        std::mutex m_DeferredMutex;
         std::queue<DeferredDeallocation> m_DeferredQueue;
     };
 
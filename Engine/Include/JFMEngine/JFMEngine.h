@@ -10,6 +10,8 @@
 #include "Core/Layer.h"
 #include "Core/LayerStack.h"
 #include "Core/Core.h"
+#include "Core/FrameArena.h"
+#include "Core/JobSystem.h"
 
 // 事件系统
 #include "Events/Event.h"
@@ -27,7 +27,7 @@ namespace JFM::Physics {
         bool useGravity = true
     ) {
         auto rb = std::make_shared<EnhancedRigidbody>();
-        rb->m_Position = position;
+        rb->SetPosition(position);
         rb->SetMass(mass);
         rb->SetGravity(useGravity);
         return rb;
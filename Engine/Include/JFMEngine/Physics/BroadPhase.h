@@ -0,0 +1,117 @@
+//
+// BroadPhase.h - 碰撞检测宽阶段
+// 增量式扫描与裁剪（Sweep and Prune）
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/Physics.h"
+#include <vector>
+#include <cstdint>
+
+namespace JFM {
+
+    // 宽阶段输出的候选碰撞对（代理的用户数据，A < B）
+    struct BroadPhasePair {
+        uint32_t A;
+        uint32_t B;
+    };
+
+    // 扫描与裁剪宽阶段
+    // 三个轴上的端点数组跨帧保持有序，代理移动时只把它的端点在相邻位置间交换（插入排序），
+    // 端点交换时增量地加入或移除重叠对，物体每帧移动很少时整体代价接近O(n)
+    class JFM_API SweepAndPrune {
+    public:
+        static constexpr uint32_t InvalidProxy = UINT32_MAX;
+
+        // 创建/销毁/移动代理
+        uint32_t CreateProxy(const AABB& bounds, uint32_t userData);
+        void DestroyProxy(uint32_t proxy);
+        void MoveProxy(uint32_t proxy, const AABB& bounds);
+
+        void SetUserData(uint32_t proxy, uint32_t userData);
+        uint32_t GetUserData(uint32_t proxy) const { return m_Proxies[proxy].UserData; }
+        const AABB& GetBounds(uint32_t proxy) const { return m_Proxies[proxy].Bounds; }
+
+        // 处理新加入/销毁的代理，输出按(A, B)排序的重叠对；重叠对集合没有变化时直接返回上次的结果
+        const std::vector<BroadPhasePair>& UpdatePairs();
+        const std::vector<BroadPhasePair>& GetPairs() const { return m_Pairs; }
+        // 输出的重叠对每次变化时加一，调用方据此判断按碰撞对下标保存的数据是否仍然对应
+        uint64_t GetPairsVersion() const { return m_PairsVersion; }
+
+        size_t GetProxyCount() const { return m_Proxies.size() - m_FreeProxies.size() - m_DestroyedProxies.size(); }
+
+        void Clear();
+
+    private:
+        // 端点：Data = 代理ID << 1 | 是否为最大值端点
+        struct Endpoint {
+            float Value;
+            uint32_t Data;
+
+            uint32_t Proxy() const { return Data >> 1; }
+            bool IsMax() const { return (Data & 1) != 0; }
+        };
+
+        struct Proxy {
+            AABB Bounds;
+            uint32_t UserData = 0;
+            uint32_t MinEndpoint[3] = {0, 0, 0};
+            uint32_t MaxEndpoint[3] = {0, 0, 0};
+            bool Alive = false;
+            bool Pending = false; // 已创建但端点尚未排入数组
+        };
+
+        // 重叠对集合：线性探测哈希表索引一个紧凑的对数组，增删均为O(1)
+        class PairSet {
+        public:
+            void Add(uint32_t a, uint32_t b);
+            void Remove(uint32_t a, uint32_t b);
+            void Clear();
+            void Rebuild();
+
+            std::vector<BroadPhasePair>& GetPairs() { return m_Pairs; }
+
+            // 上次ResetChanged之后是否增删过重叠对
+            bool IsChanged() const { return m_Changed; }
+            void ResetChanged() { m_Changed = false; }
+
+        private:
+            static uint64_t MakeKey(uint32_t a, uint32_t b);
+            size_t Home(uint64_t key) const;
+            size_t Find(uint64_t key) const;
+            void Grow();
+
+            static constexpr uint32_t EmptySlot = UINT32_MAX;
+
+            std::vector<BroadPhasePair> m_Pairs; // 按代理ID存储，A < B
+            std::vector<uint32_t> m_Table;       // 指向m_Pairs的下标
+            bool m_Changed = false;
+        };
+
+        void ProcessDestroyedProxies();
+        void InsertPendingProxies();
+        void RebuildAll();
+
+        void SortMinDown(int axis, uint32_t index, bool updatePairs);
+        void SortMinUp(int axis, uint32_t index, bool updatePairs);
+        void SortMaxDown(int axis, uint32_t index, bool updatePairs);
+        void SortMaxUp(int axis, uint32_t index, bool updatePairs);
+        void SwapEndpoints(int axis, uint32_t a, uint32_t b);
+        void SetEndpointIndex(int axis, uint32_t index);
+        bool TestOverlap(uint32_t a, uint32_t b) const;
+
+        std::vector<Proxy> m_Proxies;
+        std::vector<uint32_t> m_FreeProxies;
+        std::vector<uint32_t> m_DestroyedProxies; // 端点仍在数组中，下次更新移除后才可复用
+        std::vector<uint32_t> m_PendingProxies;
+
+        std::vector<Endpoint> m_Endpoints[3];
+        PairSet m_PairSet;
+        std::vector<BroadPhasePair> m_Pairs;
+        bool m_PairsDirty = false;      // 代理的增删或用户数据改变了输出
+        uint64_t m_PairsVersion = 0;
+    };
+
+}
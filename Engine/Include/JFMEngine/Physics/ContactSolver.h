@@ -0,0 +1,68 @@
+//
+// ContactSolver.h - 接触流形与顺序冲量求解器
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/RigidbodyStore.h"
+#include "JFMEngine/Physics/GJK.h"
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+
+namespace JFM {
+
+    // 接触求解参数
+    struct ContactSolverSettings {
+        int VelocityIterations = 8;         // 每个子步的速度迭代次数
+        int PositionIterations = 3;         // 每个子步的穿透修正迭代次数
+        float Baumgarte = 0.2f;             // 每次迭代修正的穿透比例
+        float LinearSlop = 0.005f;          // 允许的穿透，避免接触在分离和穿透之间抖动
+        float MaxCorrection = 0.2f;         // 单次修正的最大位移
+        float RestitutionThreshold = 1.0f;  // 法向接近速度低于该值时不反弹
+        bool WarmStarting = true;
+    };
+
+    // 一对刚体之间的接触流形
+    // 刚体不旋转且形状都是轴对齐的，接触面上各点的约束完全相同，因此每个流形只保存一个接触点；
+    // 累积冲量跨帧保留，下一步用于热启动
+    struct ContactManifold {
+        uint32_t BodyA = 0;
+        uint32_t BodyB = 0;
+        glm::vec3 Normal = glm::vec3(0.0f, 1.0f, 0.0f);    // 从A指向B
+        glm::vec3 Point = glm::vec3(0.0f);
+        float Separation = 0.0f;                            // 负值为穿透深度，正值为预测接触的间距
+        glm::vec3 Offset = glm::vec3(0.0f);                 // 生成接触时B相对A的位置，用于推算位移后的间距
+        float Friction = 0.0f;
+        float Restitution = 0.0f;
+
+        float NormalImpulse = 0.0f;
+        glm::vec3 TangentImpulse = glm::vec3(0.0f);         // 摩擦冲量，按圆锥而不是两个切向分别限制
+
+        float NormalMass = 0.0f;
+        float VelocityBias = 0.0f;
+        bool Touching = false;
+
+        SimplexCache Simplex;                               // 凸网格的GJK单纯形，分离时也保留
+    };
+
+    // 顺序冲量求解器
+    namespace ContactSolver {
+
+        // 材质组合：摩擦取几何平均，恢复系数取较大值
+        inline float MixFriction(float a, float b) { return std::sqrt(a * b); }
+        inline float MixRestitution(float a, float b) { return a > b ? a : b; }
+
+        // 速度求解：热启动后迭代manifolds[indices[0..count)]中的接触，只修改动态刚体的速度
+        // 流形须在积分后的位置上生成，调用时store中仍是积分所用的速度
+        // 同一组接触必须在同一线程上求解，不同组之间不能共享动态刚体
+        JFM_API void SolveVelocities(RigidbodyStore& store, ContactManifold* manifolds, const uint32_t* indices, uint32_t count,
+                                     const ContactSolverSettings& settings, float deltaTime);
+
+        // 位置修正：直接移动动态刚体消除穿透，不改变速度，因此不会给堆叠注入能量
+        JFM_API void SolvePositions(RigidbodyStore& store, const ContactManifold* manifolds, const uint32_t* indices, uint32_t count,
+                                    const ContactSolverSettings& settings);
+    }
+
+}
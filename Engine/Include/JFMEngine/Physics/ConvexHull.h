@@ -0,0 +1,46 @@
+//
+// ConvexHull.h - 凸包
+// 创建时用quickhull从点集构建，保存顶点邻接图，支撑点查询在大凸包上用爬山法
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace JFM {
+
+    class JFM_API ConvexHull {
+    public:
+        // 顶点数不超过该值时直接遍历所有顶点，比沿邻接图爬山更快
+        static constexpr size_t HillClimbThreshold = 32;
+
+        ConvexHull() = default;
+        explicit ConvexHull(const std::vector<glm::vec3>& points);
+
+        // 重新构建凸包；点集共面或共线时只保存去重后的点，支撑点查询退化为遍历
+        void Build(const std::vector<glm::vec3>& points);
+
+        // direction方向上最远的顶点；hint为爬山起点，通常传上一次查询的结果
+        uint32_t GetSupport(const glm::vec3& direction, uint32_t hint = 0) const;
+
+        const std::vector<glm::vec3>& GetVertices() const { return m_Vertices; }
+        // 三角形面的顶点索引，逆时针为外侧
+        const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+
+        size_t GetVertexCount() const { return m_Vertices.size(); }
+        bool IsEmpty() const { return m_Vertices.empty(); }
+
+    private:
+        void BuildAdjacency();
+
+        std::vector<glm::vec3> m_Vertices;
+        std::vector<uint32_t> m_Indices;
+        // 顶点邻接表（CSR）：顶点i的邻居为m_Adjacency[m_AdjacencyOffsets[i] .. m_AdjacencyOffsets[i + 1])
+        std::vector<uint32_t> m_AdjacencyOffsets;
+        std::vector<uint32_t> m_Adjacency;
+    };
+
+}
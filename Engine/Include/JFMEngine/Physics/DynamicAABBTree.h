@@ -0,0 +1,201 @@
+//
+// DynamicAABBTree.h - 动态包围盒树
+// 用于射线检测和重叠查询的层次包围盒（BVH）
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/Physics.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace JFM {
+
+    // 动态包围盒树
+    // 叶节点保存放大过的"胖"包围盒，物体在胖包围盒内移动时树不变；
+    // 移出后才把叶节点重新插入，插入位置按表面积启发式（SAH）选择，并通过旋转保持平衡
+    class JFM_API DynamicAABBTree {
+    public:
+        static constexpr uint32_t NullNode = UINT32_MAX;
+        static constexpr int MaxStackDepth = 256;
+
+        // margin: 胖包围盒在每个方向上的余量；displacementScale: 按位移预测扩展包围盒的倍数
+        explicit DynamicAABBTree(float margin = 0.1f, float displacementScale = 2.0f);
+
+        uint32_t CreateProxy(const AABB& bounds, uint32_t userData);
+        void DestroyProxy(uint32_t proxy);
+
+        // 更新代理的包围盒，返回是否重新插入了树
+        bool MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.0f));
+
+        uint32_t GetUserData(uint32_t proxy) const { return m_Nodes[proxy].UserData; }
+        void SetUserData(uint32_t proxy, uint32_t userData) { m_Nodes[proxy].UserData = userData; }
+        const AABB& GetFatBounds(uint32_t proxy) const { return m_Nodes[proxy].Bounds; }
+
+        // 查询与bounds重叠的代理，callback(userData)返回false时停止
+        template<typename Callback>
+        void Query(const AABB& bounds, Callback&& callback) const;
+
+        // 查询与球体重叠的代理（按胖包围盒），callback(userData)返回false时停止
+        template<typename Callback>
+        void QuerySphere(const glm::vec3& center, float radius, Callback&& callback) const;
+
+        // 射线遍历，direction需归一化
+        // callback(userData, maxDistance)返回新的最大距离：命中时返回命中距离以裁剪后续遍历，
+        // 返回maxDistance表示忽略该代理，返回0表示立即停止
+        template<typename Callback>
+        void Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const;
+
+        size_t GetProxyCount() const { return m_ProxyCount; }
+        int GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+        // 所有节点表面积之和与根节点表面积之比，衡量树的质量
+        float GetAreaRatio() const;
+
+        void Clear();
+
+    private:
+        struct Node {
+            AABB Bounds;
+            uint32_t UserData = 0;
+            uint32_t Parent = NullNode;   // 空闲时作为空闲链表的下一个节点
+            uint32_t Child1 = NullNode;
+            uint32_t Child2 = NullNode;
+            int32_t Height = -1;          // 叶节点为0，空闲节点为-1
+
+            bool IsLeaf() const { return Child1 == NullNode; }
+        };
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t node);
+
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf);
+        uint32_t FindBestSibling(const AABB& bounds) const;
+        uint32_t Balance(uint32_t node);
+        void RefitAncestors(uint32_t node);
+
+        static AABB Combine(const AABB& a, const AABB& b) {
+            return AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max));
+        }
+
+        static float SurfaceArea(const AABB& bounds) {
+            glm::vec3 d = bounds.Max - bounds.Min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        static bool Contains(const AABB& outer, const AABB& inner) {
+            return outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z &&
+                   outer.Max.x >= inner.Max.x && outer.Max.y >= inner.Max.y && outer.Max.z >= inner.Max.z;
+        }
+
+        std::vector<Node> m_Nodes;
+        uint32_t m_Root = NullNode;
+        uint32_t m_FreeList = NullNode;
+        size_t m_ProxyCount = 0;
+        float m_Margin;
+        float m_DisplacementScale;
+    };
+
+    template<typename Callback>
+    void DynamicAABBTree::Query(const AABB& bounds, Callback&& callback) const {
+        if (m_Root == NullNode) {
+            return;
+        }
+
+        uint32_t stack[MaxStackDepth];
+        int count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0) {
+            const Node& node = m_Nodes[stack[--count]];
+            if (!node.Bounds.Intersects(bounds)) {
+                continue;
+            }
+
+            if (node.IsLeaf()) {
+                if (!callback(node.UserData)) {
+                    return;
+                }
+            } else {
+                JFM_CORE_ASSERT(count + 2 <= MaxStackDepth, "DynamicAABBTree stack overflow");
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+
+    template<typename Callback>
+    void DynamicAABBTree::QuerySphere(const glm::vec3& center, float radius, Callback&& callback) const {
+        if (m_Root == NullNode) {
+            return;
+        }
+
+        const float radiusSq = radius * radius;
+        uint32_t stack[MaxStackDepth];
+        int count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0) {
+            const Node& node = m_Nodes[stack[--count]];
+            glm::vec3 closest = glm::clamp(center, node.Bounds.Min, node.Bounds.Max);
+            glm::vec3 offset = center - closest;
+            if (glm::dot(offset, offset) > radiusSq) {
+                continue;
+            }
+
+            if (node.IsLeaf()) {
+                if (!callback(node.UserData)) {
+                    return;
+                }
+            } else {
+                JFM_CORE_ASSERT(count + 2 <= MaxStackDepth, "DynamicAABBTree stack overflow");
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+
+    template<typename Callback>
+    void DynamicAABBTree::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const {
+        if (m_Root == NullNode) {
+            return;
+        }
+
+        // 平板法：预先计算方向倒数，每个节点只需乘法和比较
+        const glm::vec3 invDir = 1.0f / direction;
+        uint32_t stack[MaxStackDepth];
+        int count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0) {
+            const Node& node = m_Nodes[stack[--count]];
+
+            glm::vec3 t1 = (node.Bounds.Min - origin) * invDir;
+            glm::vec3 t2 = (node.Bounds.Max - origin) * invDir;
+            glm::vec3 tNear = glm::min(t1, t2);
+            glm::vec3 tFar = glm::max(t1, t2);
+            float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+            float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+            if (enter > exit) {
+                continue;
+            }
+
+            if (node.IsLeaf()) {
+                float distance = callback(node.UserData, maxDistance);
+                if (distance <= 0.0f) {
+                    return;
+                }
+                maxDistance = std::min(maxDistance, distance);
+            } else {
+                JFM_CORE_ASSERT(count + 2 <= MaxStackDepth, "DynamicAABBTree stack overflow");
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,95 @@
+//
+// GJK.h - 凸形状之间的GJK距离查询与EPA穿透深度
+// 形状以支撑映射描述；球体和胶囊拆成核心（点、线段）加半径，GJK只处理核心
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/ConvexHull.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace JFM {
+
+    // 上一次查询结束时单纯形的顶点编号，下一步从这里开始迭代
+    // 物体移动不多时通常一两次迭代就能收敛
+    struct SimplexCache {
+        uint32_t Count = 0;
+        uint32_t IndexA[4] = { 0, 0, 0, 0 };
+        uint32_t IndexB[4] = { 0, 0, 0, 0 };
+    };
+
+    // 世界空间中的凸形状：核心形状按Center平移，再向外扩展Radius
+    struct ConvexShape {
+        enum class Kind { Point, Segment, Box, Hull, Triangle };
+
+        Kind Type = Kind::Point;
+        glm::vec3 Center = glm::vec3(0.0f);
+        glm::vec3 HalfExtents = glm::vec3(0.0f);   // Box
+        float HalfSegment = 0.0f;                   // Segment，沿Y轴
+        const ConvexHull* Hull = nullptr;           // Hull，顶点相对Center
+        glm::vec3 Triangle[3] = {};                 // Triangle，顶点相对Center
+        float Radius = 0.0f;
+
+        // direction方向上最远的核心顶点编号
+        uint32_t GetSupport(const glm::vec3& direction, uint32_t hint) const {
+            switch (Type) {
+                case Kind::Segment: return direction.y >= 0.0f ? 1u : 0u;
+                case Kind::Box: return (direction.x >= 0.0f ? 1u : 0u) | (direction.y >= 0.0f ? 2u : 0u) | (direction.z >= 0.0f ? 4u : 0u);
+                case Kind::Hull: return Hull->GetSupport(direction, hint);
+                case Kind::Triangle: {
+                    float d0 = glm::dot(Triangle[0], direction);
+                    float d1 = glm::dot(Triangle[1], direction);
+                    float d2 = glm::dot(Triangle[2], direction);
+                    return d0 >= d1 ? (d0 >= d2 ? 0u : 2u) : (d1 >= d2 ? 1u : 2u);
+                }
+                default: return 0;
+            }
+        }
+
+        glm::vec3 GetVertex(uint32_t index) const {
+            switch (Type) {
+                case Kind::Segment: return Center + glm::vec3(0.0f, index ? HalfSegment : -HalfSegment, 0.0f);
+                case Kind::Box: return Center + glm::vec3(index & 1u ? HalfExtents.x : -HalfExtents.x,
+                                                          index & 2u ? HalfExtents.y : -HalfExtents.y,
+                                                          index & 4u ? HalfExtents.z : -HalfExtents.z);
+                case Kind::Hull: return Center + Hull->GetVertices()[index];
+                case Kind::Triangle: return Center + Triangle[index];
+                default: return Center;
+            }
+        }
+
+        uint32_t GetVertexCount() const {
+            switch (Type) {
+                case Kind::Segment: return 2;
+                case Kind::Box: return 8;
+                case Kind::Hull: return static_cast<uint32_t>(Hull->GetVertexCount());
+                case Kind::Triangle: return 3;
+                default: return 1;
+            }
+        }
+    };
+
+    // 两个核心形状之间的最近点，核心重叠时为EPA求出的最小穿透
+    struct GJKResult {
+        glm::vec3 PointA = glm::vec3(0.0f);
+        glm::vec3 PointB = glm::vec3(0.0f);
+        glm::vec3 Normal = glm::vec3(0.0f, 1.0f, 0.0f);    // 从A指向B
+        float Distance = 0.0f;                              // 负值为核心的穿透深度
+        int Iterations = 0;
+    };
+
+    namespace GJK {
+
+        constexpr int MaxIterations = 32;
+        constexpr int MaxEPAIterations = 64;
+
+        // 计算核心形状之间的距离，重叠时用EPA求穿透深度
+        // 距离的下界超过maxDistance时提前返回false，此时result无效
+        // cache非空时从缓存的单纯形开始，并在返回前更新
+        JFM_API bool Evaluate(const ConvexShape& shapeA, const ConvexShape& shapeB, float maxDistance,
+                              GJKResult& result, SimplexCache* cache = nullptr);
+    }
+
+}
@@ -0,0 +1,60 @@
+//
+// Narrowphase.h - 窄阶段接触生成
+// 盒子、球体和胶囊之间的精确接触，形状都是轴对齐的（刚体不旋转）
+// 凸网格与任意形状之间用GJK/EPA，非凸网格通过三角形BVH逐个三角形求解
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/Physics.h"
+#include "JFMEngine/Physics/GJK.h"
+#include <glm/glm.hpp>
+
+namespace JFM {
+
+    // 两个形状之间最深（或最近）的接触
+    struct ContactPoint {
+        glm::vec3 Normal = glm::vec3(0.0f, 1.0f, 0.0f);    // 从A指向B
+        glm::vec3 Point = glm::vec3(0.0f);                  // 两个表面的中点
+        float Separation = 0.0f;                            // 负值为穿透深度
+    };
+
+    namespace Narrowphase {
+
+        // 间距小于该值时就生成预测接触，物体静止接触时不会在有无接触之间来回切换
+        constexpr float SpeculativeMargin = 0.02f;
+
+        // 没有碰撞器的刚体按该半径的球体处理，与Rigidbody::GetBounds一致
+        constexpr float DefaultRadius = 0.5f;
+
+        // 生成两个碰撞器之间的接触，间距不超过margin时返回true
+        // 碰撞器为空时视为DefaultRadius的球体，凸网格走GJK，非凸网格取最深的三角形接触，Custom类型按其包围盒处理
+        // cache保存GJK的单纯形，只在涉及凸网格时使用
+        JFM_API bool Collide(const Collider* shapeA, const glm::vec3& positionA,
+                             const Collider* shapeB, const glm::vec3& positionB,
+                             ContactPoint& contact, float margin = SpeculativeMargin,
+                             SimplexCache* cache = nullptr);
+
+        // 任意两个凸形状之间的接触
+        JFM_API bool Convex(const ConvexShape& shapeA, const ConvexShape& shapeB,
+                            ContactPoint& contact, float margin, SimplexCache* cache = nullptr);
+
+        JFM_API bool SphereSphere(const glm::vec3& centerA, float radiusA, const glm::vec3& centerB, float radiusB,
+                                  ContactPoint& contact, float margin);
+        JFM_API bool SphereBox(const glm::vec3& center, float radius, const glm::vec3& boxCenter, const glm::vec3& halfExtents,
+                               ContactPoint& contact, float margin);
+        JFM_API bool BoxBox(const glm::vec3& centerA, const glm::vec3& halfExtentsA, const glm::vec3& centerB, const glm::vec3& halfExtentsB,
+                            ContactPoint& contact, float margin);
+
+        // 胶囊以Y轴线段（中心、半长）和半径描述
+        JFM_API bool CapsuleSphere(const glm::vec3& center, float halfSegment, float radius, const glm::vec3& sphereCenter, float sphereRadius,
+                                   ContactPoint& contact, float margin);
+        JFM_API bool CapsuleCapsule(const glm::vec3& centerA, float halfSegmentA, float radiusA,
+                                    const glm::vec3& centerB, float halfSegmentB, float radiusB,
+                                    ContactPoint& contact, float margin);
+        JFM_API bool CapsuleBox(const glm::vec3& center, float halfSegment, float radius, const glm::vec3& boxCenter, const glm::vec3& halfExtents,
+                                ContactPoint& contact, float margin);
+    }
+
+}
@@ -6,9 +6,12 @@
 #pragma once
 
 #include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/RigidbodyStore.h"
+#include "JFMEngine/Physics/ContactSolver.h"
 #include <glm/glm.hpp>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 namespace JFM {
 
@@ -25,39 +28,114 @@ namespace JFM {
         glm::vec3 GetSize() const { return Max - Min; }
     };
 
+    struct BroadPhasePair;
+    class SweepAndPrune;
+    class SpatialHashGrid;
+    class DynamicAABBTree;
+    class Collider;
+    struct PhysicsSnapshot;
+
+    // 物理材质
+    struct JFM_API PhysicsMaterial {
+        float Friction = 0.6f;        // 摩擦系数
+        float Restitution = 0.5f;     // 恢复系数（弹性）
+        float Density = 1.0f;         // 密度
+
+        PhysicsMaterial() = default;
+        PhysicsMaterial(float friction, float restitution, float density)
+            : Friction(friction), Restitution(restitution), Density(density) {}
+    };
+
+
     // 刚体组件
+    // 加入物理世界后状态保存在世界的RigidbodyStore中，Rigidbody只是指向槽位的句柄；
+    // 未加入世界时状态保存在对象内部
     class JFM_API Rigidbody {
     public:
         Rigidbody();
+        virtual ~Rigidbody() = default;
+
+        Rigidbody(const Rigidbody&) = delete;
+        Rigidbody& operator=(const Rigidbody&) = delete;
+
+        // 宽阶段使用的世界空间包围盒，没有碰撞器时视为半径0.5的球
+        virtual AABB GetBounds() const;
+
+        // 窄阶段使用的碰撞器，返回空时视为半径0.5的球
+        virtual const Collider* GetShape() const { return nullptr; }
+        virtual const PhysicsMaterial& GetMaterial() const;
+
+        void SetMass(float mass);
+        float GetMass() const { return m_Store ? m_Store->GetMass(m_Slot) : m_LocalState.Mass; }
+        float GetInvMass() const { return m_Store ? m_Store->GetInvMass(m_Slot) : m_LocalState.InvMass; }
+
+        void SetPosition(const glm::vec3& position);
+        glm::vec3 GetPosition() const { return m_Store ? m_Store->GetPosition(m_Slot) : m_LocalState.Position; }
+
+        void SetVelocity(const glm::vec3& velocity);
+        glm::vec3 GetVelocity() const { return m_Store ? m_Store->GetVelocity(m_Slot) : m_LocalState.Velocity; }
+
+        void AddForce(const glm::vec3& force);
+        glm::vec3 GetForce() const { return m_Store ? m_Store->GetForce(m_Slot) : m_LocalState.Force; }
+
+        void SetGravity(bool gravity);
+        bool GetGravity() const { return m_Store ? m_Store->GetUseGravity(m_Slot) : m_LocalState.UseGravity; }
+
+        void SetDrag(float drag);
+        float GetDrag() const { return m_Store ? m_Store->GetDrag(m_Slot) : m_LocalState.Drag; }
 
-        void SetMass(float mass) { m_Mass = mass; m_InvMass = (mass == 0.0f) ? 0.0f : 1.0f / mass; }
-        float GetMass() const { return m_Mass; }
+        // 休眠状态，移动、设置速度、施加力或冲量时自动唤醒；醒着的刚体碰到休眠的刚体时唤醒它所在的整个岛
+        void SetAwake(bool awake);
+        bool IsAwake() const { return m_Store ? m_Store->IsAwake(m_Slot) : m_LocalState.Awake; }
 
-        void SetVelocity(const glm::vec3& velocity) { m_Velocity = velocity; }
-        glm::vec3 GetVelocity() const { return m_Velocity; }
+        // 单独的休眠速度阈值，负值（默认）使用物理世界的阈值，0表示从不休眠（例如玩家控制的物体）
+        void SetSleepThreshold(float linearVelocity);
+        float GetSleepThreshold() const { return m_Store ? m_Store->GetSleepThreshold(m_Slot) : m_LocalState.SleepThreshold; }
 
-        void AddForce(const glm::vec3& force) { m_Force += force; }
-        void SetGravity(bool gravity) { m_UseGravity = gravity; }
+        // 连续碰撞检测：宽阶段使用本步扫过的包围盒，快速运动时在本步起点生成预测接触，
+        // 高速的小物体不会穿过薄墙；只有开启的刚体承担额外开销
+        void SetContinuousCollision(bool continuous);
+        bool IsContinuousCollision() const { return m_Store ? m_Store->IsContinuous(m_Slot) : m_LocalState.Continuous; }
 
+        // 单独积分这一个刚体（物理世界内的刚体由世界批量积分）
         void UpdatePhysics(float deltaTime);
 
-        glm::vec3 m_Position = glm::vec3(0.0f);
-        glm::vec3 m_Velocity = glm::vec3(0.0f);
-        glm::vec3 m_Force = glm::vec3(0.0f);
+    protected:
+        // 唤醒并通知物理世界在下一步更新包围盒，形状改变等影响包围盒的操作也需要调用
+        void WakeUp() {
+            if (m_Store) {
+                m_Store->Activate(m_Slot);
+            }
+        }
 
     private:
-        float m_Mass = 1.0f;
-        float m_InvMass = 1.0f;
-        bool m_UseGravity = true;
-        float m_Drag = 0.98f;
+        friend class PhysicsWorld;
+
+        RigidbodyStore* m_Store = nullptr;  // 所在世界的存储，未加入世界时为空
+        uint32_t m_Slot = 0;
+        RigidbodyState m_LocalState;
+    };
+
+    // 碰撞器类型，窄阶段据此选择接触生成函数
+    enum class ColliderType {
+        Box,
+        Sphere,
+        Capsule,
+        Mesh,
+        Custom      // 按GetAABB当作盒子处理
     };
 
     // 碰撞器基类
     class JFM_API Collider {
     public:
         virtual ~Collider() = default;
+        virtual ColliderType GetType() const { return ColliderType::Custom; }
         virtual AABB GetAABB(const glm::vec3& position) const = 0;
         virtual bool CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const = 0;
+
+        // 射线求交，direction需归一化；默认与包围盒求交
+        virtual bool Raycast(const glm::vec3& position, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                             float& distance, glm::vec3& normal) const;
     };
 
     // 盒子碰撞器
@@ -65,6 +143,8 @@ namespace JFM {
     public:
         BoxCollider(const glm::vec3& size) : m_Size(size) {}
 
+        virtual ColliderType GetType() const override { return ColliderType::Box; }
+
         virtual AABB GetAABB(const glm::vec3& position) const override;
         virtual bool CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const override;
 
@@ -74,6 +154,25 @@ namespace JFM {
         glm::vec3 m_Size;
     };
 
+    // 物理统计信息
+    struct PhysicsStats {
+        uint32_t BroadPhasePairs = 0;   // 最近一次子步的候选碰撞对数
+        float BroadPhaseMs = 0.0f;      // 最近一次子步宽阶段耗时，含代理包围盒更新
+        uint32_t IslandCount = 0;       // 最近一次子步的模拟岛数量（含休眠的岛）
+        uint32_t AwakeIslandCount = 0;
+        uint32_t ActiveBodies = 0;      // 最近一次子步积分并更新包围盒的刚体数
+        uint32_t AwakeBodies = 0;       // 最近一次子步结束时醒着的动态刚体数
+        uint32_t SleepingBodies = 0;    // 最近一次子步结束时休眠的动态刚体数
+        uint32_t ContactCount = 0;      // 最近一次子步实际接触的碰撞对数
+        float SolveMs = 0.0f;           // 最近一次子步建岛、窄阶段和求解耗时
+    };
+
+    // 宽阶段算法
+    enum class BroadPhaseType {
+        SweepAndPrune,      // 增量扫描与裁剪，适合尺寸差异大、多数物体静止或移动很少的场景
+        SpatialHashGrid     // 均匀网格，适合大量尺寸相近且都在运动的物体（碎片、人群、粒子）
+    };
+
     // 物理世界
     class JFM_API PhysicsWorld {
     public:
@@ -82,7 +181,13 @@ namespace JFM {
             return instance;
         }
 
-        void Update(float deltaTime);
+        virtual void Update(float deltaTime);
+
+        // 不经过时间累积直接前进一个固定步，不受暂停影响；锁步模拟每个逻辑帧调用一次
+        void Step();
+        // 已模拟的固定步数
+        uint64_t GetStepCount() const { return m_StepCount; }
+
         void AddRigidbody(std::shared_ptr<Rigidbody> rigidbody);
         void RemoveRigidbody(std::shared_ptr<Rigidbody> rigidbody);
 
@@ -92,6 +197,10 @@ namespace JFM {
         // 获取所有刚体（用于工具函数）
         const std::vector<std::shared_ptr<Rigidbody>>& GetRigidbodies() const { return m_Rigidbodies; }
 
+        // 刚体状态的SoA存储，槽位i对应GetRigidbodies()[i]
+        RigidbodyStore& GetRigidbodyStore() { return m_Store; }
+        const RigidbodyStore& GetRigidbodyStore() const { return m_Store; }
+
         // 设置物理参数
         void SetTimeStep(float timeStep) { m_FixedTimeStep = timeStep; }
         float GetTimeStep() const { return m_FixedTimeStep; }
@@ -103,15 +212,177 @@ namespace JFM {
         void SetPaused(bool paused) { m_Paused = paused; }
         bool IsPaused() const { return m_Paused; }
 
+        // 宽阶段与统计；切换算法后下一步重新生成全部碰撞对，接触缓存按刚体对保留
+        void SetBroadPhaseType(BroadPhaseType type);
+        BroadPhaseType GetBroadPhaseType() const { return m_BroadPhaseType; }
+        // 网格单元格边长，0表示按刚体尺寸自动选择
+        void SetGridCellSize(float cellSize);
+        const SweepAndPrune& GetBroadPhase() const { return *m_BroadPhase; }
+        const SpatialHashGrid& GetSpatialHashGrid() const { return *m_Grid; }
+        // 当前宽阶段最近一次输出的碰撞对
+        const std::vector<BroadPhasePair>& GetBroadPhasePairs() const;
+        const PhysicsStats& GetStats() const { return m_Stats; }
+        // 下一步积分并更新包围盒的刚体槽位，不含此后才激活的刚体（见RigidbodyStore::GetActivated）
+        const std::vector<uint32_t>& GetActiveBodies() const { return m_ActiveBodies; }
+
+        // 接触求解参数
+        void SetContactSolverSettings(const ContactSolverSettings& settings) { m_ContactSettings = settings; }
+        const ContactSolverSettings& GetContactSolverSettings() const { return m_ContactSettings; }
+        void SetSolverIterations(int iterations) { m_ContactSettings.VelocityIterations = iterations; }
+        int GetSolverIterations() const { return m_ContactSettings.VelocityIterations; }
+
+        // 最近一次子步的接触流形，与GetBroadPhasePairs()一一对应；删除刚体后在下次Update前无效
+        const std::vector<ContactManifold>& GetContactManifolds() const { return m_Manifolds; }
+
+        // 休眠：岛内所有刚体速度持续低于各自的阈值达到timeToSleep秒后整个岛休眠，不再积分和求解。
+        // 世界维护醒着的刚体列表，积分、宽阶段包围盒和查询树只处理列表中的刚体，
+        // 大量静止物体休眠后每步的开销只与运动的刚体数相关
+        void SetSleepingEnabled(bool enabled);
+        bool IsSleepingEnabled() const { return m_SleepingEnabled; }
+        void SetSleepThreshold(float linearVelocity) { m_SleepLinearVelocity = linearVelocity; }
+        float GetSleepThreshold() const { return m_SleepLinearVelocity; }
+        void SetTimeToSleep(float seconds) { m_TimeToSleep = seconds; }
+        float GetTimeToSleep() const { return m_TimeToSleep; }
+
+        // 按槽位顺序对所有刚体的位置、速度和休眠状态求64位FNV-1a哈希
+        // 相同输入下结果与工作线程数无关，用于校验多线程求解的确定性
+        uint64_t ComputeStateHash() const;
+
+        // 确定性模式：每个固定步结束后计算ComputeStateHash()，锁步的各端按步比对即可发现分歧，
+        // 不必同步完整状态。模拟本身总是按槽位顺序进行，各岛独立求解，统计按岛的顺序汇总，
+        // 结果与线程数和调度无关；跨机器逐位一致还需要以JFM_DETERMINISTIC_PHYSICS编译
+        void SetDeterministic(bool deterministic) { m_Deterministic = deterministic; }
+        bool IsDeterministic() const { return m_Deterministic; }
+        // 最近一步结束时的状态哈希，只在确定性模式下更新
+        uint64_t GetStepChecksum() const { return m_StepChecksum; }
+
+        // 是否以严格浮点设置（JFM_DETERMINISTIC_PHYSICS）编译，锁步的各端握手时应当一致
+        static bool IsStrictFloatingPoint();
+
+        // 状态快照：刚体SoA状态、接触缓存（热启动冲量）和步数写入连续缓冲区，用于回滚和倒放调试；
+        // 恢复后继续模拟与从未回退过的结果逐位一致。历史见PhysicsHistory
+        // 恢复要求刚体集合与保存时相同（同样的刚体在同样的槽位），刚体数不同时返回false；
+        // 恢复后立即做射线或重叠查询需先调用SyncQueryTree()
+        void SaveSnapshot(PhysicsSnapshot& snapshot) const;
+        bool RestoreSnapshot(const PhysicsSnapshot& snapshot);
+
+        // 射线检测和重叠查询使用的包围盒树，代理的用户数据为刚体在GetRigidbodies()中的下标
+        const DynamicAABBTree& GetQueryTree() const { return *m_QueryTree; }
+
+        // 把刚体当前的包围盒同步到查询树（网格宽阶段时还有网格），Update结束时自动调用；
+        // 在Update之外直接移动刚体后可手动调用
+        void SyncQueryTree();
+
+        // 包围盒与球体相交的刚体下标，结果追加到bodies；网格宽阶段时查询网格，否则查询包围盒树
+        void OverlapSphere(const glm::vec3& center, float radius, std::vector<uint32_t>& bodies);
+
+    protected:
+        PhysicsWorld();
+        virtual ~PhysicsWorld();
+
+        static constexpr uint32_t InvalidBody = UINT32_MAX;
+
+        // 连接两个刚体的约束，用于把刚体合并到同一个模拟岛
+        struct ConstraintEdge {
+            uint32_t BodyA = InvalidBody;   // GetRigidbodies()中的下标，不在本世界时为InvalidBody
+            uint32_t BodyB = InvalidBody;
+        };
+
+        // 刚体在GetRigidbodies()中的下标，不属于本世界时返回InvalidBody
+        uint32_t GetBodyIndex(const Rigidbody* rigidbody) const {
+            return (rigidbody && rigidbody->m_Store == &m_Store) ? rigidbody->m_Slot : InvalidBody;
+        }
+
+        // 每个子步建岛前收集派生世界的约束，约束编号即在constraints中的下标
+        virtual void CollectConstraints(std::vector<ConstraintEdge>& constraints) { (void)constraints; }
+
+        // 求解一个约束，同一个岛内的约束在同一线程上按编号顺序求解；
+        // 不同岛的约束可能并行执行，实现只能修改该约束连接的刚体；Rigidbody的setter在求解期间记入岛自己的激活列表
+        virtual void SolveConstraint(uint32_t constraint, float deltaTime) { (void)constraint; (void)deltaTime; }
+
     private:
+        static constexpr uint8_t ActiveFlag = 1;
+        static constexpr uint8_t QueryDirtyFlag = 2;
+
+        enum IslandStateValue : uint8_t { IslandSleeping, IslandAwake, IslandFellAsleep };
+
+        // 模拟岛：由接触和约束连通的动态刚体，静态刚体不连通不同的岛
+        struct Island {
+            uint32_t BodyBegin = 0, BodyCount = 0;
+            uint32_t PairBegin = 0, PairCount = 0;
+            uint32_t ConstraintBegin = 0, ConstraintCount = 0;
+        };
+
+        // 一个固定步：积分、宽阶段、建岛和求解
+        void Simulate(float deltaTime);
+
+        // 把存储中新激活的刚体并入本步的活动列表
+        void MergeActivatedBodies();
+        void AddActiveBody(uint32_t body);
+        // 下一步的活动列表：醒着的岛和本步刚进入休眠的岛（位置在本步求解中改变过）
+        void UpdateActiveBodies();
+
+        void BuildIslands();
+        void SolveIslands(float deltaTime);
+        void SolveIsland(uint32_t islandIndex, float deltaTime);
+        uint32_t FindIslandRoot(uint32_t body);
+
+        // 把上一步的接触缓存按刚体对合并到本步的流形中，用于热启动
+        // 碰撞对没有变化时m_Manifolds仍与之一一对应，直接沿用
+        void MatchContactCache();
+        // 需要时才从m_Manifolds整理出缓存：碰撞对变化、保存快照或删除刚体之前
+        void FlushContactCache();
+        static bool IsCachedManifold(const ContactManifold& manifold) { return manifold.Touching || manifold.Simplex.Count > 0; }
+        void UpdateContact(uint32_t pairIndex, float deltaTime);
+
         std::vector<std::shared_ptr<Rigidbody>> m_Rigidbodies;
+        RigidbodyStore m_Store;
+        std::vector<uint32_t> m_Proxies;                // 与m_Rigidbodies一一对应的扫描与裁剪代理，网格宽阶段时为InvalidProxy
+        std::vector<uint32_t> m_QueryProxies;           // 与m_Rigidbodies一一对应的查询树代理
+        std::vector<glm::vec3> m_QueryPositions;        // 上次更新查询树时的位置，用于预测位移
+        std::vector<uint32_t> m_ActiveBodies;           // 本步积分并更新宽阶段包围盒的刚体（可含静态和休眠刚体）
+        std::vector<uint32_t> m_QueryDirtyBodies;       // 上次同步查询树之后更新过包围盒的刚体
+        std::vector<uint8_t> m_BodyFlags;               // 与m_Rigidbodies一一对应，ActiveFlag | QueryDirtyFlag
+        BroadPhaseType m_BroadPhaseType = BroadPhaseType::SweepAndPrune;
+        std::unique_ptr<SweepAndPrune> m_BroadPhase;
+        std::unique_ptr<SpatialHashGrid> m_Grid;        // 物体下标即刚体槽位
+        std::unique_ptr<DynamicAABBTree> m_QueryTree;
+        PhysicsStats m_Stats;
+
+        // 建岛数据，每个子步重建，容量跨帧复用
+        std::vector<uint32_t> m_IslandParent;           // 并查集，根为集合中最小的刚体下标
+        std::vector<uint32_t> m_BodyIsland;             // 刚体所属岛，静态刚体为InvalidBody
+        std::vector<Island> m_Islands;                  // 按岛内最小刚体下标排序
+        std::vector<uint32_t> m_IslandBodies;
+        std::vector<uint32_t> m_IslandPairs;            // 宽阶段碰撞对的下标
+        std::vector<uint32_t> m_IslandConstraints;
+        std::vector<uint32_t> m_FreeConstraints;        // 不连接任何动态刚体的约束，在主线程上求解
+        std::vector<uint8_t> m_IslandState;             // IslandSleeping、IslandAwake或IslandFellAsleep
+        std::vector<std::vector<uint32_t>> m_IslandActivations;    // 各岛求解期间激活的刚体，只增不减以保留容量
+        std::vector<ConstraintEdge> m_Constraints;
+        std::vector<glm::vec3> m_SolverVelocities;      // 求解前的速度，求解后按速度变化修正位置
+
+        // 接触：m_Manifolds与宽阶段碰撞对一一对应，m_ContactCache保存上一步仍接触的流形（按刚体对排序）
+        std::vector<ContactManifold> m_Manifolds;
+        std::vector<ContactManifold> m_ContactCache;
+        bool m_ContactCacheSorted = true;
+        bool m_ContactCacheStale = false;               // m_Manifolds比缓存新
+        uint64_t m_ManifoldPairsVersion = UINT64_MAX;   // m_Manifolds对应的宽阶段碰撞对版本，UINT64_MAX为无效
+        uint32_t m_TouchingCount = 0;                   // m_Manifolds中接触的流形数
+        std::vector<int32_t> m_IslandContactDelta;      // 各岛本步接触流形数的变化
+        ContactSolverSettings m_ContactSettings;
+
+        bool m_SleepingEnabled = true;
+        float m_SleepLinearVelocity = 0.05f;
+        float m_TimeToSleep = 0.5f;
         glm::vec3 m_Gravity = glm::vec3(0.0f, -9.81f, 0.0f);
         float m_FixedTimeStep = 1.0f / 60.0f; // 60 FPS
         int m_MaxSubSteps = 3;
         bool m_Paused = false;
         float m_AccumulatedTime = 0.0f;
-
-        PhysicsWorld() = default;
+        bool m_Deterministic = false;
+        uint64_t m_StepCount = 0;
+        uint64_t m_StepChecksum = 0;
     };
 
 }
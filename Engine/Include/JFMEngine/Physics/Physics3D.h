@@ -4,10 +4,14 @@
 
 #pragma once
 
-#include "JFMEngine/Physics/Physics.h"
+#include "JFMEngine/Physics/PhysicsComponents.h"
+#include "JFMEngine/Physics/ConvexHull.h"
+#include "JFMEngine/Physics/TriangleBVH.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+#include <cfloat>
 
 namespace JFM {
 
@@ -62,37 +66,54 @@ namespace JFM {
     };
 
     // 复杂碰撞器
+    // 标记为凸的网格在创建（或SetConvex）时构建凸包，窄阶段用GJK/EPA；
+    // 非凸网格构建三角形BVH，用于静态关卡几何，两个非凸网格之间不产生接触
     class JFM_API MeshCollider : public Collider {
     public:
-        MeshCollider(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+        MeshCollider(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, bool convex = false);
+        // 使用离线构建（TriangleBVH::LoadFromFile）的BVH，加载时不再重新构建
+        explicit MeshCollider(TriangleBVH bvh);
+
+        virtual ColliderType GetType() const override { return ColliderType::Mesh; }
 
         virtual AABB GetAABB(const glm::vec3& position) const override;
         virtual bool CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const override;
+        virtual bool Raycast(const glm::vec3& position, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                             float& distance, glm::vec3& normal) const override;
 
         bool IsConvex() const { return m_IsConvex; }
-        void SetConvex(bool convex) { m_IsConvex = convex; }
+        void SetConvex(bool convex);
+
+        // 凸网格的凸包，非凸时返回空
+        const ConvexHull* GetConvexHull() const { return m_IsConvex && !m_Hull.IsEmpty() ? &m_Hull : nullptr; }
+        // 非凸网格的三角形BVH，凸网格或没有三角形时返回空
+        const TriangleBVH* GetTriangleBVH() const { return !m_IsConvex && !m_BVH.IsEmpty() ? &m_BVH : nullptr; }
 
     private:
         std::vector<glm::vec3> m_Vertices;
         std::vector<uint32_t> m_Indices;
         bool m_IsConvex = false;
-
-        bool RayTriangleIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
-                                const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
-                                float& t) const;
+        ConvexHull m_Hull;
+        TriangleBVH m_BVH;
+        AABB m_Bounds;  // 局部空间包围盒
     };
 
-    // 胶囊碰撞器
+    // 胶囊碰撞器，沿Y轴，height为包含两端半球的总高度
     class JFM_API CapsuleCollider : public Collider {
     public:
         CapsuleCollider(float radius, float height) : m_Radius(radius), m_Height(height) {}
 
+        virtual ColliderType GetType() const override { return ColliderType::Capsule; }
+
         virtual AABB GetAABB(const glm::vec3& position) const override;
         virtual bool CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const override;
 
         float GetRadius() const { return m_Radius; }
         float GetHeight() const { return m_Height; }
 
+        // 中心线段的半长
+        float GetHalfSegment() const { return std::max(0.0f, m_Height * 0.5f - m_Radius); }
+
     private:
         float m_Radius;
         float m_Height;
@@ -117,6 +138,9 @@ namespace JFM {
         void SetBreakForce(float force) { m_BreakForce = force; }
         bool IsBroken() const { return m_Broken; }
 
+        const std::shared_ptr<Rigidbody3D>& GetBodyA() const { return m_BodyA; }
+        const std::shared_ptr<Rigidbody3D>& GetBodyB() const { return m_BodyB; }
+
     protected:
         Type m_Type;
         std::shared_ptr<Rigidbody3D> m_BodyA;
@@ -166,16 +190,23 @@ namespace JFM {
             std::shared_ptr<Rigidbody3D> Rigidbody = nullptr;
         };
 
+        // 通过查询树遍历，只返回Rigidbody3D
         RaycastHit3D Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = 1000.0f);
+        void RaycastBatch(const PhysicsUtils::Ray* rays, size_t count, RaycastHit3D* hits);
         std::vector<std::shared_ptr<Rigidbody3D>> SphereCast(const glm::vec3& center, float radius);
 
         // 3D物理更新
         virtual void Update(float deltaTime) override;
 
+    protected:
+        // 关节作为约束参与建岛，在所在岛的求解任务中按固定时间步更新
+        virtual void CollectConstraints(std::vector<ConstraintEdge>& constraints) override;
+        virtual void SolveConstraint(uint32_t constraint, float deltaTime) override;
+
     private:
         std::vector<std::shared_ptr<Joint>> m_Joints;
+        std::vector<Joint*> m_SolverJoints;     // 约束编号到关节的映射，每个子步重建
 
-        void UpdateJoints(float deltaTime);
         void SolveConstraints(float deltaTime);
     };
 
@@ -14,6 +14,8 @@ namespace JFM {
     public:
         SphereCollider(float radius) : m_Radius(radius) {}
 
+        virtual ColliderType GetType() const override { return ColliderType::Sphere; }
+
         virtual AABB GetAABB(const glm::vec3& position) const override;
         virtual bool CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const override;
 
@@ -30,27 +32,23 @@ namespace JFM {
         float m_Radius;
     };
 
-    // 物理材质
-    struct JFM_API PhysicsMaterial {
-        float Friction = 0.6f;        // 摩擦系数
-        float Restitution = 0.5f;     // 恢复系数（弹性）
-        float Density = 1.0f;         // 密度
-
-        PhysicsMaterial() = default;
-        PhysicsMaterial(float friction, float restitution, float density)
-            : Friction(friction), Restitution(restitution), Density(density) {}
-    };
-
     // 增强的刚体组件
     class JFM_API EnhancedRigidbody : public Rigidbody {
     public:
         EnhancedRigidbody();
 
         void SetMaterial(const PhysicsMaterial& material) { m_Material = material; }
-        const PhysicsMaterial& GetMaterial() const { return m_Material; }
+        const PhysicsMaterial& GetMaterial() const override { return m_Material; }
 
-        void SetCollider(std::shared_ptr<Collider> collider) { m_Collider = collider; }
+        void SetCollider(std::shared_ptr<Collider> collider) {
+            m_Collider = collider;
+            WakeUp();   // 包围盒随形状改变
+        }
         std::shared_ptr<Collider> GetCollider() const { return m_Collider; }
+        const Collider* GetShape() const override { return m_Collider.get(); }
+
+        // 有碰撞器时使用碰撞器的包围盒
+        AABB GetBounds() const override;
 
         // 应用冲量
         void ApplyImpulse(const glm::vec3& impulse);
@@ -96,10 +94,20 @@ namespace JFM {
                 : Origin(origin), Direction(glm::normalize(direction)), MaxDistance(maxDist) {}
         };
 
-        // 射线投射
+        // 射线投射，返回最近的命中（按刚体的碰撞器）
         JFM_API RaycastHit Raycast(const Ray& ray);
 
-        // 重叠检测
+        // 批量射线投射：一次调用处理count条射线，结果写入hits[0..count)
+        // 适合大量视线检测，省去逐次调用的开销并复用遍历状态
+        JFM_API void RaycastBatch(const Ray* rays, size_t count, RaycastHit* hits);
+        JFM_API std::vector<RaycastHit> RaycastBatch(const std::vector<Ray>& rays);
+
+        // 射线与包围盒求交，起点在盒内时距离为0
+        JFM_API bool RayIntersectsAABB(const Ray& ray, const AABB& aabb, float& distance, glm::vec3& normal);
+        // 与刚体的碰撞器求交，没有碰撞器时与包围盒求交
+        JFM_API bool RayIntersectsBody(const Ray& ray, const Rigidbody& body, float& distance, glm::vec3& normal);
+
+        // 重叠检测（按刚体包围盒）
         JFM_API std::vector<std::shared_ptr<Rigidbody>> OverlapSphere(const glm::vec3& center, float radius);
         JFM_API std::vector<std::shared_ptr<Rigidbody>> OverlapBox(const glm::vec3& center, const glm::vec3& size);
 
@@ -0,0 +1,92 @@
+//
+// PhysicsSnapshot.h - 物理世界状态快照与回滚历史
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace JFM {
+
+    class PhysicsWorld;
+
+    // 物理世界状态快照
+    // 连续的4字节字缓冲区：头部、刚体SoA数组（逐个数组首尾相接）、接触缓存；
+    // 保存和恢复都只是按段memcpy，缓冲区容量跨帧复用
+    struct JFM_API PhysicsSnapshot {
+        static constexpr uint32_t Magic = 0x50534E50u;     // "PNSP"
+
+        struct Header {
+            uint32_t Magic = 0;
+            uint32_t BodyCount = 0;
+            uint32_t ContactCount = 0;
+            uint32_t Flags = 0;
+            uint64_t StepCount = 0;
+            uint64_t StepChecksum = 0;
+            float AccumulatedTime = 0.0f;
+            uint32_t Reserved = 0;
+        };
+        static constexpr size_t HeaderWords = sizeof(Header) / sizeof(uint32_t);
+
+        enum HeaderFlags : uint32_t {
+            HasForces = 1u << 0,
+            ContactCacheSorted = 1u << 1
+        };
+
+        std::vector<uint32_t> Data;
+
+        bool IsEmpty() const { return Data.size() < HeaderWords; }
+        const Header& GetHeader() const { return *reinterpret_cast<const Header*>(Data.data()); }
+        size_t GetByteSize() const { return Data.size() * sizeof(uint32_t); }
+    };
+
+    // 最近若干帧快照的环形历史，用于回滚网络同步和倒放调试
+    // 最新一帧完整保存；较早的每一帧保存与其后一帧的异或差分，连续的零字按行程编码。
+    // 静止、休眠和静态刚体以及质量等很少变化的分量异或后全为零，历史只占完整快照的一小部分；
+    // 回退k帧需要依次应用k个差分
+    class JFM_API PhysicsHistory {
+    public:
+        explicit PhysicsHistory(uint32_t capacity = 60);
+
+        // 保存世界当前状态为最新一帧，超出容量时丢弃最旧的一帧
+        void Record(const PhysicsWorld& world);
+
+        // 把世界恢复到framesBack帧之前（0为最新一帧），更新的帧被丢弃，恢复的帧成为最新一帧
+        // 刚体集合与保存时不同或没有这么多帧时返回false，世界保持不变
+        bool Rewind(PhysicsWorld& world, uint32_t framesBack);
+
+        // 只取出framesBack帧之前的快照，历史保持不变
+        bool GetSnapshot(uint32_t framesBack, PhysicsSnapshot& snapshot) const;
+
+        void Clear();
+        void SetCapacity(uint32_t capacity);
+        uint32_t GetCapacity() const { return m_Capacity; }
+        uint32_t GetFrameCount() const { return m_Latest.IsEmpty() ? 0 : m_DeltaCount + 1; }
+
+        // 最新一帧和全部差分占用的字节数
+        size_t GetMemoryUsage() const;
+
+    private:
+        // delta = [older的字数, (零字数, 字面字数, 字面字...)...]，字面字为older ^ newer；xorWords为临时缓冲区
+        static void EncodeDelta(const std::vector<uint32_t>& older, const std::vector<uint32_t>& newer,
+                                std::vector<uint32_t>& delta, std::vector<uint32_t>& xorWords);
+        static void ApplyDelta(const std::vector<uint32_t>& newer, const std::vector<uint32_t>& delta, std::vector<uint32_t>& older);
+
+        // 由新到旧第index个差分，0为最新一帧与前一帧之间的差分
+        const std::vector<uint32_t>& GetDelta(uint32_t index) const {
+            return m_Deltas[(m_DeltaNewest + m_Deltas.size() - index) % m_Deltas.size()];
+        }
+
+        uint32_t m_Capacity = 0;
+        PhysicsSnapshot m_Latest;
+        std::vector<std::vector<uint32_t>> m_Deltas;    // 环形缓冲区，容量为m_Capacity - 1，槽位容量复用
+        size_t m_DeltaNewest = 0;
+        uint32_t m_DeltaCount = 0;
+        PhysicsSnapshot m_Scratch;
+        std::vector<uint32_t> m_ScratchWords;
+    };
+
+}
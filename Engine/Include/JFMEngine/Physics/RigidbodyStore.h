@@ -0,0 +1,196 @@
+//
+// RigidbodyStore.h - 刚体状态的SoA存储
+// 位置、速度、力和质量按分量存放在连续数组中，积分内核一次处理多个刚体
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace JFM {
+
+    namespace Detail {
+        // 按缓存行对齐的分配器，保证SIMD按对齐方式加载
+        template<typename T, size_t Alignment = 64>
+        class AlignedAllocator {
+        public:
+            using value_type = T;
+
+            template<typename U>
+            struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+            AlignedAllocator() noexcept = default;
+            template<typename U>
+            AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+            T* allocate(size_t count) {
+                return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+            }
+
+            void deallocate(T* ptr, size_t) noexcept {
+                ::operator delete(ptr, std::align_val_t(Alignment));
+            }
+
+            template<typename U>
+            bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+            template<typename U>
+            bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+        };
+    }
+
+    // 单个刚体的完整状态，用于刚体加入/离开存储时整体拷贝
+    struct RigidbodyState {
+        glm::vec3 Position = glm::vec3(0.0f);
+        glm::vec3 Velocity = glm::vec3(0.0f);
+        glm::vec3 Force = glm::vec3(0.0f);
+        float Mass = 1.0f;
+        float InvMass = 1.0f;   // 0表示静态物体
+        float Drag = 0.98f;     // 每步速度衰减系数，(0, 1]之外视为无阻力
+        bool UseGravity = true;
+        bool Awake = true;      // 休眠的刚体不参与积分和求解
+        float SleepTime = 0.0f; // 速度持续低于休眠阈值的时间
+        float SleepThreshold = -1.0f;   // 休眠速度阈值，负值使用物理世界的设置，0表示从不休眠
+        bool Continuous = false;    // 连续碰撞检测
+    };
+
+    // 刚体SoA存储
+    // 槽位是紧凑的：删除时把最后一个刚体移到空出的槽位，调用方负责同步句柄
+    class JFM_API RigidbodyStore {
+    public:
+        using FloatArray = std::vector<float, Detail::AlignedAllocator<float>>;
+
+        uint32_t Add(const RigidbodyState& state);
+
+        // 删除槽位，最后一个槽位的刚体移到slot
+        void Remove(uint32_t slot);
+
+        void Clear();
+        void Reserve(size_t count);
+        size_t GetSize() const { return m_PosX.size(); }
+
+        RigidbodyState GetState(uint32_t slot) const;
+        void SetState(uint32_t slot, const RigidbodyState& state);
+
+        glm::vec3 GetPosition(uint32_t slot) const { return glm::vec3(m_PosX[slot], m_PosY[slot], m_PosZ[slot]); }
+        void SetPosition(uint32_t slot, const glm::vec3& position) {
+            m_PosX[slot] = position.x; m_PosY[slot] = position.y; m_PosZ[slot] = position.z;
+        }
+
+        glm::vec3 GetVelocity(uint32_t slot) const { return glm::vec3(m_VelX[slot], m_VelY[slot], m_VelZ[slot]); }
+        void SetVelocity(uint32_t slot, const glm::vec3& velocity) {
+            m_VelX[slot] = velocity.x; m_VelY[slot] = velocity.y; m_VelZ[slot] = velocity.z;
+        }
+
+        glm::vec3 GetForce(uint32_t slot) const { return glm::vec3(m_ForceX[slot], m_ForceY[slot], m_ForceZ[slot]); }
+        void SetForce(uint32_t slot, const glm::vec3& force) {
+            m_ForceX[slot] = force.x; m_ForceY[slot] = force.y; m_ForceZ[slot] = force.z;
+            m_HasForces = true;
+        }
+        void AddForce(uint32_t slot, const glm::vec3& force) {
+            m_ForceX[slot] += force.x; m_ForceY[slot] += force.y; m_ForceZ[slot] += force.z;
+            m_HasForces = true;
+        }
+
+        float GetMass(uint32_t slot) const { return m_Mass[slot]; }
+        float GetInvMass(uint32_t slot) const { return m_InvMass[slot]; }
+        void SetMass(uint32_t slot, float mass);
+
+        float GetDrag(uint32_t slot) const { return m_Drag[slot]; }
+        void SetDrag(uint32_t slot, float drag);
+
+        bool GetUseGravity(uint32_t slot) const { return m_GravityScale[slot] != 0.0f; }
+        void SetUseGravity(uint32_t slot, bool useGravity) { m_GravityScale[slot] = useGravity ? 1.0f : 0.0f; }
+
+        bool IsAwake(uint32_t slot) const { return m_Awake[slot] != 0.0f; }
+        // 唤醒时清零休眠计时；进入休眠时速度归零。只改标志，不通知物理世界，外部唤醒应使用Activate
+        void SetAwake(uint32_t slot, bool awake);
+
+        // 唤醒刚体并记入激活列表，物理世界在下一步开始时据此更新包围盒；
+        // 静态刚体被移动后同样需要激活。在ActivationScope之外不是线程安全的
+        void Activate(uint32_t slot);
+        const std::vector<uint32_t>& GetActivated() const { return m_Activated; }
+        void ClearActivated() { m_Activated.clear(); }
+        // 追加已经唤醒的槽位，不改变休眠状态
+        void AppendActivated(const std::vector<uint32_t>& slots) { m_Activated.insert(m_Activated.end(), slots.begin(), slots.end()); }
+
+        // 作用域内当前线程对store的Activate只唤醒刚体并记入list，不写共享的激活列表；
+        // 并行求解时每个岛使用一个列表，结束后由调用方按岛的顺序AppendActivated，结果与线程数无关
+        class JFM_API ActivationScope {
+        public:
+            ActivationScope(RigidbodyStore& store, std::vector<uint32_t>& list);
+            ~ActivationScope();
+
+            ActivationScope(const ActivationScope&) = delete;
+            ActivationScope& operator=(const ActivationScope&) = delete;
+
+        private:
+            const RigidbodyStore* m_PreviousStore;
+            std::vector<uint32_t>* m_PreviousList;
+        };
+
+        float GetSleepTime(uint32_t slot) const { return m_SleepTime[slot]; }
+        void SetSleepTime(uint32_t slot, float time) { m_SleepTime[slot] = time; }
+
+        float GetSleepThreshold(uint32_t slot) const { return m_SleepThreshold[slot]; }
+        void SetSleepThreshold(uint32_t slot, float threshold) { m_SleepThreshold[slot] = threshold; }
+
+        bool IsContinuous(uint32_t slot) const { return m_Continuous[slot] != 0.0f; }
+        void SetContinuous(uint32_t slot, bool continuous) { m_Continuous[slot] = continuous ? 1.0f : 0.0f; }
+
+        // 半隐式欧拉积分所有醒着的动态刚体，并清除累积的力
+        // 速度或位置出现非有限值时与原先的标量实现一样归零
+        void Integrate(float deltaTime, const glm::vec3& gravity);
+        // 只积分列表中的槽位，醒着的动态刚体远少于总数时比整体扫描快；结果与整体积分一致
+        void Integrate(float deltaTime, const glm::vec3& gravity, const uint32_t* slots, size_t count);
+
+        // 单个刚体状态的标量积分，与Integrate的结果一致
+        static void IntegrateState(RigidbodyState& state, float deltaTime, const glm::vec3& gravity);
+
+        // 当前编译使用的积分内核："AVX2"、"SSE2"或"Scalar"
+        static const char* GetKernelName();
+
+        // 快照：所有分量数组按固定顺序首尾相接写入，共GetSnapshotFloatCount()个float
+        static constexpr size_t SnapshotArrayCount = 17;
+        size_t GetSnapshotFloatCount() const { return SnapshotArrayCount * GetSize(); }
+        void SaveSnapshot(float* out) const;
+        // 槽位数须与保存时相同；hasForces为保存时的HasForces()
+        void LoadSnapshot(const float* in, bool hasForces);
+        bool HasForces() const { return m_HasForces; }
+
+        // 供其他求解阶段直接访问的分量数组
+        float* GetPositionX() { return m_PosX.data(); }
+        float* GetPositionY() { return m_PosY.data(); }
+        float* GetPositionZ() { return m_PosZ.data(); }
+        float* GetVelocityX() { return m_VelX.data(); }
+        float* GetVelocityY() { return m_VelY.data(); }
+        float* GetVelocityZ() { return m_VelZ.data(); }
+        const float* GetInvMassArray() const { return m_InvMass.data(); }
+
+    private:
+        template<typename Self, typename Func>
+        static void ForEachArray(Self& self, Func&& func);
+
+        void IntegrateScalar(size_t begin, size_t end, float deltaTime, const glm::vec3& gravity);
+        void IntegrateSlot(uint32_t slot, float deltaTime, const glm::vec3& gravity);
+
+        FloatArray m_PosX, m_PosY, m_PosZ;
+        FloatArray m_VelX, m_VelY, m_VelZ;
+        FloatArray m_ForceX, m_ForceY, m_ForceZ;
+        FloatArray m_InvMass;
+        FloatArray m_GravityScale;  // 1或0，避免内核中分支
+        FloatArray m_Drag;          // 已处理过的有效阻力系数
+        FloatArray m_Mass;
+        FloatArray m_Awake;         // 1或0，与m_GravityScale一样避免内核中分支
+        FloatArray m_SleepTime;
+        FloatArray m_SleepThreshold;
+        FloatArray m_Continuous;    // 1或0
+        bool m_HasForces = false;   // 上次积分后是否施加过力，没有时内核跳过力数组
+        std::vector<uint32_t> m_Activated;  // 上一步之后被激活的槽位，可能重复
+    };
+
+}
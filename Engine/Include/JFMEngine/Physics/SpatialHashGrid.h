@@ -0,0 +1,177 @@
+//
+// SpatialHashGrid.h - 均匀网格宽阶段
+// 用于大量尺寸相近的物体（碎片、人群、粒子）
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/Physics.h"
+#include "JFMEngine/Physics/BroadPhase.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+namespace JFM {
+
+    // 空间哈希网格
+    // 每个物体按包围盒中心放入一个单元格，单元格坐标哈希到桶；每次更新用计数排序把物体按桶
+    // 排进一个扁平数组，没有逐单元格的分配。单元格边长不小于物体尺寸时重叠的物体必然位于
+    // 相邻的27个单元格中；更大的物体单独存放，与所有物体逐个比较，适合只有少数（如地面）的情况
+    // 物体下标即用户数据，删除时与RigidbodyStore一样把最后一个物体移到空出的位置
+    class JFM_API SpatialHashGrid {
+    public:
+        // 单元格边长，0表示自动选择：尺寸中位数两倍以内的物体中最大的尺寸
+        void SetCellSize(float cellSize);
+        float GetCellSize() const { return m_CellSize; }
+
+        uint32_t Add(const AABB& bounds);
+        void Remove(uint32_t index);
+        void Clear();
+
+        void SetBounds(uint32_t index, const AABB& bounds) { m_Bounds[index] = bounds; m_CellsDirty = m_PairsDirty = true; }
+        const AABB& GetBounds(uint32_t index) const { return m_Bounds[index]; }
+        size_t GetCount() const { return m_Bounds.size(); }
+        size_t GetOversizedCount() const { return m_Oversized.size(); }
+
+        // 重建网格并并行生成重叠对，输出按(A, B)排序，与线程数无关；上次之后没有改动包围盒时直接返回
+        const std::vector<BroadPhasePair>& UpdatePairs();
+        const std::vector<BroadPhasePair>& GetPairs() const { return m_Pairs; }
+        // 输出的重叠对每次变化时加一
+        uint64_t GetPairsVersion() const { return m_PairsVersion; }
+
+        // 包围盒与bounds重叠的物体，callback(index)返回false时停止；包围盒改变后先重建网格
+        template<typename Callback>
+        void Query(const AABB& bounds, Callback&& callback);
+
+        // 包围盒与球体相交的物体
+        template<typename Callback>
+        void QuerySphere(const glm::vec3& center, float radius, Callback&& callback);
+
+    private:
+        static constexpr uint32_t OversizedCell = UINT32_MAX;
+        static constexpr size_t EntriesPerJob = 1024;
+
+        struct CellCoord {
+            int32_t X, Y, Z;
+
+            bool operator==(const CellCoord& other) const { return X == other.X && Y == other.Y && Z == other.Z; }
+        };
+
+        // 桶中的一项，带一份包围盒使相邻单元格的测试只读连续的内存；
+        // 不同单元格可能哈希到同一个桶，按坐标过滤即可保证每个物体只访问一次
+        struct CellEntry {
+            AABB Bounds;
+            CellCoord Cell;
+            uint32_t Index;
+        };
+
+        void UpdateCellSize();
+        void BuildCells();
+        void CollectPairs(const CellEntry& entry, std::vector<BroadPhasePair>& pairs) const;
+        void CollectOversizedPairs(uint32_t index, std::vector<BroadPhasePair>& pairs) const;
+
+        CellCoord GetCell(const glm::vec3& point) const {
+            return {static_cast<int32_t>(std::floor(point.x * m_InvCellSize)),
+                    static_cast<int32_t>(std::floor(point.y * m_InvCellSize)),
+                    static_cast<int32_t>(std::floor(point.z * m_InvCellSize))};
+        }
+        // z方向相邻的单元格落在相邻的桶中，一列相邻的单元格对应m_Entries中连续的一段
+        static uint32_t HashColumn(int32_t x, int32_t y) {
+            return (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u);
+        }
+        uint32_t Hash(int32_t x, int32_t y, int32_t z) const {
+            return (HashColumn(x, y) + static_cast<uint32_t>(z)) & m_BucketMask;
+        }
+
+        // 访问单元格范围内的物体，范围内的单元格比物体还多时返回false，由调用方改为逐个比较
+        template<typename Visit>
+        bool ForEachCell(const CellCoord& min, const CellCoord& max, Visit&& visit) const;
+
+        std::vector<AABB> m_Bounds;
+        float m_RequestedCellSize = 0.0f;
+        float m_CellSize = 1.0f;
+        float m_InvCellSize = 1.0f;
+        size_t m_CellSizeCount = 0;         // 上次自动选择边长时的物体数
+        bool m_CellsDirty = true;
+        bool m_PairsDirty = true;
+
+        // 计数排序的结果：桶b中的物体为m_Entries[m_CellStart[b], m_CellStart[b + 1])，桶内按下标升序
+        std::vector<uint32_t> m_BodyBucket; // 每个物体所在的桶，过大的物体为OversizedCell
+        std::vector<CellCoord> m_BodyCell;
+        std::vector<uint32_t> m_CellStart;  // 桶数为2的幂，末尾多一个元素
+        uint32_t m_BucketMask = 0;
+        std::vector<CellEntry> m_Entries;
+        std::vector<uint32_t> m_Oversized;  // 按下标升序
+
+        std::vector<std::vector<BroadPhasePair>> m_JobPairs;   // 每个任务块的重叠对，容量跨帧复用
+        std::vector<BroadPhasePair> m_Pairs;
+        std::vector<BroadPhasePair> m_NewPairs;
+        uint64_t m_PairsVersion = 0;
+    };
+
+    template<typename Visit>
+    bool SpatialHashGrid::ForEachCell(const CellCoord& min, const CellCoord& max, Visit&& visit) const {
+        int64_t cells = int64_t(max.X - min.X + 1) * int64_t(max.Y - min.Y + 1) * int64_t(max.Z - min.Z + 1);
+        if (cells > static_cast<int64_t>(m_Entries.size())) {
+            return false;
+        }
+
+        for (int32_t x = min.X; x <= max.X; ++x) {
+            for (int32_t y = min.Y; y <= max.Y; ++y) {
+                for (int32_t z = min.Z; z <= max.Z; ++z) {
+                    CellCoord cell{x, y, z};
+                    uint32_t bucket = Hash(x, y, z);
+                    for (uint32_t i = m_CellStart[bucket]; i < m_CellStart[bucket + 1]; ++i) {
+                        if (m_Entries[i].Cell == cell && !visit(m_Entries[i].Index, m_Entries[i].Bounds)) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename Callback>
+    void SpatialHashGrid::Query(const AABB& bounds, Callback&& callback) {
+        BuildCells();
+
+        bool stopped = false;
+        auto visit = [&](uint32_t index, const AABB& other) {
+            if (other.Intersects(bounds) && !callback(index)) {
+                stopped = true;
+            }
+            return !stopped;
+        };
+
+        // 物体的中心离它的包围盒不超过半个单元格
+        glm::vec3 reach(m_CellSize * 0.5f);
+        if (!ForEachCell(GetCell(bounds.Min - reach), GetCell(bounds.Max + reach), visit)) {
+            for (uint32_t index = 0; index < m_Bounds.size() && !stopped; ++index) {
+                if (m_BodyBucket[index] != OversizedCell) {
+                    visit(index, m_Bounds[index]);
+                }
+            }
+        }
+        for (size_t i = 0; i < m_Oversized.size() && !stopped; ++i) {
+            visit(m_Oversized[i], m_Bounds[m_Oversized[i]]);
+        }
+    }
+
+    template<typename Callback>
+    void SpatialHashGrid::QuerySphere(const glm::vec3& center, float radius, Callback&& callback) {
+        const float radiusSq = radius * radius;
+        Query(AABB(center - glm::vec3(radius), center + glm::vec3(radius)), [&](uint32_t index) {
+            const AABB& bounds = m_Bounds[index];
+            glm::vec3 closest = glm::clamp(center, bounds.Min, bounds.Max);
+            glm::vec3 offset = closest - center;
+            if (glm::dot(offset, offset) > radiusSq) {
+                return true;
+            }
+            return static_cast<bool>(callback(index));
+        });
+    }
+
+}
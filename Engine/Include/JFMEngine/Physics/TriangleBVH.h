@@ -0,0 +1,173 @@
+//
+// TriangleBVH.h - 静态三角形网格的层次包围盒
+// 用于关卡几何等静态网格的射线、球体扫掠和胶囊查询
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Physics/Physics.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+
+namespace JFM {
+
+    // 射线或扫掠命中的三角形
+    struct MeshHit {
+        uint32_t Triangle = 0;      // 构建时传入的三角形序号
+        float Distance = 0.0f;
+        glm::vec3 Point = glm::vec3(0.0f);     // 三角形上的命中点
+        glm::vec3 Normal = glm::vec3(0.0f);    // 指向查询一侧
+    };
+
+    // 形状与三角形之间的接触
+    struct MeshContact {
+        uint32_t Triangle = 0;
+        glm::vec3 Point = glm::vec3(0.0f);     // 三角形上的最近点
+        glm::vec3 Normal = glm::vec3(0.0f);    // 从三角形指向形状
+        float Separation = 0.0f;               // 负值为穿透深度
+    };
+
+    // 静态三角形BVH
+    // 按SAH构建后不再修改；每个32字节节点同时保存两个子节点量化到16位的包围盒，
+    // 遍历时一次读取就能测试两个子节点，节点按深度优先顺序存放
+    class JFM_API TriangleBVH {
+    public:
+        static constexpr uint32_t MaxLeafTriangles = 4;
+        static constexpr int MaxStackDepth = 64;
+
+        struct Node {
+            uint16_t Min[2][3];
+            uint16_t Max[2][3];
+            uint32_t Child[2];      // 最高位为1时是叶节点：低4位为三角形数，其余为首个三角形
+        };
+        static_assert(sizeof(Node) == 32, "TriangleBVH::Node must stay 32 bytes");
+
+        TriangleBVH() = default;
+        TriangleBVH(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
+        void Build(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+        void Clear();
+
+        // 二进制格式，按本机字节序保存，加载时校验标识和版本
+        bool Serialize(std::ostream& out) const;
+        bool Deserialize(std::istream& in);
+        bool SaveToFile(const std::string& path) const;
+        bool LoadFromFile(const std::string& path);
+
+        // 最近的命中，direction需归一化
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, MeshHit& hit) const;
+
+        // 球体沿direction扫掠时最先碰到的三角形，起始位置已接触时距离为0
+        bool SphereSweep(const glm::vec3& center, float radius, const glm::vec3& direction, float maxDistance, MeshHit& hit) const;
+
+        // 胶囊（线段p0-p1加半径）与间距不超过margin的三角形，callback(const MeshContact&)返回false时停止
+        template<typename Callback>
+        void OverlapCapsule(const glm::vec3& p0, const glm::vec3& p1, float radius, float margin, Callback&& callback) const;
+
+        // 包围盒与bounds重叠的三角形，callback(triangle)返回false时停止；triangle为内部序号
+        template<typename Callback>
+        void Query(const AABB& bounds, Callback&& callback) const;
+
+        // 内部序号的三角形顶点
+        void GetTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const {
+            a = m_Vertices[m_Triangles[triangle * 3]];
+            b = m_Vertices[m_Triangles[triangle * 3 + 1]];
+            c = m_Vertices[m_Triangles[triangle * 3 + 2]];
+        }
+        uint32_t GetOriginalTriangle(uint32_t triangle) const { return m_TriangleIds[triangle]; }
+
+        const AABB& GetBounds() const { return m_Bounds; }
+        const std::vector<glm::vec3>& GetVertices() const { return m_Vertices; }
+        size_t GetTriangleCount() const { return m_TriangleIds.size(); }
+        size_t GetNodeCount() const { return m_Nodes.size(); }
+        bool IsEmpty() const { return m_TriangleIds.empty(); }
+
+        // 线段与三角形的接触，间距不超过margin时返回true
+        bool CapsuleTriangle(const glm::vec3& p0, const glm::vec3& p1, float radius, float margin,
+                             uint32_t triangle, MeshContact& contact) const;
+
+        // 双面射线三角形求交，t为沿direction的距离
+        static bool IntersectRayTriangle(const glm::vec3& origin, const glm::vec3& direction,
+                                         const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float& t);
+
+    private:
+        static constexpr uint32_t LeafFlag = 0x80000000u;
+        static constexpr uint32_t LeafCountBits = 4;
+        static constexpr uint32_t LeafCountMask = (1u << LeafCountBits) - 1;
+
+        static bool IsLeaf(uint32_t child) { return (child & LeafFlag) != 0; }
+        static uint32_t LeafFirst(uint32_t child) { return (child & ~LeafFlag) >> LeafCountBits; }
+        static uint32_t LeafCount(uint32_t child) { return child & LeafCountMask; }
+
+        struct BuildEntry;
+        uint32_t BuildRecursive(std::vector<BuildEntry>& entries, uint32_t begin, uint32_t end, int depth, AABB& bounds);
+        void Quantize(const AABB& bounds, uint16_t* qMin, uint16_t* qMax) const;
+        void QuantizeQuery(const AABB& bounds, uint32_t* qMin, uint32_t* qMax) const;
+        AABB Dequantize(const Node& node, int child) const;
+
+        std::vector<glm::vec3> m_Vertices;
+        std::vector<uint32_t> m_Triangles;      // 按叶节点顺序重排的三角形顶点索引
+        std::vector<uint32_t> m_TriangleIds;    // 重排后每个三角形的原始序号
+        std::vector<Node> m_Nodes;
+        uint32_t m_Root = 0;                    // 与Node::Child编码相同
+        AABB m_Bounds;
+        glm::vec3 m_QuantizeScale = glm::vec3(1.0f);   // 每个量化单位对应的长度
+    };
+
+    template<typename Callback>
+    void TriangleBVH::Query(const AABB& bounds, Callback&& callback) const {
+        if (IsEmpty() || !m_Bounds.Intersects(bounds)) {
+            return;
+        }
+
+        // 查询包围盒转换到量化空间，节点测试只需整数比较
+        uint32_t qMin[3], qMax[3];
+        QuantizeQuery(bounds, qMin, qMax);
+
+        uint32_t stack[MaxStackDepth];
+        int count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0) {
+            uint32_t ref = stack[--count];
+            if (IsLeaf(ref)) {
+                uint32_t first = LeafFirst(ref);
+                for (uint32_t i = 0; i < LeafCount(ref); ++i) {
+                    if (!callback(first + i)) {
+                        return;
+                    }
+                }
+                continue;
+            }
+
+            const Node& node = m_Nodes[ref];
+            for (int c = 0; c < 2; ++c) {
+                if (node.Min[c][0] > qMax[0] || node.Max[c][0] < qMin[0] ||
+                    node.Min[c][1] > qMax[1] || node.Max[c][1] < qMin[1] ||
+                    node.Min[c][2] > qMax[2] || node.Max[c][2] < qMin[2]) {
+                    continue;
+                }
+                JFM_CORE_ASSERT(count < MaxStackDepth, "TriangleBVH stack overflow");
+                stack[count++] = node.Child[c];
+            }
+        }
+    }
+
+    template<typename Callback>
+    void TriangleBVH::OverlapCapsule(const glm::vec3& p0, const glm::vec3& p1, float radius, float margin, Callback&& callback) const {
+        glm::vec3 reach(radius + margin);
+        AABB bounds(glm::min(p0, p1) - reach, glm::max(p0, p1) + reach);
+        Query(bounds, [&](uint32_t triangle) {
+            MeshContact contact;
+            if (CapsuleTriangle(p0, p1, radius, margin, triangle, contact)) {
+                return static_cast<bool>(callback(contact));
+            }
+            return true;
+        });
+    }
+
+}
@@ -22,13 +22,19 @@ public:
     float GetPitch() const { return m_Pitch; }
     float GetYaw() const { return m_Yaw; }
     float GetFov() const { return m_Fov; }
-    //根据相机属性生成渲染所需的视图矩阵和投影矩阵
-    glm::mat4 GetViewMatrix() const {
+    float GetNearClip() const { return m_Near; }
+    float GetFarClip() const { return m_Far; }
+    //相机朝向的单位向量
+    glm::vec3 GetForward() const {
         glm::vec3 front;
         front.x = cos(glm::radians(m_Yaw)) * cos(glm::radians(m_Pitch));
         front.y = sin(glm::radians(m_Pitch));
         front.z = sin(glm::radians(m_Yaw)) * cos(glm::radians(m_Pitch));
-        return glm::lookAt(m_Position, m_Position + glm::normalize(front), glm::vec3(0, 1, 0));
+        return glm::normalize(front);
+    }
+    //根据相机属性生成渲染所需的视图矩阵和投影矩阵
+    glm::mat4 GetViewMatrix() const {
+        return glm::lookAt(m_Position, m_Position + GetForward(), glm::vec3(0, 1, 0));
     }
     glm::mat4 GetProjectionMatrix() const {
         return glm::perspective(glm::radians(m_Fov), m_Aspect, m_Near, m_Far);
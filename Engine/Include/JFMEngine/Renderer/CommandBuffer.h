@@ -0,0 +1,208 @@
+//
+// CommandBuffer.h - 渲染命令缓冲
+// 渲染器把一帧的绘制记录成与图形API无关的POD命令流，后端在提交时统一执行
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Renderer/Material.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace JFM {
+
+    class Shader;
+    class Mesh;
+    class VertexArray;
+    enum class PolygonMode;
+
+    enum class CommandType : uint16_t {
+        SetViewport,
+        SetClearColor,
+        Clear,
+        SetPolygonMode,
+        BindShader,
+        SetFloat,
+        SetFloat3,
+        SetMat4,
+        BindMaterial,
+        DrawIndexed,
+        DrawArrays,
+        DrawMesh,
+        Count
+    };
+
+    // uniform名字登记在全局表中，命令里只保存ID，命令流不引用调用方的字符串
+    // 同一名字得到同一ID，登记后一直有效；构造需要加锁查表，频繁使用的名字应保存在静态变量中，GetString不加锁
+    class JFM_API UniformName {
+    public:
+        UniformName() = default;
+        explicit UniformName(const char* name);
+
+        uint32_t GetID() const { return m_ID; }
+        const std::string& GetString() const;
+
+        bool operator==(const UniformName& other) const { return m_ID == other.m_ID; }
+        bool operator!=(const UniformName& other) const { return m_ID != other.m_ID; }
+
+    private:
+        uint32_t m_ID = 0;  // 0为空名字
+    };
+
+    // 每条命令以8字节的头开始，Size为包含头在内的字节数（8的倍数），命令数据紧跟在头之后
+    struct CommandHeader {
+        CommandType Type;
+        uint16_t Reserved;
+        uint32_t Size;
+    };
+
+    // 命令数据，只含POD成员；指针指向的对象需保持到命令执行完
+    namespace Commands {
+
+        struct SetViewport {
+            static constexpr CommandType Type = CommandType::SetViewport;
+            uint32_t X, Y, Width, Height;
+        };
+
+        struct SetClearColor {
+            static constexpr CommandType Type = CommandType::SetClearColor;
+            glm::vec4 Color;
+        };
+
+        struct Clear {
+            static constexpr CommandType Type = CommandType::Clear;
+        };
+
+        struct SetPolygonMode {
+            static constexpr CommandType Type = CommandType::SetPolygonMode;
+            PolygonMode Mode;
+        };
+
+        struct BindShader {
+            static constexpr CommandType Type = CommandType::BindShader;
+            JFM::Shader* Shader;
+        };
+
+        struct SetFloat {
+            static constexpr CommandType Type = CommandType::SetFloat;
+            JFM::Shader* Shader;
+            UniformName Name;
+            float Value;
+        };
+
+        struct SetFloat3 {
+            static constexpr CommandType Type = CommandType::SetFloat3;
+            JFM::Shader* Shader;
+            UniformName Name;
+            glm::vec3 Value;
+        };
+
+        struct SetMat4 {
+            static constexpr CommandType Type = CommandType::SetMat4;
+            JFM::Shader* Shader;
+            UniformName Name;
+            glm::mat4 Value;
+        };
+
+        // 材质参数按值记录，提交时的Material可以是临时对象
+        struct BindMaterial {
+            static constexpr CommandType Type = CommandType::BindMaterial;
+            JFM::Shader* Shader;
+            MaterialProperties Properties;
+        };
+
+        struct DrawIndexed {
+            static constexpr CommandType Type = CommandType::DrawIndexed;
+            const JFM::VertexArray* VertexArray;
+            uint32_t IndexCount;    // 记录时已解析，不为0
+        };
+
+        struct DrawArrays {
+            static constexpr CommandType Type = CommandType::DrawArrays;
+            const JFM::VertexArray* VertexArray;
+            uint32_t VertexCount;
+        };
+
+        struct DrawMesh {
+            static constexpr CommandType Type = CommandType::DrawMesh;
+            const JFM::Mesh* Mesh;
+            uint32_t IndexCount;    // 只用于统计，执行时由网格决定
+            uint32_t VertexCount;
+        };
+
+    }
+
+    // 命令缓冲，每帧清空后重新记录，保留容量，稳定后不再分配内存
+    // 不使用帧分配器，使工作线程可以各自记录一个命令缓冲；同一个命令缓冲同时只能由一个线程写入
+    class JFM_API CommandBuffer {
+    public:
+        void Clear();
+
+        template<typename T>
+        void Record(const T& command) {
+            Encode(m_Words, command);
+            m_CommandCount++;
+        }
+
+        // 把一条命令追加到任意uint64_t容器的末尾，与Record的格式相同
+        template<typename Words, typename T>
+        static void Encode(Words& words, const T& command);
+
+        const uint64_t* GetData() const { return m_Words.data(); }
+        size_t GetSizeInWords() const { return m_Words.size(); }
+        size_t GetSizeInBytes() const { return m_Words.size() * sizeof(uint64_t); }
+        uint32_t GetCommandCount() const { return m_CommandCount; }
+        bool IsEmpty() const { return m_CommandCount == 0; }
+
+        // 按记录顺序访问命令，visitor(const CommandHeader&)，用GetCommand取出命令数据
+        template<typename Visitor>
+        void ForEach(Visitor&& visitor) const { ForEach(m_Words.data(), m_Words.size(), visitor); }
+
+        // 遍历任意位置保存的命令流（例如RecordingRendererAPI拷贝的结果）
+        template<typename Visitor>
+        static void ForEach(const uint64_t* words, size_t wordCount, Visitor&& visitor);
+
+        template<typename T>
+        static const T& GetCommand(const CommandHeader& header) {
+            return *reinterpret_cast<const T*>(&header + 1);
+        }
+
+    private:
+        std::vector<uint64_t> m_Words;
+        uint32_t m_CommandCount = 0;
+    };
+
+    template<typename Words, typename T>
+    void CommandBuffer::Encode(Words& words, const T& command) {
+        static_assert(std::is_trivially_copyable<T>::value, "渲染命令只能包含POD数据");
+        static_assert(sizeof(CommandHeader) == sizeof(uint64_t), "命令头需占8字节");
+        static_assert(alignof(T) <= alignof(uint64_t), "命令数据按8字节对齐");
+
+        constexpr size_t payloadWords = std::is_empty<T>::value ? 0 : (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        const size_t offset = words.size();
+        words.resize(offset + 1 + payloadWords);
+
+        CommandHeader header{T::Type, 0, static_cast<uint32_t>((1 + payloadWords) * sizeof(uint64_t))};
+        std::memcpy(&words[offset], &header, sizeof(header));
+        if (payloadWords > 0) {
+            std::memcpy(&words[offset + 1], &command, sizeof(T));
+        }
+    }
+
+    template<typename Visitor>
+    void CommandBuffer::ForEach(const uint64_t* words, size_t wordCount, Visitor&& visitor) {
+        size_t offset = 0;
+        while (offset < wordCount) {
+            const CommandHeader& header = *reinterpret_cast<const CommandHeader*>(words + offset);
+            visitor(header);
+            offset += header.Size / sizeof(uint64_t);
+        }
+    }
+
+}
@@ -11,8 +11,10 @@
 #include "JFMEngine/Renderer/Camera.h"
 #include "JFMEngine/Renderer/Shader.h"
 #include "JFMEngine/Renderer/VertexArray.h"
+#include "JFMEngine/Renderer/CommandBuffer.h"
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 
 namespace JFM {
 
@@ -24,22 +26,37 @@ namespace JFM {
         static void BeginScene(const Camera& camera);
         static void EndScene();
 
-        // 渲染带光照的物体
+        // 渲染带光照的物体：记录到命令缓冲，EndScene时统一执行；着色器和顶点数组的所有权保留到EndScene
+        // 着色器与上一次提交相同时不再重复设置相机和光照参数
         static void Submit(const std::shared_ptr<Shader>& shader,
                           const std::shared_ptr<VertexArray>& vertexArray,
                           const Material& material,
                           const glm::mat4& transform = glm::mat4(1.0f));
 
-        // 设置光照参数到着色器
-        static void SetLightingUniforms(std::shared_ptr<Shader> shader, const glm::vec3& viewPos);
+        // 把光照参数记录为命令
+        static void RecordLightingUniforms(CommandBuffer& commands, Shader* shader);
+
+        // 本帧记录的命令，EndScene执行后清空
+        static const CommandBuffer& GetCommandBuffer() { return s_CommandBuffer; }
 
     private:
+        // 命令中只保存裸指针，提交的对象保留到本帧命令执行完；与上一次保留的对象相同时跳过
+        template<typename T>
+        static void Retain(const std::shared_ptr<T>& object) {
+            if (object && (s_Retained.empty() || s_Retained.back().get() != object.get())) {
+                s_Retained.push_back(object);
+            }
+        }
+
         struct SceneData {
             glm::mat4 ViewProjectionMatrix;
             glm::vec3 ViewPosition;
+            Shader* BoundShader = nullptr;  // 命令缓冲中最后绑定的着色器
         };
 
         static SceneData* s_SceneData;
+        static CommandBuffer s_CommandBuffer;
+        static std::vector<std::shared_ptr<const void>> s_Retained;
     };
 
 }
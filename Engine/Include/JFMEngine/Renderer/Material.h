@@ -8,6 +8,7 @@
 #include "JFMEngine/Core/Core.h"
 #include <glm/glm.hpp>
 #include <memory>
+#include <cstdint>
 
 namespace JFM {
 
@@ -25,6 +26,8 @@ namespace JFM {
         float Metallic = 0.0f;                                // 金属度 (0.0 = 非金属, 1.0 = 金属)
         float Roughness = 0.5f;                               // 粗糙度 (0.0 = 光滑, 1.0 = 粗糙)
         float AO = 1.0f;                                      // 环境遮蔽
+
+        float Opacity = 1.0f;                                 // 不透明度，小于1时按半透明物体排序和绘制
     };
 
     class JFM_API Material {
@@ -33,6 +36,8 @@ namespace JFM {
         ~Material() = default;
 
         void Bind(std::shared_ptr<Shader> shader) const;
+        // 命令缓冲按值记录材质参数，执行时直接设置
+        static void Bind(Shader& shader, const MaterialProperties& properties);
 
         // Phong光照属性设置器
         void SetAmbient(const glm::vec3& ambient) { m_Properties.Ambient = ambient; }
@@ -45,11 +50,17 @@ namespace JFM {
         void SetMetallic(float metallic) { m_Properties.Metallic = metallic; }
         void SetRoughness(float roughness) { m_Properties.Roughness = roughness; }
         void SetAO(float ao) { m_Properties.AO = ao; }
+        void SetOpacity(float opacity) { m_Properties.Opacity = opacity; }
+
+        bool IsTransparent() const { return m_Properties.Opacity < 1.0f; }
+        // 创建时分配的编号，从1开始，用于渲染队列的排序键
+        uint32_t GetSortID() const { return m_SortID; }
 
         const MaterialProperties& GetProperties() const { return m_Properties; }
 
     private:
         MaterialProperties m_Properties;
+        uint32_t m_SortID;
     };
 
     // 预定义材质
@@ -33,8 +33,12 @@ namespace JFM {
         void Draw() const;
         void SetupMesh();
 
+        // 创建时分配的编号，从1开始，用于渲染队列的排序键
+        uint32_t GetSortID() const { return m_SortID; }
+
     private:
         bool m_IsSetup = false;
+        uint32_t m_SortID;
     };
 
     class JFM_API MeshGenerator {
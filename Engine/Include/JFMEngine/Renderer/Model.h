@@ -26,6 +26,8 @@ namespace JFM {
     class JFM_API Model {
     public:
         Model(const std::string& path);
+        // 由已有的网格组成模型，例如程序生成的几何体
+        explicit Model(std::vector<std::shared_ptr<Mesh>> meshes);
         ~Model() = default;
 
         void Draw(const std::shared_ptr<Shader>& shader) const;
@@ -0,0 +1,79 @@
+//
+// NullRendererAPI.h - 不访问GPU的渲染后端
+// 用于没有图形环境的CI、基准测试，以及检查渲染器生成的命令流
+//
+
+#pragma once
+
+#include "JFMEngine/Renderer/RendererAPI.h"
+#include "JFMEngine/Renderer/CommandBuffer.h"
+#include <array>
+#include <vector>
+
+namespace JFM {
+
+    // 丢弃所有命令
+    class JFM_API NullRendererAPI : public RendererAPI {
+    public:
+        virtual void Init() override {}
+        virtual void SetViewport(uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/) override {}
+
+        virtual void SetClearColor(const glm::vec4& /*color*/) override {}
+        virtual void Clear() override {}
+
+        virtual void DrawIndexed(const std::shared_ptr<VertexArray>& /*vertexArray*/, uint32_t /*indexCount*/ = 0) override {}
+        virtual void DrawArrays(const std::shared_ptr<VertexArray>& /*vertexArray*/, uint32_t /*vertexCount*/) override {}
+        virtual void DrawIndexed(const VertexArray& /*vertexArray*/, uint32_t /*indexCount*/) override {}
+        virtual void DrawArrays(const VertexArray& /*vertexArray*/, uint32_t /*vertexCount*/) override {}
+
+        virtual void SetPolygonMode(PolygonMode /*mode*/) override {}
+
+        virtual void Execute(const CommandBuffer& /*commands*/) override {}
+    };
+
+    // 把执行的命令缓冲和直接调用的命令按顺序保存下来，不访问命令引用的着色器、网格等对象
+    // 保存的命令流在Reset之前一直有效，指针只用于比较，不能在对象释放后解引用；
+    // 命令数据中的填充字节没有定义，检查命令时按字段比较
+    class JFM_API RecordingRendererAPI : public NullRendererAPI {
+    public:
+        virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+
+        virtual void SetClearColor(const glm::vec4& color) override;
+        virtual void Clear() override;
+
+        virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
+        virtual void DrawArrays(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount) override;
+        virtual void DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount) override;
+        virtual void DrawArrays(const VertexArray& vertexArray, uint32_t vertexCount) override;
+
+        virtual void SetPolygonMode(PolygonMode mode) override;
+
+        virtual void Execute(const CommandBuffer& commands) override;
+
+        // 清空保存的命令和统计
+        void Reset();
+
+        const std::vector<uint64_t>& GetCommands() const { return m_Words; }
+        uint32_t GetCommandCount() const { return m_CommandCount; }
+        uint32_t GetCommandCount(CommandType type) const { return m_TypeCounts[static_cast<size_t>(type)]; }
+        uint32_t GetExecuteCount() const { return m_ExecuteCount; }
+
+        // 按顺序访问保存的命令，visitor(const CommandHeader&)
+        template<typename Visitor>
+        void ForEach(Visitor&& visitor) const { CommandBuffer::ForEach(m_Words.data(), m_Words.size(), visitor); }
+
+    private:
+        template<typename T>
+        void Record(const T& command) {
+            CommandBuffer::Encode(m_Words, command);
+            m_TypeCounts[static_cast<size_t>(T::Type)]++;
+            m_CommandCount++;
+        }
+
+        std::vector<uint64_t> m_Words;
+        std::array<uint32_t, static_cast<size_t>(CommandType::Count)> m_TypeCounts{};
+        uint32_t m_CommandCount = 0;
+        uint32_t m_ExecuteCount = 0;
+    };
+
+}
@@ -18,6 +18,8 @@ namespace JFM {
 
         virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
         virtual void DrawArrays(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount) override;
+        virtual void DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount) override;
+        virtual void DrawArrays(const VertexArray& vertexArray, uint32_t vertexCount) override;
 
         virtual void SetPolygonMode(PolygonMode mode) override;
     };
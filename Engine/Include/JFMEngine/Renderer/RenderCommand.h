@@ -18,6 +18,8 @@ namespace JFM {
         Point  // 点模式
     };
 
+    class CommandBuffer;
+
     class JFM_API RenderCommand {
     public:
         static void Init();
@@ -27,6 +29,11 @@ namespace JFM {
         static void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount = 0);
         static void DrawArrays(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount);
         static void SetPolygonMode(PolygonMode mode);
+        static void Execute(const CommandBuffer& commands);
+
+        // 替换渲染后端，例如在没有GPU的环境中使用NullRendererAPI或RecordingRendererAPI
+        static void SetRendererAPI(std::unique_ptr<RendererAPI> rendererAPI) { s_RendererAPI = std::move(rendererAPI); }
+        static RendererAPI* GetRendererAPI() { return s_RendererAPI.get(); }
 
     private:
         static std::unique_ptr<RendererAPI> s_RendererAPI;
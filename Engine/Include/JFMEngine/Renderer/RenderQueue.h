@@ -0,0 +1,196 @@
+//
+// RenderQueue.h - 按排序键提交的渲染队列
+// 每次绘制生成一个64位排序键，数据另外存放，排序只移动键和下标
+//
+
+#pragma once
+
+#include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Core/FrameArena.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace JFM {
+
+    class Shader;
+    class Material;
+    class Mesh;
+
+    // 渲染通道，位于排序键的最高位，先绘制编号小的通道
+    enum class RenderPass : uint8_t {
+        Shadow = 0,
+        Main = 1,
+        Overlay = 2
+    };
+
+    // 排序键，按数值升序绘制
+    // 不透明：| 通道 4 | 0 | 着色器 11 | 材质 16 | 网格 16 | 深度 16 |，状态相同时由近到远
+    // 半透明：| 通道 4 | 1 | 反转深度 24 | 着色器 11 | 材质 12 | 网格 12 |，由远到近，深度相同时按状态
+    // 同一通道内半透明物体总在不透明物体之后；编号超出字段宽度时只取低位，只影响合批，不影响结果
+    // depth为归一化到[0, 1]的视线方向深度，超出范围时截断
+    namespace RenderSortKey {
+        constexpr uint32_t PassShift = 60;
+        constexpr uint32_t TransparentShift = 59;
+
+        JFM_API uint64_t Opaque(RenderPass pass, uint32_t shader, uint32_t material, uint32_t mesh, float depth);
+        JFM_API uint64_t Transparent(RenderPass pass, uint32_t shader, uint32_t material, uint32_t mesh, float depth);
+
+        inline RenderPass GetPass(uint64_t key) { return static_cast<RenderPass>(key >> PassShift); }
+        inline bool IsTransparent(uint64_t key) { return ((key >> TransparentShift) & 1) != 0; }
+    }
+
+    // 一次绘制的数据；指向的对象需保持到队列被清空，提交时通过队列的Retain保留所有权
+    struct RenderItem {
+        JFM::Shader* Shader = nullptr;
+        const JFM::Material* Material = nullptr;
+        const JFM::Mesh* Mesh = nullptr;
+        glm::mat4 Transform = glm::mat4(1.0f);
+    };
+
+    struct RenderQueueEntry {
+        uint64_t Key;
+        uint32_t Item;  // RenderItem的下标
+    };
+
+    // 按队列顺序绘制时各类状态的切换次数，第一次绑定也计入
+    struct RenderStateChanges {
+        uint32_t Shader = 0;
+        uint32_t Material = 0;
+        uint32_t Mesh = 0;
+    };
+
+    // 已排序队列的只读视图，用于归并多个队列
+    struct RenderQueueView {
+        const RenderQueueEntry* Entries = nullptr;
+        size_t Count = 0;
+        const RenderItem* Items = nullptr;
+    };
+
+    // 渲染队列，键和数据都放在帧分配器上
+    class JFM_API RenderQueue {
+    public:
+        // 重新绑定到当前帧的内存，按上一帧的规模预留；每帧开始提交前调用
+        void Reset();
+        void Clear();
+
+        void Push(uint64_t key, const RenderItem& item);
+        // 保留提交对象的所有权到下一次Reset/Clear，RenderItem中只保存裸指针；与上一次保留的对象相同时跳过
+        template<typename T>
+        void Retain(const std::shared_ptr<T>& object) {
+            if (object && (m_Retained.empty() || m_Retained.back().get() != object.get())) {
+                m_Retained.push_back(object);
+            }
+        }
+
+        // 按键的基数排序，键相同时保持提交顺序
+        void Sort();
+
+        size_t GetSize() const { return m_Entries.size(); }
+        bool IsEmpty() const { return m_Entries.empty(); }
+        const FrameVector<RenderQueueEntry>& GetEntries() const { return m_Entries; }
+        const RenderItem& GetItem(const RenderQueueEntry& entry) const { return m_Items[entry.Item]; }
+        RenderQueueView GetView() const { return {m_Entries.data(), m_Entries.size(), m_Items.data()}; }
+
+        // 只比较RenderItem中的指针，不访问图形API
+        RenderStateChanges CountStateChanges() const;
+
+    private:
+        FrameVector<RenderQueueEntry> m_Entries;
+        FrameVector<RenderQueueEntry> m_Scratch;
+        FrameVector<RenderItem> m_Items;
+        // 析构时需要释放引用，不能放在帧分配器上
+        std::vector<std::shared_ptr<const void>> m_Retained;
+    };
+
+    // 一个工作线程（场景分区）的提交列表
+    // 帧分配器只供主线程使用，列表放在普通堆上并跨帧保留容量；每个线程只写自己的列表，提交时不加锁
+    class JFM_API RenderCommandList {
+    public:
+        void Clear();
+
+        void Push(uint64_t key, const RenderItem& item);
+        // 保留提交对象的所有权到下一次Reset/Clear，RenderItem中只保存裸指针；与上一次保留的对象相同时跳过
+        template<typename T>
+        void Retain(const std::shared_ptr<T>& object) {
+            if (object && (m_Retained.empty() || m_Retained.back().get() != object.get())) {
+                m_Retained.push_back(object);
+            }
+        }
+
+        // 提交的物体数，一个物体可以有多个网格，只用于统计
+        void AddObject() { m_ObjectCount++; }
+
+        // 按键的基数排序，可以在工作线程上调用
+        void Sort();
+
+        size_t GetSize() const { return m_Entries.size(); }
+        bool IsEmpty() const { return m_Entries.empty(); }
+        uint32_t GetObjectCount() const { return m_ObjectCount; }
+        const std::vector<RenderQueueEntry>& GetEntries() const { return m_Entries; }
+        const RenderItem& GetItem(const RenderQueueEntry& entry) const { return m_Items[entry.Item]; }
+        RenderQueueView GetView() const { return {m_Entries.data(), m_Entries.size(), m_Items.data()}; }
+
+    private:
+        std::vector<RenderQueueEntry> m_Entries;
+        std::vector<RenderQueueEntry> m_Scratch;
+        std::vector<RenderItem> m_Items;
+        std::vector<std::shared_ptr<const void>> m_Retained;
+        uint32_t m_ObjectCount = 0;
+    };
+
+    // 64位键的LSD基数排序，每轮8位，所有键在某一字节上相同时跳过该轮；稳定
+    // scratch至少有count个元素，返回存放结果的数组（entries或scratch）
+    JFM_API RenderQueueEntry* RadixSort(RenderQueueEntry* entries, RenderQueueEntry* scratch, size_t count);
+
+    // 按键的范围把若干已排序的队列分成segmentCount段，各段可以在不同线程上独立归并，依次连接即为整体的归并结果
+    // 键相同的元素总在同一段；segments[s * queueCount + q]为第s段中队列q的部分，
+    // previous[s]为按归并顺序位于第s段之前的最后一个元素，没有时为nullptr
+    JFM_API void SplitRenderQueues(const RenderQueueView* queues, size_t queueCount, size_t segmentCount,
+                                   RenderQueueView* segments, const RenderItem** previous);
+
+    // 按键升序归并若干已排序的队列，visit(const RenderQueueEntry&, const RenderItem&)
+    // 键相同时先访问靠前的队列，同一队列内保持原有顺序，结果与各队列由哪个线程填充无关
+    template<typename Visit>
+    void MergeRenderQueues(const RenderQueueView* queues, size_t queueCount, Visit&& visit) {
+        // 各队列的队首按(键, 队列编号)组成小根堆；取出最小的队列后连续输出到超过新的堆顶为止，
+        // 每段只需一次O(log k)的堆调整
+        struct Head {
+            uint64_t Key;
+            size_t Queue;
+            bool operator<(const Head& other) const { return Key < other.Key || (Key == other.Key && Queue < other.Queue); }
+        };
+        auto greater = [](const Head& a, const Head& b) { return b < a; };
+
+        std::vector<Head> heap;
+        std::vector<size_t> positions(queueCount, 0);
+        heap.reserve(queueCount);
+        for (size_t q = 0; q < queueCount; ++q) {
+            if (queues[q].Count > 0) {
+                heap.push_back({queues[q].Entries[0].Key, q});
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), greater);
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            const size_t q = heap.back().Queue;
+            heap.pop_back();
+
+            const RenderQueueView& queue = queues[q];
+            size_t& position = positions[q];
+            do {
+                visit(queue.Entries[position], queue.Items[queue.Entries[position].Item]);
+                ++position;
+            } while (position < queue.Count && (heap.empty() || Head{queue.Entries[position].Key, q} < heap.front()));
+
+            if (position < queue.Count) {
+                heap.push_back({queue.Entries[position].Key, q});
+                std::push_heap(heap.begin(), heap.end(), greater);
+            }
+        }
+    }
+}
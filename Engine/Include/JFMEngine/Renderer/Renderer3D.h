@@ -5,12 +5,15 @@
 #pragma once
 
 #include "JFMEngine/Core/Core.h"
+#include "JFMEngine/Core/FrameArena.h"
 #include "Camera.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "VertexArray.h"
 #include "Model.h"
 #include "Light.h"
+#include "RenderQueue.h"
+#include "CommandBuffer.h"
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -23,14 +26,7 @@ namespace JFM {
         uint32_t VertexCount = 0;
         uint32_t IndexCount = 0;
         uint32_t ModelCount = 0;
-    };
-
-    // 渲染队列项
-    struct RenderItem {
-        std::shared_ptr<Model> Model;
-        glm::mat4 Transform;
-        std::shared_ptr<Material> Material;
-        float DistanceToCamera;
+        RenderStateChanges StateChanges;    // 按排序后的顺序绘制时的状态切换次数
     };
 
     class JFM_API Renderer3D {
@@ -42,11 +38,23 @@ namespace JFM {
         static void BeginScene(const Camera& camera, const std::vector<Light>& lights = {});
         static void EndScene();
 
-        // 模型提交
+        // 模型提交：模型的每个网格生成一个排序键，EndScene时排序，
+        // 不透明物体按状态合批、由近到远，半透明物体由远到近；渲染队列保留模型和材质的引用直到下一帧BeginScene，可以提交临时对象
+        // EndScene按排序后的顺序只在状态变化时记录绑定命令，再把命令缓冲交给渲染后端执行
         static void Submit(const std::shared_ptr<Model>& model, const glm::mat4& transform);
         static void Submit(const std::shared_ptr<Model>& model, const glm::mat4& transform,
                           const std::shared_ptr<Material>& material);
 
+        // 多线程提交：BeginScene之后在主线程调用，准备count个空的提交列表（例如每个场景分区一个）
+        static void PrepareCommandLists(uint32_t count);
+        static RenderCommandList& GetCommandList(uint32_t index) { return s_CommandLists[index]; }
+        static uint32_t GetCommandListCount() { return s_CommandListCount; }
+        // 可在工作线程上调用，每个列表同时只能由一个线程写入；EndScene时各列表并行排序，
+        // 再与主线程提交的物体按排序键归并，键相同时主线程的物体在前，其余按列表编号
+        // 归并按键的范围分段在JobSystem上并行，每段记录到自己的命令缓冲，按顺序执行即为完整的命令流
+        static void Submit(RenderCommandList& list, const std::shared_ptr<Model>& model, const glm::mat4& transform,
+                          const std::shared_ptr<Material>& material = nullptr);
+
         // 基础几何体渲染
         static void DrawCube(const glm::vec3& position, const glm::vec3& size,
                            const glm::vec4& color = glm::vec4(1.0f));
@@ -58,6 +66,9 @@ namespace JFM {
         // 实例化渲染
         static void DrawInstanced(const std::shared_ptr<Model>& model,
                                 const std::vector<glm::mat4>& transforms);
+        // 变换矩阵可以来自FrameVector等任意连续存储
+        static void DrawInstanced(const std::shared_ptr<Model>& model,
+                                const glm::mat4* transforms, size_t count);
 
         // 天空盒渲染
         static void SetSkybox(const std::shared_ptr<Texture>& skybox);
@@ -74,6 +85,11 @@ namespace JFM {
 
         // 调试和性能
         static const Renderer3DStats& GetStats();
+        // 本帧主线程提交的渲染队列，EndScene之后为排序后的顺序
+        static const RenderQueue& GetRenderQueue() { return s_RenderQueue; }
+        // 本帧记录的命令，EndScene之后有效；按编号顺序连接即为完整的命令流
+        static uint32_t GetCommandBufferCount() { return s_CommandBufferCount; }
+        static const CommandBuffer& GetCommandBuffer(uint32_t index) { return s_CommandBuffers[index]; }
         static void ResetStats();
 
         // 渲染设置
@@ -88,10 +104,17 @@ namespace JFM {
         static void RenderOpaqueObjects();
         static void RenderTransparentObjects();
         static void RenderPostProcessing();
+        static void ResetFrameQueues();
 
         static Renderer3DStats s_Stats;
-        static std::vector<RenderItem> s_OpaqueQueue;
-        static std::vector<RenderItem> s_TransparentQueue;
+        // 渲染队列与光源只在一帧内有效，放在帧分配器上
+        static RenderQueue s_RenderQueue;
+        // 工作线程的提交列表和各段的命令缓冲，数量只增不减以保留容量
+        static std::vector<RenderCommandList> s_CommandLists;
+        static uint32_t s_CommandListCount;
+        static std::vector<CommandBuffer> s_CommandBuffers;
+        static uint32_t s_CommandBufferCount;
+        static glm::vec4 s_DepthPlane;      // 点积得到归一化的视线方向深度
 
         static std::shared_ptr<Shader> s_DefaultShader;
         static std::shared_ptr<Shader> s_ShadowShader;
@@ -100,7 +123,7 @@ namespace JFM {
 
         static std::shared_ptr<Texture> s_Skybox;
         static Camera s_Camera;
-        static std::vector<Light> s_Lights;
+        static FrameVector<Light> s_Lights;
 
         static bool s_ShadowsEnabled;
         static bool s_PostProcessingEnabled;
@@ -12,6 +12,7 @@
 namespace JFM {
 
     class VertexArray;
+    class CommandBuffer;
 
     // 前向声明多边形模式枚举
     enum class PolygonMode;
@@ -37,10 +38,18 @@ namespace JFM {
 
         virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
         virtual void DrawArrays(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+        // 顶点数组已绑定，按给定的数量绘制
+        virtual void DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount) = 0;
+        virtual void DrawArrays(const VertexArray& vertexArray, uint32_t vertexCount) = 0;
 
         virtual void SetPolygonMode(PolygonMode mode) = 0;
 
+        // 按顺序执行命令缓冲中的命令，默认逐条调用上面的接口和着色器、材质、网格
+        virtual void Execute(const CommandBuffer& commands);
+
         static API GetAPI() { return s_API; }
+        // 选择图形后端，需在创建任何图形资源之前调用；None时网格只保留几何数据
+        static void SetAPI(API api) { s_API = api; }
         static std::unique_ptr<RendererAPI> Create();
 
     private:
@@ -8,6 +8,7 @@
 #include <glm/glm.hpp>
 #include <string>
 #include <unordered_map>
+#include <cstdint>
 
 namespace JFM {
 
@@ -30,8 +31,17 @@ namespace JFM {
 
         virtual const std::string& GetName() const = 0;
 
+        // 创建时分配的编号，从1开始，用于渲染队列的排序键
+        uint32_t GetSortID() const { return m_SortID; }
+
         static std::shared_ptr<Shader> Create(const std::string& filepath);
         static std::shared_ptr<Shader> Create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+
+    protected:
+        Shader();
+
+    private:
+        uint32_t m_SortID;
     };
 
     class JFM_API ShaderLibrary {
@@ -1,17 +1,48 @@
 #pragma once
 
+#include "JFMEngine/Core/LockFreeQueue.h"
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <type_traits>
+#include <cstdint>
 #include <mutex>
 #include <thread>
-#include <queue>
 #include <condition_variable>
 #include <chrono>
+#include <ctime>
 #include <atomic>
 
+// 编译期日志级别：低于该级别的日志宏展开为空，参数不会被求值
+// 0=TRACE 1=DEBUG 2=INFO 3=WARN 4=ERROR 5=CRITICAL 6=OFF
+#define JFM_LOG_LEVEL_TRACE    0
+#define JFM_LOG_LEVEL_DEBUG    1
+#define JFM_LOG_LEVEL_INFO     2
+#define JFM_LOG_LEVEL_WARN     3
+#define JFM_LOG_LEVEL_ERROR    4
+#define JFM_LOG_LEVEL_CRITICAL 5
+#define JFM_LOG_LEVEL_OFF      6
+
+#ifndef JFM_ACTIVE_LOG_LEVEL
+    #ifdef NDEBUG
+        #define JFM_ACTIVE_LOG_LEVEL JFM_LOG_LEVEL_INFO
+    #else
+        #define JFM_ACTIVE_LOG_LEVEL JFM_LOG_LEVEL_TRACE
+    #endif
+#endif
+
+// C++20下格式串在编译期解析和校验，C++17下退化为constexpr
+#if defined(__cpp_consteval)
+    #define JFM_LOG_CONSTEVAL consteval
+#else
+    #define JFM_LOG_CONSTEVAL constexpr
+#endif
+
 namespace JFM {
 
     // 日志级别
@@ -24,14 +55,20 @@ namespace JFM {
         CRITICAL = 5
     };
 
+    // 编译期是否保留该级别的日志
+    constexpr bool is_log_level_active(LogLevel level) {
+        return static_cast<int>(level) >= JFM_ACTIVE_LOG_LEVEL;
+    }
+
     // 日志消息结构
     struct LogMessage {
-        LogLevel level;
+        LogLevel level = LogLevel::INFO;
         std::string logger_name;
         std::string message;
         std::chrono::system_clock::time_point timestamp;
         std::thread::id thread_id;
 
+        LogMessage() = default;
         LogMessage(LogLevel lvl, std::string name, std::string msg)
             : level(lvl), logger_name(std::move(name)), message(std::move(msg)),
               timestamp(std::chrono::system_clock::now()),
@@ -45,6 +82,16 @@ namespace JFM {
         virtual void log(const LogMessage& msg) = 0;
         virtual void flush() {}
 
+        // 工作线程一次交付一批消息，默认逐条调用log
+        virtual void log_batch(const LogMessage* msgs, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                log(msgs[i]);
+            }
+        }
+
+        // 工作线程空闲时调用，用于按时间间隔刷新缓冲
+        virtual void poll_flush() {}
+
         void set_level(LogLevel level) { level_ = level; }
         [[nodiscard]] LogLevel get_level() const { return level_; }
 
@@ -60,64 +107,411 @@ namespace JFM {
     public:
         explicit ConsoleSink(bool use_colors = true) : use_colors_(use_colors) {}
         void log(const LogMessage& msg) override;
+        void log_batch(const LogMessage* msgs, size_t count) override;
 
     private:
+        void format_line(std::string& out, const LogMessage& msg);
         [[nodiscard]] static std::string get_color_code(LogLevel level);
         [[nodiscard]] static std::string get_level_string(LogLevel level);
         bool use_colors_;
         std::mutex mutex_;
+        std::string out_buffer_;
+        std::string err_buffer_;
     };
 
-    // 文件输出
-    class FileSink : public LogSink {
+    // 文件刷新策略：满足任一条件即写入文件
+    struct FlushPolicy {
+        size_t max_buffered_bytes = 64 * 1024;                 // 缓冲达到该大小
+        std::chrono::milliseconds interval{1000};               // 距上次写入超过该时间
+        LogLevel flush_level = LogLevel::ERROR;                 // 出现该级别及以上的消息
+    };
+
+    // 带缓冲的文件输出基类：整批消息格式化进可复用的缓冲区，再用一次write/writev写出
+    class BufferedFileSink : public LogSink {
     public:
-        explicit FileSink(const std::string& filename);
-        ~FileSink() override;
+        ~BufferedFileSink() override;
         void log(const LogMessage& msg) override;
+        void log_batch(const LogMessage* msgs, size_t count) override;
         void flush() override;
+        void poll_flush() override;
+
+        void set_flush_policy(const FlushPolicy& policy);
+        [[nodiscard]] FlushPolicy get_flush_policy() const { return policy_; }
+
+    protected:
+        BufferedFileSink(const std::string& filename, bool truncate);
+
+        // 即将写入bytes字节，派生类可在此轮转文件
+        virtual void before_write(size_t /*bytes*/) {}
+
+        void open_file(const std::string& filename, bool truncate);
+        void close_file();
+
+        int fd_ = -1;
 
     private:
-        [[nodiscard]] static std::string get_level_string(LogLevel level);
-        std::ofstream file_;
+        void append_message(const LogMessage& msg);
+        void append_prefix(const LogMessage& msg);
+        void write_buffer();
+        void write_large(const LogMessage& msg);
+
+        FlushPolicy policy_;
         std::mutex mutex_;
+        std::string buffer_;
+        std::string prefix_;
+        std::chrono::steady_clock::time_point last_write_;
+
+        // 时间戳和线程ID的格式化结果缓存
+        std::time_t cached_time_ = 0;
+        char cached_time_str_[32] = {};
+        std::thread::id cached_thread_id_;
+        std::string cached_thread_str_;
+    };
+
+    // 文件输出
+    class FileSink : public BufferedFileSink {
+    public:
+        explicit FileSink(const std::string& filename);
     };
 
     // 轮转文件输出
-    class RotatingFileSink : public LogSink {
+    class RotatingFileSink : public BufferedFileSink {
     public:
         RotatingFileSink(const std::string& base_filename, size_t max_size, size_t max_files);
         ~RotatingFileSink() override;
-        void log(const LogMessage& msg) override;
-        void flush() override;
+
+    protected:
+        void before_write(size_t bytes) override;
 
     private:
         void rotate_file();
-        [[nodiscard]] static std::string get_level_string(LogLevel level);
 
         std::string base_filename_;
         size_t max_size_;
         size_t max_files_;
         size_t current_size_;
-        std::ofstream file_;
-        std::mutex mutex_;
     };
 
-    // 格式化辅助函数声明
-    template<typename T, typename... Args>
-    void format_recursive(std::ostringstream& oss, const std::string& fmt, size_t& pos, size_t& arg_index, T&& value, Args&&... args);
+    // 延迟格式化：调用线程只把参数编码进固定大小的日志记录，由工作线程负责格式化
+    namespace log_detail {
+
+        template<typename T>
+        struct type_identity { using type = T; };
+
+        template<typename T>
+        using type_identity_t = typename type_identity<T>::type;
+
+        // 预先解析的占位符位置
+        struct FormatSlot {
+            uint16_t begin = UINT16_MAX; // '{' 的位置，UINT16_MAX表示没有对应占位符（参数被忽略）
+            uint16_t end = UINT16_MAX;   // '}' 之后的位置
+            bool hex = false;            // {:x}
+        };
+
+        // 解析最多max_slots个 {} / {:x} 占位符，返回格式串中占位符的总数
+        constexpr size_t parse_format(const char* fmt, FormatSlot* slots, size_t max_slots) {
+            size_t count = 0;
+            for (size_t pos = 0; fmt[pos] != '\0' && pos < UINT16_MAX; ++pos) {
+                if (fmt[pos] != '{') {
+                    continue;
+                }
+
+                size_t close = pos + 1;
+                bool in_spec = false;
+                bool hex = false;
+                while (fmt[close] != '\0' && fmt[close] != '}') {
+                    if (fmt[close] == ':') {
+                        in_spec = true;
+                    } else if (in_spec && (fmt[close] == 'x' || fmt[close] == 'X')) {
+                        hex = true;
+                    }
+                    ++close;
+                }
+                if (fmt[close] != '}' || close + 1 >= UINT16_MAX) {
+                    // 未闭合的 '{' 按普通文本处理
+                    break;
+                }
+
+                if (count < max_slots) {
+                    slots[count].begin = static_cast<uint16_t>(pos);
+                    slots[count].end = static_cast<uint16_t>(close + 1);
+                    slots[count].hex = hex;
+                }
+                ++count;
+                pos = close;
+            }
+            return count;
+        }
+
+        // 非constexpr函数：在编译期求值中被调用即产生编译错误
+        inline void format_error(const char*) {}
+
+    } // namespace log_detail
+
+    // 编译期解析的格式串，记录每个参数对应的占位符位置
+    template<typename... Args>
+    class BasicFormatString {
+    public:
+        static constexpr size_t ArgCount = sizeof...(Args);
+
+        template<size_t N>
+        JFM_LOG_CONSTEVAL BasicFormatString(const char (&fmt)[N]) : str_(fmt) {
+            size_t count = log_detail::parse_format(fmt, slots_, ArgCount);
+            if (count != ArgCount) {
+                log_detail::format_error("number of {} placeholders does not match number of arguments");
+            }
+        }
+
+        [[nodiscard]] constexpr const char* get() const { return str_; }
+        [[nodiscard]] constexpr const log_detail::FormatSlot* slots() const { return slots_; }
+
+    private:
+        const char* str_;
+        log_detail::FormatSlot slots_[ArgCount > 0 ? ArgCount : 1] = {};
+    };
+
+    template<typename... Args>
+    using FormatString = BasicFormatString<log_detail::type_identity_t<std::decay_t<Args>>...>;
+
+    namespace log_detail {
+
+        template<typename T, typename = void>
+        struct is_streamable : std::false_type {};
+
+        template<typename T>
+        struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream&>() << std::declval<const T&>())>>
+            : std::true_type {};
+
+        template<typename T>
+        struct is_string_arg : std::bool_constant<
+            std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+            std::is_same_v<T, const char*> || std::is_same_v<T, char*>> {};
+
+        // 可以按字节复制到记录中、由工作线程格式化的参数类型：算术类型、枚举、非字符串指针（只输出地址）
+        // 其他类型即使可平凡复制也可能持有指针（如视图类型），在调用线程转换成文本，避免工作线程访问悬空数据
+        template<typename T>
+        struct is_bytewise_arg : std::bool_constant<
+            std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+            (std::is_pointer_v<T> && !is_string_arg<T>::value)> {};
+
+        // 参数在记录中的存储类型：按字节复制的类型保持原样，其余都以文本形式保存
+        template<typename T>
+        using stored_type_t = std::conditional_t<
+            is_bytewise_arg<std::decay_t<T>>::value, std::decay_t<T>, std::string_view>;
+
+        // 参数编码器，超出初始缓冲后转存到按需增长的堆缓冲，每个参数只编码一次
+        class ArgWriter {
+        public:
+            ArgWriter(unsigned char* data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+            void write(const void* src, size_t size) {
+                if (size_ + size > capacity_) {
+                    grow(size_ + size);
+                }
+                std::memcpy(data_ + size_, src, size);
+                size_ += size;
+            }
+
+            void write_string(std::string_view str) {
+                auto length = static_cast<uint32_t>(str.size());
+                write(&length, sizeof(length));
+                write(str.data(), length);
+            }
+
+            [[nodiscard]] size_t size() const { return size_; }
+            [[nodiscard]] bool overflowed() const { return heap_ != nullptr; }
+
+            // 取走溢出时的堆缓冲，其中包含全部已编码的参数
+            std::unique_ptr<unsigned char[]> release_heap() { return std::move(heap_); }
+
+        private:
+            void grow(size_t required) {
+                size_t capacity = std::max(required, capacity_ * 2);
+                std::unique_ptr<unsigned char[]> heap(new unsigned char[capacity]);
+                std::memcpy(heap.get(), data_, size_);
+                heap_ = std::move(heap);
+                data_ = heap_.get();
+                capacity_ = capacity;
+            }
+
+            unsigned char* data_;
+            size_t capacity_;
+            size_t size_ = 0;
+            std::unique_ptr<unsigned char[]> heap_;
+        };
+
+        std::ostringstream& thread_stream();
+
+        template<typename T>
+        void encode_arg(ArgWriter& writer, const T& value) {
+            using D = std::decay_t<T>;
+            if constexpr (is_string_arg<D>::value) {
+                if constexpr (std::is_pointer_v<D>) {
+                    writer.write_string(value ? std::string_view(value) : std::string_view("(null)"));
+                } else {
+                    writer.write_string(value);
+                }
+            } else if constexpr (is_bytewise_arg<D>::value) {
+                D copy = value;
+                writer.write(&copy, sizeof(D));
+            } else {
+                // 其他类型只能在调用线程转换成文本
+                std::ostringstream& oss = thread_stream();
+                oss.str(std::string());
+                oss.clear();
+                oss << value;
+                writer.write_string(oss.str());
+            }
+        }
+
+        template<typename T>
+        T decode_arg(const unsigned char*& cursor) {
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                uint32_t length = 0;
+                std::memcpy(&length, cursor, sizeof(length));
+                std::string_view str(reinterpret_cast<const char*>(cursor + sizeof(length)), length);
+                cursor += sizeof(length) + length;
+                return str;
+            } else {
+                alignas(T) unsigned char storage[sizeof(T)];
+                std::memcpy(storage, cursor, sizeof(T));
+                cursor += sizeof(T);
+                return *std::launder(reinterpret_cast<T*>(storage));
+            }
+        }
+
+        void append_signed(std::string& out, long long value, bool hex);
+        void append_unsigned(std::string& out, unsigned long long value, bool hex);
+        void append_float(std::string& out, double value);
+        void append_pointer(std::string& out, const void* value);
+
+        template<typename T>
+        void append_value(std::string& out, const T& value, bool hex) {
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                out.append(value);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                out += value ? '1' : '0';
+            } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                                 std::is_same_v<T, unsigned char>) {
+                out += static_cast<char>(value);
+            } else if constexpr (std::is_integral_v<T>) {
+                if constexpr (std::is_signed_v<T>) {
+                    append_signed(out, value, hex);
+                } else {
+                    append_unsigned(out, value, hex);
+                }
+            } else if constexpr (std::is_floating_point_v<T>) {
+                append_float(out, static_cast<double>(value));
+            } else if constexpr (std::is_pointer_v<T>) {
+                append_pointer(out, static_cast<const void*>(value));
+            } else if constexpr (is_streamable<T>::value) {
+                std::ostringstream& oss = thread_stream();
+                oss.str(std::string());
+                oss.clear();
+                oss << value;
+                out += oss.str();
+            } else if constexpr (std::is_enum_v<T>) {
+                append_value(out, static_cast<std::underlying_type_t<T>>(value), hex);
+            } else {
+                static_assert(is_streamable<T>::value, "Log argument type has no operator<<");
+            }
+        }
+
+        // 记录中参数区的布局：先是每个参数的FormatSlot，然后是编码后的参数
+        template<typename... Args>
+        void encode_args(ArgWriter& writer, const FormatSlot* slots, const Args&... args) {
+            writer.write(slots, sizeof(FormatSlot) * sizeof...(Args));
+            (encode_arg(writer, args), ...);
+        }
+
+        // 按预先解析的位置拼接文本和参数，工作线程上不再扫描格式串
+        class Formatter {
+        public:
+            Formatter(std::string& out, const char* fmt) : out_(out), fmt_(fmt) {}
+
+            template<typename T>
+            void arg(const FormatSlot& slot, const T& value) {
+                if (slot.begin == UINT16_MAX) {
+                    return;
+                }
+                out_.append(fmt_ + literal_begin_, slot.begin - literal_begin_);
+                append_value(out_, value, slot.hex);
+                literal_begin_ = slot.end;
+            }
+
+            void finish() { out_.append(fmt_ + literal_begin_); }
+
+        private:
+            std::string& out_;
+            const char* fmt_;
+            size_t literal_begin_ = 0;
+        };
+
+        template<typename... Args>
+        void format_args(std::string& out, const char* fmt, const unsigned char* args) {
+            constexpr size_t count = sizeof...(Args);
+            FormatSlot slots[count > 0 ? count : 1];
+            std::memcpy(slots, args, sizeof(FormatSlot) * count);
+
+            Formatter formatter(out, fmt);
+            const unsigned char* cursor = args + sizeof(FormatSlot) * count;
+            size_t index = 0;
+            (void)cursor;
+            (void)index;
+            (formatter.arg(slots[index++], decode_arg<stored_type_t<Args>>(cursor)), ...);
+            formatter.finish();
+        }
 
-    void format_recursive(std::ostringstream& oss, const std::string& fmt, size_t& pos, size_t& arg_index);
+    } // namespace log_detail
 
-    // 格式化字符串函数
+    // 固定大小的二进制日志记录，参数放不下时转存到堆上
+    struct LogRecord {
+        using FormatFunc = void (*)(std::string& out, const char* fmt, const unsigned char* args);
+
+        static constexpr size_t RecordSize = 256;
+        static constexpr size_t InlineArgsSize = RecordSize - 6 * sizeof(void*);
+
+        const char* fmt = nullptr;              // 格式串（字符串字面量）
+        FormatFunc format = nullptr;            // 按参数类型生成的格式化函数
+        unsigned char* heap_args = nullptr;     // 参数超出内联容量时的堆缓冲
+        std::chrono::system_clock::time_point timestamp;
+        std::thread::id thread_id;
+        LogLevel level = LogLevel::INFO;
+        unsigned char args[InlineArgsSize];
+
+        [[nodiscard]] const unsigned char* args_data() const { return heap_args ? heap_args : args; }
+    };
+
+    static_assert(sizeof(LogRecord) <= LogRecord::RecordSize, "LogRecord must stay within one fixed-size slot");
+    static_assert(std::is_trivially_copyable_v<LogRecord>, "LogRecord is copied bytewise through the ring");
+
+    // 格式化字符串函数（立即格式化，用于运行时的格式串）
     template<typename... Args>
     std::string format_string(const std::string& fmt, Args&&... args) {
-        std::ostringstream oss;
-        size_t pos = 0;
-        size_t arg_index = 0;
-        format_recursive(oss, fmt, pos, arg_index, std::forward<Args>(args)...);
-        return oss.str();
+        log_detail::FormatSlot slots[sizeof...(Args) > 0 ? sizeof...(Args) : 1] = {};
+        log_detail::parse_format(fmt.c_str(), slots, sizeof...(Args));
+
+        unsigned char inline_args[LogRecord::InlineArgsSize];
+        log_detail::ArgWriter writer(inline_args, sizeof(inline_args));
+        log_detail::encode_args(writer, slots, args...);
+
+        std::unique_ptr<unsigned char[]> heap_args = writer.release_heap();
+        const unsigned char* data = heap_args ? heap_args.get() : inline_args;
+
+        std::string result;
+        log_detail::format_args<std::decay_t<Args>...>(result, fmt.c_str(), data);
+        return result;
     }
 
+    // 日志队列：任意线程写入，只有日志器的工作线程读取
+    using LogQueue = LockFreeQueue<LogRecord, 4096, ProducerPolicy::Multi, ConsumerPolicy::Single>;
+
+    // 队列满时的处理策略
+    enum class LogOverflowPolicy {
+        Block, // 等待工作线程消费，保证不丢日志
+        Drop   // 直接丢弃并计数
+    };
+
     // 异步日志器
     class AsyncLogger {
     public:
@@ -128,49 +522,77 @@ namespace JFM {
         void set_level(LogLevel level) { level_ = level; }
         [[nodiscard]] LogLevel get_level() const { return level_; }
 
-        void log(LogLevel level, const std::string& message);
+        void set_overflow_policy(LogOverflowPolicy policy) { overflow_policy_ = policy; }
+        [[nodiscard]] LogOverflowPolicy get_overflow_policy() const { return overflow_policy_; }
+        [[nodiscard]] uint64_t get_dropped_count() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+        // 输出已经格式化好的文本
+        void log(LogLevel level, std::string_view message);
+
+        // 延迟格式化：参数编码进记录，由工作线程格式化
+        template<typename... Args>
+        void log_deferred(LogLevel level, const BasicFormatString<Args...>& fmt, const Args&... args);
+
+        // 等待工作线程处理完调用前已入队的记录，再刷新所有sink
         void flush();
 
         // 便捷方法
-        void trace(const std::string& message);
-        void debug(const std::string& message);
-        void info(const std::string& message);
-        void warn(const std::string& message);
-        void error(const std::string& message);
-        void critical(const std::string& message);
-
-        // 模板方法用于格式化参数
+        void trace(std::string_view message);
+        void debug(std::string_view message);
+        void info(std::string_view message);
+        void warn(std::string_view message);
+        void error(std::string_view message);
+        void critical(std::string_view message);
+
+        // 模板方法用于格式化参数：格式串必须是字面量，在编译期解析；运行时格式串请先调用format_string
         template<typename... Args>
-        void trace(const std::string& fmt, Args&&... args);
+        void trace(FormatString<Args...> fmt, Args&&... args);
 
         template<typename... Args>
-        void debug(const std::string& fmt, Args&&... args);
+        void debug(FormatString<Args...> fmt, Args&&... args);
 
         template<typename... Args>
-        void info(const std::string& fmt, Args&&... args);
+        void info(FormatString<Args...> fmt, Args&&... args);
 
         template<typename... Args>
-        void warn(const std::string& fmt, Args&&... args);
+        void warn(FormatString<Args...> fmt, Args&&... args);
 
         template<typename... Args>
-        void error(const std::string& fmt, Args&&... args);
+        void error(FormatString<Args...> fmt, Args&&... args);
 
         template<typename... Args>
-        void critical(const std::string& fmt, Args&&... args);
+        void critical(FormatString<Args...> fmt, Args&&... args);
 
     private:
         [[nodiscard]] bool should_log(LogLevel level) const { return level >= level_; }
         void worker_function();
+        void dispatch_batch(size_t count);
+
+        // 记录已在调用线程编码完成，写入队列槽位只是一次按字节复制
+        void enqueue_record(const LogRecord& record);
 
         std::string name_;
         LogLevel level_;
         std::vector<std::shared_ptr<LogSink>> sinks_;
 
-        std::queue<LogMessage> message_queue_;
-        std::mutex queue_mutex_;
+        std::unique_ptr<LogQueue> message_queue_;
+        std::mutex queue_mutex_; // 仅用于工作线程休眠等待
         std::condition_variable queue_cv_;
         std::thread worker_thread_;
         std::atomic<bool> should_stop_;
+        LogOverflowPolicy overflow_policy_ = LogOverflowPolicy::Block;
+        std::atomic<uint64_t> dropped_count_{0};
+
+        // 工作线程已处理的累计记录数，与队列的写入位置比较来判断flush是否完成
+        std::atomic<size_t> consumed_count_{0};
+        std::atomic<uint32_t> flush_waiters_{0};
+        std::mutex flush_mutex_;
+        std::condition_variable flush_cv_;
+
+        // 工作线程批量取出的记录及其格式化结果，反复复用
+        static constexpr size_t BatchSize = 64;
+        std::vector<LogRecord> record_batch_;
+        std::vector<LogMessage> message_batch_;
     };
 
     // 主日志类
@@ -188,85 +610,121 @@ namespace JFM {
         static bool s_Initialized;
     };
 
-    // 格式化辅助函数实现
-    template<typename T, typename... Args>
-    void format_recursive(std::ostringstream& oss, const std::string& fmt, size_t& pos, size_t& arg_index, T&& value, Args&&... args) {
-        // 查找下一个占位符 {}
-        size_t placeholder_pos = fmt.find("{}", pos);
-        if (placeholder_pos != std::string::npos) {
-            // 添加占位符之前的文本
-            oss << fmt.substr(pos, placeholder_pos - pos);
-            // 添加参数值
-            oss << value;
-            // 更新位置
-            pos = placeholder_pos + 2;
-            arg_index++;
-            // 递归处理剩余参数
-            format_recursive(oss, fmt, pos, arg_index, std::forward<Args>(args)...);
-        } else {
-            // 没有更多占位符，添加剩余文本
-            oss << fmt.substr(pos);
-        }
+    // 模板实现
+    template<typename... Args>
+    void AsyncLogger::log_deferred(LogLevel level, const BasicFormatString<Args...>& fmt, const Args&... args) {
+        if (!should_log(level)) return;
+
+        // 先在栈上编码参数，用户的operator<<和堆转存都发生在占用队列槽位之前，
+        // 抛出异常或在其中再次写日志都不会影响队列
+        LogRecord record;
+        record.fmt = fmt.get();
+        record.format = &log_detail::format_args<Args...>;
+        record.timestamp = std::chrono::system_clock::now();
+        record.thread_id = std::this_thread::get_id();
+        record.level = level;
+
+        log_detail::ArgWriter writer(record.args, sizeof(record.args));
+        log_detail::encode_args(writer, fmt.slots(), args...);
+        // 参数太大时已转存到堆上，由工作线程格式化后释放
+        record.heap_args = writer.release_heap().release();
+
+        enqueue_record(record);
     }
 
-    // 模板实现
     template<typename... Args>
-    void AsyncLogger::trace(const std::string& fmt, Args&&... args) {
-        if (should_log(LogLevel::TRACE)) {
-            log(LogLevel::TRACE, format_string(fmt, std::forward<Args>(args)...));
+    void AsyncLogger::trace(FormatString<Args...> fmt, Args&&... args) {
+        if constexpr (is_log_level_active(LogLevel::TRACE)) {
+            log_deferred<std::decay_t<Args>...>(LogLevel::TRACE, fmt, args...);
         }
     }
 
     template<typename... Args>
-    void AsyncLogger::debug(const std::string& fmt, Args&&... args) {
-        if (should_log(LogLevel::DEBUG)) {
-            log(LogLevel::DEBUG, format_string(fmt, std::forward<Args>(args)...));
+    void AsyncLogger::debug(FormatString<Args...> fmt, Args&&... args) {
+        if constexpr (is_log_level_active(LogLevel::DEBUG)) {
+            log_deferred<std::decay_t<Args>...>(LogLevel::DEBUG, fmt, args...);
         }
     }
 
     template<typename... Args>
-    void AsyncLogger::info(const std::string& fmt, Args&&... args) {
-        if (should_log(LogLevel::INFO)) {
-            log(LogLevel::INFO, format_string(fmt, std::forward<Args>(args)...));
+    void AsyncLogger::info(FormatString<Args...> fmt, Args&&... args) {
+        if constexpr (is_log_level_active(LogLevel::INFO)) {
+            log_deferred<std::decay_t<Args>...>(LogLevel::INFO, fmt, args...);
         }
     }
 
     template<typename... Args>
-    void AsyncLogger::warn(const std::string& fmt, Args&&... args) {
-        if (should_log(LogLevel::WARN)) {
-            log(LogLevel::WARN, format_string(fmt, std::forward<Args>(args)...));
+    void AsyncLogger::warn(FormatString<Args...> fmt, Args&&... args) {
+        if constexpr (is_log_level_active(LogLevel::WARN)) {
+            log_deferred<std::decay_t<Args>...>(LogLevel::WARN, fmt, args...);
         }
     }
 
     template<typename... Args>
-    void AsyncLogger::error(const std::string& fmt, Args&&... args) {
-        if (should_log(LogLevel::ERROR)) {
-            log(LogLevel::ERROR, format_string(fmt, std::forward<Args>(args)...));
+    void AsyncLogger::error(FormatString<Args...> fmt, Args&&... args) {
+        if constexpr (is_log_level_active(LogLevel::ERROR)) {
+            log_deferred<std::decay_t<Args>...>(LogLevel::ERROR, fmt, args...);
         }
     }
 
     template<typename... Args>
-    void AsyncLogger::critical(const std::string& fmt, Args&&... args) {
-        if (should_log(LogLevel::CRITICAL)) {
-            log(LogLevel::CRITICAL, format_string(fmt, std::forward<Args>(args)...));
+    void AsyncLogger::critical(FormatString<Args...> fmt, Args&&... args) {
+        if constexpr (is_log_level_active(LogLevel::CRITICAL)) {
+            log_deferred<std::decay_t<Args>...>(LogLevel::CRITICAL, fmt, args...);
         }
     }
 
 } // namespace JFM
 
-// 便捷宏定义
-#define JFM_CORE_TRACE(...)    ::JFM::Log::GetCoreLogger()->trace(__VA_ARGS__)
-#define JFM_CORE_DEBUG(...)    ::JFM::Log::GetCoreLogger()->debug(__VA_ARGS__)
-#define JFM_CORE_INFO(...)     ::JFM::Log::GetCoreLogger()->info(__VA_ARGS__)
-#define JFM_CORE_WARN(...)     ::JFM::Log::GetCoreLogger()->warn(__VA_ARGS__)
-#define JFM_CORE_ERROR(...)    ::JFM::Log::GetCoreLogger()->error(__VA_ARGS__)
-#define JFM_CORE_CRITICAL(...) ::JFM::Log::GetCoreLogger()->critical(__VA_ARGS__)
-
-#define JFM_TRACE(...)         ::JFM::Log::GetClientLogger()->trace(__VA_ARGS__)
-#ifndef JFM_DEBUG
-#define JFM_DEBUG(...)         ::JFM::Log::GetClientLogger()->debug(__VA_ARGS__)
+// 便捷宏定义，低于JFM_ACTIVE_LOG_LEVEL的调用在编译期被移除
+#if JFM_ACTIVE_LOG_LEVEL <= JFM_LOG_LEVEL_TRACE
+    #define JFM_CORE_TRACE(...)    ::JFM::Log::GetCoreLogger()->trace(__VA_ARGS__)
+    #define JFM_TRACE(...)         ::JFM::Log::GetClientLogger()->trace(__VA_ARGS__)
+#else
+    #define JFM_CORE_TRACE(...)    ((void)0)
+    #define JFM_TRACE(...)         ((void)0)
+#endif
+
+#if JFM_ACTIVE_LOG_LEVEL <= JFM_LOG_LEVEL_DEBUG
+    #define JFM_CORE_DEBUG(...)    ::JFM::Log::GetCoreLogger()->debug(__VA_ARGS__)
+    #ifndef JFM_DEBUG
+    #define JFM_DEBUG(...)         ::JFM::Log::GetClientLogger()->debug(__VA_ARGS__)
+    #endif
+#else
+    #define JFM_CORE_DEBUG(...)    ((void)0)
+    #ifndef JFM_DEBUG
+    #define JFM_DEBUG(...)         ((void)0)
+    #endif
+#endif
+
+#if JFM_ACTIVE_LOG_LEVEL <= JFM_LOG_LEVEL_INFO
+    #define JFM_CORE_INFO(...)     ::JFM::Log::GetCoreLogger()->info(__VA_ARGS__)
+    #define JFM_INFO(...)          ::JFM::Log::GetClientLogger()->info(__VA_ARGS__)
+#else
+    #define JFM_CORE_INFO(...)     ((void)0)
+    #define JFM_INFO(...)          ((void)0)
+#endif
+
+#if JFM_ACTIVE_LOG_LEVEL <= JFM_LOG_LEVEL_WARN
+    #define JFM_CORE_WARN(...)     ::JFM::Log::GetCoreLogger()->warn(__VA_ARGS__)
+    #define JFM_WARN(...)          ::JFM::Log::GetClientLogger()->warn(__VA_ARGS__)
+#else
+    #define JFM_CORE_WARN(...)     ((void)0)
+    #define JFM_WARN(...)          ((void)0)
+#endif
+
+#if JFM_ACTIVE_LOG_LEVEL <= JFM_LOG_LEVEL_ERROR
+    #define JFM_CORE_ERROR(...)    ::JFM::Log::GetCoreLogger()->error(__VA_ARGS__)
+    #define JFM_ERROR(...)         ::JFM::Log::GetClientLogger()->error(__VA_ARGS__)
+#else
+    #define JFM_CORE_ERROR(...)    ((void)0)
+    #define JFM_ERROR(...)         ((void)0)
+#endif
+
+#if JFM_ACTIVE_LOG_LEVEL <= JFM_LOG_LEVEL_CRITICAL
+    #define JFM_CORE_CRITICAL(...) ::JFM::Log::GetCoreLogger()->critical(__VA_ARGS__)
+    #define JFM_CRITICAL(...)      ::JFM::Log::GetClientLogger()->critical(__VA_ARGS__)
+#else
+    #define JFM_CORE_CRITICAL(...) ((void)0)
+    #define JFM_CRITICAL(...)      ((void)0)
 #endif
-#define JFM_INFO(...)          ::JFM::Log::GetClientLogger()->info(__VA_ARGS__)
-#define JFM_WARN(...)          ::JFM::Log::GetClientLogger()->warn(__VA_ARGS__)
-#define JFM_ERROR(...)         ::JFM::Log::GetClientLogger()->error(__VA_ARGS__)
-#define JFM_CRITICAL(...)      ::JFM::Log::GetClientLogger()->critical(__VA_ARGS__)
@@ -3,6 +3,8 @@
 //
 
 #include "JFMEngine/Core/Application.h"
+#include "JFMEngine/Core/FrameArena.h"
+#include "JFMEngine/Core/JobSystem.h"
 #include "JFMEngine/Utils/Log.h"
 #include "JFMEngine/Events/KeyEvent.h"
 #include "JFMEngine/Events/MouseEvent.h"
@@ -70,6 +72,7 @@ namespace JFM {
 
         // 关闭Core事件系统
         JFM::EventSystem::GetInstance().Shutdown();
+        JFM::JobSystem::GetInstance().Shutdown();
 
         if (m_Window)
         {
@@ -86,6 +89,9 @@ namespace JFM {
 
         while (!glfwWindowShouldClose(m_Window) && m_Running)
         {
+            // 重置帧分配器，回收最早一帧的临时数据
+            JFM::FrameArena::GetInstance().BeginFrame();
+
             // 计算deltaTime
             float time = (float)glfwGetTime();
             float deltaTime = time - lastFrameTime;
@@ -163,6 +169,9 @@ namespace JFM {
     {
         // 初始化Core事件系统，使用多线程处理
         JFM::EventSystem::GetInstance().Initialize(2);
+
+        // 并行任务系统，供物理等模块拆分每帧计算
+        JFM::JobSystem::GetInstance().Initialize();
     }
 
     void Application::RegisterEventHandlers()
@@ -293,20 +302,17 @@ namespace JFM {
             {
                 case GLFW_PRESS:
                 {
-                    auto event = std::make_unique<JFM::KeyPressedEvent>(key, 0);
-                    JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+                    JFM::EventSystem::GetInstance().PostEvent<JFM::KeyPressedEvent>(key, 0);
                     break;
                 }
                 case GLFW_RELEASE:
                 {
-                    auto event = std::make_unique<JFM::KeyReleasedEvent>(key);
-                    JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+                    JFM::EventSystem::GetInstance().PostEvent<JFM::KeyReleasedEvent>(key);
                     break;
                 }
                 case GLFW_REPEAT:
                 {
-                    auto event = std::make_unique<JFM::KeyPressedEvent>(key, 1);
-                    JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+                    JFM::EventSystem::GetInstance().PostEvent<JFM::KeyPressedEvent>(key, 1);
                     break;
                 }
             }
@@ -318,14 +324,12 @@ namespace JFM {
             {
                 case GLFW_PRESS:
                 {
-                    auto event = std::make_unique<JFM::MouseButtonPressedEvent>(button);
-                    JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+                    JFM::EventSystem::GetInstance().PostEvent<JFM::MouseButtonPressedEvent>(button);
                     break;
                 }
                 case GLFW_RELEASE:
                 {
-                    auto event = std::make_unique<JFM::MouseButtonReleasedEvent>(button);
-                    JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+                    JFM::EventSystem::GetInstance().PostEvent<JFM::MouseButtonReleasedEvent>(button);
                     break;
                 }
             }
@@ -333,26 +337,22 @@ namespace JFM {
 
         glfwSetCursorPosCallback(m_Window, [](GLFWwindow* window, double xpos, double ypos)
         {
-            auto event = std::make_unique<JFM::MouseMovedEvent>((float)xpos, (float)ypos);
-            JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+            JFM::EventSystem::GetInstance().PostEvent<JFM::MouseMovedEvent>((float)xpos, (float)ypos);
         });
 
         glfwSetScrollCallback(m_Window, [](GLFWwindow* window, double xoffset, double yoffset)
         {
-            auto event = std::make_unique<JFM::MouseScrolledEvent>((float)xoffset, (float)yoffset);
-            JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+            JFM::EventSystem::GetInstance().PostEvent<JFM::MouseScrolledEvent>((float)xoffset, (float)yoffset);
         });
 
         glfwSetWindowCloseCallback(m_Window, [](GLFWwindow* window)
         {
-            auto event = std::make_unique<JFM::WindowCloseEvent>();
-            JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+            JFM::EventSystem::GetInstance().PostEvent<JFM::WindowCloseEvent>();
         });
 
         glfwSetWindowSizeCallback(m_Window, [](GLFWwindow* window, int width, int height)
         {
-            auto event = std::make_unique<JFM::WindowResizeEvent>(width, height);
-            JFM::EventSystem::GetInstance().PostEvent(std::move(event));
+            JFM::EventSystem::GetInstance().PostEvent<JFM::WindowResizeEvent>(width, height);
         });
 
     }
@@ -10,6 +10,60 @@
 
 namespace JFM {
 
+    // 分发时不加锁也不修改快照的引用计数：读者进入前登记，写者替换快照后若没有读者，
+    // 之后进入的读者只能看到新快照，此时释放所有被替换的快照；否则留到下一次替换或析构时释放
+    struct EventSystem::HandlerTables {
+        std::array<std::atomic<const HandlerList*>, EventTypeCount> Tables{};
+        std::atomic<uint32_t> Readers{0};
+        std::vector<const HandlerList*> Retired;   // 被替换但可能仍在遍历的快照，持有m_HandlersMutex时访问
+
+        ~HandlerTables() {
+            for (auto& table : Tables) {
+                delete table.load();
+            }
+            Reclaim();
+        }
+
+        // 调用方持有m_HandlersMutex
+        void Publish(size_t index, const HandlerList* handlers) {
+            if (const HandlerList* previous = Tables[index].exchange(handlers)) {
+                Retired.push_back(previous);
+            }
+            if (Readers.load() == 0) {
+                Reclaim();
+            }
+        }
+
+        void Reclaim() {
+            for (const HandlerList* handlers : Retired) {
+                delete handlers;
+            }
+            Retired.clear();
+        }
+    };
+
+    namespace {
+        // 分发期间登记为读者，处理器抛出异常时同样注销
+        class HandlerReadScope {
+        public:
+            explicit HandlerReadScope(std::atomic<uint32_t>& readers) : m_Readers(readers) { m_Readers.fetch_add(1); }
+            ~HandlerReadScope() { m_Readers.fetch_sub(1); }
+
+            HandlerReadScope(const HandlerReadScope&) = delete;
+            HandlerReadScope& operator=(const HandlerReadScope&) = delete;
+
+        private:
+            std::atomic<uint32_t>& m_Readers;
+        };
+    }
+
+    EventSystem::EventSystem() : m_HandlerTables(std::make_unique<HandlerTables>()) {
+    }
+
+    EventSystem::~EventSystem() {
+        Shutdown();
+    }
+
     void EventSystem::Initialize(size_t workerThreads) {
         if (m_Running.load()) {
             return;
@@ -20,7 +74,7 @@ namespace JFM {
         m_EventQueue = std::make_unique<EventQueue>();
 
         // 注意：不需要为抽象Event类创建内存池
-        // 具体的事件类型会使用EventMemoryManager
+        // 内置事件直接存放在队列槽位中，其他具体事件类型使用EventMemoryManager
 
         // 启动工作线程
         m_Running.store(true);
@@ -54,10 +108,12 @@ namespace JFM {
         // 处理剩余事件
         ProcessEvents(UINT32_MAX);
 
-        // 清理资源
+        // 清理资源：释放所有快照，处理器在不再被引用时析构
         {
             std::lock_guard<std::mutex> lock(m_HandlersMutex);
-            m_Handlers.clear();
+            for (size_t i = 0; i < EventTypeCount; ++i) {
+                m_HandlerTables->Publish(i, nullptr);
+            }
         }
 
     }
@@ -68,11 +124,8 @@ namespace JFM {
         }
 
         // 应用事件过滤器
-        {
-            std::lock_guard<std::mutex> lock(m_FilterMutex);
-            if (m_EventFilter && !m_EventFilter(*event)) {
-                return; // 事件被过滤
-            }
+        if (!PassesFilter(*event)) {
+            return; // 事件被过滤
         }
 
         // 立即处理事件
@@ -84,35 +137,52 @@ namespace JFM {
             return false;
         }
 
+        return PostPooled(event.release(), [](Event* e) { delete e; });
+    }
+
+    bool EventSystem::PostPooled(Event* event, void (*release)(Event*)) {
         // 应用事件过滤器
-        {
-            std::lock_guard<std::mutex> lock(m_FilterMutex);
-            if (m_EventFilter && !m_EventFilter(*event)) {
-                return true; // 事件被过滤，但不算错误
-            }
+        if (!PassesFilter(*event)) {
+            release(event);
+            return true; // 事件被过滤，但不算错误
         }
 
         // 尝试将事件加入队列
-        Event* rawEvent = event.release();
-        if (m_EventQueue->Enqueue(rawEvent)) {
-            // 更新队列大小统计
-            size_t currentSize = m_EventQueue->GetSize();
-            uint64_t maxSize = m_Stats.MaxQueueSize.load();
-            uint64_t currentSizeULL = static_cast<uint64_t>(currentSize);
-            while (currentSizeULL > maxSize &&
-                   !m_Stats.MaxQueueSize.compare_exchange_weak(maxSize, currentSizeULL)) {
-                maxSize = m_Stats.MaxQueueSize.load();
-            }
+        bool queued = m_EventQueue->EnqueueWith([&](PostedEvent& slot) {
+            slot.emplace<PooledEvent>(PooledEvent{event, release});
+        });
 
-            // 通知工作线程
-            m_WorkerCV.notify_one();
-            return true;
-        } else {
-            // 队列已满，删除事件并记录统计
-            delete rawEvent;
+        if (!queued) {
+            // 队列已满，释放事件
+            release(event);
+        }
+        return OnEnqueued(queued);
+    }
+
+    bool EventSystem::PassesFilter(const Event& event) {
+        std::lock_guard<std::mutex> lock(m_FilterMutex);
+        return !m_EventFilter || m_EventFilter(event);
+    }
+
+    bool EventSystem::OnEnqueued(bool queued) {
+        if (!queued) {
+            // 队列已满，记录统计
             m_Stats.EventsDropped.fetch_add(1);
             return false;
         }
+
+        // 更新队列大小统计
+        size_t currentSize = m_EventQueue->GetSize();
+        uint64_t maxSize = m_Stats.MaxQueueSize.load();
+        uint64_t currentSizeULL = static_cast<uint64_t>(currentSize);
+        while (currentSizeULL > maxSize &&
+               !m_Stats.MaxQueueSize.compare_exchange_weak(maxSize, currentSizeULL)) {
+            maxSize = m_Stats.MaxQueueSize.load();
+        }
+
+        // 通知工作线程
+        m_WorkerCV.notify_one();
+        return true;
     }
 
     void EventSystem::RegisterHandler(std::shared_ptr<IEventHandler> handler) {
@@ -122,15 +192,25 @@ namespace JFM {
 
         std::lock_guard<std::mutex> lock(m_HandlersMutex);
         EventType eventType = handler->GetHandledEventType();
+        size_t index = static_cast<size_t>(eventType);
+        if (index >= EventTypeCount) {
+            return;
+        }
 
-        auto& handlers = m_Handlers[eventType];
+        // 复制当前快照并追加
+        HandlerList handlers;
+        if (const HandlerList* current = m_HandlerTables->Tables[index].load()) {
+            handlers = *current;
+        }
         handlers.push_back(handler);
 
-        // 按优先级排序（高优先级在前）
-        std::sort(handlers.begin(), handlers.end(),
+        // 按优先级排序（高优先级在前），stable_sort保证同优先级按注册顺序
+        std::stable_sort(handlers.begin(), handlers.end(),
             [](const std::shared_ptr<IEventHandler>& a, const std::shared_ptr<IEventHandler>& b) {
                 return a->GetPriority() > b->GetPriority();
             });
+
+        PublishHandlers(eventType, std::move(handlers));
     }
 
     void EventSystem::UnregisterHandler(std::shared_ptr<IEventHandler> handler) {
@@ -140,14 +220,27 @@ namespace JFM {
 
         std::lock_guard<std::mutex> lock(m_HandlersMutex);
         EventType eventType = handler->GetHandledEventType();
+        size_t index = static_cast<size_t>(eventType);
+        if (index >= EventTypeCount) {
+            return;
+        }
 
-        auto it = m_Handlers.find(eventType);
-        if (it != m_Handlers.end()) {
-            auto& handlers = it->second;
-            handlers.erase(
-                std::remove(handlers.begin(), handlers.end(), handler),
-                handlers.end());
+        const HandlerList* current = m_HandlerTables->Tables[index].load();
+        if (!current || std::find(current->begin(), current->end(), handler) == current->end()) {
+            return;
         }
+
+        HandlerList handlers = *current;
+        handlers.erase(
+            std::remove(handlers.begin(), handlers.end(), handler),
+            handlers.end());
+
+        PublishHandlers(eventType, std::move(handlers));
+    }
+
+    void EventSystem::PublishHandlers(EventType eventType, HandlerList handlers) {
+        // 仍在遍历旧快照的分发线程结束前旧快照不会释放，注销的处理器随旧快照析构
+        m_HandlerTables->Publish(static_cast<size_t>(eventType), new HandlerList(std::move(handlers)));
     }
 
     void EventSystem::ProcessEvent(Event& event) {
@@ -155,27 +248,47 @@ namespace JFM {
     }
 
     void EventSystem::ProcessEvents(size_t maxEvents) {
-        Event* event = nullptr;
+        PostedEvent batch[EventBatchSize];
         size_t processedCount = 0;
 
-        while (processedCount < maxEvents && m_EventQueue->Dequeue(event)) {
-            if (event) {
-                ProcessEventInternal(*event);
-                delete event;
-                processedCount++;
+        // 按批出队，每批只需一次CAS
+        while (processedCount < maxEvents) {
+            size_t count = m_EventQueue->DequeueBulk(batch, std::min(EventBatchSize, maxEvents - processedCount));
+            if (count == 0) {
+                break;
             }
+
+            for (size_t i = 0; i < count; ++i) {
+                DispatchPostedEvent(batch[i]);
+            }
+            processedCount += count;
         }
     }
 
+    void EventSystem::DispatchPostedEvent(PostedEvent& posted) {
+        std::visit([this](auto& event) {
+            using T = std::decay_t<decltype(event)>;
+            if constexpr (std::is_same_v<T, PooledEvent>) {
+                if (event.Ptr) {
+                    ProcessEventInternal(*event.Ptr);
+                    event.Release(event.Ptr);
+                    event.Ptr = nullptr;
+                }
+            } else if constexpr (!std::is_same_v<T, std::monostate>) {
+                ProcessEventInternal(event);
+            }
+        }, posted);
+    }
+
     void EventSystem::WorkerThreadFunc() {
-        while (m_Running.load()) {
-            Event* event = nullptr;
+        PostedEvent batch[EventBatchSize];
 
-            // 尝试从队列中获取事件
-            if (m_EventQueue->Dequeue(event)) {
-                if (event) {
-                    ProcessEventInternal(*event);
-                    delete event;
+        while (m_Running.load()) {
+            // 尝试从队列中批量获取事件
+            size_t count = m_EventQueue->DequeueBulk(batch, EventBatchSize);
+            if (count > 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    DispatchPostedEvent(batch[i]);
                 }
             } else {
                 // 队列为空，等待通知
@@ -189,14 +302,14 @@ namespace JFM {
     void EventSystem::ProcessEventInternal(Event& event) {
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        std::lock_guard<std::mutex> lock(m_HandlersMutex);
-        auto it = m_Handlers.find(event.GetEventType());
-
-        if (it != m_Handlers.end()) {
-            auto& handlers = it->second;
+        // 登记为读者后取得当前快照，遍历期间即使发布了新快照也保持有效
+        size_t index = static_cast<size_t>(event.GetEventType());
+        HandlerReadScope readScope(m_HandlerTables->Readers);
+        const HandlerList* handlers = index < EventTypeCount ? m_HandlerTables->Tables[index].load() : nullptr;
 
+        if (handlers) {
             // 调用所有有效的处理器
-            for (auto& handler : handlers) {
+            for (auto& handler : *handlers) {
                 if (handler && handler->Handle(event)) {
                     // 如果处理器返回true，表示事件已被处理，停止传播
                     break;
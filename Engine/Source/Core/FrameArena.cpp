@@ -0,0 +1,93 @@
+//
+// FrameArena.cpp - 每帧线性分配器实现
+//
+
+#include "JFMEngine/Core/FrameArena.h"
+#include <algorithm>
+
+namespace JFM {
+
+    FrameArena::FrameArena() {
+        for (uint32_t i = 0; i < MaxFramesInFlight; ++i) {
+            AddChunk(m_Frames[i], DefaultChunkSize);
+        }
+    }
+
+    void FrameArena::BeginFrame() {
+        m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
+        ResetFrame(m_Frames[m_CurrentFrame]);
+    }
+
+    void FrameArena::SetFramesInFlight(uint32_t count) {
+        count = std::clamp(count, 1u, MaxFramesInFlight);
+        if (count == m_FramesInFlight) {
+            return;
+        }
+
+        m_FramesInFlight = count;
+        if (m_CurrentFrame >= count) {
+            m_CurrentFrame = 0;
+            ResetFrame(m_Frames[m_CurrentFrame]);
+        }
+    }
+
+    void FrameArena::ResetFrame(FrameBuffer& frame) {
+        m_PeakBytes = std::max(m_PeakBytes, frame.Used);
+
+        // 上一轮用到了多个块时合并成一个足够大的块，之后的帧不再需要申请内存
+        if (frame.Chunks.size() > 1) {
+            size_t total = 0;
+            for (const Chunk& chunk : frame.Chunks) {
+                total += chunk.Size;
+            }
+            frame.Chunks.clear();
+            AddChunk(frame, total);
+        }
+
+        for (Chunk& chunk : frame.Chunks) {
+            chunk.Offset = 0;
+        }
+        frame.Current = 0;
+        frame.Used = 0;
+    }
+
+    void* FrameArena::AllocateSlow(size_t size, size_t alignment) {
+        FrameBuffer& frame = m_Frames[m_CurrentFrame];
+
+        // 当前块空间不足，尝试本帧已有的后续块，再不够才申请新块
+        while (true) {
+            ++frame.Current;
+            if (frame.Current >= frame.Chunks.size()) {
+                size_t lastSize = frame.Chunks.empty() ? DefaultChunkSize : frame.Chunks.back().Size;
+                AddChunk(frame, std::max(lastSize * 2, size + alignment));
+            }
+
+            Chunk& chunk = frame.Chunks[frame.Current];
+            if (size + alignment <= chunk.Size) {
+                return Allocate(size, alignment);
+            }
+        }
+    }
+
+    void FrameArena::AddChunk(FrameBuffer& frame, size_t size) {
+        Chunk chunk;
+        chunk.Data.reset(new uint8_t[size]);
+        chunk.Size = size;
+        frame.Chunks.push_back(std::move(chunk));
+        ++m_ChunkAllocations;
+    }
+
+    FrameArenaStats FrameArena::GetStats() const {
+        FrameArenaStats stats;
+        stats.UsedBytes = m_Frames[m_CurrentFrame].Used;
+        stats.PeakBytes = std::max(m_PeakBytes, stats.UsedBytes);
+        stats.ChunkAllocations = m_ChunkAllocations;
+        for (const FrameBuffer& frame : m_Frames) {
+            for (const Chunk& chunk : frame.Chunks) {
+                stats.CapacityBytes += chunk.Size;
+            }
+        }
+        return stats;
+    }
+
+}
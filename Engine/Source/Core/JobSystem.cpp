@@ -0,0 +1,136 @@
+//
+// JobSystem.cpp - 并行任务系统实现
+//
+
+#include "JFMEngine/Core/JobSystem.h"
+#include <algorithm>
+
+namespace JFM {
+
+    namespace {
+        // 工作线程以及正在执行任务块的调用线程，嵌套的ParallelFor直接顺序执行，避免互相等待
+        thread_local bool t_InsideJob = false;
+    }
+
+    void JobSystem::Initialize(size_t workerThreads) {
+        std::lock_guard<std::mutex> submit(m_SubmitMutex);
+        if (m_Running) {
+            return;
+        }
+
+        m_Running = true;
+        m_WorkerThreads.reserve(workerThreads);
+        for (size_t i = 0; i < workerThreads; ++i) {
+            m_WorkerThreads.emplace_back(&JobSystem::WorkerThreadFunc, this);
+        }
+    }
+
+    void JobSystem::Shutdown() {
+        std::lock_guard<std::mutex> submit(m_SubmitMutex);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Running) {
+                return;
+            }
+            m_Running = false;
+        }
+        m_WorkCV.notify_all();
+
+        for (auto& thread : m_WorkerThreads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        m_WorkerThreads.clear();
+    }
+
+    void JobSystem::Run(JobFunction function, void* context, size_t count, size_t grainSize) {
+        if (count == 0) {
+            return;
+        }
+
+        Job job;
+        job.Function = function;
+        job.Context = context;
+        job.Count = count;
+        job.GrainSize = std::max<size_t>(grainSize, 1);
+        job.ChunkCount = (count + job.GrainSize - 1) / job.GrainSize;
+
+        if (job.ChunkCount == 1 || t_InsideJob || m_WorkerThreads.empty()) {
+            function(context, 0, count);
+            return;
+        }
+
+        std::lock_guard<std::mutex> submit(m_SubmitMutex);
+        if (!m_Running) {
+            function(context, 0, count);
+            return;
+        }
+
+        {
+            // 上一个任务的迟到线程可能还持有旧任务，等它们退出后才能重置计数
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_DoneCV.wait(lock, [this] { return m_ActiveWorkers == 0; });
+
+            m_Job = job;
+            m_NextChunk.store(0, std::memory_order_relaxed);
+            m_PendingChunks.store(job.ChunkCount, std::memory_order_relaxed);
+            ++m_Generation;
+        }
+        m_WorkCV.notify_all();
+
+        t_InsideJob = true;
+        ExecuteChunks(job);
+        t_InsideJob = false;
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_DoneCV.wait(lock, [this] { return m_PendingChunks.load(std::memory_order_acquire) == 0; });
+    }
+
+    void JobSystem::ExecuteChunks(const Job& job) {
+        for (;;) {
+            size_t chunk = m_NextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= job.ChunkCount) {
+                return;
+            }
+
+            size_t begin = chunk * job.GrainSize;
+            size_t end = std::min(job.Count, begin + job.GrainSize);
+            job.Function(job.Context, begin, end);
+
+            if (m_PendingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_DoneCV.notify_all();
+            }
+        }
+    }
+
+    void JobSystem::WorkerThreadFunc() {
+        t_InsideJob = true;
+        uint64_t seenGeneration = 0;
+
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkCV.wait(lock, [&] { return !m_Running || m_Generation != seenGeneration; });
+                if (!m_Running) {
+                    return;
+                }
+
+                seenGeneration = m_Generation;
+                job = m_Job;
+                ++m_ActiveWorkers;
+            }
+
+            ExecuteChunks(job);
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_ActiveWorkers;
+            }
+            m_DoneCV.notify_all();
+        }
+    }
+
+}
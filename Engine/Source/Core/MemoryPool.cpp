@@ -9,181 +9,174 @@
 
 namespace JFM {
 
-    // 内存块大小常量
-
-    constexpr size_t BLOCK_SIZE = 64 * 1024;  // 64KB块
-    constexpr size_t ALIGNMENT = 16;          // 16字节对齐
-
-    // 内存块头部信息
-    struct MemoryBlockHeader {
-        size_t size;           // 块大小
-        size_t used;           // 已使用字节数
-        uint8_t* data;         // 数据起始地址
-
-        // 空闲块链表
-        struct FreeBlock {
-            size_t size;
-            FreeBlock* next;
-        };
-        FreeBlock* freeList;   // 空闲块链表头
-
-        MemoryBlockHeader(size_t blockSize)
-            : size(blockSize), used(0), freeList(nullptr) {
-            data = reinterpret_cast<uint8_t*>(this) + sizeof(MemoryBlockHeader);
-        }
+    namespace Detail {
+
+        namespace {
+            // 线程缓存槽位分配表，故意不析构：分离线程可能在静态对象析构之后才退出
+            struct ThreadCacheRegistry {
+                std::mutex Mutex;
+                std::vector<uint32_t> FreeIndices;
+                uint32_t NextIndex = 0;
+            };
+
+            ThreadCacheRegistry& GetRegistry() {
+                static ThreadCacheRegistry* registry = new ThreadCacheRegistry();
+                return *registry;
+            }
 
-        // 检查是否有足够空间
-        bool HasSpace(size_t requestedSize) const {
-            size_t alignedSize = AlignSize(requestedSize);
+            struct ThreadCacheHandle {
+                uint32_t Index = InvalidThreadCache;
+                bool Requested = false;
 
-            // 首先检查空闲列表
-            FreeBlock* current = freeList;
-            while (current) {
-                if (current->size >= alignedSize) {
-                    return true;
+                ~ThreadCacheHandle() {
+                    if (Index == InvalidThreadCache) {
+                        return;
+                    }
+                    // 归还槽位，各内存池中该槽位弹匣里的对象由下一个线程继续使用
+                    auto& registry = GetRegistry();
+                    std::lock_guard<std::mutex> lock(registry.Mutex);
+                    registry.FreeIndices.push_back(Index);
                 }
-                current = current->next;
-            }
+            };
 
-            // 然后检查未使用的空间
-            return (used + alignedSize) <= size;
+            thread_local ThreadCacheHandle t_ThreadCache;
         }
 
-        // 分配内存
-        void* Allocate(size_t requestedSize) {
-            size_t alignedSize = AlignSize(requestedSize);
-
-            // 首先尝试从空闲列表分配
-            FreeBlock** current = &freeList;
-            while (*current) {
-                if ((*current)->size >= alignedSize) {
-                    FreeBlock* block = *current;
-                    *current = block->next; // 从空闲列表移除
-
-                    // 如果块太大，分割它
-                    if (block->size > alignedSize + sizeof(FreeBlock)) {
-                        FreeBlock* remainder = reinterpret_cast<FreeBlock*>(
-                            reinterpret_cast<uint8_t*>(block) + alignedSize
-                        );
-                        remainder->size = block->size - alignedSize;
-                        remainder->next = freeList;
-                        freeList = remainder;
-                    }
-
-                    return block;
+        uint32_t GetThreadCacheIndex() {
+            if (!t_ThreadCache.Requested) {
+                t_ThreadCache.Requested = true;
+
+                auto& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                if (!registry.FreeIndices.empty()) {
+                    t_ThreadCache.Index = registry.FreeIndices.back();
+                    registry.FreeIndices.pop_back();
+                } else if (registry.NextIndex < MaxThreadCaches) {
+                    t_ThreadCache.Index = registry.NextIndex++;
                 }
-                current = &(*current)->next;
             }
+            return t_ThreadCache.Index;
+        }
 
-            // 从未使用空间分配
-            if (!HasSpace(alignedSize)) {
-                return nullptr;
-            }
+    }
 
-            void* ptr = data + used;
-            used += alignedSize;
-            return ptr;
-        }
+    namespace {
+        constexpr size_t BLOCK_SIZE = 64 * 1024;  // 64KB块，按块大小对齐
+        constexpr size_t BLOCK_HEADER_SIZE = 64;  // 块头部占用的字节数
 
-        // 标记内存为空闲
-        void MarkAsFree(void* ptr, size_t size) {
-            if (!ptr) return;
+        // 尺寸级别表：前8级步长16字节，之后每翻一倍分4级
+        constexpr std::array<size_t, EventMemoryManager::SizeClassCount> SIZE_CLASSES = {
+            16, 32, 48, 64, 80, 96, 112, 128,
+            160, 192, 224, 256, 320, 384, 448, 512
+        };
 
-            size_t alignedSize = AlignSize(size);
-            FreeBlock* newBlock = reinterpret_cast<FreeBlock*>(ptr);
-            newBlock->size = alignedSize;
-            newBlock->next = freeList;
-            freeList = newBlock;
+        // 以16字节为单位的尺寸到级别索引的查找表
+        constexpr size_t SIZE_LOOKUP_COUNT = EventMemoryManager::MaxSmallSize / EventMemoryManager::Alignment + 1;
 
-            // 尝试合并相邻的空闲块
-            CoalesceFreeBlocks();
+        constexpr std::array<uint8_t, SIZE_LOOKUP_COUNT> BuildSizeLookup() {
+            std::array<uint8_t, SIZE_LOOKUP_COUNT> table{};
+            size_t sizeClass = 0;
+            for (size_t i = 0; i < SIZE_LOOKUP_COUNT; ++i) {
+                size_t size = i * EventMemoryManager::Alignment;
+                while (SIZE_CLASSES[sizeClass] < size) {
+                    ++sizeClass;
+                }
+                table[i] = static_cast<uint8_t>(sizeClass);
+            }
+            return table;
         }
 
-        // 检查块是否完全空闲
-        bool IsCompletelyFree() const {
-            // 简化检查：如果所有已使用的内存都在空闲列表中
-            size_t totalFreeSize = 0;
-            FreeBlock* current = freeList;
-            while (current) {
-                totalFreeSize += current->size;
-                current = current->next;
-            }
+        constexpr std::array<uint8_t, SIZE_LOOKUP_COUNT> SIZE_LOOKUP = BuildSizeLookup();
 
-            return totalFreeSize >= used;
+        size_t GetSizeClass(size_t size) {
+            return SIZE_LOOKUP[(size + EventMemoryManager::Alignment - 1) / EventMemoryManager::Alignment];
         }
 
-    private:
-        static size_t AlignSize(size_t size) {
-            return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
-        }
+        // 空闲槽位中存放的链表节点
+        struct FreeSlot {
+            FreeSlot* next;
+        };
+    }
 
-        // 合并相邻的空闲块
-        void CoalesceFreeBlocks() {
-            if (!freeList || !freeList->next) return;
+    // 内存块头部信息，位于每个64KB对齐块的起始处
+    struct EventMemoryManager::BlockHeader {
+        uint32_t sizeClass;    // 所属尺寸级别
+        uint32_t slotSize;     // 槽位大小
+        uint32_t used;         // 已切分的字节数（从数据区起始算起）
+        uint32_t liveCount;    // 活跃分配数
 
-            // 对空闲块按地址排序
-            std::vector<FreeBlock*> blocks;
-            FreeBlock* current = freeList;
-            while (current) {
-                blocks.push_back(current);
-                current = current->next;
-            }
+        uint8_t* Data() { return reinterpret_cast<uint8_t*>(this) + BLOCK_HEADER_SIZE; }
 
-            std::sort(blocks.begin(), blocks.end());
+        bool Contains(const void* ptr) {
+            auto bytes = static_cast<const uint8_t*>(ptr);
+            return bytes >= Data() && bytes < Data() + used;
+        }
 
-            // 合并相邻块
-            freeList = nullptr;
-            FreeBlock* lastAdded = nullptr;
+        // 通过地址掩码找到指针所属的块
+        static BlockHeader* FromPointer(void* ptr) {
+            return reinterpret_cast<BlockHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(BLOCK_SIZE - 1));
+        }
+    };
 
-            for (FreeBlock* block : blocks) {
-                if (lastAdded &&
-                    reinterpret_cast<uint8_t*>(lastAdded) + lastAdded->size ==
-                    reinterpret_cast<uint8_t*>(block)) {
-                    // 合并到前一个块
-                    lastAdded->size += block->size;
-                } else {
-                    // 添加新块到链表
-                    block->next = freeList;
-                    freeList = block;
-                    lastAdded = block;
-                }
+    EventMemoryManager::~EventMemoryManager() {
+        for (auto& bin : m_Bins) {
+            for (BlockHeader* block : bin.Blocks) {
+                ::operator delete(block, std::align_val_t(BLOCK_SIZE));
             }
         }
-    };
+    }
 
     void* EventMemoryManager::AllocateRawMemory(size_t size) {
-        std::lock_guard<std::mutex> lock(m_Mutex);
-
-        // 尝试从现有块中分配
-        for (auto& block : m_MemoryBlocks) {
-            MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(block.get());
-            if (header->HasSpace(size)) {
-                return header->Allocate(size);
-            }
+        if (size > MaxSmallSize) {
+            // 大对象直接走系统分配器
+            m_LargeAllocations.fetch_add(1, std::memory_order_relaxed);
+            m_LargeBytes.fetch_add(size, std::memory_order_relaxed);
+            return ::operator new(size, std::align_val_t(Alignment));
         }
 
-        // 需要新的内存块
-        size_t blockSize = std::max(BLOCK_SIZE, size + sizeof(MemoryBlockHeader) + ALIGNMENT);
-        auto newBlock = std::make_unique<uint8_t[]>(blockSize);
+        size_t sizeClass = GetSizeClass(size);
+        SizeClassBin& bin = m_Bins[sizeClass];
+        std::lock_guard<std::mutex> lock(bin.Mutex);
 
-        // 初始化块头部
-        MemoryBlockHeader* header = new(newBlock.get()) MemoryBlockHeader(
-            blockSize - sizeof(MemoryBlockHeader)
-        );
+        // 首先复用已释放的槽位
+        if (bin.FreeList) {
+            FreeSlot* slot = static_cast<FreeSlot*>(bin.FreeList);
+            bin.FreeList = slot->next;
+            BlockHeader::FromPointer(slot)->liveCount++;
+            return slot;
+        }
 
-        void* result = header->Allocate(size);
-        m_MemoryBlocks.push_back(std::move(newBlock));
+        // 然后从当前块顺序切分，空间不足时申请新块
+        BlockHeader* block = bin.Current;
+        if (!block || block->used + block->slotSize > BLOCK_SIZE - BLOCK_HEADER_SIZE) {
+            static_assert(sizeof(BlockHeader) <= BLOCK_HEADER_SIZE, "Block header too large");
+            void* memory = ::operator new(BLOCK_SIZE, std::align_val_t(BLOCK_SIZE));
+            block = new(memory) BlockHeader{
+                static_cast<uint32_t>(sizeClass),
+                static_cast<uint32_t>(SIZE_CLASSES[sizeClass]),
+                0,
+                0
+            };
+            bin.Blocks.push_back(block);
+            bin.Current = block;
+        }
 
-        return result;
+        void* ptr = block->Data() + block->used;
+        block->used += block->slotSize;
+        block->liveCount++;
+        return ptr;
     }
 
     void EventMemoryManager::DeallocateRawMemory(void* ptr, size_t size) {
         if (!ptr) return;
 
-        std::lock_guard<std::mutex> lock(m_Mutex);
+        // 清理分配记录
+        if (m_TrackAllocations.load(std::memory_order_relaxed)) {
+            UnregisterAllocation(ptr);
+        }
 
         // 根据释放策略处理
-        switch (m_ReleasePolicy) {
+        switch (m_ReleasePolicy.load(std::memory_order_relaxed)) {
             case ReleasePolicy::Immediate:
                 DeallocateImmediate(ptr, size);
                 break;
@@ -196,30 +189,36 @@ namespace JFM {
                 DeallocateBatchDeferred(ptr, size);
                 break;
         }
-
-        // 清理分配记录
-        UnregisterAllocation(ptr);
     }
 
     void EventMemoryManager::DeallocateImmediate(void* ptr, size_t size) {
-        // 立即释放策略：尝试将内存标记为可重用
-        for (auto& block : m_MemoryBlocks) {
-            MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(block.get());
-
-            // 检查指针是否在此块范围内
-            uint8_t* blockStart = reinterpret_cast<uint8_t*>(header);
-            uint8_t* blockEnd = blockStart + sizeof(MemoryBlockHeader) + header->size;
-            uint8_t* ptrBytes = reinterpret_cast<uint8_t*>(ptr);
-
-            if (ptrBytes >= header->data && ptrBytes < blockEnd) {
-                // 在简化实现中，我们将释放的内存添加到空闲列表
-                header->MarkAsFree(ptr, size);
-                return;
-            }
+        if (size > MaxSmallSize) {
+            m_LargeAllocations.fetch_sub(1, std::memory_order_relaxed);
+            m_LargeBytes.fetch_sub(size, std::memory_order_relaxed);
+            ::operator delete(ptr, std::align_val_t(Alignment));
+            return;
         }
+
+        BlockHeader* block = BlockHeader::FromPointer(ptr);
+        SizeClassBin& bin = m_Bins[block->sizeClass];
+        std::lock_guard<std::mutex> lock(bin.Mutex);
+
+        // 调试时校验指针确实是本块切分出的槽位起始地址，且尺寸级别与分配时一致
+        JFM_CORE_ASSERT(block->Contains(ptr), "Pointer was not allocated from this memory block");
+        JFM_CORE_ASSERT((static_cast<uint8_t*>(ptr) - block->Data()) % block->slotSize == 0, "Pointer is not at a slot boundary");
+        JFM_CORE_ASSERT(block->sizeClass == GetSizeClass(size), "Deallocation size does not match allocation");
+        JFM_CORE_ASSERT(block->liveCount > 0, "Double free in memory block");
+
+        // 将槽位压回本级别的空闲链表
+        FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+        slot->next = static_cast<FreeSlot*>(bin.FreeList);
+        bin.FreeList = slot;
+        block->liveCount--;
     }
 
     void EventMemoryManager::DeallocateDeferred(void* ptr, size_t size) {
+        std::lock_guard<std::mutex> lock(m_DeferredMutex);
+
         // 延迟释放策略：添加到延迟队列
         DeferredDeallocation deferred{
             ptr,
@@ -236,6 +235,8 @@ namespace JFM {
     }
 
     void EventMemoryManager::DeallocateBatchDeferred(void* ptr, size_t size) {
+        std::lock_guard<std::mutex> lock(m_DeferredMutex);
+
         // 批量延迟释放：先放入队列，定期批量处理
         DeferredDeallocation deferred{ptr, size, std::chrono::steady_clock::now()};
         m_DeferredQueue.push(deferred);
@@ -272,6 +273,32 @@ namespace JFM {
         }
     }
 
+    void EventMemoryManager::FlushDeferredDeallocations() {
+        std::lock_guard<std::mutex> lock(m_DeferredMutex);
+        while (!m_DeferredQueue.empty()) {
+            auto& deferred = m_DeferredQueue.front();
+            DeallocateImmediate(deferred.ptr, deferred.size);
+            m_DeferredQueue.pop();
+        }
+    }
+
+    void EventMemoryManager::SetReleasePolicy(ReleasePolicy policy) {
+        m_ReleasePolicy.store(policy, std::memory_order_relaxed);
+
+        // 切换到立即释放时不再有人处理队列，先清空
+        if (policy == ReleasePolicy::Immediate) {
+            FlushDeferredDeallocations();
+        }
+    }
+
+    void EventMemoryManager::SetAllocationTracking(bool enabled) {
+        std::lock_guard<std::mutex> lock(m_TrackingMutex);
+        m_TrackAllocations.store(enabled, std::memory_order_relaxed);
+        if (!enabled) {
+            m_Allocations.clear();
+        }
+    }
+
     void EventMemoryManager::RegisterAllocation(void* ptr, size_t size, size_t typeHash) {
         AllocationInfo info{
             size,
@@ -279,10 +306,12 @@ namespace JFM {
             std::chrono::steady_clock::now()
         };
 
+        std::lock_guard<std::mutex> lock(m_TrackingMutex);
         m_Allocations[ptr] = info;
     }
 
     void EventMemoryManager::UnregisterAllocation(void* ptr) {
+        std::lock_guard<std::mutex> lock(m_TrackingMutex);
         auto it = m_Allocations.find(ptr);
         if (it != m_Allocations.end()) {
             m_Allocations.erase(it);
@@ -290,21 +319,25 @@ namespace JFM {
     }
 
     EventMemoryManager::MemoryStats EventMemoryManager::GetStats() {
-        std::lock_guard<std::mutex> lock(m_Mutex);
-
         MemoryStats stats;
-        stats.activeAllocations = m_Allocations.size();
-        stats.totalBlocks = m_MemoryBlocks.size();
-
-        // 计算总分配内存
-        for (const auto& pair : m_Allocations) {
-            stats.totalAllocated += pair.second.size;
+        stats.activeAllocations = m_LargeAllocations.load(std::memory_order_relaxed);
+        stats.totalAllocated = m_LargeBytes.load(std::memory_order_relaxed);
+
+        // 各级别的块头部已经记录了活跃分配数，无需追踪表
+        for (auto& bin : m_Bins) {
+            std::lock_guard<std::mutex> lock(bin.Mutex);
+            for (BlockHeader* block : bin.Blocks) {
+                stats.activeAllocations += block->liveCount;
+                stats.totalAllocated += static_cast<size_t>(block->liveCount) * block->slotSize;
+            }
+            stats.totalBlocks += bin.Blocks.size();
         }
 
         // 计算碎片化比例
         size_t totalBlockMemory = stats.totalBlocks * BLOCK_SIZE;
         if (totalBlockMemory > 0) {
-            size_t wastedMemory = totalBlockMemory - stats.totalAllocated;
+            size_t smallAllocated = stats.totalAllocated - m_LargeBytes.load(std::memory_order_relaxed);
+            size_t wastedMemory = totalBlockMemory > smallAllocated ? totalBlockMemory - smallAllocated : 0;
             stats.fragmentationRatio = (wastedMemory * 100) / totalBlockMemory;
         }
 
@@ -312,26 +345,37 @@ namespace JFM {
     }
 
     void EventMemoryManager::Compact() {
-        std::lock_guard<std::mutex> lock(m_Mutex);
-
         // 首先处理所有延迟释放
-        while (!m_DeferredQueue.empty()) {
-            auto& deferred = m_DeferredQueue.front();
-            DeallocateImmediate(deferred.ptr, deferred.size);
-            m_DeferredQueue.pop();
-        }
-
-        // 内存压缩整理（简化版）
-        // 在生产环境中，这里会实现复杂的内存迁移和整理算法
+        FlushDeferredDeallocations();
 
         // 移除完全空闲的内存块
-        auto it = std::remove_if(m_MemoryBlocks.begin(), m_MemoryBlocks.end(),
-            [](const auto& block) {
-                MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(block.get());
-                return header->IsCompletelyFree();
-            });
+        for (auto& bin : m_Bins) {
+            std::lock_guard<std::mutex> lock(bin.Mutex);
 
-        m_MemoryBlocks.erase(it, m_MemoryBlocks.end());
+            auto emptyBegin = std::partition(bin.Blocks.begin(), bin.Blocks.end(),
+                [](BlockHeader* block) { return block->liveCount > 0; });
+            if (emptyBegin == bin.Blocks.end()) {
+                continue;
+            }
+
+            // 从空闲链表中摘除属于空闲块的槽位
+            FreeSlot** link = reinterpret_cast<FreeSlot**>(&bin.FreeList);
+            while (*link) {
+                if (BlockHeader::FromPointer(*link)->liveCount == 0) {
+                    *link = (*link)->next;
+                } else {
+                    link = &(*link)->next;
+                }
+            }
+
+            for (auto it = emptyBegin; it != bin.Blocks.end(); ++it) {
+                if (*it == bin.Current) {
+                    bin.Current = nullptr;
+                }
+                ::operator delete(*it, std::align_val_t(BLOCK_SIZE));
+            }
+            bin.Blocks.erase(emptyBegin, bin.Blocks.end());
+        }
     }
 
 }
@@ -0,0 +1,433 @@
+//
+// BroadPhase.cpp - 扫描与裁剪宽阶段实现
+//
+
+#include "JFMEngine/Physics/BroadPhase.h"
+#include <algorithm>
+
+namespace JFM {
+
+    // ---------------------------------------------------------------------
+    // PairSet
+
+    uint64_t SweepAndPrune::PairSet::MakeKey(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    size_t SweepAndPrune::PairSet::Home(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (m_Table.size() - 1);
+    }
+
+    size_t SweepAndPrune::PairSet::Find(uint64_t key) const {
+        if (m_Table.empty()) {
+            return SIZE_MAX;
+        }
+
+        size_t mask = m_Table.size() - 1;
+        for (size_t slot = Home(key);; slot = (slot + 1) & mask) {
+            uint32_t index = m_Table[slot];
+            if (index == EmptySlot) {
+                return SIZE_MAX;
+            }
+            const BroadPhasePair& pair = m_Pairs[index];
+            if (MakeKey(pair.A, pair.B) == key) {
+                return slot;
+            }
+        }
+    }
+
+    void SweepAndPrune::PairSet::Add(uint32_t a, uint32_t b) {
+        if (a > b) {
+            std::swap(a, b);
+        }
+
+        // 装载因子保持在1/2以下
+        if ((m_Pairs.size() + 1) * 2 > m_Table.size()) {
+            Grow();
+        }
+
+        uint64_t key = MakeKey(a, b);
+        size_t mask = m_Table.size() - 1;
+        size_t slot = Home(key);
+        while (m_Table[slot] != EmptySlot) {
+            const BroadPhasePair& pair = m_Pairs[m_Table[slot]];
+            if (pair.A == a && pair.B == b) {
+                return;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        m_Table[slot] = static_cast<uint32_t>(m_Pairs.size());
+        m_Pairs.push_back({a, b});
+        m_Changed = true;
+    }
+
+    void SweepAndPrune::PairSet::Remove(uint32_t a, uint32_t b) {
+        if (a > b) {
+            std::swap(a, b);
+        }
+
+        size_t slot = Find(MakeKey(a, b));
+        if (slot == SIZE_MAX) {
+            return;
+        }
+        uint32_t index = m_Table[slot];
+
+        // 线性探测的后移删除：把同一探测链上后面的元素前移填补空位
+        size_t mask = m_Table.size() - 1;
+        size_t hole = slot;
+        m_Table[hole] = EmptySlot;
+        for (size_t next = (hole + 1) & mask; m_Table[next] != EmptySlot; next = (next + 1) & mask) {
+            const BroadPhasePair& pair = m_Pairs[m_Table[next]];
+            size_t home = Home(MakeKey(pair.A, pair.B));
+            bool between = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+            if (!between) {
+                m_Table[hole] = m_Table[next];
+                m_Table[next] = EmptySlot;
+                hole = next;
+            }
+        }
+
+        // 用最后一个对填补紧凑数组中的空位
+        uint32_t last = static_cast<uint32_t>(m_Pairs.size() - 1);
+        if (index != last) {
+            const BroadPhasePair& moved = m_Pairs[last];
+            m_Table[Find(MakeKey(moved.A, moved.B))] = index;
+            m_Pairs[index] = moved;
+        }
+        m_Pairs.pop_back();
+        m_Changed = true;
+    }
+
+    void SweepAndPrune::PairSet::Clear() {
+        m_Changed = m_Changed || !m_Pairs.empty();
+        m_Pairs.clear();
+        std::fill(m_Table.begin(), m_Table.end(), EmptySlot);
+    }
+
+    void SweepAndPrune::PairSet::Grow() {
+        size_t capacity = std::max<size_t>(64, m_Table.size() * 2);
+        while (capacity < (m_Pairs.size() + 1) * 2) {
+            capacity *= 2;
+        }
+        m_Table.assign(capacity, EmptySlot);
+        Rebuild();
+    }
+
+    void SweepAndPrune::PairSet::Rebuild() {
+        std::fill(m_Table.begin(), m_Table.end(), EmptySlot);
+        size_t mask = m_Table.size() - 1;
+        for (uint32_t i = 0; i < m_Pairs.size(); ++i) {
+            size_t slot = Home(MakeKey(m_Pairs[i].A, m_Pairs[i].B));
+            while (m_Table[slot] != EmptySlot) {
+                slot = (slot + 1) & mask;
+            }
+            m_Table[slot] = i;
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // SweepAndPrune
+
+    uint32_t SweepAndPrune::CreateProxy(const AABB& bounds, uint32_t userData) {
+        uint32_t proxy;
+        if (!m_FreeProxies.empty()) {
+            proxy = m_FreeProxies.back();
+            m_FreeProxies.pop_back();
+        } else {
+            proxy = static_cast<uint32_t>(m_Proxies.size());
+            m_Proxies.emplace_back();
+        }
+
+        Proxy& data = m_Proxies[proxy];
+        data.Bounds = bounds;
+        data.UserData = userData;
+        data.Alive = true;
+        data.Pending = true;
+
+        // 端点在下次UpdatePairs时统一排入
+        m_PendingProxies.push_back(proxy);
+        return proxy;
+    }
+
+    void SweepAndPrune::DestroyProxy(uint32_t proxy) {
+        if (proxy >= m_Proxies.size() || !m_Proxies[proxy].Alive) {
+            return;
+        }
+        m_Proxies[proxy].Alive = false;
+        m_DestroyedProxies.push_back(proxy);
+    }
+
+    void SweepAndPrune::MoveProxy(uint32_t proxy, const AABB& bounds) {
+        Proxy& data = m_Proxies[proxy];
+        AABB old = data.Bounds;
+        data.Bounds = bounds;
+        if (!data.Alive || data.Pending) {
+            return;
+        }
+
+        for (int axis = 0; axis < 3; ++axis) {
+            auto& endpoints = m_Endpoints[axis];
+            uint32_t minIndex = data.MinEndpoint[axis];
+            uint32_t maxIndex = data.MaxEndpoint[axis];
+            endpoints[minIndex].Value = bounds.Min[axis];
+            endpoints[maxIndex].Value = bounds.Max[axis];
+
+            // 先扩张再收缩，保证最小值端点不会越过自己的最大值端点
+            float deltaMin = bounds.Min[axis] - old.Min[axis];
+            float deltaMax = bounds.Max[axis] - old.Max[axis];
+            if (deltaMin < 0.0f) SortMinDown(axis, minIndex, true);
+            if (deltaMax > 0.0f) SortMaxUp(axis, maxIndex, true);
+            if (deltaMin > 0.0f) SortMinUp(axis, data.MinEndpoint[axis], true);
+            if (deltaMax < 0.0f) SortMaxDown(axis, data.MaxEndpoint[axis], true);
+        }
+    }
+
+    void SweepAndPrune::SetUserData(uint32_t proxy, uint32_t userData) {
+        m_Proxies[proxy].UserData = userData;
+        m_PairsDirty = true;
+    }
+
+    void SweepAndPrune::Clear() {
+        m_Proxies.clear();
+        m_FreeProxies.clear();
+        m_DestroyedProxies.clear();
+        m_PendingProxies.clear();
+        for (auto& endpoints : m_Endpoints) {
+            endpoints.clear();
+        }
+        m_PairSet.Clear();
+        m_Pairs.clear();
+        m_PairsDirty = true;
+    }
+
+    const std::vector<BroadPhasePair>& SweepAndPrune::UpdatePairs() {
+        ProcessDestroyedProxies();
+        InsertPendingProxies();
+
+        // 静止或休眠的物体占多数时重叠对很少变化，没有变化就不必重新排序
+        if (!m_PairsDirty && !m_PairSet.IsChanged()) {
+            return m_Pairs;
+        }
+        m_PairsDirty = false;
+        m_PairSet.ResetChanged();
+        m_PairsVersion++;
+
+        // 重叠对集合内部按代理ID存储，输出时换成用户数据并排序，使结果与增删顺序无关
+        const auto& pairs = m_PairSet.GetPairs();
+        m_Pairs.resize(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            uint32_t userA = m_Proxies[pairs[i].A].UserData;
+            uint32_t userB = m_Proxies[pairs[i].B].UserData;
+            m_Pairs[i] = {std::min(userA, userB), std::max(userA, userB)};
+        }
+        std::sort(m_Pairs.begin(), m_Pairs.end(), [](const BroadPhasePair& a, const BroadPhasePair& b) {
+            return a.A < b.A || (a.A == b.A && a.B < b.B);
+        });
+        return m_Pairs;
+    }
+
+    void SweepAndPrune::ProcessDestroyedProxies() {
+        if (m_DestroyedProxies.empty()) {
+            return;
+        }
+
+        // 一次遍历移除所有已销毁代理的端点，其余端点保持有序
+        for (int axis = 0; axis < 3; ++axis) {
+            auto& endpoints = m_Endpoints[axis];
+            size_t write = 0;
+            for (size_t read = 0; read < endpoints.size(); ++read) {
+                const Proxy& data = m_Proxies[endpoints[read].Proxy()];
+                if (data.Alive) {
+                    endpoints[write] = endpoints[read];
+                    SetEndpointIndex(axis, static_cast<uint32_t>(write));
+                    ++write;
+                }
+            }
+            endpoints.resize(write);
+        }
+
+        auto& pairs = m_PairSet.GetPairs();
+        pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [this](const BroadPhasePair& pair) {
+            return !m_Proxies[pair.A].Alive || !m_Proxies[pair.B].Alive;
+        }), pairs.end());
+        m_PairSet.Rebuild();
+        m_PairsDirty = true;
+
+        // 创建后尚未插入就被销毁的代理
+        for (uint32_t proxy : m_DestroyedProxies) {
+            m_Proxies[proxy].Pending = false;
+        }
+        m_PendingProxies.erase(std::remove_if(m_PendingProxies.begin(), m_PendingProxies.end(), [this](uint32_t proxy) {
+            return !m_Proxies[proxy].Alive;
+        }), m_PendingProxies.end());
+
+        m_FreeProxies.insert(m_FreeProxies.end(), m_DestroyedProxies.begin(), m_DestroyedProxies.end());
+        m_DestroyedProxies.clear();
+    }
+
+    void SweepAndPrune::InsertPendingProxies() {
+        if (m_PendingProxies.empty()) {
+            return;
+        }
+
+        // 逐个插入需要把端点从数组末尾移到正确位置，代价为O(n)；一次加入大量代理时整体重建更快
+        size_t count = m_Endpoints[0].size() / 2;
+        if (m_PendingProxies.size() > std::max<size_t>(16, count / 16)) {
+            RebuildAll();
+            return;
+        }
+
+        for (uint32_t proxy : m_PendingProxies) {
+            Proxy& data = m_Proxies[proxy];
+            data.Pending = false;
+
+            for (int axis = 0; axis < 3; ++axis) {
+                auto& endpoints = m_Endpoints[axis];
+                uint32_t minIndex = static_cast<uint32_t>(endpoints.size());
+                endpoints.push_back({data.Bounds.Min[axis], proxy << 1});
+                endpoints.push_back({data.Bounds.Max[axis], (proxy << 1) | 1});
+                data.MinEndpoint[axis] = minIndex;
+                data.MaxEndpoint[axis] = minIndex + 1;
+
+                // 最小值端点越过其他代理的最大值端点时检测并加入重叠对
+                SortMinDown(axis, minIndex, true);
+                SortMaxDown(axis, data.MaxEndpoint[axis], true);
+            }
+        }
+        m_PendingProxies.clear();
+    }
+
+    void SweepAndPrune::RebuildAll() {
+        for (uint32_t proxy : m_PendingProxies) {
+            m_Proxies[proxy].Pending = false;
+        }
+        m_PendingProxies.clear();
+
+        for (int axis = 0; axis < 3; ++axis) {
+            auto& endpoints = m_Endpoints[axis];
+            endpoints.clear();
+            for (uint32_t proxy = 0; proxy < m_Proxies.size(); ++proxy) {
+                const Proxy& data = m_Proxies[proxy];
+                if (data.Alive) {
+                    endpoints.push_back({data.Bounds.Min[axis], proxy << 1});
+                    endpoints.push_back({data.Bounds.Max[axis], (proxy << 1) | 1});
+                }
+            }
+
+            // 值相等时最小值端点排在前面，与AABB::Intersects把接触视为重叠一致
+            std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint& a, const Endpoint& b) {
+                if (a.Value != b.Value) return a.Value < b.Value;
+                if (a.IsMax() != b.IsMax()) return !a.IsMax();
+                return a.Proxy() < b.Proxy();
+            });
+
+            for (uint32_t i = 0; i < endpoints.size(); ++i) {
+                SetEndpointIndex(axis, i);
+            }
+        }
+
+        // 按X轴最小值顺序把包围盒拷贝到连续数组，向后扫描到最小值超过当前最大值为止
+        std::vector<AABB> sortedBounds;
+        std::vector<uint32_t> sortedProxies;
+        sortedBounds.reserve(m_Endpoints[0].size() / 2);
+        sortedProxies.reserve(m_Endpoints[0].size() / 2);
+        for (const Endpoint& endpoint : m_Endpoints[0]) {
+            if (!endpoint.IsMax()) {
+                sortedBounds.push_back(m_Proxies[endpoint.Proxy()].Bounds);
+                sortedProxies.push_back(endpoint.Proxy());
+            }
+        }
+
+        m_PairSet.Clear();
+        for (size_t i = 0; i < sortedBounds.size(); ++i) {
+            const AABB& a = sortedBounds[i];
+            for (size_t j = i + 1; j < sortedBounds.size(); ++j) {
+                const AABB& b = sortedBounds[j];
+                if (b.Min.x > a.Max.x) {
+                    break;
+                }
+                if (a.Min.y <= b.Max.y && a.Max.y >= b.Min.y && a.Min.z <= b.Max.z && a.Max.z >= b.Min.z) {
+                    m_PairSet.Add(sortedProxies[i], sortedProxies[j]);
+                }
+            }
+        }
+    }
+
+    // 以下四个函数把端点向一个方向移动到有序位置
+    // 端点越过另一个代理的端点时，只有两种情况会改变该轴上的重叠关系：
+    // 最小值越过对方最大值（向下时开始重叠，向上时结束），最大值越过对方最小值（向上时开始重叠，向下时结束）
+
+    void SweepAndPrune::SortMinDown(int axis, uint32_t index, bool updatePairs) {
+        auto& endpoints = m_Endpoints[axis];
+        uint32_t proxy = endpoints[index].Proxy();
+        while (index > 0 && endpoints[index - 1].Value > endpoints[index].Value) {
+            const Endpoint& prev = endpoints[index - 1];
+            if (updatePairs && prev.IsMax() && prev.Proxy() != proxy && TestOverlap(proxy, prev.Proxy())) {
+                m_PairSet.Add(proxy, prev.Proxy());
+            }
+            SwapEndpoints(axis, index - 1, index);
+            --index;
+        }
+    }
+
+    void SweepAndPrune::SortMinUp(int axis, uint32_t index, bool updatePairs) {
+        auto& endpoints = m_Endpoints[axis];
+        uint32_t proxy = endpoints[index].Proxy();
+        while (index + 1 < endpoints.size() && endpoints[index + 1].Value < endpoints[index].Value) {
+            const Endpoint& next = endpoints[index + 1];
+            if (updatePairs && next.IsMax() && next.Proxy() != proxy) {
+                m_PairSet.Remove(proxy, next.Proxy());
+            }
+            SwapEndpoints(axis, index, index + 1);
+            ++index;
+        }
+    }
+
+    void SweepAndPrune::SortMaxDown(int axis, uint32_t index, bool updatePairs) {
+        auto& endpoints = m_Endpoints[axis];
+        uint32_t proxy = endpoints[index].Proxy();
+        while (index > 0 && endpoints[index - 1].Value > endpoints[index].Value) {
+            const Endpoint& prev = endpoints[index - 1];
+            if (updatePairs && !prev.IsMax() && prev.Proxy() != proxy) {
+                m_PairSet.Remove(proxy, prev.Proxy());
+            }
+            SwapEndpoints(axis, index - 1, index);
+            --index;
+        }
+    }
+
+    void SweepAndPrune::SortMaxUp(int axis, uint32_t index, bool updatePairs) {
+        auto& endpoints = m_Endpoints[axis];
+        uint32_t proxy = endpoints[index].Proxy();
+        while (index + 1 < endpoints.size() && endpoints[index + 1].Value < endpoints[index].Value) {
+            const Endpoint& next = endpoints[index + 1];
+            if (updatePairs && !next.IsMax() && next.Proxy() != proxy && TestOverlap(proxy, next.Proxy())) {
+                m_PairSet.Add(proxy, next.Proxy());
+            }
+            SwapEndpoints(axis, index, index + 1);
+            ++index;
+        }
+    }
+
+    void SweepAndPrune::SwapEndpoints(int axis, uint32_t a, uint32_t b) {
+        std::swap(m_Endpoints[axis][a], m_Endpoints[axis][b]);
+        SetEndpointIndex(axis, a);
+        SetEndpointIndex(axis, b);
+    }
+
+    void SweepAndPrune::SetEndpointIndex(int axis, uint32_t index) {
+        const Endpoint& endpoint = m_Endpoints[axis][index];
+        Proxy& data = m_Proxies[endpoint.Proxy()];
+        if (endpoint.IsMax()) {
+            data.MaxEndpoint[axis] = index;
+        } else {
+            data.MinEndpoint[axis] = index;
+        }
+    }
+
+    bool SweepAndPrune::TestOverlap(uint32_t a, uint32_t b) const {
+        return m_Proxies[a].Bounds.Intersects(m_Proxies[b].Bounds);
+    }
+
+}
@@ -0,0 +1,137 @@
+//
+// ContactSolver.cpp - 顺序冲量求解器实现
+//
+
+#include "JFMEngine/Physics/ContactSolver.h"
+#include <algorithm>
+
+namespace JFM {
+
+    namespace ContactSolver {
+
+        namespace {
+            // 直接读写SoA速度数组，静态物体（逆质量为0）从不写入，可被多个岛同时读取
+            struct VelocityAccess {
+                float* X;
+                float* Y;
+                float* Z;
+                const float* InvMass;
+
+                glm::vec3 Get(uint32_t body) const { return glm::vec3(X[body], Y[body], Z[body]); }
+
+                void Apply(uint32_t body, const glm::vec3& impulse) const {
+                    float invMass = InvMass[body];
+                    if (invMass > 0.0f) {
+                        X[body] += impulse.x * invMass;
+                        Y[body] += impulse.y * invMass;
+                        Z[body] += impulse.z * invMass;
+                    }
+                }
+            };
+
+            // SoA位置数组的同类访问
+            using PositionAccess = VelocityAccess;
+        }
+
+        void SolveVelocities(RigidbodyStore& store, ContactManifold* manifolds, const uint32_t* indices, uint32_t count,
+                             const ContactSolverSettings& settings, float deltaTime) {
+            if (count == 0 || deltaTime <= 0.0f) {
+                return;
+            }
+
+            VelocityAccess velocity = { store.GetVelocityX(), store.GetVelocityY(), store.GetVelocityZ(), store.GetInvMassArray() };
+            const float invDeltaTime = 1.0f / deltaTime;
+
+            // 预处理：有效质量和速度偏置
+            for (uint32_t i = 0; i < count; ++i) {
+                ContactManifold& m = manifolds[indices[i]];
+                if (!m.Touching) continue;
+
+                float invMassSum = velocity.InvMass[m.BodyA] + velocity.InvMass[m.BodyB];
+                m.NormalMass = invMassSum > 0.0f ? 1.0f / invMassSum : 0.0f;
+
+                // 接触在积分后的位置上生成，此时的速度就是积分所用的速度；
+                // 刚体只平移，沿法向退回这段位移即为本步开始时的间距
+                float normalVelocity = glm::dot(velocity.Get(m.BodyB) - velocity.Get(m.BodyA), m.Normal);
+                // 预测接触允许在本步内恰好闭合间距；穿透由SolvePositions修正，不进入速度
+                float separation = m.Separation - normalVelocity * deltaTime;
+                m.VelocityBias = separation > 0.0f ? -separation * invDeltaTime : 0.0f;
+                if (normalVelocity < -settings.RestitutionThreshold && m.Restitution > 0.0f) {
+                    m.VelocityBias = std::max(m.VelocityBias, -m.Restitution * normalVelocity);
+                }
+            }
+
+            // 热启动单独一轮：预处理读取的必须是所有接触施加冲量之前的速度
+            for (uint32_t i = 0; i < count; ++i) {
+                ContactManifold& m = manifolds[indices[i]];
+                if (!m.Touching) continue;
+
+                if (settings.WarmStarting) {
+                    // 法向变化后旧的摩擦冲量只保留切平面内的分量
+                    m.TangentImpulse -= glm::dot(m.TangentImpulse, m.Normal) * m.Normal;
+                    glm::vec3 impulse = m.NormalImpulse * m.Normal + m.TangentImpulse;
+                    velocity.Apply(m.BodyA, -impulse);
+                    velocity.Apply(m.BodyB, impulse);
+                } else {
+                    m.NormalImpulse = 0.0f;
+                    m.TangentImpulse = glm::vec3(0.0f);
+                }
+            }
+
+            for (int iteration = 0; iteration < settings.VelocityIterations; ++iteration) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    ContactManifold& m = manifolds[indices[i]];
+                    if (!m.Touching || m.NormalMass == 0.0f) continue;
+
+                    // 先解摩擦：法向约束更重要，放在最后保证不穿透
+                    glm::vec3 relative = velocity.Get(m.BodyB) - velocity.Get(m.BodyA);
+                    glm::vec3 tangentVelocity = relative - glm::dot(relative, m.Normal) * m.Normal;
+                    glm::vec3 oldTangent = m.TangentImpulse;
+                    glm::vec3 newTangent = oldTangent - tangentVelocity * m.NormalMass;
+                    float maxFriction = m.Friction * m.NormalImpulse;
+                    float tangentLengthSq = glm::dot(newTangent, newTangent);
+                    if (tangentLengthSq > maxFriction * maxFriction) {
+                        newTangent *= maxFriction / std::sqrt(tangentLengthSq);
+                    }
+                    m.TangentImpulse = newTangent;
+                    glm::vec3 tangentDelta = newTangent - oldTangent;
+                    velocity.Apply(m.BodyA, -tangentDelta);
+                    velocity.Apply(m.BodyB, tangentDelta);
+
+                    // 法向：累积冲量非负
+                    float normalVelocity = glm::dot(velocity.Get(m.BodyB) - velocity.Get(m.BodyA), m.Normal);
+                    float lambda = -m.NormalMass * (normalVelocity - m.VelocityBias);
+                    float newImpulse = std::max(m.NormalImpulse + lambda, 0.0f);
+                    glm::vec3 normalDelta = (newImpulse - m.NormalImpulse) * m.Normal;
+                    m.NormalImpulse = newImpulse;
+                    velocity.Apply(m.BodyA, -normalDelta);
+                    velocity.Apply(m.BodyB, normalDelta);
+                }
+            }
+        }
+
+        void SolvePositions(RigidbodyStore& store, const ContactManifold* manifolds, const uint32_t* indices, uint32_t count,
+                            const ContactSolverSettings& settings) {
+            PositionAccess position = { store.GetPositionX(), store.GetPositionY(), store.GetPositionZ(), store.GetInvMassArray() };
+
+            for (int iteration = 0; iteration < settings.PositionIterations; ++iteration) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    const ContactManifold& m = manifolds[indices[i]];
+                    if (!m.Touching || m.NormalMass == 0.0f) continue;
+
+                    // 刚体只平移，法向不变时间距随相对位移线性变化
+                    glm::vec3 offset = position.Get(m.BodyB) - position.Get(m.BodyA);
+                    float separation = m.Separation + glm::dot(offset - m.Offset, m.Normal);
+                    float correction = std::clamp(settings.Baumgarte * (separation + settings.LinearSlop), -settings.MaxCorrection, 0.0f);
+                    if (correction == 0.0f) continue;
+
+                    glm::vec3 impulse = (-correction * m.NormalMass) * m.Normal;
+                    position.Apply(m.BodyA, -impulse);
+                    position.Apply(m.BodyB, impulse);
+                }
+            }
+        }
+
+    }
+
+}
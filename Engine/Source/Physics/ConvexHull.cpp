@@ -0,0 +1,420 @@
+//
+// ConvexHull.cpp - quickhull凸包构建与支撑点查询
+//
+
+#include "JFMEngine/Physics/ConvexHull.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace JFM {
+
+    namespace {
+        constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+        // 三角形面：边i为V[i] -> V[(i + 1) % 3]，Adjacent[i]为共享该边的相邻面
+        struct HullFace {
+            uint32_t V[3] = { 0, 0, 0 };
+            uint32_t Adjacent[3] = { InvalidIndex, InvalidIndex, InvalidIndex };
+            glm::vec3 Normal = glm::vec3(0.0f);
+            float Offset = 0.0f;
+            std::vector<uint32_t> Outside;  // 位于该面外侧、尚未处理的点
+            bool Visible = false;
+            bool Removed = false;
+
+            float Distance(const glm::vec3& point) const { return glm::dot(Normal, point) - Offset; }
+        };
+
+        struct HorizonEdge {
+            uint32_t From;
+            uint32_t To;
+            uint32_t Face;      // 边外侧不可见的面
+        };
+
+        class QuickHull {
+        public:
+            QuickHull(const std::vector<glm::vec3>& points, float epsilon)
+                : m_Points(points), m_Epsilon(epsilon) {}
+
+            // 点集退化（共面或共线）时返回false
+            bool Build();
+
+            void Extract(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) const;
+
+        private:
+            uint32_t AddFace(uint32_t a, uint32_t b, uint32_t c);
+            bool BuildInitialSimplex();
+            void AssignPoint(uint32_t point, const std::vector<uint32_t>& faces);
+            void AddPoint(uint32_t face, uint32_t eye);
+            void FindHorizon(const glm::vec3& eye, uint32_t face, uint32_t startEdge);
+
+            uint32_t EdgeIndex(const HullFace& face, uint32_t neighbor) const {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    if (face.Adjacent[i] == neighbor) return i;
+                }
+                return InvalidIndex;
+            }
+
+            const std::vector<glm::vec3>& m_Points;
+            float m_Epsilon;
+            std::vector<HullFace> m_Faces;
+            std::vector<HorizonEdge> m_Horizon;
+            std::vector<uint32_t> m_VisibleFaces;
+            std::vector<uint32_t> m_NewFaces;
+        };
+
+        uint32_t QuickHull::AddFace(uint32_t a, uint32_t b, uint32_t c) {
+            HullFace face;
+            face.V[0] = a;
+            face.V[1] = b;
+            face.V[2] = c;
+
+            // 细长三角形的法向在单精度下误差较大，用双精度计算
+            const glm::vec3& pa = m_Points[a];
+            const glm::vec3& pb = m_Points[b];
+            const glm::vec3& pc = m_Points[c];
+            double e0[3], e1[3];
+            for (int i = 0; i < 3; ++i) {
+                e0[i] = double(pb[i]) - double(pa[i]);
+                e1[i] = double(pc[i]) - double(pa[i]);
+            }
+            double normal[3] = {
+                e0[1] * e1[2] - e0[2] * e1[1],
+                e0[2] * e1[0] - e0[0] * e1[2],
+                e0[0] * e1[1] - e0[1] * e1[0]
+            };
+            double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (length > 0.0) {
+                double offset = 0.0;
+                for (int i = 0; i < 3; ++i) {
+                    normal[i] /= length;
+                    offset += normal[i] * (double(pa[i]) + double(pb[i]) + double(pc[i])) / 3.0;
+                }
+                face.Normal = glm::vec3(float(normal[0]), float(normal[1]), float(normal[2]));
+                face.Offset = static_cast<float>(offset);
+            }
+
+            m_Faces.push_back(std::move(face));
+            return static_cast<uint32_t>(m_Faces.size() - 1);
+        }
+
+        bool QuickHull::BuildInitialSimplex() {
+            // 各轴上的极值点中取距离最远的两个
+            uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+            for (uint32_t i = 0; i < m_Points.size(); ++i) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (m_Points[i][axis] < m_Points[extremes[axis * 2]][axis]) extremes[axis * 2] = i;
+                    if (m_Points[i][axis] > m_Points[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+                }
+            }
+
+            uint32_t i0 = 0, i1 = 0;
+            float bestDistance = -1.0f;
+            for (int a = 0; a < 6; ++a) {
+                for (int b = a + 1; b < 6; ++b) {
+                    glm::vec3 d = m_Points[extremes[a]] - m_Points[extremes[b]];
+                    float distance = glm::dot(d, d);
+                    if (distance > bestDistance) {
+                        bestDistance = distance;
+                        i0 = extremes[a];
+                        i1 = extremes[b];
+                    }
+                }
+            }
+            if (std::sqrt(bestDistance) <= m_Epsilon) {
+                return false;
+            }
+
+            // 离直线最远的点
+            glm::vec3 line = glm::normalize(m_Points[i1] - m_Points[i0]);
+            uint32_t i2 = 0;
+            bestDistance = -1.0f;
+            for (uint32_t i = 0; i < m_Points.size(); ++i) {
+                glm::vec3 d = m_Points[i] - m_Points[i0];
+                glm::vec3 perpendicular = d - line * glm::dot(d, line);
+                float distance = glm::dot(perpendicular, perpendicular);
+                if (distance > bestDistance) {
+                    bestDistance = distance;
+                    i2 = i;
+                }
+            }
+            if (std::sqrt(bestDistance) <= m_Epsilon) {
+                return false;
+            }
+
+            // 离平面最远的点
+            glm::vec3 normal = glm::normalize(glm::cross(m_Points[i1] - m_Points[i0], m_Points[i2] - m_Points[i0]));
+            uint32_t i3 = 0;
+            bestDistance = 0.0f;
+            for (uint32_t i = 0; i < m_Points.size(); ++i) {
+                float distance = glm::dot(m_Points[i] - m_Points[i0], normal);
+                if (std::abs(distance) > std::abs(bestDistance)) {
+                    bestDistance = distance;
+                    i3 = i;
+                }
+            }
+            if (std::abs(bestDistance) <= m_Epsilon) {
+                return false;
+            }
+
+            // 第四个点在底面外侧时翻转底面，保证所有面朝外
+            if (bestDistance > 0.0f) {
+                std::swap(i1, i2);
+            }
+
+            AddFace(i0, i1, i2);
+            AddFace(i0, i3, i1);
+            AddFace(i1, i3, i2);
+            AddFace(i2, i3, i0);
+
+            // 四面体的邻接关系按共享边匹配
+            for (uint32_t f = 0; f < 4; ++f) {
+                for (uint32_t e = 0; e < 3; ++e) {
+                    uint32_t from = m_Faces[f].V[e];
+                    uint32_t to = m_Faces[f].V[(e + 1) % 3];
+                    for (uint32_t g = 0; g < 4; ++g) {
+                        if (g == f) continue;
+                        for (uint32_t k = 0; k < 3; ++k) {
+                            if (m_Faces[g].V[k] == to && m_Faces[g].V[(k + 1) % 3] == from) {
+                                m_Faces[f].Adjacent[e] = g;
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::vector<uint32_t> initialFaces = { 0, 1, 2, 3 };
+            for (uint32_t i = 0; i < m_Points.size(); ++i) {
+                if (i != i0 && i != i1 && i != i2 && i != i3) {
+                    AssignPoint(i, initialFaces);
+                }
+            }
+            return true;
+        }
+
+        void QuickHull::AssignPoint(uint32_t point, const std::vector<uint32_t>& faces) {
+            // 分给距离最远的面，在容差内的点已在凸包内，直接丢弃
+            uint32_t best = InvalidIndex;
+            float bestDistance = m_Epsilon;
+            for (uint32_t face : faces) {
+                float distance = m_Faces[face].Distance(m_Points[point]);
+                if (distance > bestDistance) {
+                    bestDistance = distance;
+                    best = face;
+                }
+            }
+            if (best != InvalidIndex) {
+                m_Faces[best].Outside.push_back(point);
+            }
+        }
+
+        void QuickHull::FindHorizon(const glm::vec3& eye, uint32_t faceIndex, uint32_t startEdge) {
+            // 深度优先遍历可见面，按绕向依次记录地平线边，保证地平线首尾相接
+            m_Faces[faceIndex].Visible = true;
+            m_VisibleFaces.push_back(faceIndex);
+
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint32_t edge = (startEdge + k) % 3;
+                uint32_t neighbor = m_Faces[faceIndex].Adjacent[edge];
+                if (m_Faces[neighbor].Visible) {
+                    continue;
+                }
+
+                if (m_Faces[neighbor].Distance(eye) > -m_Epsilon) {
+                    uint32_t back = EdgeIndex(m_Faces[neighbor], faceIndex);
+                    FindHorizon(eye, neighbor, (back + 1) % 3);
+                } else {
+                    const HullFace& face = m_Faces[faceIndex];
+                    m_Horizon.push_back({ face.V[edge], face.V[(edge + 1) % 3], neighbor });
+                }
+            }
+        }
+
+        void QuickHull::AddPoint(uint32_t faceIndex, uint32_t eye) {
+            m_Horizon.clear();
+            m_VisibleFaces.clear();
+            m_NewFaces.clear();
+            FindHorizon(m_Points[eye], faceIndex, 0);
+
+            // 地平线上每条边与视点构成新面：(From, To, eye)
+            for (const HorizonEdge& edge : m_Horizon) {
+                uint32_t face = AddFace(edge.From, edge.To, eye);
+                m_Faces[face].Adjacent[0] = edge.Face;
+                HullFace& outer = m_Faces[edge.Face];
+                for (uint32_t k = 0; k < 3; ++k) {
+                    if (outer.V[k] == edge.To && outer.V[(k + 1) % 3] == edge.From) {
+                        outer.Adjacent[k] = face;
+                    }
+                }
+                m_NewFaces.push_back(face);
+            }
+
+            // 新面之间首尾相连
+            size_t count = m_NewFaces.size();
+            for (size_t i = 0; i < count; ++i) {
+                HullFace& face = m_Faces[m_NewFaces[i]];
+                face.Adjacent[1] = m_NewFaces[(i + 1) % count];
+                face.Adjacent[2] = m_NewFaces[(i + count - 1) % count];
+            }
+
+            // 可见面的外部点重新分配给新面
+            for (uint32_t visible : m_VisibleFaces) {
+                std::vector<uint32_t> outside = std::move(m_Faces[visible].Outside);
+                m_Faces[visible].Outside.clear();
+                m_Faces[visible].Removed = true;
+                for (uint32_t point : outside) {
+                    if (point != eye) {
+                        AssignPoint(point, m_NewFaces);
+                    }
+                }
+            }
+        }
+
+        bool QuickHull::Build() {
+            if (m_Points.size() < 4 || !BuildInitialSimplex()) {
+                return false;
+            }
+
+            // 新面追加在末尾，一次顺序遍历即可处理完所有外部点
+            for (uint32_t f = 0; f < m_Faces.size(); ++f) {
+                if (m_Faces[f].Removed || m_Faces[f].Outside.empty()) {
+                    continue;
+                }
+
+                const HullFace& face = m_Faces[f];
+                uint32_t eye = face.Outside[0];
+                float eyeDistance = face.Distance(m_Points[eye]);
+                for (uint32_t point : face.Outside) {
+                    float distance = face.Distance(m_Points[point]);
+                    if (distance > eyeDistance) {
+                        eyeDistance = distance;
+                        eye = point;
+                    }
+                }
+                AddPoint(f, eye);
+            }
+            return true;
+        }
+
+        void QuickHull::Extract(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) const {
+            std::vector<uint32_t> remap(m_Points.size(), InvalidIndex);
+            for (const HullFace& face : m_Faces) {
+                if (face.Removed) continue;
+                for (uint32_t v : face.V) {
+                    if (remap[v] == InvalidIndex) {
+                        remap[v] = static_cast<uint32_t>(vertices.size());
+                        vertices.push_back(m_Points[v]);
+                    }
+                    indices.push_back(remap[v]);
+                }
+            }
+        }
+    }
+
+    ConvexHull::ConvexHull(const std::vector<glm::vec3>& points) {
+        Build(points);
+    }
+
+    void ConvexHull::Build(const std::vector<glm::vec3>& points) {
+        m_Vertices.clear();
+        m_Indices.clear();
+        m_AdjacencyOffsets.clear();
+        m_Adjacency.clear();
+        if (points.empty()) {
+            return;
+        }
+
+        glm::vec3 low = points[0];
+        glm::vec3 high = points[0];
+        for (const glm::vec3& point : points) {
+            low = glm::min(low, point);
+            high = glm::max(high, point);
+        }
+
+        // 容差与坐标的量级成比例
+        glm::vec3 magnitude = glm::max(glm::abs(low), glm::abs(high));
+        float epsilon = 3.0f * FLT_EPSILON * (magnitude.x + magnitude.y + magnitude.z) * 8.0f;
+
+        QuickHull builder(points, epsilon);
+        if (builder.Build()) {
+            builder.Extract(m_Vertices, m_Indices);
+            BuildAdjacency();
+            return;
+        }
+
+        // 退化点集：保留去重后的点
+        m_Vertices = points;
+        std::sort(m_Vertices.begin(), m_Vertices.end(), [](const glm::vec3& a, const glm::vec3& b) {
+            return a.x < b.x || (a.x == b.x && (a.y < b.y || (a.y == b.y && a.z < b.z)));
+        });
+        m_Vertices.erase(std::unique(m_Vertices.begin(), m_Vertices.end()), m_Vertices.end());
+    }
+
+    void ConvexHull::BuildAdjacency() {
+        // 每条边在两个面中以相反方向各出现一次，只取From < To的那次
+        std::vector<uint32_t> degree(m_Vertices.size() + 1, 0);
+        for (size_t i = 0; i < m_Indices.size(); i += 3) {
+            for (size_t e = 0; e < 3; ++e) {
+                uint32_t from = m_Indices[i + e];
+                uint32_t to = m_Indices[i + (e + 1) % 3];
+                if (from < to) {
+                    degree[from]++;
+                    degree[to]++;
+                }
+            }
+        }
+
+        m_AdjacencyOffsets.assign(m_Vertices.size() + 1, 0);
+        for (size_t v = 0; v < m_Vertices.size(); ++v) {
+            m_AdjacencyOffsets[v + 1] = m_AdjacencyOffsets[v] + degree[v];
+        }
+
+        m_Adjacency.resize(m_AdjacencyOffsets.back());
+        std::vector<uint32_t> cursor(m_AdjacencyOffsets.begin(), m_AdjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < m_Indices.size(); i += 3) {
+            for (size_t e = 0; e < 3; ++e) {
+                uint32_t from = m_Indices[i + e];
+                uint32_t to = m_Indices[i + (e + 1) % 3];
+                if (from < to) {
+                    m_Adjacency[cursor[from]++] = to;
+                    m_Adjacency[cursor[to]++] = from;
+                }
+            }
+        }
+    }
+
+    uint32_t ConvexHull::GetSupport(const glm::vec3& direction, uint32_t hint) const {
+        if (m_Vertices.size() <= HillClimbThreshold || m_Adjacency.empty()) {
+            uint32_t best = 0;
+            float bestDot = -FLT_MAX;
+            for (uint32_t i = 0; i < m_Vertices.size(); ++i) {
+                float d = glm::dot(m_Vertices[i], direction);
+                if (d > bestDot) {
+                    bestDot = d;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // 凸多面体上线性函数的局部最大即全局最大：沿邻接图走向更远的邻居，直到没有更远的
+        uint32_t current = hint < m_Vertices.size() ? hint : 0;
+        float currentDot = glm::dot(m_Vertices[current], direction);
+        for (;;) {
+            uint32_t next = current;
+            for (uint32_t i = m_AdjacencyOffsets[current]; i < m_AdjacencyOffsets[current + 1]; ++i) {
+                uint32_t neighbor = m_Adjacency[i];
+                float d = glm::dot(m_Vertices[neighbor], direction);
+                if (d > currentDot) {
+                    currentDot = d;
+                    next = neighbor;
+                }
+            }
+            if (next == current) {
+                return current;
+            }
+            current = next;
+        }
+    }
+
+}
@@ -0,0 +1,310 @@
+//
+// DynamicAABBTree.cpp - 动态包围盒树实现
+//
+
+#include "JFMEngine/Physics/DynamicAABBTree.h"
+#include <cmath>
+
+namespace JFM {
+
+    DynamicAABBTree::DynamicAABBTree(float margin, float displacementScale)
+        : m_Margin(margin), m_DisplacementScale(displacementScale) {
+    }
+
+    uint32_t DynamicAABBTree::AllocateNode() {
+        if (m_FreeList == NullNode) {
+            m_Nodes.emplace_back();
+            return static_cast<uint32_t>(m_Nodes.size() - 1);
+        }
+
+        uint32_t node = m_FreeList;
+        m_FreeList = m_Nodes[node].Parent;
+        m_Nodes[node] = Node();
+        return node;
+    }
+
+    void DynamicAABBTree::FreeNode(uint32_t node) {
+        m_Nodes[node].Parent = m_FreeList;
+        m_Nodes[node].Height = -1;
+        m_FreeList = node;
+    }
+
+    uint32_t DynamicAABBTree::CreateProxy(const AABB& bounds, uint32_t userData) {
+        uint32_t proxy = AllocateNode();
+
+        Node& node = m_Nodes[proxy];
+        glm::vec3 margin(m_Margin);
+        node.Bounds = AABB(bounds.Min - margin, bounds.Max + margin);
+        node.UserData = userData;
+        node.Height = 0;
+
+        InsertLeaf(proxy);
+        ++m_ProxyCount;
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(uint32_t proxy) {
+        if (proxy >= m_Nodes.size() || !m_Nodes[proxy].IsLeaf() || m_Nodes[proxy].Height < 0) {
+            return;
+        }
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --m_ProxyCount;
+    }
+
+    bool DynamicAABBTree::MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement) {
+        // 新的胖包围盒：四周加上余量，并沿位移方向预先扩展
+        glm::vec3 margin(m_Margin);
+        AABB fat(bounds.Min - margin, bounds.Max + margin);
+        glm::vec3 predicted = displacement * m_DisplacementScale;
+        fat.Min += glm::min(predicted, glm::vec3(0.0f));
+        fat.Max += glm::max(predicted, glm::vec3(0.0f));
+
+        const AABB& current = m_Nodes[proxy].Bounds;
+        if (Contains(current, bounds)) {
+            // 仍在原胖包围盒内，除非原包围盒已经比需要的大很多（例如物体减速后），否则不动
+            glm::vec3 hugeMargin(4.0f * m_Margin);
+            AABB huge(fat.Min - hugeMargin, fat.Max + hugeMargin);
+            if (Contains(huge, current)) {
+                return false;
+            }
+        }
+
+        RemoveLeaf(proxy);
+        m_Nodes[proxy].Bounds = fat;
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void DynamicAABBTree::Clear() {
+        m_Nodes.clear();
+        m_Root = NullNode;
+        m_FreeList = NullNode;
+        m_ProxyCount = 0;
+    }
+
+    float DynamicAABBTree::GetAreaRatio() const {
+        if (m_Root == NullNode) {
+            return 0.0f;
+        }
+
+        float rootArea = SurfaceArea(m_Nodes[m_Root].Bounds);
+        float totalArea = 0.0f;
+        for (const Node& node : m_Nodes) {
+            if (node.Height >= 0) {
+                totalArea += SurfaceArea(node.Bounds);
+            }
+        }
+        return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+    }
+
+    uint32_t DynamicAABBTree::FindBestSibling(const AABB& bounds) const {
+        // 自顶向下按表面积启发式选择兄弟节点：
+        // 作为当前节点的兄弟的代价，与下降到某个子节点的代价（含祖先包围盒增大的继承代价）比较
+        uint32_t index = m_Root;
+        while (!m_Nodes[index].IsLeaf()) {
+            const Node& node = m_Nodes[index];
+            float area = SurfaceArea(node.Bounds);
+            float combinedArea = SurfaceArea(Combine(node.Bounds, bounds));
+
+            float cost = 2.0f * combinedArea;
+            float inheritance = 2.0f * (combinedArea - area);
+
+            auto childCost = [&](uint32_t child) {
+                const Node& childNode = m_Nodes[child];
+                float newArea = SurfaceArea(Combine(bounds, childNode.Bounds));
+                if (childNode.IsLeaf()) {
+                    return newArea + inheritance;
+                }
+                return newArea - SurfaceArea(childNode.Bounds) + inheritance;
+            };
+
+            float cost1 = childCost(node.Child1);
+            float cost2 = childCost(node.Child2);
+
+            if (cost < cost1 && cost < cost2) {
+                break;
+            }
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+        return index;
+    }
+
+    void DynamicAABBTree::InsertLeaf(uint32_t leaf) {
+        if (m_Root == NullNode) {
+            m_Root = leaf;
+            m_Nodes[leaf].Parent = NullNode;
+            return;
+        }
+
+        AABB leafBounds = m_Nodes[leaf].Bounds;
+        uint32_t sibling = FindBestSibling(leafBounds);
+
+        // 新建父节点替换兄弟节点的位置
+        uint32_t oldParent = m_Nodes[sibling].Parent;
+        uint32_t newParent = AllocateNode();
+        Node& parentNode = m_Nodes[newParent];
+        parentNode.Parent = oldParent;
+        parentNode.Bounds = Combine(leafBounds, m_Nodes[sibling].Bounds);
+        parentNode.Height = m_Nodes[sibling].Height + 1;
+        parentNode.Child1 = sibling;
+        parentNode.Child2 = leaf;
+
+        if (oldParent != NullNode) {
+            if (m_Nodes[oldParent].Child1 == sibling) {
+                m_Nodes[oldParent].Child1 = newParent;
+            } else {
+                m_Nodes[oldParent].Child2 = newParent;
+            }
+        } else {
+            m_Root = newParent;
+        }
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent = newParent;
+
+        RefitAncestors(newParent);
+    }
+
+    void DynamicAABBTree::RemoveLeaf(uint32_t leaf) {
+        if (leaf == m_Root) {
+            m_Root = NullNode;
+            return;
+        }
+
+        uint32_t parent = m_Nodes[leaf].Parent;
+        uint32_t grandParent = m_Nodes[parent].Parent;
+        uint32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        // 兄弟节点顶替父节点
+        if (grandParent != NullNode) {
+            if (m_Nodes[grandParent].Child1 == parent) {
+                m_Nodes[grandParent].Child1 = sibling;
+            } else {
+                m_Nodes[grandParent].Child2 = sibling;
+            }
+            m_Nodes[sibling].Parent = grandParent;
+            FreeNode(parent);
+            RefitAncestors(grandParent);
+        } else {
+            m_Root = sibling;
+            m_Nodes[sibling].Parent = NullNode;
+            FreeNode(parent);
+        }
+    }
+
+    void DynamicAABBTree::RefitAncestors(uint32_t index) {
+        // 自下而上重新计算包围盒和高度，沿途做旋转保持平衡
+        while (index != NullNode) {
+            index = Balance(index);
+
+            Node& node = m_Nodes[index];
+            const Node& child1 = m_Nodes[node.Child1];
+            const Node& child2 = m_Nodes[node.Child2];
+            node.Height = 1 + std::max(child1.Height, child2.Height);
+            node.Bounds = Combine(child1.Bounds, child2.Bounds);
+
+            index = node.Parent;
+        }
+    }
+
+    uint32_t DynamicAABBTree::Balance(uint32_t iA) {
+        // 左右子树高度差超过1时，把较高的子节点C旋转上来，返回替换iA位置的节点
+        Node& A = m_Nodes[iA];
+        if (A.IsLeaf() || A.Height < 2) {
+            return iA;
+        }
+
+        uint32_t iB = A.Child1;
+        uint32_t iC = A.Child2;
+        Node& B = m_Nodes[iB];
+        Node& C = m_Nodes[iC];
+        int32_t balance = C.Height - B.Height;
+
+        // 右侧过高：C上移
+        if (balance > 1) {
+            uint32_t iF = C.Child1;
+            uint32_t iG = C.Child2;
+            Node& F = m_Nodes[iF];
+            Node& G = m_Nodes[iG];
+
+            C.Child1 = iA;
+            C.Parent = A.Parent;
+            A.Parent = iC;
+
+            if (C.Parent != NullNode) {
+                if (m_Nodes[C.Parent].Child1 == iA) {
+                    m_Nodes[C.Parent].Child1 = iC;
+                } else {
+                    m_Nodes[C.Parent].Child2 = iC;
+                }
+            } else {
+                m_Root = iC;
+            }
+
+            // 较高的孙节点留在C下，较矮的交给A
+            if (F.Height > G.Height) {
+                C.Child2 = iF;
+                A.Child2 = iG;
+                G.Parent = iA;
+                A.Bounds = Combine(B.Bounds, G.Bounds);
+                C.Bounds = Combine(A.Bounds, F.Bounds);
+                A.Height = 1 + std::max(B.Height, G.Height);
+                C.Height = 1 + std::max(A.Height, F.Height);
+            } else {
+                C.Child2 = iG;
+                A.Child2 = iF;
+                F.Parent = iA;
+                A.Bounds = Combine(B.Bounds, F.Bounds);
+                C.Bounds = Combine(A.Bounds, G.Bounds);
+                A.Height = 1 + std::max(B.Height, F.Height);
+                C.Height = 1 + std::max(A.Height, G.Height);
+            }
+            return iC;
+        }
+
+        // 左侧过高：B上移
+        if (balance < -1) {
+            uint32_t iD = B.Child1;
+            uint32_t iE = B.Child2;
+            Node& D = m_Nodes[iD];
+            Node& E = m_Nodes[iE];
+
+            B.Child1 = iA;
+            B.Parent = A.Parent;
+            A.Parent = iB;
+
+            if (B.Parent != NullNode) {
+                if (m_Nodes[B.Parent].Child1 == iA) {
+                    m_Nodes[B.Parent].Child1 = iB;
+                } else {
+                    m_Nodes[B.Parent].Child2 = iB;
+                }
+            } else {
+                m_Root = iB;
+            }
+
+            if (D.Height > E.Height) {
+                B.Child2 = iD;
+                A.Child1 = iE;
+                E.Parent = iA;
+                A.Bounds = Combine(C.Bounds, E.Bounds);
+                B.Bounds = Combine(A.Bounds, D.Bounds);
+                A.Height = 1 + std::max(C.Height, E.Height);
+                B.Height = 1 + std::max(A.Height, D.Height);
+            } else {
+                B.Child2 = iE;
+                A.Child1 = iD;
+                D.Parent = iA;
+                A.Bounds = Combine(C.Bounds, D.Bounds);
+                B.Bounds = Combine(A.Bounds, E.Bounds);
+                A.Height = 1 + std::max(C.Height, D.Height);
+                B.Height = 1 + std::max(A.Height, E.Height);
+            }
+            return iB;
+        }
+
+        return iA;
+    }
+
+}
@@ -0,0 +1,532 @@
+//
+// GJK.cpp - GJK距离查询与EPA穿透深度实现
+//
+
+#include "JFMEngine/Physics/GJK.h"
+#include <cfloat>
+#include <cmath>
+
+namespace JFM {
+
+    namespace GJK {
+
+        namespace {
+            constexpr float OverlapTolerance = 1e-5f;       // 核心距离小于该值时按重叠处理
+            constexpr float RelativeTolerance = 1e-5f;      // 距离平方的相对改进小于该值时收敛
+            constexpr float EPATolerance = 1e-4f;
+            constexpr int MaxEPAVertices = MaxEPAIterations + 4;
+            constexpr int MaxEPAFaces = MaxEPAVertices * 2;
+            constexpr int MaxEPAEdges = MaxEPAFaces * 3;
+
+            // 闵可夫斯基差B - A上的一个顶点
+            struct SimplexVertex {
+                glm::vec3 A;
+                glm::vec3 B;
+                glm::vec3 W;
+                uint32_t IndexA;
+                uint32_t IndexB;
+            };
+
+            // 单纯形上最近点所在的特征：顶点编号及重心坐标
+            struct Feature {
+                int Count = 0;
+                int Index[3] = { 0, 0, 0 };
+                float Weight[3] = { 0.0f, 0.0f, 0.0f };
+            };
+
+            Feature MakeFeature(int i0) {
+                Feature f;
+                f.Count = 1;
+                f.Index[0] = i0;
+                f.Weight[0] = 1.0f;
+                return f;
+            }
+
+            Feature MakeFeature(int i0, int i1, float w1) {
+                Feature f;
+                f.Count = 2;
+                f.Index[0] = i0; f.Index[1] = i1;
+                f.Weight[0] = 1.0f - w1; f.Weight[1] = w1;
+                return f;
+            }
+
+            float DistanceSq(const Feature& feature, const SimplexVertex* vertices) {
+                glm::vec3 point(0.0f);
+                for (int i = 0; i < feature.Count; ++i) {
+                    point += feature.Weight[i] * vertices[feature.Index[i]].W;
+                }
+                return glm::dot(point, point);
+            }
+
+            Feature ClosestOnSegment(const SimplexVertex* vertices, int i0, int i1) {
+                const glm::vec3& a = vertices[i0].W;
+                glm::vec3 ab = vertices[i1].W - a;
+                float lengthSq = glm::dot(ab, ab);
+                if (lengthSq <= FLT_EPSILON * FLT_EPSILON) {
+                    return MakeFeature(i0);
+                }
+
+                float t = -glm::dot(a, ab) / lengthSq;
+                if (t <= 0.0f) return MakeFeature(i0);
+                if (t >= 1.0f) return MakeFeature(i1);
+                return MakeFeature(i0, i1, t);
+            }
+
+            Feature ClosestOnTriangle(const SimplexVertex* vertices, int i0, int i1, int i2) {
+                const glm::vec3& a = vertices[i0].W;
+                const glm::vec3& b = vertices[i1].W;
+                const glm::vec3& c = vertices[i2].W;
+                glm::vec3 ab = b - a;
+                glm::vec3 ac = c - a;
+
+                // 退化三角形：取三条边中最近的
+                glm::vec3 normal = glm::cross(ab, ac);
+                if (glm::dot(normal, normal) <= 1e-10f * glm::dot(ab, ab) * glm::dot(ac, ac)) {
+                    Feature best = ClosestOnSegment(vertices, i0, i1);
+                    float bestDistance = DistanceSq(best, vertices);
+                    Feature candidates[2] = { ClosestOnSegment(vertices, i1, i2), ClosestOnSegment(vertices, i0, i2) };
+                    for (const Feature& candidate : candidates) {
+                        float distance = DistanceSq(candidate, vertices);
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            best = candidate;
+                        }
+                    }
+                    return best;
+                }
+
+                // 按Voronoi区域判断原点最近的特征
+                float d1 = -glm::dot(ab, a);
+                float d2 = -glm::dot(ac, a);
+                if (d1 <= 0.0f && d2 <= 0.0f) return MakeFeature(i0);
+
+                float d3 = -glm::dot(ab, b);
+                float d4 = -glm::dot(ac, b);
+                if (d3 >= 0.0f && d4 <= d3) return MakeFeature(i1);
+
+                float vc = d1 * d4 - d3 * d2;
+                if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return MakeFeature(i0, i1, d1 / (d1 - d3));
+
+                float d5 = -glm::dot(ab, c);
+                float d6 = -glm::dot(ac, c);
+                if (d6 >= 0.0f && d5 <= d6) return MakeFeature(i2);
+
+                float vb = d5 * d2 - d1 * d6;
+                if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return MakeFeature(i0, i2, d2 / (d2 - d6));
+
+                float va = d3 * d6 - d5 * d4;
+                if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+                    return MakeFeature(i1, i2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+                }
+
+                float denominator = 1.0f / (va + vb + vc);
+                Feature f;
+                f.Count = 3;
+                f.Index[0] = i0; f.Index[1] = i1; f.Index[2] = i2;
+                f.Weight[1] = vb * denominator;
+                f.Weight[2] = vc * denominator;
+                f.Weight[0] = 1.0f - f.Weight[1] - f.Weight[2];
+                return f;
+            }
+
+            struct Simplex {
+                SimplexVertex V[4];
+                float Lambda[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+                int Count = 0;
+
+                // 求单纯形上离原点最近的点，并缩减为包含该点的最小子单纯形
+                // 原点在四面体内部时返回false
+                bool Solve(glm::vec3& closest) {
+                    Feature feature;
+                    switch (Count) {
+                        case 1: feature = MakeFeature(0); break;
+                        case 2: feature = ClosestOnSegment(V, 0, 1); break;
+                        case 3: feature = ClosestOnTriangle(V, 0, 1, 2); break;
+                        default: {
+                            // 只有原点与对顶点分处某个面两侧时，最近点才可能在该面上
+                            static const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+                            float bestDistance = FLT_MAX;
+                            bool outside = false;
+                            for (const auto& face : faces) {
+                                const glm::vec3& a = V[face[0]].W;
+                                glm::vec3 normal = glm::cross(V[face[1]].W - a, V[face[2]].W - a);
+                                float sideOrigin = -glm::dot(a, normal);
+                                float sideOpposite = glm::dot(V[face[3]].W - a, normal);
+                                bool degenerate = sideOpposite * sideOpposite <= 1e-12f * glm::dot(normal, normal);
+                                if (!degenerate && sideOrigin * sideOpposite >= 0.0f) {
+                                    continue;
+                                }
+
+                                outside = true;
+                                Feature candidate = ClosestOnTriangle(V, face[0], face[1], face[2]);
+                                float distance = DistanceSq(candidate, V);
+                                if (distance < bestDistance) {
+                                    bestDistance = distance;
+                                    feature = candidate;
+                                }
+                            }
+                            if (!outside) {
+                                closest = glm::vec3(0.0f);
+                                return false;
+                            }
+                            break;
+                        }
+                    }
+
+                    SimplexVertex reduced[3];
+                    closest = glm::vec3(0.0f);
+                    for (int i = 0; i < feature.Count; ++i) {
+                        reduced[i] = V[feature.Index[i]];
+                        Lambda[i] = feature.Weight[i];
+                        closest += Lambda[i] * reduced[i].W;
+                    }
+                    for (int i = 0; i < feature.Count; ++i) {
+                        V[i] = reduced[i];
+                    }
+                    Count = feature.Count;
+                    return true;
+                }
+            };
+
+            SimplexVertex MakeVertex(const ConvexShape& shapeA, const ConvexShape& shapeB, uint32_t indexA, uint32_t indexB) {
+                SimplexVertex vertex;
+                vertex.IndexA = indexA;
+                vertex.IndexB = indexB;
+                vertex.A = shapeA.GetVertex(indexA);
+                vertex.B = shapeB.GetVertex(indexB);
+                vertex.W = vertex.B - vertex.A;
+                return vertex;
+            }
+
+            // 闵可夫斯基差在direction方向上的支撑点
+            SimplexVertex Support(const ConvexShape& shapeA, const ConvexShape& shapeB, const glm::vec3& direction,
+                                  uint32_t& hintA, uint32_t& hintB) {
+                hintA = shapeA.GetSupport(-direction, hintA);
+                hintB = shapeB.GetSupport(direction, hintB);
+                return MakeVertex(shapeA, shapeB, hintA, hintB);
+            }
+
+            glm::vec3 AnyPerpendicular(const glm::vec3& axis) {
+                glm::vec3 a = glm::abs(axis);
+                glm::vec3 other = (a.x <= a.y && a.x <= a.z) ? glm::vec3(1.0f, 0.0f, 0.0f)
+                                : (a.y <= a.z ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f));
+                return glm::normalize(glm::cross(axis, other));
+            }
+
+            // 把GJK结束时的单纯形补成包含原点的四面体；闵可夫斯基差本身是平的时返回false
+            bool ExpandToTetrahedron(const ConvexShape& shapeA, const ConvexShape& shapeB, Simplex& simplex,
+                                     uint32_t& hintA, uint32_t& hintB) {
+                if (simplex.Count == 1) {
+                    static const glm::vec3 axes[6] = {
+                        glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0),
+                        glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1)
+                    };
+                    for (const glm::vec3& axis : axes) {
+                        SimplexVertex vertex = Support(shapeA, shapeB, axis, hintA, hintB);
+                        glm::vec3 d = vertex.W - simplex.V[0].W;
+                        if (glm::dot(d, d) > OverlapTolerance * OverlapTolerance) {
+                            simplex.V[simplex.Count++] = vertex;
+                            break;
+                        }
+                    }
+                    if (simplex.Count < 2) return false;
+                }
+
+                if (simplex.Count == 2) {
+                    glm::vec3 axis = glm::normalize(simplex.V[1].W - simplex.V[0].W);
+                    glm::vec3 p1 = AnyPerpendicular(axis);
+                    glm::vec3 p2 = glm::cross(axis, p1);
+                    const glm::vec3 directions[4] = { p1, -p1, p2, -p2 };
+                    for (const glm::vec3& direction : directions) {
+                        SimplexVertex vertex = Support(shapeA, shapeB, direction, hintA, hintB);
+                        glm::vec3 offLine = glm::cross(vertex.W - simplex.V[0].W, axis);
+                        if (glm::dot(offLine, offLine) > OverlapTolerance * OverlapTolerance) {
+                            simplex.V[simplex.Count++] = vertex;
+                            break;
+                        }
+                    }
+                    if (simplex.Count < 3) return false;
+                }
+
+                if (simplex.Count == 3) {
+                    glm::vec3 normal = glm::cross(simplex.V[1].W - simplex.V[0].W, simplex.V[2].W - simplex.V[0].W);
+                    float length = glm::length(normal);
+                    if (length <= 0.0f) return false;
+                    normal /= length;
+                    const glm::vec3 directions[2] = { normal, -normal };
+                    for (const glm::vec3& direction : directions) {
+                        SimplexVertex vertex = Support(shapeA, shapeB, direction, hintA, hintB);
+                        if (std::abs(glm::dot(vertex.W - simplex.V[0].W, normal)) > OverlapTolerance) {
+                            simplex.V[simplex.Count++] = vertex;
+                            break;
+                        }
+                    }
+                    if (simplex.Count < 4) return false;
+                }
+                return true;
+            }
+
+            struct EPAFace {
+                int V[3];
+                glm::vec3 Normal;
+                float Distance;
+            };
+
+            bool MakeFace(const SimplexVertex* vertices, int a, int b, int c, EPAFace& face) {
+                face.V[0] = a; face.V[1] = b; face.V[2] = c;
+                glm::vec3 normal = glm::cross(vertices[b].W - vertices[a].W, vertices[c].W - vertices[a].W);
+                float length = glm::length(normal);
+                if (length <= FLT_EPSILON) {
+                    return false;
+                }
+                face.Normal = normal / length;
+                face.Distance = glm::dot(face.Normal, vertices[a].W);
+                return true;
+            }
+
+            // 扩展多面体：不断沿离原点最近的面向外扩展，直到该面就是闵可夫斯基差的边界
+            void Penetration(const ConvexShape& shapeA, const ConvexShape& shapeB, Simplex& simplex,
+                             uint32_t hintA, uint32_t hintB, GJKResult& result) {
+                SimplexVertex vertices[MaxEPAVertices];
+                EPAFace faces[MaxEPAFaces];
+                int edges[MaxEPAEdges][2];
+                int vertexCount = 4;
+                int faceCount = 0;
+
+                for (int i = 0; i < 4; ++i) {
+                    vertices[i] = simplex.V[i];
+                }
+
+                // 初始四面体，所有面朝外
+                static const int tetrahedron[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+                for (const auto& t : tetrahedron) {
+                    EPAFace face;
+                    if (!MakeFace(vertices, t[0], t[1], t[2], face)) continue;
+                    if (glm::dot(face.Normal, vertices[t[3]].W - vertices[t[0]].W) > 0.0f) {
+                        MakeFace(vertices, t[0], t[2], t[1], face);
+                    }
+                    faces[faceCount++] = face;
+                }
+
+                int closest = -1;
+                for (int iteration = 0; iteration < MaxEPAIterations && faceCount > 0; ++iteration) {
+                    closest = 0;
+                    for (int i = 1; i < faceCount; ++i) {
+                        if (faces[i].Distance < faces[closest].Distance) closest = i;
+                    }
+
+                    const EPAFace& best = faces[closest];
+                    SimplexVertex vertex = Support(shapeA, shapeB, best.Normal, hintA, hintB);
+                    if (glm::dot(best.Normal, vertex.W) - best.Distance <= EPATolerance || vertexCount == MaxEPAVertices) {
+                        break;
+                    }
+
+                    // 删除新顶点可见的面，只出现一次的边组成地平线
+                    int newVertex = vertexCount;
+                    vertices[vertexCount++] = vertex;
+                    int edgeCount = 0;
+                    int kept = 0;
+                    for (int i = 0; i < faceCount; ++i) {
+                        const EPAFace& face = faces[i];
+                        if (glm::dot(face.Normal, vertex.W) - face.Distance <= 0.0f) {
+                            faces[kept++] = face;
+                            continue;
+                        }
+                        for (int e = 0; e < 3; ++e) {
+                            int from = face.V[e];
+                            int to = face.V[(e + 1) % 3];
+                            bool shared = false;
+                            for (int k = 0; k < edgeCount; ++k) {
+                                if (edges[k][0] == to && edges[k][1] == from) {
+                                    edges[k][0] = edges[edgeCount - 1][0];
+                                    edges[k][1] = edges[edgeCount - 1][1];
+                                    --edgeCount;
+                                    shared = true;
+                                    break;
+                                }
+                            }
+                            if (!shared && edgeCount < MaxEPAEdges) {
+                                edges[edgeCount][0] = from;
+                                edges[edgeCount][1] = to;
+                                ++edgeCount;
+                            }
+                        }
+                    }
+                    faceCount = kept;
+
+                    if (faceCount + edgeCount > MaxEPAFaces) {
+                        closest = -1;
+                        break;
+                    }
+                    for (int k = 0; k < edgeCount; ++k) {
+                        EPAFace face;
+                        if (MakeFace(vertices, edges[k][0], edges[k][1], newVertex, face)) {
+                            faces[faceCount++] = face;
+                        }
+                    }
+                    closest = -1;
+                }
+
+                if (closest < 0) {
+                    // 容量用完：取当前最近的面
+                    if (faceCount == 0) {
+                        result.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+                        result.Distance = 0.0f;
+                        result.PointA = result.PointB = simplex.V[0].A;
+                        return;
+                    }
+                    closest = 0;
+                    for (int i = 1; i < faceCount; ++i) {
+                        if (faces[i].Distance < faces[closest].Distance) closest = i;
+                    }
+                }
+
+                // 原点在最近面上的投影按重心坐标换算回两个形状上的点
+                const EPAFace& face = faces[closest];
+                const SimplexVertex& a = vertices[face.V[0]];
+                const SimplexVertex& b = vertices[face.V[1]];
+                const SimplexVertex& c = vertices[face.V[2]];
+                glm::vec3 projection = face.Normal * face.Distance;
+                glm::vec3 e0 = b.W - a.W;
+                glm::vec3 e1 = c.W - a.W;
+                glm::vec3 e2 = projection - a.W;
+                float d00 = glm::dot(e0, e0);
+                float d01 = glm::dot(e0, e1);
+                float d11 = glm::dot(e1, e1);
+                float d20 = glm::dot(e2, e0);
+                float d21 = glm::dot(e2, e1);
+                float denominator = d00 * d11 - d01 * d01;
+                float v = 0.0f;
+                float w = 0.0f;
+                if (std::abs(denominator) > FLT_EPSILON * FLT_EPSILON) {
+                    v = (d11 * d20 - d01 * d21) / denominator;
+                    w = (d00 * d21 - d01 * d20) / denominator;
+                }
+                float u = 1.0f - v - w;
+
+                // 面的外法向是B - A的穿出方向，B需要沿其反方向移动才能分开
+                result.PointA = u * a.A + v * b.A + w * c.A;
+                result.PointB = u * a.B + v * b.B + w * c.B;
+                result.Normal = -face.Normal;
+                result.Distance = -face.Distance;
+            }
+        }
+
+        bool Evaluate(const ConvexShape& shapeA, const ConvexShape& shapeB, float maxDistance,
+                      GJKResult& result, SimplexCache* cache) {
+            Simplex simplex;
+
+            // 从缓存的顶点编号重建单纯形，编号越界（形状变了）时丢弃
+            if (cache && cache->Count > 0 && cache->Count <= 4) {
+                uint32_t countA = shapeA.GetVertexCount();
+                uint32_t countB = shapeB.GetVertexCount();
+                for (uint32_t i = 0; i < cache->Count; ++i) {
+                    if (cache->IndexA[i] >= countA || cache->IndexB[i] >= countB) {
+                        simplex.Count = 0;
+                        break;
+                    }
+                    simplex.V[simplex.Count++] = MakeVertex(shapeA, shapeB, cache->IndexA[i], cache->IndexB[i]);
+                }
+            }
+
+            uint32_t hintA = 0;
+            uint32_t hintB = 0;
+            if (simplex.Count == 0) {
+                glm::vec3 direction = shapeA.Center - shapeB.Center;
+                if (glm::dot(direction, direction) <= FLT_EPSILON) {
+                    direction = glm::vec3(1.0f, 0.0f, 0.0f);
+                }
+                simplex.V[simplex.Count++] = Support(shapeA, shapeB, direction, hintA, hintB);
+            } else {
+                hintA = simplex.V[0].IndexA;
+                hintB = simplex.V[0].IndexB;
+            }
+
+            const float maxDistanceSq = maxDistance * maxDistance;
+            glm::vec3 closest(0.0f);
+            bool overlap = false;
+            bool separated = false;
+            int iteration = 0;
+            for (; iteration < MaxIterations; ++iteration) {
+                if (!simplex.Solve(closest)) {
+                    overlap = true;
+                    break;
+                }
+
+                float closestSq = glm::dot(closest, closest);
+                if (closestSq <= OverlapTolerance * OverlapTolerance) {
+                    overlap = true;
+                    break;
+                }
+
+                SimplexVertex vertex = Support(shapeA, shapeB, -closest, hintA, hintB);
+                float progress = glm::dot(closest, vertex.W);
+
+                // closest方向是分离轴：距离至少为progress / |closest|
+                if (progress > 0.0f && progress * progress > maxDistanceSq * closestSq) {
+                    separated = true;
+                    break;
+                }
+
+                // 支撑点已在单纯形中或几乎没有更近，已收敛
+                bool duplicate = false;
+                for (int i = 0; i < simplex.Count; ++i) {
+                    if (simplex.V[i].IndexA == vertex.IndexA && simplex.V[i].IndexB == vertex.IndexB) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (duplicate || closestSq - progress <= RelativeTolerance * closestSq) {
+                    break;
+                }
+
+                simplex.V[simplex.Count++] = vertex;
+            }
+
+            if (cache) {
+                cache->Count = static_cast<uint32_t>(simplex.Count);
+                for (int i = 0; i < simplex.Count; ++i) {
+                    cache->IndexA[i] = simplex.V[i].IndexA;
+                    cache->IndexB[i] = simplex.V[i].IndexB;
+                }
+            }
+
+            result.Iterations = iteration;
+            if (separated) {
+                return false;
+            }
+
+            if (!overlap) {
+                result.PointA = glm::vec3(0.0f);
+                result.PointB = glm::vec3(0.0f);
+                for (int i = 0; i < simplex.Count; ++i) {
+                    result.PointA += simplex.Lambda[i] * simplex.V[i].A;
+                    result.PointB += simplex.Lambda[i] * simplex.V[i].B;
+                }
+                result.Distance = std::sqrt(glm::dot(closest, closest));
+                result.Normal = closest / result.Distance;
+                return result.Distance <= maxDistance;
+            }
+
+            if (!ExpandToTetrahedron(shapeA, shapeB, simplex, hintA, hintB)) {
+                // 闵可夫斯基差是平的（例如两个共面的薄片），只能当作恰好接触
+                result.PointA = simplex.V[0].A;
+                result.PointB = simplex.V[0].B;
+                result.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+                if (simplex.Count == 3) {
+                    glm::vec3 normal = glm::cross(simplex.V[1].W - simplex.V[0].W, simplex.V[2].W - simplex.V[0].W);
+                    if (glm::dot(normal, shapeB.Center - shapeA.Center) < 0.0f) normal = -normal;
+                    float length = glm::length(normal);
+                    if (length > 0.0f) result.Normal = normal / length;
+                }
+                result.Distance = 0.0f;
+                return true;
+            }
+
+            Penetration(shapeA, shapeB, simplex, hintA, hintB, result);
+            return true;
+        }
+
+    }
+
+}
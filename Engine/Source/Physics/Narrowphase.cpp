@@ -0,0 +1,353 @@
+//
+// Narrowphase.cpp - 窄阶段接触生成实现
+//
+
+#include "JFMEngine/Physics/Narrowphase.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace JFM {
+
+    namespace Narrowphase {
+
+        namespace {
+            // 按分派顺序排列：较小的类型放在A，需要时交换并翻转法向
+            enum class ShapeKind { Sphere = 0, Capsule = 1, Box = 2, Hull = 3, Mesh = 4 };
+
+            struct ShapeDesc {
+                ShapeKind Kind = ShapeKind::Sphere;
+                glm::vec3 Center = glm::vec3(0.0f);
+                glm::vec3 HalfExtents = glm::vec3(0.0f);
+                float Radius = DefaultRadius;
+                float HalfSegment = 0.0f;
+                const ConvexHull* Hull = nullptr;
+                const TriangleBVH* Mesh = nullptr;
+            };
+
+            ShapeDesc Describe(const Collider* shape, const glm::vec3& position) {
+                ShapeDesc desc;
+                desc.Center = position;
+                if (!shape) {
+                    return desc;
+                }
+
+                switch (shape->GetType()) {
+                    case ColliderType::Sphere:
+                        desc.Radius = static_cast<const SphereCollider*>(shape)->GetRadius();
+                        break;
+                    case ColliderType::Capsule: {
+                        auto capsule = static_cast<const CapsuleCollider*>(shape);
+                        desc.Kind = ShapeKind::Capsule;
+                        desc.Radius = capsule->GetRadius();
+                        desc.HalfSegment = capsule->GetHalfSegment();
+                        break;
+                    }
+                    case ColliderType::Box:
+                        desc.Kind = ShapeKind::Box;
+                        desc.HalfExtents = static_cast<const BoxCollider*>(shape)->GetSize() * 0.5f;
+                        break;
+                    case ColliderType::Mesh:
+                        desc.Hull = static_cast<const MeshCollider*>(shape)->GetConvexHull();
+                        desc.Mesh = static_cast<const MeshCollider*>(shape)->GetTriangleBVH();
+                        if (desc.Hull) {
+                            desc.Kind = ShapeKind::Hull;
+                            break;
+                        }
+                        if (desc.Mesh) {
+                            desc.Kind = ShapeKind::Mesh;
+                            break;
+                        }
+                        [[fallthrough]];
+                    default: {
+                        AABB bounds = shape->GetAABB(position);
+                        desc.Kind = ShapeKind::Box;
+                        desc.Center = bounds.GetCenter();
+                        desc.HalfExtents = bounds.GetSize() * 0.5f;
+                        break;
+                    }
+                }
+                return desc;
+            }
+
+            ConvexShape ToConvex(const ShapeDesc& desc) {
+                ConvexShape shape;
+                shape.Center = desc.Center;
+                switch (desc.Kind) {
+                    case ShapeKind::Sphere:
+                        shape.Type = ConvexShape::Kind::Point;
+                        shape.Radius = desc.Radius;
+                        break;
+                    case ShapeKind::Capsule:
+                        shape.Type = ConvexShape::Kind::Segment;
+                        shape.HalfSegment = desc.HalfSegment;
+                        shape.Radius = desc.Radius;
+                        break;
+                    case ShapeKind::Box:
+                        shape.Type = ConvexShape::Kind::Box;
+                        shape.HalfExtents = desc.HalfExtents;
+                        break;
+                    case ShapeKind::Hull:
+                        shape.Type = ConvexShape::Kind::Hull;
+                        shape.Hull = desc.Hull;
+                        break;
+                    case ShapeKind::Mesh:
+                        break;
+                }
+                return shape;
+            }
+
+            // 三角形网格与凸形状：逐个三角形求接触，取最深的一个；法向从网格指向形状
+            bool MeshConvex(const ShapeDesc& mesh, const ShapeDesc& other, ContactPoint& contact, float margin) {
+                const TriangleBVH& bvh = *mesh.Mesh;
+                bool hit = false;
+                contact.Separation = FLT_MAX;
+
+                // 球体和胶囊直接用线段与三角形的最近点，在网格局部空间中查询
+                if (other.Kind == ShapeKind::Sphere || other.Kind == ShapeKind::Capsule) {
+                    glm::vec3 center = other.Center - mesh.Center;
+                    glm::vec3 half(0.0f, other.HalfSegment, 0.0f);
+                    bvh.OverlapCapsule(center - half, center + half, other.Radius, margin, [&](const MeshContact& triangle) {
+                        if (triangle.Separation < contact.Separation) {
+                            contact.Normal = triangle.Normal;
+                            contact.Separation = triangle.Separation;
+                            contact.Point = mesh.Center + triangle.Point + triangle.Normal * (0.5f * triangle.Separation);
+                            hit = true;
+                        }
+                        return true;
+                    });
+                    return hit;
+                }
+
+                // 盒子和凸包：用支撑点求出局部包围盒，与每个候选三角形做GJK
+                ConvexShape shape = ToConvex(other);
+                glm::vec3 reach(shape.Radius + margin);
+                AABB bounds;
+                for (int axis = 0; axis < 3; ++axis) {
+                    glm::vec3 direction(0.0f);
+                    direction[axis] = 1.0f;
+                    bounds.Max[axis] = shape.GetVertex(shape.GetSupport(direction, 0))[axis];
+                    bounds.Min[axis] = shape.GetVertex(shape.GetSupport(-direction, 0))[axis];
+                }
+                bounds = AABB(bounds.Min - mesh.Center - reach, bounds.Max - mesh.Center + reach);
+
+                ConvexShape triangle;
+                triangle.Type = ConvexShape::Kind::Triangle;
+                triangle.Center = mesh.Center;
+                bvh.Query(bounds, [&](uint32_t index) {
+                    bvh.GetTriangle(index, triangle.Triangle[0], triangle.Triangle[1], triangle.Triangle[2]);
+                    ContactPoint candidate;
+                    if (Convex(triangle, shape, candidate, margin) && candidate.Separation < contact.Separation) {
+                        contact = candidate;
+                        hit = true;
+                    }
+                    return true;
+                });
+                return hit;
+            }
+
+            // 竖直线段上离高度区间[low, high]最近的点：区间重叠时取重叠部分的中点
+            float ClosestHeight(float segmentLow, float segmentHigh, float low, float high) {
+                float overlapLow = std::max(segmentLow, low);
+                float overlapHigh = std::min(segmentHigh, high);
+                if (overlapLow <= overlapHigh) {
+                    return 0.5f * (overlapLow + overlapHigh);
+                }
+                return segmentHigh < low ? segmentHigh : segmentLow;
+            }
+        }
+
+        bool SphereSphere(const glm::vec3& centerA, float radiusA, const glm::vec3& centerB, float radiusB,
+                          ContactPoint& contact, float margin) {
+            glm::vec3 offset = centerB - centerA;
+            float distanceSq = glm::dot(offset, offset);
+            float reach = radiusA + radiusB + margin;
+            if (distanceSq > reach * reach) {
+                return false;
+            }
+
+            float distance = std::sqrt(distanceSq);
+            contact.Normal = distance > 1e-6f ? offset / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+            contact.Separation = distance - radiusA - radiusB;
+            contact.Point = centerA + contact.Normal * (radiusA + 0.5f * contact.Separation);
+            return true;
+        }
+
+        bool SphereBox(const glm::vec3& center, float radius, const glm::vec3& boxCenter, const glm::vec3& halfExtents,
+                       ContactPoint& contact, float margin) {
+            glm::vec3 local = center - boxCenter;
+            glm::vec3 clamped = glm::clamp(local, -halfExtents, halfExtents);
+            glm::vec3 toBox = clamped - local;
+            float distanceSq = glm::dot(toBox, toBox);
+
+            if (distanceSq > 1e-12f) {
+                // 球心在盒外：沿到最近点的方向
+                float reach = radius + margin;
+                if (distanceSq > reach * reach) {
+                    return false;
+                }
+                float distance = std::sqrt(distanceSq);
+                contact.Normal = toBox / distance;
+                contact.Separation = distance - radius;
+                contact.Point = boxCenter + clamped - contact.Normal * (0.5f * contact.Separation);
+                return true;
+            }
+
+            // 球心在盒内：从穿透最浅的面推出
+            int axis = 0;
+            float faceDistance = halfExtents.x - std::abs(local.x);
+            for (int i = 1; i < 3; ++i) {
+                float distance = halfExtents[i] - std::abs(local[i]);
+                if (distance < faceDistance) {
+                    faceDistance = distance;
+                    axis = i;
+                }
+            }
+
+            glm::vec3 outward(0.0f);
+            outward[axis] = local[axis] >= 0.0f ? 1.0f : -1.0f;
+            contact.Normal = -outward;
+            contact.Separation = -(faceDistance + radius);
+            contact.Point = center;
+            contact.Point[axis] = boxCenter[axis] + outward[axis] * halfExtents[axis];
+            return true;
+        }
+
+        bool BoxBox(const glm::vec3& centerA, const glm::vec3& halfExtentsA, const glm::vec3& centerB, const glm::vec3& halfExtentsB,
+                    ContactPoint& contact, float margin) {
+            // 轴对齐盒子的分离轴只有三个坐标轴，取间距最大（穿透最浅）的轴
+            glm::vec3 offset = centerB - centerA;
+            glm::vec3 gap = glm::abs(offset) - (halfExtentsA + halfExtentsB);
+
+            int axis = 0;
+            for (int i = 1; i < 3; ++i) {
+                if (gap[i] > gap[axis]) {
+                    axis = i;
+                }
+            }
+            if (gap[axis] > margin) {
+                return false;
+            }
+
+            contact.Normal = glm::vec3(0.0f);
+            contact.Normal[axis] = offset[axis] >= 0.0f ? 1.0f : -1.0f;
+            contact.Separation = gap[axis];
+
+            // 接触点取两个盒子重叠区域的中心
+            glm::vec3 low = glm::max(centerA - halfExtentsA, centerB - halfExtentsB);
+            glm::vec3 high = glm::min(centerA + halfExtentsA, centerB + halfExtentsB);
+            contact.Point = 0.5f * (low + high);
+            return true;
+        }
+
+        bool CapsuleSphere(const glm::vec3& center, float halfSegment, float radius, const glm::vec3& sphereCenter, float sphereRadius,
+                           ContactPoint& contact, float margin) {
+            glm::vec3 closest = center;
+            closest.y = glm::clamp(sphereCenter.y, center.y - halfSegment, center.y + halfSegment);
+            return SphereSphere(closest, radius, sphereCenter, sphereRadius, contact, margin);
+        }
+
+        bool CapsuleCapsule(const glm::vec3& centerA, float halfSegmentA, float radiusA,
+                            const glm::vec3& centerB, float halfSegmentB, float radiusB,
+                            ContactPoint& contact, float margin) {
+            // 两条平行的竖直线段：高度重叠时水平最近，否则取相邻的端点
+            glm::vec3 pointA = centerA;
+            glm::vec3 pointB = centerB;
+            pointA.y = ClosestHeight(centerA.y - halfSegmentA, centerA.y + halfSegmentA, centerB.y - halfSegmentB, centerB.y + halfSegmentB);
+            pointB.y = glm::clamp(pointA.y, centerB.y - halfSegmentB, centerB.y + halfSegmentB);
+            return SphereSphere(pointA, radiusA, pointB, radiusB, contact, margin);
+        }
+
+        bool CapsuleBox(const glm::vec3& center, float halfSegment, float radius, const glm::vec3& boxCenter, const glm::vec3& halfExtents,
+                        ContactPoint& contact, float margin) {
+            // 竖直线段与轴对齐盒子：线段上离盒子最近的点只取决于高度区间
+            glm::vec3 closest = center;
+            closest.y = ClosestHeight(center.y - halfSegment, center.y + halfSegment,
+                                      boxCenter.y - halfExtents.y, boxCenter.y + halfExtents.y);
+            return SphereBox(closest, radius, boxCenter, halfExtents, contact, margin);
+        }
+
+        bool Convex(const ConvexShape& shapeA, const ConvexShape& shapeB,
+                    ContactPoint& contact, float margin, SimplexCache* cache) {
+            GJKResult result;
+            float radius = shapeA.Radius + shapeB.Radius;
+            if (!GJK::Evaluate(shapeA, shapeB, radius + margin, result, cache)) {
+                return false;
+            }
+
+            // 核心之间的最近点沿法向各自扩展半径得到表面点
+            contact.Normal = result.Normal;
+            contact.Separation = result.Distance - radius;
+            glm::vec3 surfaceA = result.PointA + result.Normal * shapeA.Radius;
+            glm::vec3 surfaceB = result.PointB - result.Normal * shapeB.Radius;
+            contact.Point = 0.5f * (surfaceA + surfaceB);
+            return contact.Separation <= margin;
+        }
+
+        bool Collide(const Collider* shapeA, const glm::vec3& positionA,
+                     const Collider* shapeB, const glm::vec3& positionB,
+                     ContactPoint& contact, float margin, SimplexCache* cache) {
+            ShapeDesc a = Describe(shapeA, positionA);
+            ShapeDesc b = Describe(shapeB, positionB);
+
+            // 三角形网格只与凸形状产生接触
+            if (a.Kind == ShapeKind::Mesh || b.Kind == ShapeKind::Mesh) {
+                if (a.Kind == b.Kind) {
+                    return false;
+                }
+                if (a.Kind == ShapeKind::Mesh) {
+                    return MeshConvex(a, b, contact, margin);
+                }
+                bool hit = MeshConvex(b, a, contact, margin);
+                contact.Normal = -contact.Normal;
+                return hit;
+            }
+
+            // 凸网格不交换顺序，单纯形缓存中的顶点编号始终对应(A, B)
+            if (a.Kind == ShapeKind::Hull || b.Kind == ShapeKind::Hull) {
+                return Convex(ToConvex(a), ToConvex(b), contact, margin, cache);
+            }
+
+            bool flipped = a.Kind > b.Kind;
+            if (flipped) {
+                std::swap(a, b);
+            }
+
+            bool hit = false;
+            switch (a.Kind) {
+                case ShapeKind::Sphere:
+                    if (b.Kind == ShapeKind::Sphere) {
+                        hit = SphereSphere(a.Center, a.Radius, b.Center, b.Radius, contact, margin);
+                    } else if (b.Kind == ShapeKind::Capsule) {
+                        // 以胶囊为A求解，再翻转
+                        hit = CapsuleSphere(b.Center, b.HalfSegment, b.Radius, a.Center, a.Radius, contact, margin);
+                        contact.Normal = -contact.Normal;
+                    } else {
+                        hit = SphereBox(a.Center, a.Radius, b.Center, b.HalfExtents, contact, margin);
+                    }
+                    break;
+                case ShapeKind::Capsule:
+                    if (b.Kind == ShapeKind::Capsule) {
+                        hit = CapsuleCapsule(a.Center, a.HalfSegment, a.Radius, b.Center, b.HalfSegment, b.Radius, contact, margin);
+                    } else {
+                        hit = CapsuleBox(a.Center, a.HalfSegment, a.Radius, b.Center, b.HalfExtents, contact, margin);
+                    }
+                    break;
+                case ShapeKind::Box:
+                    hit = BoxBox(a.Center, a.HalfExtents, b.Center, b.HalfExtents, contact, margin);
+                    break;
+                case ShapeKind::Hull:
+                case ShapeKind::Mesh:
+                    break;
+            }
+
+            if (hit && flipped) {
+                contact.Normal = -contact.Normal;
+            }
+            return hit;
+        }
+
+    }
+
+}
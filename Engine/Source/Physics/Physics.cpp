@@ -3,8 +3,18 @@
 //
 
 #include "JFMEngine/Physics/Physics.h"
+#include "JFMEngine/Physics/BroadPhase.h"
+#include "JFMEngine/Physics/SpatialHashGrid.h"
+#include "JFMEngine/Physics/DynamicAABBTree.h"
+#include "JFMEngine/Physics/Narrowphase.h"
+#include "JFMEngine/Physics/PhysicsSnapshot.h"
+#include "JFMEngine/Core/JobSystem.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <type_traits>
 
 namespace JFM {
 
@@ -16,71 +26,113 @@ namespace JFM {
     }
 
     // Rigidbody 实现
-    Rigidbody::Rigidbody() {
-        m_Position = glm::vec3(0.0f);
-        m_Velocity = glm::vec3(0.0f);
-        m_Force = glm::vec3(0.0f);
-        m_Mass = 1.0f;
-        m_InvMass = 1.0f;
-        m_UseGravity = true;
-        m_Drag = 0.98f;
-    }
+    Rigidbody::Rigidbody() = default;
 
-    void Rigidbody::UpdatePhysics(float deltaTime) {
-        if (m_InvMass == 0.0f) return; // 静态物体
+    AABB Rigidbody::GetBounds() const {
+        glm::vec3 position = GetPosition();
+        glm::vec3 halfExtent(0.5f);
+        return AABB(position - halfExtent, position + halfExtent);
+    }
 
-        // 检查输入参数的有效性
-        if (deltaTime <= 0.0f || !std::isfinite(deltaTime)) return;
+    const PhysicsMaterial& Rigidbody::GetMaterial() const {
+        static const PhysicsMaterial defaultMaterial;
+        return defaultMaterial;
+    }
 
-        // 检查当前状态的有效性
-        if (!std::isfinite(m_Position.x) || !std::isfinite(m_Position.y) || !std::isfinite(m_Position.z)) {
-            // 重置到安全位置
-            m_Position = glm::vec3(0.0f, 0.0f, 0.0f);
-            m_Velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-            m_Force = glm::vec3(0.0f, 0.0f, 0.0f);
-            return;
+    void Rigidbody::SetMass(float mass) {
+        if (m_Store) {
+            m_Store->SetMass(m_Slot, mass);
+            WakeUp();   // 静态刚体变为动态时需要加入活动列表
+        } else {
+            m_LocalState.Mass = mass;
+            m_LocalState.InvMass = (mass == 0.0f) ? 0.0f : 1.0f / mass;
         }
+    }
 
-        // 应用重力
-        if (m_UseGravity) {
-            glm::vec3 gravity = PhysicsWorld::GetInstance().GetGravity();
-            if (std::isfinite(gravity.x) && std::isfinite(gravity.y) && std::isfinite(gravity.z)) {
-                m_Force += gravity * m_Mass;
-            }
+    void Rigidbody::SetPosition(const glm::vec3& position) {
+        if (m_Store) {
+            m_Store->SetPosition(m_Slot, position);
+            WakeUp();
+        } else {
+            m_LocalState.Position = position;
         }
+    }
 
-        // 计算加速度 F = ma -> a = F/m
-        glm::vec3 acceleration = m_Force * m_InvMass;
+    void Rigidbody::SetVelocity(const glm::vec3& velocity) {
+        if (m_Store) {
+            m_Store->SetVelocity(m_Slot, velocity);
+            WakeUp();
+        } else {
+            m_LocalState.Velocity = velocity;
+        }
+    }
 
-        // 检查加速度的有效性
-        if (!std::isfinite(acceleration.x) || !std::isfinite(acceleration.y) || !std::isfinite(acceleration.z)) {
-            acceleration = glm::vec3(0.0f);
+    void Rigidbody::AddForce(const glm::vec3& force) {
+        if (m_Store) {
+            m_Store->AddForce(m_Slot, force);
+            WakeUp();
+        } else {
+            m_LocalState.Force += force;
         }
+    }
 
-        // 更新速度
-        m_Velocity += acceleration * deltaTime;
+    void Rigidbody::SetGravity(bool gravity) {
+        if (m_Store) {
+            m_Store->SetUseGravity(m_Slot, gravity);
+        } else {
+            m_LocalState.UseGravity = gravity;
+        }
+    }
 
-        // 检查速度的有效性
-        if (!std::isfinite(m_Velocity.x) || !std::isfinite(m_Velocity.y) || !std::isfinite(m_Velocity.z)) {
-            m_Velocity = glm::vec3(0.0f);
+    void Rigidbody::SetDrag(float drag) {
+        if (m_Store) {
+            m_Store->SetDrag(m_Slot, drag);
+        } else {
+            m_LocalState.Drag = drag;
         }
+    }
 
-        // 应用阻力
-        if (m_Drag > 0.0f && m_Drag <= 1.0f) {
-            m_Velocity *= m_Drag;
+    void Rigidbody::SetContinuousCollision(bool continuous) {
+        if (m_Store) {
+            m_Store->SetContinuous(m_Slot, continuous);
+        } else {
+            m_LocalState.Continuous = continuous;
         }
+    }
 
-        // 更新位置
-        m_Position += m_Velocity * deltaTime;
+    void Rigidbody::SetAwake(bool awake) {
+        if (m_Store) {
+            if (awake) {
+                m_Store->Activate(m_Slot);
+            } else {
+                m_Store->SetAwake(m_Slot, false);
+            }
+        } else {
+            m_LocalState.Awake = awake;
+            m_LocalState.SleepTime = 0.0f;
+            if (!awake) {
+                m_LocalState.Velocity = glm::vec3(0.0f);
+            }
+        }
+    }
 
-        // 检查位置的有效性
-        if (!std::isfinite(m_Position.x) || !std::isfinite(m_Position.y) || !std::isfinite(m_Position.z)) {
-            m_Position = glm::vec3(0.0f, 0.0f, 0.0f);
-            m_Velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+    void Rigidbody::SetSleepThreshold(float linearVelocity) {
+        if (m_Store) {
+            m_Store->SetSleepThreshold(m_Slot, linearVelocity);
+        } else {
+            m_LocalState.SleepThreshold = linearVelocity;
         }
+    }
+
+    void Rigidbody::UpdatePhysics(float deltaTime) {
+        RigidbodyState state = m_Store ? m_Store->GetState(m_Slot) : m_LocalState;
+        RigidbodyStore::IntegrateState(state, deltaTime, PhysicsWorld::GetInstance().GetGravity());
 
-        // 清除力
-        m_Force = glm::vec3(0.0f);
+        if (m_Store) {
+            m_Store->SetState(m_Slot, state);
+        } else {
+            m_LocalState = state;
+        }
     }
 
     // BoxCollider 实现
@@ -97,6 +149,32 @@ namespace JFM {
     }
 
     // PhysicsWorld 实现
+    namespace {
+        // 宽阶段包围盒按预测接触的余量放大：恰好贴合的物体包围盒只在边界上相接，
+        // 排序时的相等比较会让这类碰撞对时有时无，静止的堆叠因此失去支撑
+        // sweep为本步的位移，连续碰撞检测的刚体包含本步起点的包围盒
+        AABB GetContactBounds(const Rigidbody& rigidbody, const glm::vec3& sweep = glm::vec3(0.0f)) {
+            AABB bounds = rigidbody.GetBounds();
+            glm::vec3 margin(Narrowphase::SpeculativeMargin);
+            glm::vec3 start = glm::min(sweep, glm::vec3(0.0f));
+            glm::vec3 end = glm::max(sweep, glm::vec3(0.0f));
+            return AABB(bounds.Min - end - margin, bounds.Max - start + margin);
+        }
+    }
+
+    PhysicsWorld::PhysicsWorld()
+        : m_BroadPhase(std::make_unique<SweepAndPrune>()), m_Grid(std::make_unique<SpatialHashGrid>()),
+          m_QueryTree(std::make_unique<DynamicAABBTree>()) {
+    }
+
+    PhysicsWorld::~PhysicsWorld() {
+        // 外部仍持有的刚体取回自己的状态，不再指向即将销毁的存储
+        for (size_t i = 0; i < m_Rigidbodies.size(); ++i) {
+            m_Rigidbodies[i]->m_LocalState = m_Store.GetState(static_cast<uint32_t>(i));
+            m_Rigidbodies[i]->m_Store = nullptr;
+        }
+    }
+
     void PhysicsWorld::Update(float deltaTime) {
         if (m_Paused) return;
 
@@ -105,92 +183,749 @@ namespace JFM {
 
         int subSteps = 0;
         while (m_AccumulatedTime >= m_FixedTimeStep && subSteps < m_MaxSubSteps) {
-            // 更新所有刚体
-            for (auto& rigidbody : m_Rigidbodies) {
-                if (rigidbody) {
-                    rigidbody->UpdatePhysics(m_FixedTimeStep);
+            Simulate(m_FixedTimeStep);
+            m_AccumulatedTime -= m_FixedTimeStep;
+            subSteps++;
+        }
+
+        if (subSteps > 0) {
+            SyncQueryTree();
+        }
+    }
+
+    void PhysicsWorld::Step() {
+        Simulate(m_FixedTimeStep);
+        SyncQueryTree();
+    }
+
+    void PhysicsWorld::Simulate(float deltaTime) {
+        // 积分活动列表中的刚体，再同步它们的宽阶段包围盒；休眠和未移动的静态刚体的代理保持不变
+        // 活动刚体占多数时整体扫描的SIMD内核更快，休眠和静态刚体在内核中被屏蔽
+        MergeActivatedBodies();
+        if (m_ActiveBodies.size() * 8 < m_Rigidbodies.size()) {
+            m_Store.Integrate(deltaTime, m_Gravity, m_ActiveBodies.data(), m_ActiveBodies.size());
+        } else {
+            m_Store.Integrate(deltaTime, m_Gravity);
+        }
+        const bool useGrid = m_BroadPhaseType == BroadPhaseType::SpatialHashGrid;
+        // 宽阶段耗时包含代理更新：扫描与裁剪的增量排序在MoveProxy中完成
+        auto broadPhaseStart = std::chrono::high_resolution_clock::now();
+        for (uint32_t body : m_ActiveBodies) {
+            glm::vec3 sweep = m_Store.IsContinuous(body) ? m_Store.GetVelocity(body) * deltaTime : glm::vec3(0.0f);
+            if (useGrid) {
+                m_Grid->SetBounds(body, GetContactBounds(*m_Rigidbodies[body], sweep));
+            } else {
+                m_BroadPhase->MoveProxy(m_Proxies[body], GetContactBounds(*m_Rigidbodies[body], sweep));
+            }
+            if (!(m_BodyFlags[body] & QueryDirtyFlag)) {
+                m_BodyFlags[body] |= QueryDirtyFlag;
+                m_QueryDirtyBodies.push_back(body);
+            }
+        }
+        m_Stats.ActiveBodies = static_cast<uint32_t>(m_ActiveBodies.size());
+
+        // 宽阶段：只对包围盒重叠的刚体对做碰撞响应
+        const auto& pairs = useGrid ? m_Grid->UpdatePairs() : m_BroadPhase->UpdatePairs();
+        auto broadPhaseEnd = std::chrono::high_resolution_clock::now();
+
+        m_Stats.BroadPhasePairs = static_cast<uint32_t>(pairs.size());
+        m_Stats.BroadPhaseMs = std::chrono::duration<float, std::milli>(broadPhaseEnd - broadPhaseStart).count();
+
+        // 按接触和约束建岛，各岛并行生成接触并求解
+        auto solveStart = std::chrono::high_resolution_clock::now();
+        MatchContactCache();
+        BuildIslands();
+        SolveIslands(deltaTime);
+        m_ContactCacheStale = true;
+        UpdateActiveBodies();
+        auto solveEnd = std::chrono::high_resolution_clock::now();
+        m_Stats.SolveMs = std::chrono::duration<float, std::milli>(solveEnd - solveStart).count();
+
+        m_StepCount++;
+        if (m_Deterministic) {
+            m_StepChecksum = ComputeStateHash();
+        }
+    }
+
+    void PhysicsWorld::SyncQueryTree() {
+        // 查询只在帧间发生，所有子步结束后同步一次即可；只处理这期间移动过和新激活的刚体，
+        // 物体留在胖包围盒内时不改动树
+        // 网格没有胖包围盒，刚体在子步的求解中或Update之外移动后直接改写它的包围盒
+        const bool useGrid = m_BroadPhaseType == BroadPhaseType::SpatialHashGrid;
+        auto sync = [this, useGrid](uint32_t body) {
+            glm::vec3 position = m_Store.GetPosition(body);
+            m_QueryTree->MoveProxy(m_QueryProxies[body], m_Rigidbodies[body]->GetBounds(), position - m_QueryPositions[body]);
+            m_QueryPositions[body] = position;
+            if (useGrid) {
+                m_Grid->SetBounds(body, GetContactBounds(*m_Rigidbodies[body]));
+            }
+        };
+
+        for (uint32_t body : m_QueryDirtyBodies) {
+            m_BodyFlags[body] &= ~QueryDirtyFlag;
+            sync(body);
+        }
+        m_QueryDirtyBodies.clear();
+        for (uint32_t body : m_Store.GetActivated()) {
+            sync(body);
+        }
+    }
+
+    void PhysicsWorld::OverlapSphere(const glm::vec3& center, float radius, std::vector<uint32_t>& bodies) {
+        // 两种结构中的包围盒都比刚体大（胖包围盒或接触余量），再用刚体当前的包围盒精确过滤
+        const float radiusSq = radius * radius;
+        auto visit = [&](uint32_t body) {
+            AABB bounds = m_Rigidbodies[body]->GetBounds();
+            glm::vec3 offset = glm::clamp(center, bounds.Min, bounds.Max) - center;
+            if (glm::dot(offset, offset) <= radiusSq) {
+                bodies.push_back(body);
+            }
+            return true;
+        };
+
+        if (m_BroadPhaseType == BroadPhaseType::SpatialHashGrid) {
+            m_Grid->QuerySphere(center, radius, visit);
+        } else {
+            m_QueryTree->QuerySphere(center, radius, visit);
+        }
+    }
+
+    void PhysicsWorld::SetBroadPhaseType(BroadPhaseType type) {
+        if (type == m_BroadPhaseType) {
+            return;
+        }
+        m_BroadPhaseType = type;
+
+        // 不用的结构清空，切换时按刚体当前的包围盒整体重建
+        m_BroadPhase->Clear();
+        m_Grid->Clear();
+        for (uint32_t body = 0; body < m_Rigidbodies.size(); ++body) {
+            AABB bounds = GetContactBounds(*m_Rigidbodies[body]);
+            if (type == BroadPhaseType::SpatialHashGrid) {
+                m_Grid->Add(bounds);
+                m_Proxies[body] = SweepAndPrune::InvalidProxy;
+            } else {
+                m_Proxies[body] = m_BroadPhase->CreateProxy(bounds, body);
+            }
+        }
+
+        // 流形与旧宽阶段的碰撞对对应，先整理进缓存，下一步按刚体对取回
+        FlushContactCache();
+        m_Manifolds.clear();
+        m_ManifoldPairsVersion = UINT64_MAX;
+    }
+
+    void PhysicsWorld::SetGridCellSize(float cellSize) {
+        m_Grid->SetCellSize(cellSize);
+    }
+
+    const std::vector<BroadPhasePair>& PhysicsWorld::GetBroadPhasePairs() const {
+        return m_BroadPhaseType == BroadPhaseType::SpatialHashGrid ? m_Grid->GetPairs() : m_BroadPhase->GetPairs();
+    }
+
+    void PhysicsWorld::AddActiveBody(uint32_t body) {
+        if (!(m_BodyFlags[body] & ActiveFlag)) {
+            m_BodyFlags[body] |= ActiveFlag;
+            m_ActiveBodies.push_back(body);
+        }
+    }
+
+    void PhysicsWorld::MergeActivatedBodies() {
+        for (uint32_t body : m_Store.GetActivated()) {
+            AddActiveBody(body);
+        }
+        m_Store.ClearActivated();
+    }
+
+    void PhysicsWorld::UpdateActiveBodies() {
+        for (uint32_t body : m_ActiveBodies) {
+            m_BodyFlags[body] &= ~ActiveFlag;
+        }
+        m_ActiveBodies.clear();
+
+        // 刚进入休眠的岛在本步求解中移动过，下一步还要同步一次包围盒，之后保持不变
+        for (size_t i = 0; i < m_Islands.size(); ++i) {
+            if (m_IslandState[i] == IslandSleeping) continue;
+            const Island& island = m_Islands[i];
+            for (uint32_t j = 0; j < island.BodyCount; ++j) {
+                AddActiveBody(m_IslandBodies[island.BodyBegin + j]);
+            }
+        }
+    }
+
+    void PhysicsWorld::SetSleepingEnabled(bool enabled) {
+        m_SleepingEnabled = enabled;
+        if (!enabled) {
+            for (uint32_t i = 0; i < m_Store.GetSize(); ++i) {
+                if (!m_Store.IsAwake(i)) {
+                    m_Store.Activate(i);
                 }
             }
+        }
+    }
+
+    bool PhysicsWorld::IsStrictFloatingPoint() {
+#if defined(JFM_DETERMINISTIC_PHYSICS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void PhysicsWorld::SaveSnapshot(PhysicsSnapshot& snapshot) const {
+        static_assert(std::is_trivially_copyable<ContactManifold>::value && sizeof(ContactManifold) % sizeof(uint32_t) == 0,
+                      "ContactManifold must be copyable as whole words");
+        constexpr size_t ManifoldWords = sizeof(ContactManifold) / sizeof(uint32_t);
+
+        // 缓存过期时直接从流形中挑出要缓存的部分，结果与先整理缓存相同（流形按碰撞对排序）
+        size_t contactCount = m_ContactCache.size();
+        if (m_ContactCacheStale) {
+            contactCount = static_cast<size_t>(std::count_if(m_Manifolds.begin(), m_Manifolds.end(), IsCachedManifold));
+        }
+
+        const size_t bodyWords = m_Store.GetSnapshotFloatCount();
+        snapshot.Data.resize(PhysicsSnapshot::HeaderWords + bodyWords + contactCount * ManifoldWords);
+
+        PhysicsSnapshot::Header header;
+        header.Magic = PhysicsSnapshot::Magic;
+        header.BodyCount = static_cast<uint32_t>(m_Store.GetSize());
+        header.ContactCount = static_cast<uint32_t>(contactCount);
+        header.Flags = (m_Store.HasForces() ? PhysicsSnapshot::HasForces : 0u) |
+                       (m_ContactCacheSorted || m_ContactCacheStale ? PhysicsSnapshot::ContactCacheSorted : 0u);
+        header.StepCount = m_StepCount;
+        header.StepChecksum = m_StepChecksum;
+        header.AccumulatedTime = m_AccumulatedTime;
+
+        uint32_t* words = snapshot.Data.data();
+        std::memcpy(words, &header, sizeof(header));
+        words += PhysicsSnapshot::HeaderWords;
+        m_Store.SaveSnapshot(reinterpret_cast<float*>(words));
+        words += bodyWords;
+        if (m_ContactCacheStale) {
+            for (const ContactManifold& manifold : m_Manifolds) {
+                if (IsCachedManifold(manifold)) {
+                    std::memcpy(words, &manifold, sizeof(ContactManifold));
+                    words += ManifoldWords;
+                }
+            }
+        } else if (!m_ContactCache.empty()) {
+            std::memcpy(words, m_ContactCache.data(), m_ContactCache.size() * sizeof(ContactManifold));
+        }
+    }
+
+    bool PhysicsWorld::RestoreSnapshot(const PhysicsSnapshot& snapshot) {
+        constexpr size_t ManifoldWords = sizeof(ContactManifold) / sizeof(uint32_t);
+        if (snapshot.IsEmpty()) {
+            return false;
+        }
+
+        const PhysicsSnapshot::Header& header = snapshot.GetHeader();
+        const size_t bodyWords = m_Store.GetSnapshotFloatCount();
+        if (header.Magic != PhysicsSnapshot::Magic || header.BodyCount != m_Store.GetSize() ||
+            snapshot.Data.size() != PhysicsSnapshot::HeaderWords + bodyWords + size_t(header.ContactCount) * ManifoldWords) {
+            return false;
+        }
+
+        const uint32_t* words = snapshot.Data.data() + PhysicsSnapshot::HeaderWords;
+        m_Store.LoadSnapshot(reinterpret_cast<const float*>(words), (header.Flags & PhysicsSnapshot::HasForces) != 0);
+        words += bodyWords;
+        m_ContactCache.resize(header.ContactCount);
+        if (header.ContactCount > 0) {
+            std::memcpy(static_cast<void*>(m_ContactCache.data()), words, m_ContactCache.size() * sizeof(ContactManifold));
+        }
+        m_ContactCacheSorted = (header.Flags & PhysicsSnapshot::ContactCacheSorted) != 0;
+        m_ContactCacheStale = false;
+        m_StepCount = header.StepCount;
+        m_StepChecksum = header.StepChecksum;
+        m_AccumulatedTime = header.AccumulatedTime;
+
+        // 上一步的流形与恢复后的状态无关；所有刚体（包括恢复为休眠的）都可能移动过，
+        // 下一步全部更新一次宽阶段包围盒，查询树在下一次Update或Step后或者手动调用SyncQueryTree时同步
+        m_Manifolds.clear();
+        m_ManifoldPairsVersion = UINT64_MAX;
+        for (uint32_t i = 0; i < m_Store.GetSize(); ++i) {
+            AddActiveBody(i);
+            if (!(m_BodyFlags[i] & QueryDirtyFlag)) {
+                m_BodyFlags[i] |= QueryDirtyFlag;
+                m_QueryDirtyBodies.push_back(i);
+            }
+        }
+        return true;
+    }
+
+    uint64_t PhysicsWorld::ComputeStateHash() const {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 4; ++i) {
+                hash ^= (bits >> (i * 8)) & 0xFFu;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        for (uint32_t i = 0; i < m_Store.GetSize(); ++i) {
+            glm::vec3 position = m_Store.GetPosition(i);
+            glm::vec3 velocity = m_Store.GetVelocity(i);
+            mix(position.x); mix(position.y); mix(position.z);
+            mix(velocity.x); mix(velocity.y); mix(velocity.z);
+            mix(m_Store.IsAwake(i) ? 1.0f : 0.0f);
+        }
+        return hash;
+    }
+
+    uint32_t PhysicsWorld::FindIslandRoot(uint32_t body) {
+        // 路径减半
+        while (m_IslandParent[body] != body) {
+            m_IslandParent[body] = m_IslandParent[m_IslandParent[body]];
+            body = m_IslandParent[body];
+        }
+        return body;
+    }
+
+    void PhysicsWorld::BuildIslands() {
+        const uint32_t bodyCount = static_cast<uint32_t>(m_Rigidbodies.size());
+        const float* invMass = m_Store.GetInvMassArray();
+        const auto& pairs = GetBroadPhasePairs();
+
+        m_Constraints.clear();
+        CollectConstraints(m_Constraints);
+
+        // 并查集：只连接两个动态刚体，总是把较大的根挂到较小的根下，根即集合中最小的下标
+        m_IslandParent.resize(bodyCount);
+        for (uint32_t i = 0; i < bodyCount; ++i) {
+            m_IslandParent[i] = i;
+        }
+
+        auto isDynamic = [&](uint32_t body) { return body < bodyCount && invMass[body] > 0.0f; };
+        auto unite = [&](uint32_t a, uint32_t b) {
+            if (!isDynamic(a) || !isDynamic(b)) return;
+            uint32_t rootA = FindIslandRoot(a);
+            uint32_t rootB = FindIslandRoot(b);
+            if (rootA < rootB) {
+                m_IslandParent[rootB] = rootA;
+            } else if (rootB < rootA) {
+                m_IslandParent[rootA] = rootB;
+            }
+        };
+
+        for (const BroadPhasePair& pair : pairs) {
+            unite(pair.A, pair.B);
+        }
+        for (const ConstraintEdge& edge : m_Constraints) {
+            unite(edge.BodyA, edge.BodyB);
+        }
+
+        // 按刚体下标顺序编号，根先于集合中的其他刚体出现，岛的顺序与线程数无关
+        m_Islands.clear();
+        m_BodyIsland.assign(bodyCount, InvalidBody);
+        m_SolverVelocities.resize(bodyCount);
+        for (uint32_t i = 0; i < bodyCount; ++i) {
+            if (!isDynamic(i)) continue;
+
+            uint32_t root = FindIslandRoot(i);
+            if (root == i) {
+                m_BodyIsland[i] = static_cast<uint32_t>(m_Islands.size());
+                m_Islands.emplace_back();
+            } else {
+                m_BodyIsland[i] = m_BodyIsland[root];
+            }
+            m_Islands[m_BodyIsland[i]].BodyCount++;
+        }
+
+        auto islandOf = [&](uint32_t a, uint32_t b) {
+            if (isDynamic(a)) return m_BodyIsland[a];
+            if (isDynamic(b)) return m_BodyIsland[b];
+            return InvalidBody;
+        };
+
+        for (const BroadPhasePair& pair : pairs) {
+            uint32_t island = islandOf(pair.A, pair.B);
+            if (island != InvalidBody) {
+                m_Islands[island].PairCount++;
+            }
+        }
+
+        m_FreeConstraints.clear();
+        for (uint32_t c = 0; c < m_Constraints.size(); ++c) {
+            uint32_t island = islandOf(m_Constraints[c].BodyA, m_Constraints[c].BodyB);
+            if (island != InvalidBody) {
+                m_Islands[island].ConstraintCount++;
+            } else {
+                m_FreeConstraints.push_back(c);
+            }
+        }
 
-            // 简单的碰撞检测和响应
-            for (size_t i = 0; i < m_Rigidbodies.size(); ++i) {
-                for (size_t j = i + 1; j < m_Rigidbodies.size(); ++j) {
-                    auto& rbA = m_Rigidbodies[i];
-                    auto& rbB = m_Rigidbodies[j];
+        // 计数排序：各岛的数据连续存放，岛内保持刚体下标、碰撞对和约束编号的原有顺序
+        uint32_t bodyOffset = 0, pairOffset = 0, constraintOffset = 0;
+        for (Island& island : m_Islands) {
+            island.BodyBegin = bodyOffset;
+            island.PairBegin = pairOffset;
+            island.ConstraintBegin = constraintOffset;
+            bodyOffset += island.BodyCount;
+            pairOffset += island.PairCount;
+            constraintOffset += island.ConstraintCount;
+            island.BodyCount = island.PairCount = island.ConstraintCount = 0;
+        }
 
-                    if (rbA && rbB) {
-                        // 简单的碰撞响应：弹性碰撞
-                        float distance = glm::length(rbA->m_Position - rbB->m_Position);
-                        float minDistance = 1.0f; // 最小距离阈值
+        m_IslandBodies.resize(bodyOffset);
+        m_IslandPairs.resize(pairOffset);
+        m_IslandConstraints.resize(constraintOffset);
 
-                        if (distance < minDistance && distance > 0.0f) {
-                            // 计算碰撞法向量
-                            glm::vec3 normal = glm::normalize(rbA->m_Position - rbB->m_Position);
+        for (uint32_t i = 0; i < bodyCount; ++i) {
+            if (m_BodyIsland[i] != InvalidBody) {
+                Island& island = m_Islands[m_BodyIsland[i]];
+                m_IslandBodies[island.BodyBegin + island.BodyCount++] = i;
+            }
+        }
+        for (uint32_t p = 0; p < pairs.size(); ++p) {
+            uint32_t index = islandOf(pairs[p].A, pairs[p].B);
+            if (index != InvalidBody) {
+                Island& island = m_Islands[index];
+                m_IslandPairs[island.PairBegin + island.PairCount++] = p;
+            }
+        }
+        for (uint32_t c = 0; c < m_Constraints.size(); ++c) {
+            uint32_t index = islandOf(m_Constraints[c].BodyA, m_Constraints[c].BodyB);
+            if (index != InvalidBody) {
+                Island& island = m_Islands[index];
+                m_IslandConstraints[island.ConstraintBegin + island.ConstraintCount++] = c;
+            }
+        }
+    }
 
-                            // 检查法向量是否有效
-                            if (glm::length(normal) < 0.001f) {
-                                // 如果法向量无效，使用默认分离方向
-                                normal = glm::vec3(1.0f, 0.0f, 0.0f);
-                            }
+    void PhysicsWorld::SolveIslands(float deltaTime) {
+        // 岛之间不共享动态刚体，静态刚体在求解中只读，因此各岛可以并行求解；
+        // 每个岛在单一线程上按固定顺序求解，结果与线程数和调度无关
+        constexpr size_t IslandsPerJob = 8;
+        m_IslandState.assign(m_Islands.size(), IslandSleeping);
+        m_IslandContactDelta.assign(m_Islands.size(), 0);
+        if (m_IslandActivations.size() < m_Islands.size()) {
+            m_IslandActivations.resize(m_Islands.size());
+        }
 
-                            // 分离物体
-                            float overlap = minDistance - distance;
-                            float totalMass = rbA->GetMass() + rbB->GetMass();
+        // 约束通过Rigidbody的setter激活刚体，求解期间记入各岛自己的列表，汇总时按岛的顺序合并
+        JobSystem::GetInstance().ParallelFor(m_Islands.size(), IslandsPerJob, [this, deltaTime](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                RigidbodyStore::ActivationScope scope(m_Store, m_IslandActivations[i]);
+                SolveIsland(static_cast<uint32_t>(i), deltaTime);
+            }
+        });
 
-                            if (totalMass > 0.0f) {
-                                float ratioA = rbB->GetMass() / totalMass;
-                                float ratioB = rbA->GetMass() / totalMass;
+        for (uint32_t constraint : m_FreeConstraints) {
+            SolveConstraint(constraint, deltaTime);
+        }
 
-                                rbA->m_Position += normal * overlap * ratioA;
-                                rbB->m_Position -= normal * overlap * ratioB;
+        uint32_t awakeIslands = 0;
+        uint32_t awakeBodies = 0;
+        uint32_t sleepingBodies = 0;
+        for (size_t i = 0; i < m_Islands.size(); ++i) {
+            if (!m_IslandActivations[i].empty()) {
+                m_Store.AppendActivated(m_IslandActivations[i]);
+                m_IslandActivations[i].clear();
+            }
+            m_TouchingCount += m_IslandContactDelta[i];
+            if (m_IslandState[i] == IslandAwake) {
+                awakeIslands++;
+                awakeBodies += m_Islands[i].BodyCount;
+            } else {
+                sleepingBodies += m_Islands[i].BodyCount;
+            }
+        }
+        m_Stats.IslandCount = static_cast<uint32_t>(m_Islands.size());
+        m_Stats.AwakeIslandCount = awakeIslands;
+        m_Stats.AwakeBodies = awakeBodies;
+        m_Stats.SleepingBodies = sleepingBodies;
+        m_Stats.ContactCount = m_TouchingCount;
+    }
+
+    void PhysicsWorld::SolveIsland(uint32_t islandIndex, float deltaTime) {
+        const Island& island = m_Islands[islandIndex];
+        const uint32_t* bodies = m_IslandBodies.data() + island.BodyBegin;
 
-                                // 弹性碰撞速度计算
-                                float restitution = 0.8f; // 恢复系数
-                                glm::vec3 relativeVelocity = rbA->m_Velocity - rbB->m_Velocity;
-                                float velocityAlongNormal = glm::dot(relativeVelocity, normal);
+        // 岛内任意刚体醒着（例如被醒着的物体撞到）时整个岛醒来，全部休眠时跳过
+        bool awake = false;
+        for (uint32_t i = 0; i < island.BodyCount && !awake; ++i) {
+            awake = m_Store.IsAwake(bodies[i]);
+        }
+        if (!awake) {
+            return;
+        }
+        for (uint32_t i = 0; i < island.BodyCount; ++i) {
+            if (!m_Store.IsAwake(bodies[i])) {
+                m_Store.SetAwake(bodies[i], true);
+            }
+        }
 
-                                if (velocityAlongNormal > 0) continue; // 物体正在分离
+        for (uint32_t i = 0; i < island.BodyCount; ++i) {
+            m_SolverVelocities[bodies[i]] = m_Store.GetVelocity(bodies[i]);
+        }
 
-                                float impulse = -(1 + restitution) * velocityAlongNormal;
-                                float invMassSum = 1.0f/rbA->GetMass() + 1.0f/rbB->GetMass();
+        // 接触数的变化按岛记录，汇总时不必遍历休眠岛的流形
+        const uint32_t* pairs = m_IslandPairs.data() + island.PairBegin;
+        int32_t contactDelta = 0;
+        for (uint32_t i = 0; i < island.PairCount; ++i) {
+            bool touching = m_Manifolds[pairs[i]].Touching;
+            UpdateContact(pairs[i], deltaTime);
+            contactDelta += int32_t(m_Manifolds[pairs[i]].Touching) - int32_t(touching);
+        }
+        m_IslandContactDelta[islandIndex] = contactDelta;
+        ContactSolver::SolveVelocities(m_Store, m_Manifolds.data(), pairs, island.PairCount, m_ContactSettings, deltaTime);
 
-                                // 防止除零
-                                if (invMassSum > 0.0f) {
-                                    impulse /= invMassSum;
+        for (uint32_t i = 0; i < island.ConstraintCount; ++i) {
+            SolveConstraint(m_IslandConstraints[island.ConstraintBegin + i], deltaTime);
+        }
 
-                                    glm::vec3 impulseVector = impulse * normal;
-                                    rbA->m_Velocity += impulseVector / rbA->GetMass();
-                                    rbB->m_Velocity -= impulseVector / rbB->GetMass();
-                                }
-                            }
-                        }
-                    }
+        // 积分时位置已按求解前的速度前进，补上求解带来的速度变化，等价于先求解速度再积分位置
+        for (uint32_t i = 0; i < island.BodyCount; ++i) {
+            uint32_t body = bodies[i];
+            glm::vec3 correction = (m_Store.GetVelocity(body) - m_SolverVelocities[body]) * deltaTime;
+            m_Store.SetPosition(body, m_Store.GetPosition(body) + correction);
+        }
+        ContactSolver::SolvePositions(m_Store, m_Manifolds.data(), pairs, island.PairCount, m_ContactSettings);
+
+        // 岛内最慢进入休眠的刚体决定整个岛何时休眠，阈值为0的刚体使整个岛保持醒着
+        bool sleep = false;
+        if (m_SleepingEnabled) {
+            float minSleepTime = FLT_MAX;
+            for (uint32_t i = 0; i < island.BodyCount; ++i) {
+                float threshold = m_Store.GetSleepThreshold(bodies[i]);
+                if (threshold < 0.0f) {
+                    threshold = m_SleepLinearVelocity;
                 }
+                glm::vec3 velocity = m_Store.GetVelocity(bodies[i]);
+                bool resting = threshold > 0.0f && glm::dot(velocity, velocity) <= threshold * threshold;
+                float sleepTime = resting ? m_Store.GetSleepTime(bodies[i]) + deltaTime : 0.0f;
+                m_Store.SetSleepTime(bodies[i], sleepTime);
+                minSleepTime = std::min(minSleepTime, sleepTime);
             }
+            sleep = minSleepTime >= m_TimeToSleep;
+        }
 
-            m_AccumulatedTime -= m_FixedTimeStep;
-            subSteps++;
+        if (sleep) {
+            for (uint32_t i = 0; i < island.BodyCount; ++i) {
+                m_Store.SetAwake(bodies[i], false);
+            }
+        }
+        m_IslandState[islandIndex] = sleep ? IslandFellAsleep : IslandAwake;
+    }
+
+    void PhysicsWorld::MatchContactCache() {
+        // 休眠的物体占多数时碰撞对很少变化，流形原样保留，不必经过缓存来回拷贝
+        uint64_t pairsVersion = m_BroadPhaseType == BroadPhaseType::SpatialHashGrid ? m_Grid->GetPairsVersion()
+                                                                                    : m_BroadPhase->GetPairsVersion();
+        if (m_ManifoldPairsVersion == pairsVersion) {
+            return;
+        }
+        FlushContactCache();
+
+        // 宽阶段碰撞对和缓存都按(A, B)排序，一次归并即可取回上一步的冲量
+        const auto& pairs = GetBroadPhasePairs();
+        auto keyLess = [](uint32_t a0, uint32_t b0, uint32_t a1, uint32_t b1) {
+            return a0 < a1 || (a0 == a1 && b0 < b1);
+        };
+
+        if (!m_ContactCacheSorted) {
+            std::sort(m_ContactCache.begin(), m_ContactCache.end(), [&](const ContactManifold& x, const ContactManifold& y) {
+                return keyLess(x.BodyA, x.BodyB, y.BodyA, y.BodyB);
+            });
+            m_ContactCacheSorted = true;
+        }
+
+        m_Manifolds.resize(pairs.size());
+        m_ManifoldPairsVersion = pairsVersion;
+        m_TouchingCount = 0;
+        size_t cached = 0;
+        for (size_t p = 0; p < pairs.size(); ++p) {
+            const BroadPhasePair& pair = pairs[p];
+            while (cached < m_ContactCache.size() &&
+                   keyLess(m_ContactCache[cached].BodyA, m_ContactCache[cached].BodyB, pair.A, pair.B)) {
+                ++cached;
+            }
+
+            ContactManifold& manifold = m_Manifolds[p];
+            if (cached < m_ContactCache.size() && m_ContactCache[cached].BodyA == pair.A && m_ContactCache[cached].BodyB == pair.B) {
+                manifold = m_ContactCache[cached];
+                m_TouchingCount += manifold.Touching ? 1 : 0;
+            } else {
+                manifold = ContactManifold();
+                manifold.BodyA = pair.A;
+                manifold.BodyB = pair.B;
+            }
+        }
+    }
+
+    void PhysicsWorld::FlushContactCache() {
+        // 只缓存仍在接触或带有GJK单纯形的流形；休眠岛的流形原样保留，醒来时直接热启动
+        if (!m_ContactCacheStale) {
+            return;
+        }
+        m_ContactCache.clear();
+        for (const ContactManifold& manifold : m_Manifolds) {
+            if (IsCachedManifold(manifold)) {
+                m_ContactCache.push_back(manifold);
+            }
+        }
+        m_ContactCacheSorted = true;
+        m_ContactCacheStale = false;
+    }
+
+    void PhysicsWorld::UpdateContact(uint32_t pairIndex, float deltaTime) {
+        ContactManifold& manifold = m_Manifolds[pairIndex];
+        const Rigidbody& bodyA = *m_Rigidbodies[manifold.BodyA];
+        const Rigidbody& bodyB = *m_Rigidbodies[manifold.BodyB];
+
+        glm::vec3 positionA = m_Store.GetPosition(manifold.BodyA);
+        glm::vec3 positionB = m_Store.GetPosition(manifold.BodyB);
+        float margin = Narrowphase::SpeculativeMargin;
+
+        // 连续碰撞检测：本步相对位移超过预测余量时，在本步起点生成接触，余量覆盖整段位移；
+        // 刚体只平移，间距沿法向按位移线性外推到积分后的位置，求解器只允许在本步内恰好闭合间距
+        glm::vec3 displacement(0.0f);
+        if (m_Store.IsContinuous(manifold.BodyA) || m_Store.IsContinuous(manifold.BodyB)) {
+            glm::vec3 velocityA = m_Store.GetVelocity(manifold.BodyA);
+            glm::vec3 velocityB = m_Store.GetVelocity(manifold.BodyB);
+            glm::vec3 motion = (velocityB - velocityA) * deltaTime;
+            if (glm::dot(motion, motion) > margin * margin) {
+                displacement = motion;
+                positionA -= velocityA * deltaTime;
+                positionB -= velocityB * deltaTime;
+                margin += glm::length(motion);
+            }
+        }
+
+        ContactPoint contact;
+        if (!Narrowphase::Collide(bodyA.GetShape(), positionA, bodyB.GetShape(), positionB, contact,
+                                  margin, &manifold.Simplex)) {
+            manifold.Touching = false;
+            manifold.NormalImpulse = 0.0f;
+            manifold.TangentImpulse = glm::vec3(0.0f);
+            return;
         }
 
-        // 清理空指针
-        m_Rigidbodies.erase(
-            std::remove_if(m_Rigidbodies.begin(), m_Rigidbodies.end(),
-                [](const std::shared_ptr<Rigidbody>& ptr) { return !ptr; }),
-            m_Rigidbodies.end()
-        );
+        // 法向明显改变（例如滑过了盒子的棱）时旧冲量不再适用
+        if (!manifold.Touching || glm::dot(manifold.Normal, contact.Normal) < 0.95f) {
+            manifold.NormalImpulse = 0.0f;
+            manifold.TangentImpulse = glm::vec3(0.0f);
+        }
+
+        const PhysicsMaterial& materialA = bodyA.GetMaterial();
+        const PhysicsMaterial& materialB = bodyB.GetMaterial();
+        manifold.Normal = contact.Normal;
+        manifold.Point = contact.Point;
+        manifold.Separation = contact.Separation + glm::dot(displacement, contact.Normal);
+        manifold.Offset = m_Store.GetPosition(manifold.BodyB) - m_Store.GetPosition(manifold.BodyA);
+        manifold.Friction = ContactSolver::MixFriction(materialA.Friction, materialB.Friction);
+        manifold.Restitution = ContactSolver::MixRestitution(materialA.Restitution, materialB.Restitution);
+        manifold.Touching = true;
     }
 
     void PhysicsWorld::AddRigidbody(std::shared_ptr<Rigidbody> rigidbody) {
-        if (rigidbody) {
-            m_Rigidbodies.push_back(rigidbody);
+        // 已经属于某个物理世界的刚体不能重复加入
+        if (!rigidbody || rigidbody->m_Store) {
+            return;
+        }
+
+        // 刚体状态移入存储，刚体变为指向槽位的句柄
+        uint32_t index = m_Store.Add(rigidbody->m_LocalState);
+        rigidbody->m_Store = &m_Store;
+        rigidbody->m_Slot = index;
+
+        AABB bounds = rigidbody->GetBounds();
+        if (m_BroadPhaseType == BroadPhaseType::SpatialHashGrid) {
+            m_Grid->Add(GetContactBounds(*rigidbody));
+            m_Proxies.push_back(SweepAndPrune::InvalidProxy);
+        } else {
+            m_Proxies.push_back(m_BroadPhase->CreateProxy(GetContactBounds(*rigidbody), index));
+        }
+        m_QueryProxies.push_back(m_QueryTree->CreateProxy(bounds, index));
+        m_QueryPositions.push_back(m_Store.GetPosition(index));
+        m_BodyFlags.push_back(0);
+        m_Rigidbodies.push_back(rigidbody);
+
+        // 以休眠状态加入的刚体（例如关卡中预先摆好的物体）在被碰到或唤醒之前不产生任何开销
+        if (m_Store.IsAwake(index) && m_Store.GetInvMass(index) > 0.0f) {
+            m_Store.Activate(index);
         }
     }
 
     void PhysicsWorld::RemoveRigidbody(std::shared_ptr<Rigidbody> rigidbody) {
-        m_Rigidbodies.erase(
-            std::remove(m_Rigidbodies.begin(), m_Rigidbodies.end(), rigidbody),
-            m_Rigidbodies.end()
-        );
+        if (!rigidbody || rigidbody->m_Store != &m_Store) {
+            return;
+        }
+
+        // 状态拷回刚体内部
+        uint32_t index = rigidbody->m_Slot;
+        rigidbody->m_LocalState = m_Store.GetState(index);
+        rigidbody->m_Store = nullptr;
+
+        // 网格与存储一样把最后一个物体移到空出的位置
+        if (m_BroadPhaseType == BroadPhaseType::SpatialHashGrid) {
+            m_Grid->Remove(index);
+        } else {
+            m_BroadPhase->DestroyProxy(m_Proxies[index]);
+        }
+        m_QueryTree->DestroyProxy(m_QueryProxies[index]);
+
+        // 最后一个刚体移到空出的位置，所有并行数组保持一致
+        uint32_t last = static_cast<uint32_t>(m_Rigidbodies.size() - 1);
+        m_Store.Remove(index);
+        m_Rigidbodies[index] = std::move(m_Rigidbodies[last]);
+        m_Proxies[index] = m_Proxies[last];
+        m_QueryProxies[index] = m_QueryProxies[last];
+        m_QueryPositions[index] = m_QueryPositions[last];
+        m_BodyFlags[index] = m_BodyFlags[last];
+        m_Rigidbodies.pop_back();
+        m_Proxies.pop_back();
+        m_QueryProxies.pop_back();
+        m_QueryPositions.pop_back();
+        m_BodyFlags.pop_back();
+
+        // 活动列表同样丢弃被删除的刚体，最后一个刚体改用新槽位
+        for (std::vector<uint32_t>* list : {&m_ActiveBodies, &m_QueryDirtyBodies}) {
+            size_t count = 0;
+            for (uint32_t body : *list) {
+                if (body == index) continue;
+                (*list)[count++] = body == last ? index : body;
+            }
+            list->resize(count);
+        }
+
+        // 缓存的接触按槽位记录刚体：丢弃被删除刚体的接触，被移动刚体的接触改用新槽位
+        FlushContactCache();
+        m_Manifolds.clear();
+        m_ManifoldPairsVersion = UINT64_MAX;
+        size_t kept = 0;
+        for (ContactManifold& manifold : m_ContactCache) {
+            if (manifold.BodyA == index || manifold.BodyB == index) {
+                // 失去支撑的休眠刚体需要醒来
+                uint32_t other = manifold.BodyA == index ? manifold.BodyB : manifold.BodyA;
+                if (other == last) other = index;
+                if (manifold.Touching && !m_Store.IsAwake(other)) {
+                    m_Store.Activate(other);
+                }
+                continue;
+            }
+            if (manifold.BodyA == last) manifold.BodyA = index;
+            if (manifold.BodyB == last) manifold.BodyB = index;
+            if (manifold.BodyA > manifold.BodyB) {
+                std::swap(manifold.BodyA, manifold.BodyB);
+                manifold.Normal = -manifold.Normal;
+                manifold.TangentImpulse = -manifold.TangentImpulse;
+                std::swap(manifold.Simplex.IndexA, manifold.Simplex.IndexB);
+            }
+            m_ContactCache[kept++] = manifold;
+        }
+        m_ContactCache.resize(kept);
+        m_ContactCacheSorted = false;
+
+        if (index != last) {
+            m_Rigidbodies[index]->m_Slot = index;
+            if (m_BroadPhaseType == BroadPhaseType::SweepAndPrune) {
+                m_BroadPhase->SetUserData(m_Proxies[index], index);
+            }
+            m_QueryTree->SetUserData(m_QueryProxies[index], index);
+        }
     }
 
 }
@@ -0,0 +1,183 @@
+//
+// Physics3D.cpp - 3D物理世界实现
+//
+
+#include "JFMEngine/Physics/Physics3D.h"
+#include "JFMEngine/Physics/DynamicAABBTree.h"
+#include "JFMEngine/Physics/Narrowphase.h"
+#include <algorithm>
+
+namespace JFM {
+
+    // Rigidbody3D 实现
+    Rigidbody3D::Rigidbody3D() : EnhancedRigidbody() {
+    }
+
+    // MeshCollider 实现
+    MeshCollider::MeshCollider(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, bool convex)
+        : m_Vertices(vertices), m_Indices(indices) {
+        if (!m_Vertices.empty()) {
+            m_Bounds = AABB(m_Vertices[0], m_Vertices[0]);
+            for (const glm::vec3& vertex : m_Vertices) {
+                m_Bounds.Min = glm::min(m_Bounds.Min, vertex);
+                m_Bounds.Max = glm::max(m_Bounds.Max, vertex);
+            }
+        }
+        SetConvex(convex);
+    }
+
+    MeshCollider::MeshCollider(TriangleBVH bvh)
+        : m_Vertices(bvh.GetVertices()), m_BVH(std::move(bvh)), m_Bounds(m_BVH.GetBounds()) {
+    }
+
+    void MeshCollider::SetConvex(bool convex) {
+        m_IsConvex = convex;
+        // 凸包和BVH都只构建一次，碰撞查询时不再处理原始顶点
+        if (convex && m_Hull.IsEmpty()) {
+            m_Hull.Build(m_Vertices);
+        } else if (!convex && m_BVH.IsEmpty() && !m_Indices.empty()) {
+            m_BVH.Build(m_Vertices, m_Indices);
+        }
+    }
+
+    AABB MeshCollider::GetAABB(const glm::vec3& position) const {
+        return AABB(m_Bounds.Min + position, m_Bounds.Max + position);
+    }
+
+    bool MeshCollider::CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const {
+        ContactPoint contact;
+        return Narrowphase::Collide(this, posA, &other, posB, contact, 0.0f);
+    }
+
+    bool MeshCollider::Raycast(const glm::vec3& position, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                               float& distance, glm::vec3& normal) const {
+        const TriangleBVH* bvh = GetTriangleBVH();
+        if (!bvh) {
+            return Collider::Raycast(position, origin, direction, maxDistance, distance, normal);
+        }
+
+        MeshHit hit;
+        if (!bvh->Raycast(origin - position, direction, maxDistance, hit)) {
+            return false;
+        }
+        distance = hit.Distance;
+        normal = hit.Normal;
+        return true;
+    }
+
+    // CapsuleCollider 实现
+    AABB CapsuleCollider::GetAABB(const glm::vec3& position) const {
+        glm::vec3 halfExtents(m_Radius, GetHalfSegment() + m_Radius, m_Radius);
+        return AABB(position - halfExtents, position + halfExtents);
+    }
+
+    bool CapsuleCollider::CheckCollision(const Collider& other, const glm::vec3& posA, const glm::vec3& posB) const {
+        ContactPoint contact;
+        return Narrowphase::Collide(this, posA, &other, posB, contact, 0.0f);
+    }
+
+    // Joint 实现
+    Joint::Joint(Type type, std::shared_ptr<Rigidbody3D> bodyA, std::shared_ptr<Rigidbody3D> bodyB)
+        : m_Type(type), m_BodyA(std::move(bodyA)), m_BodyB(std::move(bodyB)) {
+    }
+
+    // PhysicsWorld3D 实现
+    void PhysicsWorld3D::AddJoint(std::shared_ptr<Joint> joint) {
+        if (joint) {
+            m_Joints.push_back(joint);
+        }
+    }
+
+    void PhysicsWorld3D::RemoveJoint(std::shared_ptr<Joint> joint) {
+        m_Joints.erase(std::remove(m_Joints.begin(), m_Joints.end(), joint), m_Joints.end());
+    }
+
+    void PhysicsWorld3D::Update(float deltaTime) {
+        if (IsPaused()) return;
+
+        // 关节在基类的岛求解中更新，这里只清理断开的关节
+        PhysicsWorld::Update(deltaTime);
+        SolveConstraints(deltaTime);
+    }
+
+    void PhysicsWorld3D::CollectConstraints(std::vector<ConstraintEdge>& constraints) {
+        m_SolverJoints.clear();
+        for (auto& joint : m_Joints) {
+            if (joint->IsBroken()) continue;
+
+            ConstraintEdge edge;
+            edge.BodyA = GetBodyIndex(joint->GetBodyA().get());
+            edge.BodyB = GetBodyIndex(joint->GetBodyB().get());
+            constraints.push_back(edge);
+            m_SolverJoints.push_back(joint.get());
+        }
+    }
+
+    void PhysicsWorld3D::SolveConstraint(uint32_t constraint, float deltaTime) {
+        Joint* joint = m_SolverJoints[constraint];
+        if (!joint->IsBroken()) {
+            joint->UpdateConstraint(deltaTime);
+        }
+    }
+
+    void PhysicsWorld3D::SolveConstraints(float deltaTime) {
+        (void)deltaTime;
+
+        // 移除已断开的关节
+        m_Joints.erase(
+            std::remove_if(m_Joints.begin(), m_Joints.end(),
+                [](const std::shared_ptr<Joint>& joint) { return joint->IsBroken(); }),
+            m_Joints.end()
+        );
+    }
+
+    PhysicsWorld3D::RaycastHit3D PhysicsWorld3D::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
+        PhysicsUtils::Ray ray(origin, direction, maxDistance);
+        RaycastHit3D hit;
+        RaycastBatch(&ray, 1, &hit);
+        return hit;
+    }
+
+    void PhysicsWorld3D::RaycastBatch(const PhysicsUtils::Ray* rays, size_t count, RaycastHit3D* hits) {
+        const auto& rigidbodies = GetRigidbodies();
+        const DynamicAABBTree& tree = GetQueryTree();
+
+        for (size_t i = 0; i < count; ++i) {
+            const PhysicsUtils::Ray& ray = rays[i];
+            RaycastHit3D& hit = hits[i];
+            hit = RaycastHit3D();
+
+            tree.Raycast(ray.Origin, ray.Direction, ray.MaxDistance, [&](uint32_t index, float maxDistance) {
+                auto rb = std::dynamic_pointer_cast<Rigidbody3D>(rigidbodies[index]);
+                float distance;
+                glm::vec3 normal;
+                if (!rb || !PhysicsUtils::RayIntersectsBody(ray, *rb, distance, normal) || distance > maxDistance) {
+                    return maxDistance;
+                }
+
+                hit.Hit = true;
+                hit.Point = ray.Origin + ray.Direction * distance;
+                hit.Normal = normal;
+                hit.Distance = distance;
+                hit.Rigidbody = rb;
+                return distance;
+            });
+        }
+    }
+
+    std::vector<std::shared_ptr<Rigidbody3D>> PhysicsWorld3D::SphereCast(const glm::vec3& center, float radius) {
+        std::vector<std::shared_ptr<Rigidbody3D>> results;
+        const auto& rigidbodies = GetRigidbodies();
+
+        GetQueryTree().QuerySphere(center, radius, [&](uint32_t index) {
+            auto rb = std::dynamic_pointer_cast<Rigidbody3D>(rigidbodies[index]);
+            if (rb && PhysicsUtils::DistancePointToAABB(center, rb->GetBounds()) <= radius) {
+                results.push_back(rb);
+            }
+            return true;
+        });
+
+        return results;
+    }
+
+}
@@ -3,11 +3,23 @@
 //
 
 #include "JFMEngine/Physics/PhysicsComponents.h"
+#include "JFMEngine/Physics/DynamicAABBTree.h"
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace JFM {
 
+    // Collider 实现
+    bool Collider::Raycast(const glm::vec3& position, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                           float& distance, glm::vec3& normal) const {
+        PhysicsUtils::Ray ray;
+        ray.Origin = origin;
+        ray.Direction = direction;
+        ray.MaxDistance = maxDistance;
+        return PhysicsUtils::RayIntersectsAABB(ray, GetAABB(position), distance, normal);
+    }
+
     // SphereCollider 实现
     AABB SphereCollider::GetAABB(const glm::vec3& position) const {
         glm::vec3 radiusVec(m_Radius);
@@ -55,9 +67,16 @@ namespace JFM {
         m_AngularDrag = 0.95f;
     }
 
+    AABB EnhancedRigidbody::GetBounds() const {
+        if (m_Collider) {
+            return m_Collider->GetAABB(GetPosition());
+        }
+        return Rigidbody::GetBounds();
+    }
+
     void EnhancedRigidbody::ApplyImpulse(const glm::vec3& impulse) {
         if (GetMass() > 0.0f) {
-            m_Velocity += impulse / GetMass();
+            SetVelocity(GetVelocity() + impulse / GetMass());
         }
     }
 
@@ -66,26 +85,28 @@ namespace JFM {
         AddForce(force);
 
         // 计算扭矩（简化版）
-        glm::vec3 torque = glm::cross(point - m_Position, force);
+        glm::vec3 torque = glm::cross(point - GetPosition(), force);
         m_AngularVelocity += torque * 0.1f; // 简化的惯性计算
     }
 
     void EnhancedRigidbody::ConstrainToBounds(const AABB& bounds) {
         // 约束位置
-        m_Position.x = std::max(bounds.Min.x, std::min(bounds.Max.x, m_Position.x));
-        m_Position.y = std::max(bounds.Min.y, std::min(bounds.Max.y, m_Position.y));
-        m_Position.z = std::max(bounds.Min.z, std::min(bounds.Max.z, m_Position.z));
+        glm::vec3 position = glm::clamp(GetPosition(), bounds.Min, bounds.Max);
+        glm::vec3 velocity = GetVelocity();
 
         // 如果碰到边界，反弹速度
-        if (m_Position.x <= bounds.Min.x || m_Position.x >= bounds.Max.x) {
-            m_Velocity.x *= -m_Material.Restitution;
+        if (position.x <= bounds.Min.x || position.x >= bounds.Max.x) {
+            velocity.x *= -m_Material.Restitution;
         }
-        if (m_Position.y <= bounds.Min.y || m_Position.y >= bounds.Max.y) {
-            m_Velocity.y *= -m_Material.Restitution;
+        if (position.y <= bounds.Min.y || position.y >= bounds.Max.y) {
+            velocity.y *= -m_Material.Restitution;
         }
-        if (m_Position.z <= bounds.Min.z || m_Position.z >= bounds.Max.z) {
-            m_Velocity.z *= -m_Material.Restitution;
+        if (position.z <= bounds.Min.z || position.z >= bounds.Max.z) {
+            velocity.z *= -m_Material.Restitution;
         }
+
+        SetPosition(position);
+        SetVelocity(velocity);
     }
 
     // PhysicsUtils 实现
@@ -93,35 +114,100 @@ namespace JFM {
 
         RaycastHit Raycast(const Ray& ray) {
             RaycastHit hit;
-            float closestDistance = ray.MaxDistance;
+            RaycastBatch(&ray, 1, &hit);
+            return hit;
+        }
 
-            // 遍历所有刚体进行射线检测
+        void RaycastBatch(const Ray* rays, size_t count, RaycastHit* hits) {
             auto& world = PhysicsWorld::GetInstance();
             const auto& rigidbodies = world.GetRigidbodies();
+            const DynamicAABBTree& tree = world.GetQueryTree();
+
+            for (size_t i = 0; i < count; ++i) {
+                const Ray& ray = rays[i];
+                RaycastHit& hit = hits[i];
+                hit = RaycastHit();
+
+                // 包围盒树按胖包围盒裁剪，叶节点再与刚体的碰撞器求交
+                tree.Raycast(ray.Origin, ray.Direction, ray.MaxDistance, [&](uint32_t index, float maxDistance) {
+                    const auto& rb = rigidbodies[index];
+                    float distance;
+                    glm::vec3 normal;
+                    if (!RayIntersectsBody(ray, *rb, distance, normal) || distance > maxDistance) {
+                        return maxDistance;
+                    }
 
-            for (const auto& rb : rigidbodies) {
-                if (!rb) continue;
+                    hit.Hit = true;
+                    hit.Point = ray.Origin + ray.Direction * distance;
+                    hit.Normal = normal;
+                    hit.Distance = distance;
+                    hit.Rigidbody = rb;
+                    return distance;
+                });
+            }
+        }
 
-                // 简单的射线-球体相交检测（假设每个刚体都有1单位半径的球形边界）
-                glm::vec3 toRb = rb->m_Position - ray.Origin;
-                float projection = glm::dot(toRb, ray.Direction);
+        std::vector<RaycastHit> RaycastBatch(const std::vector<Ray>& rays) {
+            std::vector<RaycastHit> hits(rays.size());
+            RaycastBatch(rays.data(), rays.size(), hits.data());
+            return hits;
+        }
 
-                if (projection < 0.0f || projection > ray.MaxDistance) continue;
+        bool RayIntersectsAABB(const Ray& ray, const AABB& aabb, float& distance, glm::vec3& normal) {
+            // 平板法，记录进入距离最大的轴作为命中面
+            float enter = 0.0f;
+            float exit = ray.MaxDistance;
+            int enterAxis = -1;
+            float enterSign = 0.0f;
+
+            for (int axis = 0; axis < 3; ++axis) {
+                float origin = ray.Origin[axis];
+                float direction = ray.Direction[axis];
+
+                if (std::abs(direction) < 1e-8f) {
+                    if (origin < aabb.Min[axis] || origin > aabb.Max[axis]) {
+                        return false;
+                    }
+                    continue;
+                }
 
-                glm::vec3 closestPoint = ray.Origin + ray.Direction * projection;
-                float distance = glm::length(rb->m_Position - closestPoint);
+                float invDir = 1.0f / direction;
+                float t1 = (aabb.Min[axis] - origin) * invDir;
+                float t2 = (aabb.Max[axis] - origin) * invDir;
+                float sign = -1.0f;
+                if (t1 > t2) {
+                    std::swap(t1, t2);
+                    sign = 1.0f;
+                }
 
-                if (distance <= 0.5f && projection < closestDistance) { // 假设0.5单位半径
-                    hit.Hit = true;
-                    hit.Point = closestPoint;
-                    hit.Normal = glm::normalize(closestPoint - rb->m_Position);
-                    hit.Distance = projection;
-                    hit.Rigidbody = rb;
-                    closestDistance = projection;
+                if (t1 > enter) {
+                    enter = t1;
+                    enterAxis = axis;
+                    enterSign = sign;
+                }
+                exit = std::min(exit, t2);
+                if (enter > exit) {
+                    return false;
                 }
             }
 
-            return hit;
+            distance = enter;
+            normal = glm::vec3(0.0f);
+            if (enterAxis >= 0) {
+                normal[enterAxis] = enterSign;
+            } else {
+                // 起点在盒内
+                normal = -ray.Direction;
+            }
+            return true;
+        }
+
+        bool RayIntersectsBody(const Ray& ray, const Rigidbody& body, float& distance, glm::vec3& normal) {
+            const Collider* shape = body.GetShape();
+            if (!shape) {
+                return RayIntersectsAABB(ray, body.GetBounds(), distance, normal);
+            }
+            return shape->Raycast(body.GetPosition(), ray.Origin, ray.Direction, ray.MaxDistance, distance, normal);
         }
 
         std::vector<std::shared_ptr<Rigidbody>> OverlapSphere(const glm::vec3& center, float radius) {
@@ -130,13 +216,11 @@ namespace JFM {
             auto& world = PhysicsWorld::GetInstance();
             const auto& rigidbodies = world.GetRigidbodies();
 
-            for (const auto& rb : rigidbodies) {
-                if (!rb) continue;
-
-                float distance = glm::length(rb->m_Position - center);
-                if (distance <= radius + 0.5f) { // 假设刚体有0.5单位半径
-                    results.push_back(rb);
-                }
+            std::vector<uint32_t> bodies;
+            world.OverlapSphere(center, radius, bodies);
+            results.reserve(bodies.size());
+            for (uint32_t index : bodies) {
+                results.push_back(rigidbodies[index]);
             }
 
             return results;
@@ -150,16 +234,13 @@ namespace JFM {
 
             AABB checkBox(center - size * 0.5f, center + size * 0.5f);
 
-            for (const auto& rb : rigidbodies) {
-                if (!rb) continue;
-
-                // 简单的点-AABB检测（假设刚体是点）
-                if (rb->m_Position.x >= checkBox.Min.x && rb->m_Position.x <= checkBox.Max.x &&
-                    rb->m_Position.y >= checkBox.Min.y && rb->m_Position.y <= checkBox.Max.y &&
-                    rb->m_Position.z >= checkBox.Min.z && rb->m_Position.z <= checkBox.Max.z) {
+            world.GetQueryTree().Query(checkBox, [&](uint32_t index) {
+                const auto& rb = rigidbodies[index];
+                if (rb->GetBounds().Intersects(checkBox)) {
                     results.push_back(rb);
                 }
-            }
+                return true;
+            });
 
             return results;
         }
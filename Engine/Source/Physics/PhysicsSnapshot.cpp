@@ -0,0 +1,163 @@
+//
+// PhysicsSnapshot.cpp - 快照历史的差分编码
+//
+
+#include "JFMEngine/Physics/PhysicsSnapshot.h"
+#include "JFMEngine/Physics/Physics.h"
+#include <algorithm>
+#include <cstring>
+
+namespace JFM {
+
+    PhysicsHistory::PhysicsHistory(uint32_t capacity) {
+        SetCapacity(capacity);
+    }
+
+    void PhysicsHistory::Clear() {
+        m_Latest.Data.clear();
+        m_DeltaNewest = 0;
+        m_DeltaCount = 0;
+    }
+
+    void PhysicsHistory::SetCapacity(uint32_t capacity) {
+        m_Capacity = std::max(capacity, 1u);
+        m_Deltas.assign(m_Capacity - 1, std::vector<uint32_t>());
+        Clear();
+    }
+
+    size_t PhysicsHistory::GetMemoryUsage() const {
+        size_t bytes = m_Latest.GetByteSize();
+        for (uint32_t i = 0; i < m_DeltaCount; ++i) {
+            bytes += GetDelta(i).size() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+    void PhysicsHistory::Record(const PhysicsWorld& world) {
+        world.SaveSnapshot(m_Scratch);
+
+        // 原来的最新一帧改存为相对新一帧的差分，容量为1时只保留最新一帧
+        if (!m_Latest.IsEmpty() && !m_Deltas.empty()) {
+            m_DeltaNewest = (m_DeltaNewest + 1) % m_Deltas.size();
+            EncodeDelta(m_Latest.Data, m_Scratch.Data, m_Deltas[m_DeltaNewest], m_ScratchWords);
+            m_DeltaCount = std::min<uint32_t>(m_DeltaCount + 1, static_cast<uint32_t>(m_Deltas.size()));
+        }
+        std::swap(m_Latest, m_Scratch);
+    }
+
+    bool PhysicsHistory::GetSnapshot(uint32_t framesBack, PhysicsSnapshot& snapshot) const {
+        if (framesBack >= GetFrameCount()) {
+            return false;
+        }
+
+        // 从最新一帧开始逐帧向前还原，两个缓冲区交替使用
+        snapshot.Data = m_Latest.Data;
+        std::vector<uint32_t> older;
+        for (uint32_t i = 0; i < framesBack; ++i) {
+            ApplyDelta(snapshot.Data, GetDelta(i), older);
+            snapshot.Data.swap(older);
+        }
+        return true;
+    }
+
+    bool PhysicsHistory::Rewind(PhysicsWorld& world, uint32_t framesBack) {
+        if (framesBack >= GetFrameCount()) {
+            return false;
+        }
+
+        m_Scratch.Data = m_Latest.Data;
+        for (uint32_t i = 0; i < framesBack; ++i) {
+            ApplyDelta(m_Scratch.Data, GetDelta(i), m_ScratchWords);
+            m_Scratch.Data.swap(m_ScratchWords);
+        }
+        if (!world.RestoreSnapshot(m_Scratch)) {
+            return false;
+        }
+
+        std::swap(m_Latest, m_Scratch);
+        if (framesBack > 0) {
+            m_DeltaNewest = (m_DeltaNewest + m_Deltas.size() - framesBack) % m_Deltas.size();
+            m_DeltaCount -= framesBack;
+        }
+        return true;
+    }
+
+    void PhysicsHistory::EncodeDelta(const std::vector<uint32_t>& older, const std::vector<uint32_t>& newer,
+                                     std::vector<uint32_t>& delta, std::vector<uint32_t>& xorWords) {
+        // 先整段求异或（编译器可向量化），两帧长度不同（接触数变化）时较短的一帧以零补齐
+        const size_t olderSize = older.size();
+        const size_t newerSize = newer.size();
+        const size_t common = std::min(olderSize, newerSize);
+        const size_t size = std::max(olderSize, newerSize);
+
+        xorWords.resize(size);
+        for (size_t i = 0; i < common; ++i) {
+            xorWords[i] = older[i] ^ newer[i];
+        }
+        const std::vector<uint32_t>& tail = olderSize > newerSize ? older : newer;
+        if (size > common) {
+            std::memcpy(xorWords.data() + common, tail.data() + common, (size - common) * sizeof(uint32_t));
+        }
+
+        delta.clear();
+        delta.push_back(static_cast<uint32_t>(olderSize));
+
+        // 字面段中不足MinZeroRun个的零字并入字面段，否则每段零字都要额外两个字的段头
+        constexpr size_t MinZeroRun = 3;
+        const uint32_t* x = xorWords.data();
+        size_t i = 0;
+        while (i < size) {
+            size_t zeroStart = i;
+            while (i < size && x[i] == 0) {
+                ++i;
+            }
+            size_t literalStart = i;
+            while (i < size) {
+                size_t run = 0;
+                while (i + run < size && run < MinZeroRun && x[i + run] == 0) {
+                    ++run;
+                }
+                if (run == MinZeroRun || i + run == size) {
+                    break;
+                }
+                i += run + 1;
+            }
+
+            delta.push_back(static_cast<uint32_t>(literalStart - zeroStart));
+            delta.push_back(static_cast<uint32_t>(i - literalStart));
+            delta.insert(delta.end(), x + literalStart, x + i);
+        }
+    }
+
+    void PhysicsHistory::ApplyDelta(const std::vector<uint32_t>& newer, const std::vector<uint32_t>& delta, std::vector<uint32_t>& older) {
+        const size_t olderSize = delta[0];
+        const size_t newerSize = newer.size();
+        older.resize(olderSize);
+
+        // 零字段直接拷贝新一帧，字面字段异或还原；超出older长度的部分只是补齐用的零
+        size_t position = 0;
+        size_t cursor = 1;
+        while (cursor < delta.size()) {
+            size_t zeros = delta[cursor++];
+            size_t literals = delta[cursor++];
+
+            size_t copyEnd = std::min(position + zeros, olderSize);
+            size_t available = std::min(copyEnd, newerSize);
+            if (available > position) {
+                std::memcpy(older.data() + position, newer.data() + position, (available - position) * sizeof(uint32_t));
+            }
+            for (size_t i = std::max(position, available); i < copyEnd; ++i) {
+                older[i] = 0;
+            }
+            position += zeros;
+
+            for (size_t j = 0; j < literals; ++j, ++position) {
+                if (position < olderSize) {
+                    older[position] = delta[cursor + j] ^ (position < newerSize ? newer[position] : 0u);
+                }
+            }
+            cursor += literals;
+        }
+    }
+
+}
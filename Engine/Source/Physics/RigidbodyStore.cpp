@@ -0,0 +1,380 @@
+//
+// RigidbodyStore.cpp - 刚体SoA存储与积分内核
+//
+
+#include "JFMEngine/Physics/RigidbodyStore.h"
+#include <cmath>
+#include <cstring>
+
+// 定义JFM_RIGIDBODY_SCALAR_ONLY时只使用标量内核，供基准对比各个内核
+#if defined(JFM_RIGIDBODY_SCALAR_ONLY)
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define JFM_RIGIDBODY_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define JFM_RIGIDBODY_SSE2 1
+#endif
+
+namespace JFM {
+
+    namespace {
+
+        // 阻力只在(0, 1]内生效，存储时直接换算成每步乘的系数
+        float EffectiveDrag(float drag) {
+            return (drag > 0.0f && drag <= 1.0f) ? drag : 1.0f;
+        }
+
+#if defined(JFM_RIGIDBODY_AVX2)
+        struct SimdOps {
+            using V = __m256;
+            static constexpr size_t Width = 8;
+
+            static V Load(const float* p) { return _mm256_load_ps(p); }
+            static void Store(float* p, V v) { _mm256_store_ps(p, v); }
+            static V Set1(float x) { return _mm256_set1_ps(x); }
+            static V Zero() { return _mm256_setzero_ps(); }
+            static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+            static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+            static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+            static V And(V a, V b) { return _mm256_and_ps(a, b); }
+            static V Greater(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static V Equal(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+            static V Select(V mask, V a, V b) { return _mm256_blendv_ps(b, a, mask); }
+        };
+#elif defined(JFM_RIGIDBODY_SSE2)
+        struct SimdOps {
+            using V = __m128;
+            static constexpr size_t Width = 4;
+
+            static V Load(const float* p) { return _mm_load_ps(p); }
+            static void Store(float* p, V v) { _mm_store_ps(p, v); }
+            static V Set1(float x) { return _mm_set1_ps(x); }
+            static V Zero() { return _mm_setzero_ps(); }
+            static V Add(V a, V b) { return _mm_add_ps(a, b); }
+            static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+            static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+            static V And(V a, V b) { return _mm_and_ps(a, b); }
+            static V Greater(V a, V b) { return _mm_cmpgt_ps(a, b); }
+            static V Equal(V a, V b) { return _mm_cmpeq_ps(a, b); }
+            static V Select(V mask, V a, V b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        };
+#endif
+
+#if defined(JFM_RIGIDBODY_AVX2) || defined(JFM_RIGIDBODY_SSE2)
+        // x - x 对有限值为0，对inf和NaN为NaN，比较结果即为有限性掩码
+        inline SimdOps::V FiniteMask(SimdOps::V x, SimdOps::V y, SimdOps::V z) {
+            using Ops = SimdOps;
+            Ops::V zero = Ops::Zero();
+            return Ops::And(Ops::And(Ops::Equal(Ops::Sub(x, x), zero), Ops::Equal(Ops::Sub(y, y), zero)),
+                            Ops::Equal(Ops::Sub(z, z), zero));
+        }
+
+        struct KernelArrays {
+            float* PosX; float* PosY; float* PosZ;
+            float* VelX; float* VelY; float* VelZ;
+            float* ForceX; float* ForceY; float* ForceZ;
+            const float* InvMass;
+            const float* GravityScale;
+            const float* Drag;
+            const float* Awake;
+        };
+
+        // 一次处理Width个刚体，返回处理到的位置，剩余部分由标量代码处理
+        // WithForces为false时所有力都为0，跳过力数组的读取和清除，减少约三分之一的内存流量
+        template<bool WithForces>
+        size_t IntegrateWide(const KernelArrays& a, size_t count, float deltaTime, const glm::vec3& gravity) {
+            using Ops = SimdOps;
+            using V = Ops::V;
+
+            const V dt = Ops::Set1(deltaTime);
+            const V gx = Ops::Set1(gravity.x);
+            const V gy = Ops::Set1(gravity.y);
+            const V gz = Ops::Set1(gravity.z);
+            const V zero = Ops::Zero();
+
+            const size_t wideEnd = count - count % Ops::Width;
+            for (size_t i = 0; i < wideEnd; i += Ops::Width) {
+                V invMass = Ops::Load(a.InvMass + i);
+                // 静态和休眠的物体保持不变，力也不清除
+                V dynamic = Ops::And(Ops::Greater(invMass, zero), Ops::Greater(Ops::Load(a.Awake + i), zero));
+
+                // 加速度 = F/m + 重力，非有限时视为0
+                V gravityScale = Ops::Load(a.GravityScale + i);
+                V ax = Ops::Mul(gx, gravityScale);
+                V ay = Ops::Mul(gy, gravityScale);
+                V az = Ops::Mul(gz, gravityScale);
+                if constexpr (WithForces) {
+                    V fx = Ops::Load(a.ForceX + i);
+                    V fy = Ops::Load(a.ForceY + i);
+                    V fz = Ops::Load(a.ForceZ + i);
+                    ax = Ops::Add(Ops::Mul(fx, invMass), ax);
+                    ay = Ops::Add(Ops::Mul(fy, invMass), ay);
+                    az = Ops::Add(Ops::Mul(fz, invMass), az);
+                    V accelFinite = FiniteMask(ax, ay, az);
+                    ax = Ops::And(ax, accelFinite);
+                    ay = Ops::And(ay, accelFinite);
+                    az = Ops::And(az, accelFinite);
+
+                    Ops::Store(a.ForceX + i, Ops::Select(dynamic, zero, fx));
+                    Ops::Store(a.ForceY + i, Ops::Select(dynamic, zero, fy));
+                    Ops::Store(a.ForceZ + i, Ops::Select(dynamic, zero, fz));
+                }
+
+                // 速度，非有限时归零
+                V drag = Ops::Load(a.Drag + i);
+                V vx = Ops::Load(a.VelX + i);
+                V vy = Ops::Load(a.VelY + i);
+                V vz = Ops::Load(a.VelZ + i);
+                V nvx = Ops::Mul(Ops::Add(vx, Ops::Mul(ax, dt)), drag);
+                V nvy = Ops::Mul(Ops::Add(vy, Ops::Mul(ay, dt)), drag);
+                V nvz = Ops::Mul(Ops::Add(vz, Ops::Mul(az, dt)), drag);
+                V velocityFinite = FiniteMask(nvx, nvy, nvz);
+                nvx = Ops::And(nvx, velocityFinite);
+                nvy = Ops::And(nvy, velocityFinite);
+                nvz = Ops::And(nvz, velocityFinite);
+
+                // 位置，非有限时位置和速度都归零
+                V px = Ops::Load(a.PosX + i);
+                V py = Ops::Load(a.PosY + i);
+                V pz = Ops::Load(a.PosZ + i);
+                V npx = Ops::Add(px, Ops::Mul(nvx, dt));
+                V npy = Ops::Add(py, Ops::Mul(nvy, dt));
+                V npz = Ops::Add(pz, Ops::Mul(nvz, dt));
+                V positionFinite = FiniteMask(npx, npy, npz);
+
+                Ops::Store(a.PosX + i, Ops::Select(dynamic, Ops::And(npx, positionFinite), px));
+                Ops::Store(a.PosY + i, Ops::Select(dynamic, Ops::And(npy, positionFinite), py));
+                Ops::Store(a.PosZ + i, Ops::Select(dynamic, Ops::And(npz, positionFinite), pz));
+                Ops::Store(a.VelX + i, Ops::Select(dynamic, Ops::And(nvx, positionFinite), vx));
+                Ops::Store(a.VelY + i, Ops::Select(dynamic, Ops::And(nvy, positionFinite), vy));
+                Ops::Store(a.VelZ + i, Ops::Select(dynamic, Ops::And(nvz, positionFinite), vz));
+            }
+            return wideEnd;
+        }
+#endif
+
+    }
+
+    template<typename Self, typename Func>
+    void RigidbodyStore::ForEachArray(Self& self, Func&& func) {
+        for (auto* array : {&self.m_PosX, &self.m_PosY, &self.m_PosZ, &self.m_VelX, &self.m_VelY, &self.m_VelZ,
+                            &self.m_ForceX, &self.m_ForceY, &self.m_ForceZ, &self.m_InvMass, &self.m_GravityScale,
+                            &self.m_Drag, &self.m_Mass, &self.m_Awake, &self.m_SleepTime, &self.m_SleepThreshold, &self.m_Continuous}) {
+            func(*array);
+        }
+    }
+
+    uint32_t RigidbodyStore::Add(const RigidbodyState& state) {
+        uint32_t slot = static_cast<uint32_t>(m_PosX.size());
+        ForEachArray(*this, [](FloatArray& array) { array.push_back(0.0f); });
+        SetState(slot, state);
+        return slot;
+    }
+
+    void RigidbodyStore::Remove(uint32_t slot) {
+        uint32_t last = static_cast<uint32_t>(m_PosX.size() - 1);
+        ForEachArray(*this, [slot](FloatArray& array) {
+            array[slot] = array.back();
+            array.pop_back();
+        });
+
+        // 激活列表同样丢弃被删除的槽位，最后一个槽位改为新位置
+        size_t kept = 0;
+        for (uint32_t activated : m_Activated) {
+            if (activated == slot) continue;
+            m_Activated[kept++] = activated == last ? slot : activated;
+        }
+        m_Activated.resize(kept);
+    }
+
+    void RigidbodyStore::Clear() {
+        ForEachArray(*this, [](FloatArray& array) { array.clear(); });
+        m_Activated.clear();
+    }
+
+    void RigidbodyStore::Reserve(size_t count) {
+        ForEachArray(*this, [count](FloatArray& array) { array.reserve(count); });
+    }
+
+    void RigidbodyStore::SaveSnapshot(float* out) const {
+        const size_t count = GetSize();
+        ForEachArray(*this, [&out, count](const FloatArray& array) {
+            std::memcpy(out, array.data(), count * sizeof(float));
+            out += count;
+        });
+    }
+
+    void RigidbodyStore::LoadSnapshot(const float* in, bool hasForces) {
+        const size_t count = GetSize();
+        ForEachArray(*this, [&in, count](FloatArray& array) {
+            std::memcpy(array.data(), in, count * sizeof(float));
+            in += count;
+        });
+        m_HasForces = hasForces;
+    }
+
+    RigidbodyState RigidbodyStore::GetState(uint32_t slot) const {
+        RigidbodyState state;
+        state.Position = GetPosition(slot);
+        state.Velocity = GetVelocity(slot);
+        state.Force = GetForce(slot);
+        state.Mass = m_Mass[slot];
+        state.InvMass = m_InvMass[slot];
+        state.Drag = m_Drag[slot];
+        state.UseGravity = GetUseGravity(slot);
+        state.Awake = IsAwake(slot);
+        state.SleepTime = m_SleepTime[slot];
+        state.SleepThreshold = m_SleepThreshold[slot];
+        state.Continuous = IsContinuous(slot);
+        return state;
+    }
+
+    void RigidbodyStore::SetState(uint32_t slot, const RigidbodyState& state) {
+        SetPosition(slot, state.Position);
+        SetVelocity(slot, state.Velocity);
+        m_ForceX[slot] = state.Force.x;
+        m_ForceY[slot] = state.Force.y;
+        m_ForceZ[slot] = state.Force.z;
+        m_HasForces = m_HasForces || state.Force != glm::vec3(0.0f);
+        m_Mass[slot] = state.Mass;
+        m_InvMass[slot] = state.InvMass;
+        SetDrag(slot, state.Drag);
+        SetUseGravity(slot, state.UseGravity);
+        m_Awake[slot] = state.Awake ? 1.0f : 0.0f;
+        m_SleepTime[slot] = state.SleepTime;
+        m_SleepThreshold[slot] = state.SleepThreshold;
+        SetContinuous(slot, state.Continuous);
+    }
+
+    void RigidbodyStore::SetMass(uint32_t slot, float mass) {
+        m_Mass[slot] = mass;
+        m_InvMass[slot] = (mass == 0.0f) ? 0.0f : 1.0f / mass;
+        m_HasForces = true; // 静态物体上累积的力不会被清除，变为动态物体后需要生效
+    }
+
+    void RigidbodyStore::SetAwake(uint32_t slot, bool awake) {
+        m_Awake[slot] = awake ? 1.0f : 0.0f;
+        m_SleepTime[slot] = 0.0f;
+        if (!awake) {
+            SetVelocity(slot, glm::vec3(0.0f));
+        }
+    }
+
+    namespace {
+        // 当前线程上延迟记录激活的存储和列表，见RigidbodyStore::ActivationScope
+        struct DeferredActivations {
+            const RigidbodyStore* Store = nullptr;
+            std::vector<uint32_t>* List = nullptr;
+        };
+        thread_local DeferredActivations t_DeferredActivations;
+    }
+
+    RigidbodyStore::ActivationScope::ActivationScope(RigidbodyStore& store, std::vector<uint32_t>& list)
+        : m_PreviousStore(t_DeferredActivations.Store), m_PreviousList(t_DeferredActivations.List) {
+        t_DeferredActivations.Store = &store;
+        t_DeferredActivations.List = &list;
+    }
+
+    RigidbodyStore::ActivationScope::~ActivationScope() {
+        t_DeferredActivations.Store = m_PreviousStore;
+        t_DeferredActivations.List = m_PreviousList;
+    }
+
+    void RigidbodyStore::Activate(uint32_t slot) {
+        if (!IsAwake(slot)) {
+            SetAwake(slot, true);
+        }
+        if (t_DeferredActivations.Store == this) {
+            t_DeferredActivations.List->push_back(slot);
+        } else {
+            m_Activated.push_back(slot);
+        }
+    }
+
+    void RigidbodyStore::SetDrag(uint32_t slot, float drag) {
+        m_Drag[slot] = EffectiveDrag(drag);
+    }
+
+    const char* RigidbodyStore::GetKernelName() {
+#if defined(JFM_RIGIDBODY_AVX2)
+        return "AVX2";
+#elif defined(JFM_RIGIDBODY_SSE2)
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void RigidbodyStore::Integrate(float deltaTime, const glm::vec3& gravity) {
+        if (deltaTime <= 0.0f || !std::isfinite(deltaTime)) return;
+
+        const size_t count = m_PosX.size();
+        size_t begin = 0;
+
+#if defined(JFM_RIGIDBODY_AVX2) || defined(JFM_RIGIDBODY_SSE2)
+        KernelArrays arrays = {
+            m_PosX.data(), m_PosY.data(), m_PosZ.data(),
+            m_VelX.data(), m_VelY.data(), m_VelZ.data(),
+            m_ForceX.data(), m_ForceY.data(), m_ForceZ.data(),
+            m_InvMass.data(), m_GravityScale.data(), m_Drag.data(), m_Awake.data()
+        };
+        begin = m_HasForces ? IntegrateWide<true>(arrays, count, deltaTime, gravity)
+                            : IntegrateWide<false>(arrays, count, deltaTime, gravity);
+#endif
+
+        IntegrateScalar(begin, count, deltaTime, gravity);
+        m_HasForces = false;
+    }
+
+    void RigidbodyStore::Integrate(float deltaTime, const glm::vec3& gravity, const uint32_t* slots, size_t count) {
+        if (deltaTime <= 0.0f || !std::isfinite(deltaTime)) return;
+
+        for (size_t i = 0; i < count; ++i) {
+            IntegrateSlot(slots[i], deltaTime, gravity);
+        }
+        m_HasForces = false;
+    }
+
+    void RigidbodyStore::IntegrateScalar(size_t begin, size_t end, float deltaTime, const glm::vec3& gravity) {
+        for (size_t i = begin; i < end; ++i) {
+            IntegrateSlot(static_cast<uint32_t>(i), deltaTime, gravity);
+        }
+    }
+
+    void RigidbodyStore::IntegrateSlot(uint32_t slot, float deltaTime, const glm::vec3& gravity) {
+        if (m_InvMass[slot] == 0.0f || m_Awake[slot] == 0.0f) return; // 静态或休眠物体
+
+        RigidbodyState state = GetState(slot);
+        IntegrateState(state, deltaTime, gravity);
+        SetPosition(slot, state.Position);
+        SetVelocity(slot, state.Velocity);
+        SetForce(slot, state.Force);
+    }
+
+    void RigidbodyStore::IntegrateState(RigidbodyState& state, float deltaTime, const glm::vec3& gravity) {
+        if (state.InvMass == 0.0f || !state.Awake) return; // 静态或休眠物体
+        if (deltaTime <= 0.0f || !std::isfinite(deltaTime)) return;
+
+        glm::vec3 acceleration = state.Force * state.InvMass + (state.UseGravity ? gravity : glm::vec3(0.0f));
+        if (!std::isfinite(acceleration.x) || !std::isfinite(acceleration.y) || !std::isfinite(acceleration.z)) {
+            acceleration = glm::vec3(0.0f);
+        }
+
+        glm::vec3 velocity = (state.Velocity + acceleration * deltaTime) * EffectiveDrag(state.Drag);
+        if (!std::isfinite(velocity.x) || !std::isfinite(velocity.y) || !std::isfinite(velocity.z)) {
+            velocity = glm::vec3(0.0f);
+        }
+
+        glm::vec3 position = state.Position + velocity * deltaTime;
+        if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z)) {
+            position = glm::vec3(0.0f);
+            velocity = glm::vec3(0.0f);
+        }
+
+        state.Position = position;
+        state.Velocity = velocity;
+        state.Force = glm::vec3(0.0f);
+    }
+
+}
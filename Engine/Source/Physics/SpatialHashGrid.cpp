@@ -0,0 +1,219 @@
+//
+// SpatialHashGrid.cpp - 均匀网格宽阶段实现
+//
+
+#include "JFMEngine/Physics/SpatialHashGrid.h"
+#include "JFMEngine/Core/JobSystem.h"
+#include <algorithm>
+#include <cstring>
+
+namespace JFM {
+
+    namespace {
+        float MaxExtent(const AABB& bounds) {
+            glm::vec3 size = bounds.Max - bounds.Min;
+            return std::max(size.x, std::max(size.y, size.z));
+        }
+    }
+
+    void SpatialHashGrid::SetCellSize(float cellSize) {
+        m_RequestedCellSize = std::max(cellSize, 0.0f);
+        m_CellSizeCount = 0;
+        m_CellsDirty = m_PairsDirty = true;
+    }
+
+    uint32_t SpatialHashGrid::Add(const AABB& bounds) {
+        m_Bounds.push_back(bounds);
+        m_CellsDirty = m_PairsDirty = true;
+        return static_cast<uint32_t>(m_Bounds.size() - 1);
+    }
+
+    void SpatialHashGrid::Remove(uint32_t index) {
+        m_Bounds[index] = m_Bounds.back();
+        m_Bounds.pop_back();
+        m_CellsDirty = m_PairsDirty = true;
+    }
+
+    void SpatialHashGrid::Clear() {
+        m_Bounds.clear();
+        m_Pairs.clear();
+        m_CellSizeCount = 0;
+        m_CellsDirty = m_PairsDirty = true;
+        m_PairsVersion++;
+    }
+
+    void SpatialHashGrid::UpdateCellSize() {
+        if (m_RequestedCellSize > 0.0f) {
+            m_CellSize = m_RequestedCellSize;
+        } else if (!m_Bounds.empty()) {
+            // 物体数变化超过八分之一时才重新估计，稳定的场景不必每步求中位数
+            size_t count = m_Bounds.size();
+            if (m_CellSizeCount != 0 && count * 8 <= m_CellSizeCount * 9 && count * 8 >= m_CellSizeCount * 7) {
+                return;
+            }
+            m_CellSizeCount = count;
+
+            std::vector<float> extents(count);
+            for (size_t i = 0; i < count; ++i) {
+                extents[i] = MaxExtent(m_Bounds[i]);
+            }
+            std::nth_element(extents.begin(), extents.begin() + count / 2, extents.end());
+            float limit = extents[count / 2] * 2.0f;
+            float cellSize = 0.0f;
+            for (float extent : extents) {
+                if (extent <= limit) {
+                    cellSize = std::max(cellSize, extent);
+                }
+            }
+            m_CellSize = cellSize > 0.0f ? cellSize : 1.0f;
+        }
+        m_InvCellSize = 1.0f / m_CellSize;
+    }
+
+    void SpatialHashGrid::BuildCells() {
+        if (!m_CellsDirty) {
+            return;
+        }
+        m_CellsDirty = false;
+        UpdateCellSize();
+
+        // 桶数为不小于物体数两倍的2的幂，哈希冲突只会多出一些包围盒测试
+        const uint32_t count = static_cast<uint32_t>(m_Bounds.size());
+        size_t buckets = 64;
+        while (buckets < size_t(count) * 2) {
+            buckets *= 2;
+        }
+        m_CellStart.assign(buckets + 1, 0);
+        m_BucketMask = static_cast<uint32_t>(buckets - 1);
+        m_BodyBucket.resize(count);
+        m_BodyCell.resize(count);
+        m_Entries.resize(count);
+        m_Oversized.clear();
+
+        // 计数排序：统计每个桶的物体数，前缀和得到各桶的结束位置，再倒序放入，桶内保持下标升序
+        for (uint32_t i = 0; i < count; ++i) {
+            const AABB& bounds = m_Bounds[i];
+            if (MaxExtent(bounds) > m_CellSize) {
+                m_BodyBucket[i] = OversizedCell;
+                m_Oversized.push_back(i);
+                continue;
+            }
+            CellCoord cell = GetCell(bounds.GetCenter());
+            uint32_t bucket = Hash(cell.X, cell.Y, cell.Z);
+            m_BodyCell[i] = cell;
+            m_BodyBucket[i] = bucket;
+            m_CellStart[bucket]++;
+        }
+
+        uint32_t offset = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            offset += m_CellStart[b];
+            m_CellStart[b] = offset;
+        }
+        m_CellStart[buckets] = offset;
+        for (uint32_t i = count; i-- > 0;) {
+            if (m_BodyBucket[i] != OversizedCell) {
+                m_Entries[--m_CellStart[m_BodyBucket[i]]] = {m_Bounds[i], m_BodyCell[i], i};
+            }
+        }
+        m_Entries.resize(offset);
+    }
+
+    const std::vector<BroadPhasePair>& SpatialHashGrid::UpdatePairs() {
+        if (!m_PairsDirty) {
+            return m_Pairs;
+        }
+        m_PairsDirty = false;
+        BuildCells();
+
+        // 每个物体只收集下标比自己大的重叠物体。按桶的顺序分块并行，同一个桶及相邻桶中的物体
+        // 查找的单元格大多相同，比按物体下标遍历的缓存命中率高得多
+        const size_t entryCount = m_Entries.size();
+        const size_t jobs = (entryCount + EntriesPerJob - 1) / EntriesPerJob;
+        if (m_JobPairs.size() < jobs) {
+            m_JobPairs.resize(jobs);
+        }
+        for (auto& pairs : m_JobPairs) {
+            pairs.clear();
+        }
+
+        JobSystem::GetInstance().ParallelFor(entryCount, EntriesPerJob, [this](size_t begin, size_t end) {
+            std::vector<BroadPhasePair>& pairs = m_JobPairs[begin / EntriesPerJob];
+            for (size_t i = begin; i < end; ++i) {
+                CollectPairs(m_Entries[i], pairs);
+            }
+        });
+
+        m_NewPairs.clear();
+        for (const auto& pairs : m_JobPairs) {
+            m_NewPairs.insert(m_NewPairs.end(), pairs.begin(), pairs.end());
+        }
+        for (uint32_t index : m_Oversized) {
+            CollectOversizedPairs(index, m_NewPairs);
+        }
+
+        // 重叠对远少于物体，生成后整体排序的代价很小；排序后的结果与分块方式无关
+        std::sort(m_NewPairs.begin(), m_NewPairs.end(), [](const BroadPhasePair& a, const BroadPhasePair& b) {
+            return a.A < b.A || (a.A == b.A && a.B < b.B);
+        });
+
+        // 重叠对没有变化时保持版本号，调用方可以沿用按碰撞对保存的数据
+        if (m_NewPairs.size() != m_Pairs.size() ||
+            (!m_Pairs.empty() && std::memcmp(m_NewPairs.data(), m_Pairs.data(), m_Pairs.size() * sizeof(BroadPhasePair)) != 0)) {
+            m_Pairs.swap(m_NewPairs);
+            m_PairsVersion++;
+        }
+        return m_Pairs;
+    }
+
+    void SpatialHashGrid::CollectPairs(const CellEntry& entry, std::vector<BroadPhasePair>& pairs) const {
+        const AABB& bounds = entry.Bounds;
+        const CellCoord cell = entry.Cell;
+        const uint32_t index = entry.Index;
+
+        // 相邻的9列单元格，每列中z相邻的3个单元格位于连续的3个桶（在桶数组末尾回绕时分段），
+        // 桶中其他单元格的物体按坐标跳过
+        auto scan = [&](int32_t x, int32_t y, uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const CellEntry& other = m_Entries[i];
+                if (other.Index > index && other.Cell.X == x && other.Cell.Y == y &&
+                    other.Cell.Z >= cell.Z - 1 && other.Cell.Z <= cell.Z + 1 && bounds.Intersects(other.Bounds)) {
+                    pairs.push_back({index, other.Index});
+                }
+            }
+        };
+        for (int32_t x = cell.X - 1; x <= cell.X + 1; ++x) {
+            for (int32_t y = cell.Y - 1; y <= cell.Y + 1; ++y) {
+                const uint32_t first = Hash(x, y, cell.Z - 1);
+                if (first + 2 <= m_BucketMask) {
+                    scan(x, y, m_CellStart[first], m_CellStart[first + 3]);
+                } else {
+                    for (uint32_t k = 0; k < 3; ++k) {
+                        const uint32_t bucket = (first + k) & m_BucketMask;
+                        scan(x, y, m_CellStart[bucket], m_CellStart[bucket + 1]);
+                    }
+                }
+            }
+        }
+
+        // 过大的物体按下标升序，只需比较下标更大的部分
+        auto it = std::upper_bound(m_Oversized.begin(), m_Oversized.end(), index);
+        for (; it != m_Oversized.end(); ++it) {
+            if (bounds.Intersects(m_Bounds[*it])) {
+                pairs.push_back({index, *it});
+            }
+        }
+    }
+
+    void SpatialHashGrid::CollectOversizedPairs(uint32_t index, std::vector<BroadPhasePair>& pairs) const {
+        // 过大的物体覆盖的单元格通常比物体还多，直接与下标更大的物体逐个比较
+        const AABB& bounds = m_Bounds[index];
+        const uint32_t count = static_cast<uint32_t>(m_Bounds.size());
+        for (uint32_t other = index + 1; other < count; ++other) {
+            if (bounds.Intersects(m_Bounds[other])) {
+                pairs.push_back({index, other});
+            }
+        }
+    }
+
+}
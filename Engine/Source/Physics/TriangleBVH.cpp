@@ -0,0 +1,747 @@
+//
+// TriangleBVH.cpp - 静态三角形BVH的构建、查询与序列化
+//
+
+#include "JFMEngine/Physics/TriangleBVH.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace JFM {
+
+    namespace {
+        constexpr int SAHBins = 16;
+        constexpr int MaxSAHDepth = 32;     // 更深的节点按中位数划分，保证遍历栈不溢出
+        constexpr uint32_t FileMagic = 0x4856424Au;    // "JBVH"
+        constexpr uint32_t FileVersion = 1;
+
+        float SurfaceArea(const AABB& bounds) {
+            glm::vec3 d = bounds.Max - bounds.Min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        AABB Combine(const AABB& a, const AABB& b) {
+            return AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max));
+        }
+
+        AABB EmptyBounds() {
+            return AABB(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX));
+        }
+
+        glm::vec3 ClosestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+            glm::vec3 ab = b - a;
+            glm::vec3 ac = c - a;
+            glm::vec3 ap = p - a;
+            float d1 = glm::dot(ab, ap);
+            float d2 = glm::dot(ac, ap);
+            if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+            glm::vec3 bp = p - b;
+            float d3 = glm::dot(ab, bp);
+            float d4 = glm::dot(ac, bp);
+            if (d3 >= 0.0f && d4 <= d3) return b;
+
+            float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+            glm::vec3 cp = p - c;
+            float d5 = glm::dot(ab, cp);
+            float d6 = glm::dot(ac, cp);
+            if (d6 >= 0.0f && d5 <= d6) return c;
+
+            float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+            float va = d3 * d6 - d5 * d4;
+            if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+                return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+            }
+
+            float sum = va + vb + vc;
+            if (sum <= 0.0f) return a;
+            float v = vb / sum;
+            float w = vc / sum;
+            return a + ab * v + ac * w;
+        }
+
+        // 两条线段之间的最近点
+        void ClosestPointsSegments(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2,
+                                   glm::vec3& c1, glm::vec3& c2) {
+            glm::vec3 d1 = q1 - p1;
+            glm::vec3 d2 = q2 - p2;
+            glm::vec3 r = p1 - p2;
+            float a = glm::dot(d1, d1);
+            float e = glm::dot(d2, d2);
+            float f = glm::dot(d2, r);
+            float s = 0.0f;
+            float t = 0.0f;
+
+            if (a <= FLT_EPSILON && e <= FLT_EPSILON) {
+                c1 = p1;
+                c2 = p2;
+                return;
+            }
+            if (a <= FLT_EPSILON) {
+                t = glm::clamp(f / e, 0.0f, 1.0f);
+            } else {
+                float c = glm::dot(d1, r);
+                if (e <= FLT_EPSILON) {
+                    s = glm::clamp(-c / a, 0.0f, 1.0f);
+                } else {
+                    float b = glm::dot(d1, d2);
+                    float denominator = a * e - b * b;
+                    s = denominator != 0.0f ? glm::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+                    t = (b * s + f) / e;
+                    if (t < 0.0f) {
+                        t = 0.0f;
+                        s = glm::clamp(-c / a, 0.0f, 1.0f);
+                    } else if (t > 1.0f) {
+                        t = 1.0f;
+                        s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+                    }
+                }
+            }
+            c1 = p1 + d1 * s;
+            c2 = p2 + d2 * t;
+        }
+
+        // 射线与以线段为轴的圆柱侧面求交，起点在圆柱外
+        bool RayCylinder(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& p, const glm::vec3& q,
+                         float radius, float& t) {
+            glm::vec3 axis = q - p;
+            glm::vec3 m = origin - p;
+            float axisSq = glm::dot(axis, axis);
+            float md = glm::dot(m, axis);
+            float nd = glm::dot(direction, axis);
+
+            float a = axisSq - nd * nd;
+            if (a <= FLT_EPSILON * axisSq) {
+                return false;   // 与轴平行，由端点球处理
+            }
+            float b = axisSq * glm::dot(m, direction) - md * nd;
+            float c = axisSq * (glm::dot(m, m) - radius * radius) - md * md;
+            float discriminant = b * b - a * c;
+            if (discriminant < 0.0f) {
+                return false;
+            }
+
+            t = (-b - std::sqrt(discriminant)) / a;
+            if (t < 0.0f) {
+                return false;
+            }
+            float s = md + t * nd;
+            return s >= 0.0f && s <= axisSq;
+        }
+
+        bool RaySphere(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& center, float radius, float& t) {
+            glm::vec3 m = origin - center;
+            float b = glm::dot(m, direction);
+            float c = glm::dot(m, m) - radius * radius;
+            if (c > 0.0f && b > 0.0f) {
+                return false;
+            }
+            float discriminant = b * b - c;
+            if (discriminant < 0.0f) {
+                return false;
+            }
+            t = std::max(0.0f, -b - std::sqrt(discriminant));
+            return true;
+        }
+
+        bool RayBox(const glm::vec3& origin, const glm::vec3& invDirection, const AABB& bounds, float maxDistance, float& enter) {
+            glm::vec3 t1 = (bounds.Min - origin) * invDirection;
+            glm::vec3 t2 = (bounds.Max - origin) * invDirection;
+            glm::vec3 tNear = glm::min(t1, t2);
+            glm::vec3 tFar = glm::max(t1, t2);
+            enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+            float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+            return enter <= exit;
+        }
+
+        // 球体沿射线扫掠到三角形的最早时刻：面、三条边（圆柱）和三个顶点（球）中最早的
+        bool SweepSphereTriangle(const glm::vec3& center, float radius, const glm::vec3& direction, float maxDistance,
+                                 const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float& t) {
+            glm::vec3 closest = ClosestPointOnTriangle(center, a, b, c);
+            glm::vec3 offset = center - closest;
+            if (glm::dot(offset, offset) <= radius * radius) {
+                t = 0.0f;
+                return true;
+            }
+
+            float best = FLT_MAX;
+            glm::vec3 normal = glm::cross(b - a, c - a);
+            float length = glm::length(normal);
+            if (length > 0.0f) {
+                normal /= length;
+                float distance = glm::dot(center - a, normal);
+                if (distance < 0.0f) {
+                    normal = -normal;
+                    distance = -distance;
+                }
+                float approach = -glm::dot(direction, normal);
+                if (approach > 0.0f) {
+                    float hitTime = (distance - radius) / approach;
+                    glm::vec3 touch = center + direction * hitTime - normal * radius;
+                    if (glm::distance(ClosestPointOnTriangle(touch, a, b, c), touch) <= 1e-5f * (1.0f + radius)) {
+                        best = hitTime;
+                    }
+                }
+            }
+
+            const glm::vec3* corners[3] = { &a, &b, &c };
+            for (int i = 0; i < 3; ++i) {
+                float hitTime;
+                if (RayCylinder(center, direction, *corners[i], *corners[(i + 1) % 3], radius, hitTime) && hitTime < best) {
+                    best = hitTime;
+                }
+                if (RaySphere(center, direction, *corners[i], radius, hitTime) && hitTime < best) {
+                    best = hitTime;
+                }
+            }
+
+            if (best > maxDistance) {
+                return false;
+            }
+            t = best;
+            return true;
+        }
+
+        template<typename T>
+        void WriteArray(std::ostream& out, const std::vector<T>& values) {
+            uint64_t count = values.size();
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            if (count > 0) {
+                out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+            }
+        }
+
+        template<typename T>
+        bool ReadArray(std::istream& in, std::vector<T>& values) {
+            uint64_t count = 0;
+            if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+                return false;
+            }
+            // 按块读取，损坏的数量不会导致一次分配超出实际数据的内存
+            constexpr uint64_t ChunkElements = 65536;
+            values.clear();
+            while (values.size() < count) {
+                size_t offset = values.size();
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(count - offset, ChunkElements));
+                values.resize(offset + chunk);
+                if (!in.read(reinterpret_cast<char*>(values.data() + offset), static_cast<std::streamsize>(chunk * sizeof(T)))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    struct TriangleBVH::BuildEntry {
+        AABB Bounds;
+        glm::vec3 Centroid;
+        uint32_t Triangle;
+    };
+
+    TriangleBVH::TriangleBVH(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices) {
+        Build(vertices, indices);
+    }
+
+    void TriangleBVH::Clear() {
+        m_Vertices.clear();
+        m_Triangles.clear();
+        m_TriangleIds.clear();
+        m_Nodes.clear();
+        m_Root = 0;
+        m_Bounds = AABB();
+        m_QuantizeScale = glm::vec3(1.0f);
+    }
+
+    void TriangleBVH::Build(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices) {
+        Clear();
+        m_Vertices = vertices;
+
+        // 越界的三角形直接跳过
+        std::vector<BuildEntry> entries;
+        entries.reserve(indices.size() / 3);
+        AABB bounds = EmptyBounds();
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            uint32_t i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+            if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) {
+                continue;
+            }
+
+            BuildEntry entry;
+            entry.Bounds.Min = glm::min(vertices[i0], glm::min(vertices[i1], vertices[i2]));
+            entry.Bounds.Max = glm::max(vertices[i0], glm::max(vertices[i1], vertices[i2]));
+            entry.Centroid = (entry.Bounds.Min + entry.Bounds.Max) * 0.5f;
+            entry.Triangle = static_cast<uint32_t>(i / 3);
+            bounds = Combine(bounds, entry.Bounds);
+            entries.push_back(entry);
+        }
+        if (entries.empty()) {
+            m_Vertices.clear();
+            return;
+        }
+        m_Bounds = bounds;
+
+        // 量化步长：保证65535个单位能覆盖整个包围盒
+        glm::vec3 extent = m_Bounds.Max - m_Bounds.Min;
+        for (int axis = 0; axis < 3; ++axis) {
+            float scale = std::max(extent[axis] / 65535.0f, FLT_MIN);
+            while (m_Bounds.Min[axis] + 65535.0f * scale < m_Bounds.Max[axis]) {
+                scale = std::nextafter(scale, FLT_MAX);
+            }
+            m_QuantizeScale[axis] = scale;
+        }
+
+        m_Nodes.reserve(entries.size());
+        AABB rootBounds;
+        m_Root = BuildRecursive(entries, 0, static_cast<uint32_t>(entries.size()), 0, rootBounds);
+
+        // 三角形按叶节点顺序重排
+        m_Triangles.reserve(entries.size() * 3);
+        m_TriangleIds.reserve(entries.size());
+        for (const BuildEntry& entry : entries) {
+            m_Triangles.push_back(indices[entry.Triangle * 3]);
+            m_Triangles.push_back(indices[entry.Triangle * 3 + 1]);
+            m_Triangles.push_back(indices[entry.Triangle * 3 + 2]);
+            m_TriangleIds.push_back(entry.Triangle);
+        }
+    }
+
+    uint32_t TriangleBVH::BuildRecursive(std::vector<BuildEntry>& entries, uint32_t begin, uint32_t end, int depth, AABB& bounds) {
+        bounds = EmptyBounds();
+        AABB centroidBounds = EmptyBounds();
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds = Combine(bounds, entries[i].Bounds);
+            centroidBounds.Min = glm::min(centroidBounds.Min, entries[i].Centroid);
+            centroidBounds.Max = glm::max(centroidBounds.Max, entries[i].Centroid);
+        }
+
+        uint32_t count = end - begin;
+        if (count <= MaxLeafTriangles) {
+            return LeafFlag | (begin << LeafCountBits) | count;
+        }
+
+        // 分箱SAH：每个轴把质心范围分成SAHBins段，选代价最小的分割面
+        uint32_t mid = begin;
+        glm::vec3 centroidExtent = centroidBounds.Max - centroidBounds.Min;
+        if (depth < MaxSAHDepth) {
+            float bestCost = FLT_MAX;
+            int bestAxis = -1;
+            int bestSplit = 0;
+
+            for (int axis = 0; axis < 3; ++axis) {
+                if (centroidExtent[axis] <= 0.0f) continue;
+
+                uint32_t binCounts[SAHBins] = {};
+                AABB binBounds[SAHBins];
+                for (AABB& b : binBounds) b = EmptyBounds();
+
+                float binScale = SAHBins / centroidExtent[axis];
+                for (uint32_t i = begin; i < end; ++i) {
+                    int bin = std::min(SAHBins - 1, static_cast<int>((entries[i].Centroid[axis] - centroidBounds.Min[axis]) * binScale));
+                    binCounts[bin]++;
+                    binBounds[bin] = Combine(binBounds[bin], entries[i].Bounds);
+                }
+
+                // 从右向左累积右侧代价，再从左向右比较
+                float rightCost[SAHBins];
+                AABB accumulated = EmptyBounds();
+                uint32_t accumulatedCount = 0;
+                for (int bin = SAHBins - 1; bin > 0; --bin) {
+                    accumulated = Combine(accumulated, binBounds[bin]);
+                    accumulatedCount += binCounts[bin];
+                    rightCost[bin] = accumulatedCount > 0 ? SurfaceArea(accumulated) * accumulatedCount : 0.0f;
+                }
+
+                accumulated = EmptyBounds();
+                accumulatedCount = 0;
+                for (int split = 1; split < SAHBins; ++split) {
+                    accumulated = Combine(accumulated, binBounds[split - 1]);
+                    accumulatedCount += binCounts[split - 1];
+                    if (accumulatedCount == 0 || accumulatedCount == count) continue;
+
+                    float cost = SurfaceArea(accumulated) * accumulatedCount + rightCost[split];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            if (bestAxis >= 0) {
+                float binScale = SAHBins / centroidExtent[bestAxis];
+                float minimum = centroidBounds.Min[bestAxis];
+                auto it = std::partition(entries.begin() + begin, entries.begin() + end, [&](const BuildEntry& entry) {
+                    int bin = std::min(SAHBins - 1, static_cast<int>((entry.Centroid[bestAxis] - minimum) * binScale));
+                    return bin < bestSplit;
+                });
+                mid = static_cast<uint32_t>(it - entries.begin());
+            }
+        }
+
+        // 没有有效的SAH分割（质心重合或过深）时按最长轴的中位数划分
+        if (mid == begin || mid == end) {
+            int axis = 0;
+            if (centroidExtent.y > centroidExtent[axis]) axis = 1;
+            if (centroidExtent.z > centroidExtent[axis]) axis = 2;
+            mid = begin + count / 2;
+            std::nth_element(entries.begin() + begin, entries.begin() + mid, entries.begin() + end,
+                [axis](const BuildEntry& a, const BuildEntry& b) { return a.Centroid[axis] < b.Centroid[axis]; });
+        }
+
+        uint32_t node = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+
+        AABB leftBounds, rightBounds;
+        uint32_t left = BuildRecursive(entries, begin, mid, depth + 1, leftBounds);
+        uint32_t right = BuildRecursive(entries, mid, end, depth + 1, rightBounds);
+
+        Node& n = m_Nodes[node];
+        Quantize(leftBounds, n.Min[0], n.Max[0]);
+        Quantize(rightBounds, n.Min[1], n.Max[1]);
+        n.Child[0] = left;
+        n.Child[1] = right;
+        return node;
+    }
+
+    void TriangleBVH::Quantize(const AABB& bounds, uint16_t* qMin, uint16_t* qMax) const {
+        // 向外取整，反量化后的包围盒一定包含原包围盒
+        for (int axis = 0; axis < 3; ++axis) {
+            float origin = m_Bounds.Min[axis];
+            float scale = m_QuantizeScale[axis];
+
+            float low = std::floor((bounds.Min[axis] - origin) / scale);
+            uint32_t lowQ = static_cast<uint32_t>(glm::clamp(low, 0.0f, 65535.0f));
+            while (lowQ > 0 && origin + lowQ * scale > bounds.Min[axis]) --lowQ;
+
+            float high = std::ceil((bounds.Max[axis] - origin) / scale);
+            uint32_t highQ = static_cast<uint32_t>(glm::clamp(high, 0.0f, 65535.0f));
+            while (highQ < 65535 && origin + highQ * scale < bounds.Max[axis]) ++highQ;
+
+            qMin[axis] = static_cast<uint16_t>(lowQ);
+            qMax[axis] = static_cast<uint16_t>(highQ);
+        }
+    }
+
+    void TriangleBVH::QuantizeQuery(const AABB& bounds, uint32_t* qMin, uint32_t* qMax) const {
+        // 多留一个单位，抵消除法的舍入误差
+        for (int axis = 0; axis < 3; ++axis) {
+            float low = std::floor((bounds.Min[axis] - m_Bounds.Min[axis]) / m_QuantizeScale[axis]) - 1.0f;
+            float high = std::ceil((bounds.Max[axis] - m_Bounds.Min[axis]) / m_QuantizeScale[axis]) + 1.0f;
+            qMin[axis] = static_cast<uint32_t>(glm::clamp(low, 0.0f, 65535.0f));
+            qMax[axis] = static_cast<uint32_t>(glm::clamp(high, 0.0f, 65535.0f));
+        }
+    }
+
+    AABB TriangleBVH::Dequantize(const Node& node, int child) const {
+        glm::vec3 qMin(node.Min[child][0], node.Min[child][1], node.Min[child][2]);
+        glm::vec3 qMax(node.Max[child][0], node.Max[child][1], node.Max[child][2]);
+        return AABB(m_Bounds.Min + qMin * m_QuantizeScale, m_Bounds.Min + qMax * m_QuantizeScale);
+    }
+
+    bool TriangleBVH::IntersectRayTriangle(const glm::vec3& origin, const glm::vec3& direction,
+                                           const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float& t) {
+        // Möller–Trumbore，双面
+        glm::vec3 edge1 = v1 - v0;
+        glm::vec3 edge2 = v2 - v0;
+        glm::vec3 p = glm::cross(direction, edge2);
+        float determinant = glm::dot(edge1, p);
+        if (std::abs(determinant) < 1e-12f) {
+            return false;
+        }
+
+        float invDeterminant = 1.0f / determinant;
+        glm::vec3 s = origin - v0;
+        float u = glm::dot(s, p) * invDeterminant;
+        if (u < 0.0f || u > 1.0f) {
+            return false;
+        }
+
+        glm::vec3 q = glm::cross(s, edge1);
+        float v = glm::dot(direction, q) * invDeterminant;
+        if (v < 0.0f || u + v > 1.0f) {
+            return false;
+        }
+
+        t = glm::dot(edge2, q) * invDeterminant;
+        return t >= 0.0f;
+    }
+
+    bool TriangleBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, MeshHit& hit) const {
+        if (IsEmpty()) {
+            return false;
+        }
+
+        const glm::vec3 invDirection = 1.0f / direction;
+        float enter;
+        if (!RayBox(origin, invDirection, m_Bounds, maxDistance, enter)) {
+            return false;
+        }
+
+        bool found = false;
+        uint32_t stack[MaxStackDepth];
+        int count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0) {
+            uint32_t ref = stack[--count];
+            if (IsLeaf(ref)) {
+                uint32_t first = LeafFirst(ref);
+                for (uint32_t i = first; i < first + LeafCount(ref); ++i) {
+                    glm::vec3 a, b, c;
+                    GetTriangle(i, a, b, c);
+                    float t;
+                    if (IntersectRayTriangle(origin, direction, a, b, c, t) && t <= maxDistance) {
+                        maxDistance = t;
+                        found = true;
+                        hit.Triangle = m_TriangleIds[i];
+                        hit.Distance = t;
+                        hit.Point = origin + direction * t;
+                        glm::vec3 normal = glm::normalize(glm::cross(b - a, c - a));
+                        hit.Normal = glm::dot(normal, direction) > 0.0f ? -normal : normal;
+                    }
+                }
+                continue;
+            }
+
+            // 两个子节点都命中时先压入远的，近的先出栈
+            const Node& node = m_Nodes[ref];
+            float enter0, enter1;
+            bool hit0 = RayBox(origin, invDirection, Dequantize(node, 0), maxDistance, enter0);
+            bool hit1 = RayBox(origin, invDirection, Dequantize(node, 1), maxDistance, enter1);
+            JFM_CORE_ASSERT(count + 2 <= MaxStackDepth, "TriangleBVH stack overflow");
+            if (hit0 && hit1) {
+                bool nearFirst = enter0 <= enter1;
+                stack[count++] = node.Child[nearFirst ? 1 : 0];
+                stack[count++] = node.Child[nearFirst ? 0 : 1];
+            } else if (hit0) {
+                stack[count++] = node.Child[0];
+            } else if (hit1) {
+                stack[count++] = node.Child[1];
+            }
+        }
+        return found;
+    }
+
+    bool TriangleBVH::SphereSweep(const glm::vec3& center, float radius, const glm::vec3& direction, float maxDistance, MeshHit& hit) const {
+        if (IsEmpty()) {
+            return false;
+        }
+
+        // 节点包围盒按半径扩展后做射线遍历
+        const glm::vec3 invDirection = 1.0f / direction;
+        const glm::vec3 reach(radius);
+        float enter;
+        if (!RayBox(center, invDirection, AABB(m_Bounds.Min - reach, m_Bounds.Max + reach), maxDistance, enter)) {
+            return false;
+        }
+
+        bool found = false;
+        uint32_t foundTriangle = 0;
+        uint32_t stack[MaxStackDepth];
+        int count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0) {
+            uint32_t ref = stack[--count];
+            if (IsLeaf(ref)) {
+                uint32_t first = LeafFirst(ref);
+                for (uint32_t i = first; i < first + LeafCount(ref); ++i) {
+                    glm::vec3 a, b, c;
+                    GetTriangle(i, a, b, c);
+                    float t;
+                    if (SweepSphereTriangle(center, radius, direction, maxDistance, a, b, c, t)) {
+                        maxDistance = t;
+                        foundTriangle = i;
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            const Node& node = m_Nodes[ref];
+            AABB bounds0 = Dequantize(node, 0);
+            AABB bounds1 = Dequantize(node, 1);
+            float enter0, enter1;
+            bool hit0 = RayBox(center, invDirection, AABB(bounds0.Min - reach, bounds0.Max + reach), maxDistance, enter0);
+            bool hit1 = RayBox(center, invDirection, AABB(bounds1.Min - reach, bounds1.Max + reach), maxDistance, enter1);
+            JFM_CORE_ASSERT(count + 2 <= MaxStackDepth, "TriangleBVH stack overflow");
+            if (hit0 && hit1) {
+                bool nearFirst = enter0 <= enter1;
+                stack[count++] = node.Child[nearFirst ? 1 : 0];
+                stack[count++] = node.Child[nearFirst ? 0 : 1];
+            } else if (hit0) {
+                stack[count++] = node.Child[0];
+            } else if (hit1) {
+                stack[count++] = node.Child[1];
+            }
+        }
+
+        if (found) {
+            // 命中时刻球心到三角形的最近点即接触点
+            glm::vec3 a, b, c;
+            GetTriangle(foundTriangle, a, b, c);
+            glm::vec3 swept = center + direction * maxDistance;
+            glm::vec3 closest = ClosestPointOnTriangle(swept, a, b, c);
+            glm::vec3 offset = swept - closest;
+            float length = glm::length(offset);
+            glm::vec3 normal = glm::normalize(glm::cross(b - a, c - a));
+
+            hit.Triangle = m_TriangleIds[foundTriangle];
+            hit.Distance = maxDistance;
+            hit.Point = closest;
+            hit.Normal = length > 1e-6f ? offset / length : (glm::dot(normal, direction) > 0.0f ? -normal : normal);
+        }
+        return found;
+    }
+
+    bool TriangleBVH::CapsuleTriangle(const glm::vec3& p0, const glm::vec3& p1, float radius, float margin,
+                                      uint32_t triangle, MeshContact& contact) const {
+        glm::vec3 a, b, c;
+        GetTriangle(triangle, a, b, c);
+
+        // 最近点只可能在线段端点对三角形、线段对三条边、或线段穿过三角形处
+        glm::vec3 bestSegment = p0;
+        glm::vec3 bestTriangle = ClosestPointOnTriangle(p0, a, b, c);
+        float bestDistanceSq = glm::dot(p0 - bestTriangle, p0 - bestTriangle);
+        auto consider = [&](const glm::vec3& onSegment, const glm::vec3& onTriangle) {
+            float distanceSq = glm::dot(onSegment - onTriangle, onSegment - onTriangle);
+            if (distanceSq < bestDistanceSq) {
+                bestDistanceSq = distanceSq;
+                bestSegment = onSegment;
+                bestTriangle = onTriangle;
+            }
+        };
+
+        consider(p1, ClosestPointOnTriangle(p1, a, b, c));
+        const glm::vec3* corners[3] = { &a, &b, &c };
+        for (int i = 0; i < 3; ++i) {
+            glm::vec3 onSegment, onEdge;
+            ClosestPointsSegments(p0, p1, *corners[i], *corners[(i + 1) % 3], onSegment, onEdge);
+            consider(onSegment, onEdge);
+        }
+
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float length = glm::length(normal);
+        normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        float side0 = glm::dot(p0 - a, normal);
+        float side1 = glm::dot(p1 - a, normal);
+        bool crosses = length > 0.0f && side0 * side1 < 0.0f;
+        if (crosses) {
+            glm::vec3 crossing = p0 + (p1 - p0) * (side0 / (side0 - side1));
+            if (glm::distance(ClosestPointOnTriangle(crossing, a, b, c), crossing) <= 1e-6f) {
+                // 线段穿过三角形：沿面法向推到中点一侧，深度取另一侧端点
+                if (side0 + side1 < 0.0f) {
+                    normal = -normal;
+                    std::swap(side0, side1);
+                }
+                float depth = std::min(side0, side1);
+                glm::vec3 deepest = side0 < side1 ? p0 : p1;
+                contact.Triangle = m_TriangleIds[triangle];
+                contact.Normal = normal;
+                contact.Separation = depth - radius;
+                contact.Point = deepest - normal * depth;
+                return true;
+            }
+        }
+
+        float reach = radius + margin;
+        if (bestDistanceSq > reach * reach) {
+            return false;
+        }
+
+        float distance = std::sqrt(bestDistanceSq);
+        contact.Triangle = m_TriangleIds[triangle];
+        contact.Point = bestTriangle;
+        contact.Separation = distance - radius;
+        if (distance > 1e-6f) {
+            contact.Normal = (bestSegment - bestTriangle) / distance;
+        } else {
+            // 线段恰好贴在三角形上：取面法向中线段所在的一侧
+            contact.Normal = side0 + side1 < 0.0f ? -normal : normal;
+        }
+        return true;
+    }
+
+    bool TriangleBVH::Serialize(std::ostream& out) const {
+        uint32_t header[2] = { FileMagic, FileVersion };
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&m_Root), sizeof(m_Root));
+        out.write(reinterpret_cast<const char*>(&m_Bounds.Min), sizeof(glm::vec3));
+        out.write(reinterpret_cast<const char*>(&m_Bounds.Max), sizeof(glm::vec3));
+        out.write(reinterpret_cast<const char*>(&m_QuantizeScale), sizeof(glm::vec3));
+        WriteArray(out, m_Vertices);
+        WriteArray(out, m_Triangles);
+        WriteArray(out, m_TriangleIds);
+        WriteArray(out, m_Nodes);
+        return static_cast<bool>(out);
+    }
+
+    bool TriangleBVH::Deserialize(std::istream& in) {
+        Clear();
+
+        uint32_t header[2] = { 0, 0 };
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != FileMagic || header[1] != FileVersion) {
+            return false;
+        }
+
+        in.read(reinterpret_cast<char*>(&m_Root), sizeof(m_Root));
+        in.read(reinterpret_cast<char*>(&m_Bounds.Min), sizeof(glm::vec3));
+        in.read(reinterpret_cast<char*>(&m_Bounds.Max), sizeof(glm::vec3));
+        in.read(reinterpret_cast<char*>(&m_QuantizeScale), sizeof(glm::vec3));
+        if (!in || !ReadArray(in, m_Vertices) || !ReadArray(in, m_Triangles) ||
+            !ReadArray(in, m_TriangleIds) || !ReadArray(in, m_Nodes)) {
+            Clear();
+            return false;
+        }
+
+        // 校验索引，损坏的文件不能导致越界访问
+        bool valid = m_Triangles.size() == m_TriangleIds.size() * 3;
+        for (uint32_t index : m_Triangles) {
+            valid = valid && index < m_Vertices.size();
+        }
+        // 节点按深度优先顺序存放，子节点的编号总大于父节点，据此排除环并限制深度不超过遍历栈
+        std::vector<int> depths(m_Nodes.size(), 0);
+        auto validRef = [&](uint32_t ref, uint32_t parent, int depth) {
+            if (IsLeaf(ref)) {
+                return static_cast<uint64_t>(LeafFirst(ref)) + LeafCount(ref) <= m_TriangleIds.size();
+            }
+            if (ref >= m_Nodes.size() || (parent != UINT32_MAX && ref <= parent) || depth >= MaxStackDepth - 1) {
+                return false;
+            }
+            depths[ref] = std::max(depths[ref], depth);
+            return true;
+        };
+        valid = valid && (m_TriangleIds.empty() || validRef(m_Root, UINT32_MAX, 0));
+        for (uint32_t i = 0; valid && i < m_Nodes.size(); ++i) {
+            valid = validRef(m_Nodes[i].Child[0], i, depths[i] + 1) && validRef(m_Nodes[i].Child[1], i, depths[i] + 1);
+        }
+        if (!valid) {
+            Clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool TriangleBVH::SaveToFile(const std::string& path) const {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        return Serialize(file);
+    }
+
+    bool TriangleBVH::LoadFromFile(const std::string& path) {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        return Deserialize(file);
+    }
+
+}
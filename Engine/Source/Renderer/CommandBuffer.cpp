@@ -0,0 +1,81 @@
+//
+// CommandBuffer.cpp - 渲染命令缓冲实现
+//
+
+#include "JFMEngine/Renderer/CommandBuffer.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace JFM {
+
+    namespace {
+        // 名字只追加不删除，存放在按2的幂增长的分块中，登记新名字时已有名字的地址不变
+        // 登记在锁内进行，读取不加锁：写入名字后以release发布数量，读取方以acquire读取
+        struct UniformNameTable {
+            static constexpr uint32_t FirstChunkSize = 64;
+            static constexpr size_t ChunkCount = 32 - 6;  // 第k块容量为64 << k，合计覆盖全部uint32 ID
+
+            std::mutex Mutex;
+            std::unordered_map<std::string, uint32_t> IDs{{std::string(), 0}};
+            std::array<std::unique_ptr<std::string[]>, ChunkCount> Chunks;
+            std::atomic<uint32_t> Count{0};
+
+            UniformNameTable() {
+                Chunks[0] = std::make_unique<std::string[]>(FirstChunkSize);
+                Count.store(1, std::memory_order_release);  // 0号为空名字
+            }
+
+            // ID所在的块和块内下标
+            static void Locate(uint32_t id, size_t& chunk, size_t& offset) {
+                uint64_t slot = static_cast<uint64_t>(id) / FirstChunkSize + 1;
+                chunk = static_cast<size_t>(std::bit_width(slot) - 1);
+                offset = static_cast<size_t>(id - FirstChunkSize * ((uint64_t(1) << chunk) - 1));
+            }
+        };
+
+        UniformNameTable& GetUniformNameTable() {
+            static UniformNameTable table;
+            return table;
+        }
+    }
+
+    UniformName::UniformName(const char* name) {
+        UniformNameTable& table = GetUniformNameTable();
+        std::lock_guard<std::mutex> lock(table.Mutex);
+        uint32_t count = table.Count.load(std::memory_order_relaxed);
+        auto result = table.IDs.emplace(name, count);
+        if (result.second) {
+            size_t chunk = 0;
+            size_t offset = 0;
+            UniformNameTable::Locate(count, chunk, offset);
+            if (!table.Chunks[chunk]) {
+                table.Chunks[chunk] = std::make_unique<std::string[]>(size_t(UniformNameTable::FirstChunkSize) << chunk);
+            }
+            table.Chunks[chunk][offset] = result.first->first;
+            table.Count.store(count + 1, std::memory_order_release);
+        }
+        m_ID = result.first->second;
+    }
+
+    const std::string& UniformName::GetString() const {
+        UniformNameTable& table = GetUniformNameTable();
+        // 与登记时的release配对，保证读到的名字和块指针已经写好
+        uint32_t count = table.Count.load(std::memory_order_acquire);
+        JFM_CORE_ASSERT(m_ID < count, "Unregistered uniform name");
+        (void)count;
+        size_t chunk = 0;
+        size_t offset = 0;
+        UniformNameTable::Locate(m_ID, chunk, offset);
+        return table.Chunks[chunk][offset];
+    }
+
+    void CommandBuffer::Clear() {
+        m_Words.clear();
+        m_CommandCount = 0;
+    }
+
+}
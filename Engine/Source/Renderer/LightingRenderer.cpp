@@ -7,12 +7,67 @@
 namespace JFM {
 
     LightingRenderer::SceneData* LightingRenderer::s_SceneData = nullptr;
+    CommandBuffer LightingRenderer::s_CommandBuffer;
+    std::vector<std::shared_ptr<const void>> LightingRenderer::s_Retained;
+
+    namespace {
+        // uniform名字在启动时登记一次，记录命令时不再查表
+        constexpr size_t MaxPointLights = 4;
+
+        struct PointLightUniforms {
+            UniformName Position;
+            UniformName Ambient;
+            UniformName Diffuse;
+            UniformName Specular;
+            UniformName Constant;
+            UniformName Linear;
+            UniformName Quadratic;
+        };
+
+#define JFM_POINT_LIGHT_UNIFORMS(index) { \
+            UniformName("u_PointLights[" #index "].position"), UniformName("u_PointLights[" #index "].ambient"), \
+            UniformName("u_PointLights[" #index "].diffuse"), UniformName("u_PointLights[" #index "].specular"), \
+            UniformName("u_PointLights[" #index "].constant"), UniformName("u_PointLights[" #index "].linear"), \
+            UniformName("u_PointLights[" #index "].quadratic") }
+
+        const PointLightUniforms s_PointLightUniforms[MaxPointLights] = {
+            JFM_POINT_LIGHT_UNIFORMS(0),
+            JFM_POINT_LIGHT_UNIFORMS(1),
+            JFM_POINT_LIGHT_UNIFORMS(2),
+            JFM_POINT_LIGHT_UNIFORMS(3)
+        };
+
+#undef JFM_POINT_LIGHT_UNIFORMS
+
+        const UniformName s_ViewProjectionMatrixUniform("u_ViewProjectionMatrix");
+        const UniformName s_ViewPosUniform("u_ViewPos");
+        const UniformName s_ModelMatrixUniform("u_ModelMatrix");
+        const UniformName s_NormalMatrixUniform("u_NormalMatrix");
+
+        const UniformName s_DirLightDirectionUniform("u_DirLight.direction");
+        const UniformName s_DirLightAmbientUniform("u_DirLight.ambient");
+        const UniformName s_DirLightDiffuseUniform("u_DirLight.diffuse");
+        const UniformName s_DirLightSpecularUniform("u_DirLight.specular");
+
+        const UniformName s_SpotLightPositionUniform("u_SpotLight.position");
+        const UniformName s_SpotLightDirectionUniform("u_SpotLight.direction");
+        const UniformName s_SpotLightAmbientUniform("u_SpotLight.ambient");
+        const UniformName s_SpotLightDiffuseUniform("u_SpotLight.diffuse");
+        const UniformName s_SpotLightSpecularUniform("u_SpotLight.specular");
+        const UniformName s_SpotLightConstantUniform("u_SpotLight.constant");
+        const UniformName s_SpotLightLinearUniform("u_SpotLight.linear");
+        const UniformName s_SpotLightQuadraticUniform("u_SpotLight.quadratic");
+        const UniformName s_SpotLightCutOffUniform("u_SpotLight.cutOff");
+        const UniformName s_SpotLightOuterCutOffUniform("u_SpotLight.outerCutOff");
+    }
 
     void LightingRenderer::Init() {
         s_SceneData = new SceneData;
     }
 
     void LightingRenderer::Shutdown() {
+        s_CommandBuffer.Clear();
+        s_Retained.clear();
         delete s_SceneData;
         s_SceneData = nullptr;
     }
@@ -20,78 +75,88 @@ namespace JFM {
     void LightingRenderer::BeginScene(const Camera& camera) {
         s_SceneData->ViewProjectionMatrix = camera.GetViewProjectionMatrix();
         s_SceneData->ViewPosition = camera.GetPosition();
+        s_SceneData->BoundShader = nullptr;
+        s_CommandBuffer.Clear();
+        s_Retained.clear();
     }
 
     void LightingRenderer::EndScene() {
-        // 可以在这里执行批处理渲染等优化
+        RenderCommand::Execute(s_CommandBuffer);
+        s_CommandBuffer.Clear();
+        s_Retained.clear();
+        s_SceneData->BoundShader = nullptr;
     }
 
     void LightingRenderer::Submit(const std::shared_ptr<Shader>& shader,
                                  const std::shared_ptr<VertexArray>& vertexArray,
                                  const Material& material,
                                  const glm::mat4& transform) {
-        shader->Bind();
+        if (!vertexArray->GetIndexBuffer()) {
+            return;
+        }
+
+        Shader* target = shader.get();
+        if (target != s_SceneData->BoundShader) {
+            s_SceneData->BoundShader = target;
+            Retain(shader);
+            s_CommandBuffer.Record(Commands::BindShader{target});
+            s_CommandBuffer.Record(Commands::SetMat4{target, s_ViewProjectionMatrixUniform, s_SceneData->ViewProjectionMatrix});
+            s_CommandBuffer.Record(Commands::SetFloat3{target, s_ViewPosUniform, s_SceneData->ViewPosition});
+            RecordLightingUniforms(s_CommandBuffer, target);
+        }
 
         // 设置变换矩阵
-        shader->SetMat4("u_ViewProjectionMatrix", s_SceneData->ViewProjectionMatrix);
-        shader->SetMat4("u_ModelMatrix", transform);
+        s_CommandBuffer.Record(Commands::SetMat4{target, s_ModelMatrixUniform, transform});
 
         // 计算法线矩阵 - 修复法线矩阵的设置方式
         glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
         // 使用SetMat4来设置法线矩阵，扩展为4x4矩阵
-        glm::mat4 normalMatrix4 = glm::mat4(normalMatrix);
-        shader->SetMat4("u_NormalMatrix", normalMatrix4);
-
-        // 设置观察位置
-        shader->SetFloat3("u_ViewPos", s_SceneData->ViewPosition);
-
-        // 绑定材质
-        material.Bind(shader);
+        s_CommandBuffer.Record(Commands::SetMat4{target, s_NormalMatrixUniform, glm::mat4(normalMatrix)});
 
-        // 设置光照
-        SetLightingUniforms(shader, s_SceneData->ViewPosition);
+        // 绑定材质，参数按值记录
+        s_CommandBuffer.Record(Commands::BindMaterial{target, material.GetProperties()});
 
-        vertexArray->Bind();
-        RenderCommand::DrawIndexed(vertexArray);
+        Retain(vertexArray);
+        s_CommandBuffer.Record(Commands::DrawIndexed{vertexArray.get(), vertexArray->GetIndexBuffer()->GetCount()});
     }
 
-    void LightingRenderer::SetLightingUniforms(std::shared_ptr<Shader> shader, const glm::vec3& viewPos) {
+    void LightingRenderer::RecordLightingUniforms(CommandBuffer& commands, Shader* shader) {
         auto& lightManager = LightManager::GetInstance();
 
-        // 设置方向光
+        // 方向光
         const auto& dirLight = lightManager.GetDirectionalLight();
-        shader->SetFloat3("u_DirLight.direction", dirLight.Direction);
-        shader->SetFloat3("u_DirLight.ambient", dirLight.Ambient);
-        shader->SetFloat3("u_DirLight.diffuse", dirLight.Diffuse);
-        shader->SetFloat3("u_DirLight.specular", dirLight.Specular);
+        commands.Record(Commands::SetFloat3{shader, s_DirLightDirectionUniform, dirLight.Direction});
+        commands.Record(Commands::SetFloat3{shader, s_DirLightAmbientUniform, dirLight.Ambient});
+        commands.Record(Commands::SetFloat3{shader, s_DirLightDiffuseUniform, dirLight.Diffuse});
+        commands.Record(Commands::SetFloat3{shader, s_DirLightSpecularUniform, dirLight.Specular});
 
-        // 设置点光源
+        // 点光源
         const auto& pointLights = lightManager.GetPointLights();
-        for (size_t i = 0; i < pointLights.size() && i < 4; ++i) {
-            std::string base = "u_PointLights[" + std::to_string(i) + "]";
-            shader->SetFloat3(base + ".position", pointLights[i].Position);
-            shader->SetFloat3(base + ".ambient", pointLights[i].Ambient);
-            shader->SetFloat3(base + ".diffuse", pointLights[i].Diffuse);
-            shader->SetFloat3(base + ".specular", pointLights[i].Specular);
-            shader->SetFloat(base + ".constant", pointLights[i].Constant);
-            shader->SetFloat(base + ".linear", pointLights[i].Linear);
-            shader->SetFloat(base + ".quadratic", pointLights[i].Quadratic);
+        for (size_t i = 0; i < pointLights.size() && i < MaxPointLights; ++i) {
+            const PointLightUniforms& names = s_PointLightUniforms[i];
+            commands.Record(Commands::SetFloat3{shader, names.Position, pointLights[i].Position});
+            commands.Record(Commands::SetFloat3{shader, names.Ambient, pointLights[i].Ambient});
+            commands.Record(Commands::SetFloat3{shader, names.Diffuse, pointLights[i].Diffuse});
+            commands.Record(Commands::SetFloat3{shader, names.Specular, pointLights[i].Specular});
+            commands.Record(Commands::SetFloat{shader, names.Constant, pointLights[i].Constant});
+            commands.Record(Commands::SetFloat{shader, names.Linear, pointLights[i].Linear});
+            commands.Record(Commands::SetFloat{shader, names.Quadratic, pointLights[i].Quadratic});
         }
 
-        // 设置聚光灯
+        // 聚光灯，只使用第一个
         const auto& spotLights = lightManager.GetSpotLights();
         if (!spotLights.empty()) {
-            const auto& spotLight = spotLights[0]; // 使用第一个聚光灯
-            shader->SetFloat3("u_SpotLight.position", spotLight.Position);
-            shader->SetFloat3("u_SpotLight.direction", spotLight.Direction);
-            shader->SetFloat3("u_SpotLight.ambient", spotLight.Ambient);
-            shader->SetFloat3("u_SpotLight.diffuse", spotLight.Diffuse);
-            shader->SetFloat3("u_SpotLight.specular", spotLight.Specular);
-            shader->SetFloat("u_SpotLight.constant", spotLight.Constant);
-            shader->SetFloat("u_SpotLight.linear", spotLight.Linear);
-            shader->SetFloat("u_SpotLight.quadratic", spotLight.Quadratic);
-            shader->SetFloat("u_SpotLight.cutOff", glm::cos(glm::radians(spotLight.CutOff)));
-            shader->SetFloat("u_SpotLight.outerCutOff", glm::cos(glm::radians(spotLight.OuterCutOff)));
+            const auto& spotLight = spotLights[0];
+            commands.Record(Commands::SetFloat3{shader, s_SpotLightPositionUniform, spotLight.Position});
+            commands.Record(Commands::SetFloat3{shader, s_SpotLightDirectionUniform, spotLight.Direction});
+            commands.Record(Commands::SetFloat3{shader, s_SpotLightAmbientUniform, spotLight.Ambient});
+            commands.Record(Commands::SetFloat3{shader, s_SpotLightDiffuseUniform, spotLight.Diffuse});
+            commands.Record(Commands::SetFloat3{shader, s_SpotLightSpecularUniform, spotLight.Specular});
+            commands.Record(Commands::SetFloat{shader, s_SpotLightConstantUniform, spotLight.Constant});
+            commands.Record(Commands::SetFloat{shader, s_SpotLightLinearUniform, spotLight.Linear});
+            commands.Record(Commands::SetFloat{shader, s_SpotLightQuadraticUniform, spotLight.Quadratic});
+            commands.Record(Commands::SetFloat{shader, s_SpotLightCutOffUniform, glm::cos(glm::radians(spotLight.CutOff))});
+            commands.Record(Commands::SetFloat{shader, s_SpotLightOuterCutOffUniform, glm::cos(glm::radians(spotLight.OuterCutOff))});
         }
     }
 
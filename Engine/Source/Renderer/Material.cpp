@@ -1,24 +1,33 @@
 #include "JFMEngine/Renderer/Material.h"
 #include "JFMEngine/Renderer/Shader.h"
+#include <atomic>
 
 namespace JFM {
 
+    namespace {
+        std::atomic<uint32_t> s_NextMaterialSortID{1};
+    }
+
     Material::Material(const MaterialProperties& properties)
-        : m_Properties(properties) {
+        : m_Properties(properties), m_SortID(s_NextMaterialSortID++) {
     }
 
     void Material::Bind(std::shared_ptr<Shader> shader) const {
+        Bind(*shader, m_Properties);
+    }
+
+    void Material::Bind(Shader& shader, const MaterialProperties& properties) {
         // 传统Phong光照属性
-        shader->SetFloat3("u_Material.ambient", m_Properties.Ambient);
-        shader->SetFloat3("u_Material.diffuse", m_Properties.Diffuse);
-        shader->SetFloat3("u_Material.specular", m_Properties.Specular);
-        shader->SetFloat("u_Material.shininess", m_Properties.Shininess);
+        shader.SetFloat3("u_Material.ambient", properties.Ambient);
+        shader.SetFloat3("u_Material.diffuse", properties.Diffuse);
+        shader.SetFloat3("u_Material.specular", properties.Specular);
+        shader.SetFloat("u_Material.shininess", properties.Shininess);
 
         // PBR材质属性
-        shader->SetFloat3("u_Material.albedo", m_Properties.Albedo);
-        shader->SetFloat("u_Material.metallic", m_Properties.Metallic);
-        shader->SetFloat("u_Material.roughness", m_Properties.Roughness);
-        shader->SetFloat("u_Material.ao", m_Properties.AO);
+        shader.SetFloat3("u_Material.albedo", properties.Albedo);
+        shader.SetFloat("u_Material.metallic", properties.Metallic);
+        shader.SetFloat("u_Material.roughness", properties.Roughness);
+        shader.SetFloat("u_Material.ao", properties.AO);
     }
 
 }
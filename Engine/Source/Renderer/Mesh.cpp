@@ -3,20 +3,26 @@
 //
 
 #include "JFMEngine/Renderer/Mesh.h"
+#include "JFMEngine/Renderer/RendererAPI.h"
 #include "JFMEngine/Utils/Log.h"
 #include <glad/glad.h>
+#include <atomic>
 
 namespace JFM {
 
+    namespace {
+        std::atomic<uint32_t> s_NextMeshSortID{1};
+    }
+
     Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
-        : Vertices(vertices), Indices(indices) {
+        : Vertices(vertices), Indices(indices), m_SortID(s_NextMeshSortID++) {
         SetupMesh();
     }
 
     // 添加带纹理的构造函数
     Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
                const std::vector<std::shared_ptr<Texture>>& textures)
-        : Vertices(vertices), Indices(indices), Textures(textures) {
+        : Vertices(vertices), Indices(indices), Textures(textures), m_SortID(s_NextMeshSortID++) {
         SetupMesh();
     }
 
@@ -64,6 +70,9 @@ namespace JFM {
         if (m_IsSetup) {
             return; // 已经设置过了
         }
+        if (RendererAPI::GetAPI() == RendererAPI::API::None) {
+            return; // 没有图形后端（测试、基准）时只保留几何数据
+        }
 
         // 生成并绑定VAO
         glGenVertexArrays(1, &VAO);
@@ -21,6 +21,9 @@ namespace JFM {
         LoadModel(path);
     }
 
+    Model::Model(std::vector<std::shared_ptr<Mesh>> meshes) : m_Meshes(std::move(meshes)) {
+    }
+
     void Model::Draw(const std::shared_ptr<Shader>& shader) const {
         for (const auto& mesh : m_Meshes) {
             if (mesh) {
@@ -0,0 +1,68 @@
+//
+// NullRendererAPI.cpp - 不访问GPU的渲染后端实现
+//
+
+#include "JFMEngine/Renderer/NullRendererAPI.h"
+#include "JFMEngine/Renderer/RenderCommand.h"
+#include "JFMEngine/Renderer/VertexArray.h"
+
+namespace JFM {
+
+    void RecordingRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+        Record(Commands::SetViewport{x, y, width, height});
+    }
+
+    void RecordingRendererAPI::SetClearColor(const glm::vec4& color) {
+        Record(Commands::SetClearColor{color});
+    }
+
+    void RecordingRendererAPI::Clear() {
+        Record(Commands::Clear{});
+    }
+
+    void RecordingRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount) {
+        if (!vertexArray || !vertexArray->GetIndexBuffer()) {
+            return;
+        }
+        // 与OpenGL后端一致，0表示绘制整个索引缓冲
+        uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+        Record(Commands::DrawIndexed{vertexArray.get(), count});
+    }
+
+    void RecordingRendererAPI::DrawArrays(const std::shared_ptr<VertexArray>& vertexArray, uint32_t vertexCount) {
+        if (vertexArray) {
+            Record(Commands::DrawArrays{vertexArray.get(), vertexCount});
+        }
+    }
+
+    void RecordingRendererAPI::DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount) {
+        Record(Commands::DrawIndexed{&vertexArray, indexCount});
+    }
+
+    void RecordingRendererAPI::DrawArrays(const VertexArray& vertexArray, uint32_t vertexCount) {
+        Record(Commands::DrawArrays{&vertexArray, vertexCount});
+    }
+
+    void RecordingRendererAPI::SetPolygonMode(PolygonMode mode) {
+        Record(Commands::SetPolygonMode{mode});
+    }
+
+    void RecordingRendererAPI::Execute(const CommandBuffer& commands) {
+        // 命令流本身与后端无关，整段拷贝后再统计
+        const uint64_t* words = commands.GetData();
+        m_Words.insert(m_Words.end(), words, words + commands.GetSizeInWords());
+        commands.ForEach([this](const CommandHeader& header) {
+            m_TypeCounts[static_cast<size_t>(header.Type)]++;
+        });
+        m_CommandCount += commands.GetCommandCount();
+        m_ExecuteCount++;
+    }
+
+    void RecordingRendererAPI::Reset() {
+        m_Words.clear();
+        m_TypeCounts.fill(0);
+        m_CommandCount = 0;
+        m_ExecuteCount = 0;
+    }
+
+}
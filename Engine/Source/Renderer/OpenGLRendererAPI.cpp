@@ -55,6 +55,14 @@ namespace JFM {
         glDrawArrays(GL_TRIANGLES, 0, vertexCount);
     }
 
+    void OpenGLRendererAPI::DrawIndexed(const VertexArray& /*vertexArray*/, uint32_t indexCount) {
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+    }
+
+    void OpenGLRendererAPI::DrawArrays(const VertexArray& /*vertexArray*/, uint32_t vertexCount) {
+        glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    }
+
     void OpenGLRendererAPI::SetPolygonMode(PolygonMode mode) {
         GLenum glMode;
 
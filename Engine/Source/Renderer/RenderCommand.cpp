@@ -3,6 +3,7 @@
 //
 
 #include "JFMEngine/Renderer/RenderCommand.h"
+#include "JFMEngine/Renderer/CommandBuffer.h"
 #include "JFMEngine/Utils/Log.h"
 
 namespace JFM {
@@ -59,4 +60,10 @@ namespace JFM {
         }
     }
 
+    void RenderCommand::Execute(const CommandBuffer& commands) {
+        if (s_RendererAPI && !commands.IsEmpty()) {
+            s_RendererAPI->Execute(commands);
+        }
+    }
+
 }
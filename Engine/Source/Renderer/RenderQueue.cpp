@@ -0,0 +1,203 @@
+//
+// RenderQueue.cpp - 渲染队列实现
+//
+
+#include "JFMEngine/Renderer/RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+namespace JFM {
+
+    namespace {
+        uint32_t QuantizeDepth(float depth, uint32_t bits) {
+            const uint32_t maxValue = (1u << bits) - 1;
+            // NaN比较总为假，min/max无法截断，先当作0处理，避免转换成整数时的未定义行为
+            if (!(depth >= 0.0f)) {
+                depth = 0.0f;
+            }
+            float clamped = std::min(depth, 1.0f);
+            return static_cast<uint32_t>(clamped * static_cast<float>(maxValue) + 0.5f);
+        }
+
+        uint64_t Field(uint32_t value, uint32_t bits, uint32_t shift) {
+            return static_cast<uint64_t>(value & ((1u << bits) - 1)) << shift;
+        }
+    }
+
+    namespace RenderSortKey {
+
+        uint64_t Opaque(RenderPass pass, uint32_t shader, uint32_t material, uint32_t mesh, float depth) {
+            return Field(static_cast<uint32_t>(pass), 4, PassShift) |
+                   Field(shader, 11, 48) |
+                   Field(material, 16, 32) |
+                   Field(mesh, 16, 16) |
+                   Field(QuantizeDepth(depth, 16), 16, 0);
+        }
+
+        uint64_t Transparent(RenderPass pass, uint32_t shader, uint32_t material, uint32_t mesh, float depth) {
+            // 深度取反，远处的物体键更小，先绘制
+            const uint32_t maxDepth = (1u << 24) - 1;
+            return Field(static_cast<uint32_t>(pass), 4, PassShift) |
+                   (uint64_t(1) << TransparentShift) |
+                   Field(maxDepth - QuantizeDepth(depth, 24), 24, 35) |
+                   Field(shader, 11, 24) |
+                   Field(material, 12, 12) |
+                   Field(mesh, 12, 0);
+        }
+
+    }
+
+    RenderQueueEntry* RadixSort(RenderQueueEntry* entries, RenderQueueEntry* scratch, size_t count) {
+        // 一次遍历统计全部8个字节的直方图
+        uint32_t histograms[8][256];
+        std::memset(histograms, 0, sizeof(histograms));
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t key = entries[i].Key;
+            for (int byte = 0; byte < 8; ++byte) {
+                histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+            }
+        }
+
+        RenderQueueEntry* source = entries;
+        RenderQueueEntry* destination = scratch;
+        for (int byte = 0; byte < 8 && count > 0; ++byte) {
+            uint32_t* histogram = histograms[byte];
+            const uint32_t shift = byte * 8;
+
+            // 通道、着色器等高位字段通常只有少数取值，整轮相同的字节不必移动数据
+            if (histogram[(source[0].Key >> shift) & 0xFF] == count) {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket) {
+                uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                destination[histogram[(source[i].Key >> shift) & 0xFF]++] = source[i];
+            }
+            std::swap(source, destination);
+        }
+        return source;
+    }
+
+    void SplitRenderQueues(const RenderQueueView* queues, size_t queueCount, size_t segmentCount,
+                           RenderQueueView* segments, const RenderItem** previous) {
+        // 从各队列中按相同的间隔取样，样本的分位数作为各段的起始键，各段的元素数大致相同
+        size_t total = 0;
+        for (size_t q = 0; q < queueCount; ++q) {
+            total += queues[q].Count;
+        }
+        const size_t stride = std::max<size_t>(1, total / (segmentCount * 32));
+        std::vector<uint64_t> samples;
+        samples.reserve(total / stride + queueCount);
+        for (size_t q = 0; q < queueCount; ++q) {
+            for (size_t i = stride / 2; i < queues[q].Count; i += stride) {
+                samples.push_back(queues[q].Entries[i].Key);
+            }
+        }
+        std::sort(samples.begin(), samples.end());
+
+        auto keyLess = [](const RenderQueueEntry& entry, uint64_t key) { return entry.Key < key; };
+        std::vector<size_t> begins(queueCount, 0);
+        for (size_t s = 0; s < segmentCount; ++s) {
+            // 归并顺序为(键, 队列编号, 队列内位置)，之前的最后一个元素是各队列在本段起点前一个元素中最大的
+            previous[s] = nullptr;
+            const RenderQueueEntry* lastEntry = nullptr;
+            for (size_t q = 0; q < queueCount; ++q) {
+                if (begins[q] > 0 && (!lastEntry || queues[q].Entries[begins[q] - 1].Key >= lastEntry->Key)) {
+                    lastEntry = &queues[q].Entries[begins[q] - 1];
+                    previous[s] = &queues[q].Items[lastEntry->Item];
+                }
+            }
+
+            const bool lastSegment = s + 1 == segmentCount || samples.empty();
+            const uint64_t splitKey = lastSegment ? 0 : samples[(s + 1) * samples.size() / segmentCount];
+            for (size_t q = 0; q < queueCount; ++q) {
+                const RenderQueueEntry* entries = queues[q].Entries;
+                size_t end = lastSegment ? queues[q].Count
+                                   : std::lower_bound(entries + begins[q], entries + queues[q].Count, splitKey, keyLess) - entries;
+                segments[s * queueCount + q] = {entries + begins[q], end - begins[q], queues[q].Items};
+                begins[q] = end;
+            }
+        }
+    }
+
+    void RenderQueue::Reset() {
+        // 不能沿用上一帧的存储（可能已被帧分配器回收）
+        size_t capacity = m_Entries.capacity();
+
+        m_Entries = FrameVector<RenderQueueEntry>();
+        m_Scratch = FrameVector<RenderQueueEntry>();
+        m_Items = FrameVector<RenderItem>();
+
+        m_Entries.reserve(capacity);
+        m_Items.reserve(capacity);
+        m_Retained.clear();
+    }
+
+    void RenderQueue::Clear() {
+        m_Entries.clear();
+        m_Items.clear();
+        m_Retained.clear();
+    }
+
+    void RenderQueue::Push(uint64_t key, const RenderItem& item) {
+        m_Entries.push_back({key, static_cast<uint32_t>(m_Items.size())});
+        m_Items.push_back(item);
+    }
+
+    void RenderQueue::Sort() {
+        m_Scratch.resize(m_Entries.size());
+        if (RadixSort(m_Entries.data(), m_Scratch.data(), m_Entries.size()) != m_Entries.data()) {
+            m_Entries.swap(m_Scratch);
+        }
+    }
+
+    RenderStateChanges RenderQueue::CountStateChanges() const {
+        RenderStateChanges changes;
+        const Shader* shader = nullptr;
+        const Material* material = nullptr;
+        const Mesh* mesh = nullptr;
+        for (const RenderQueueEntry& entry : m_Entries) {
+            const RenderItem& item = m_Items[entry.Item];
+            // 着色器切换后材质参数需要重新设置
+            if (item.Shader != shader) {
+                shader = item.Shader;
+                material = nullptr;
+                changes.Shader++;
+            }
+            if (item.Material != material) {
+                material = item.Material;
+                changes.Material++;
+            }
+            if (item.Mesh != mesh) {
+                mesh = item.Mesh;
+                changes.Mesh++;
+            }
+        }
+        return changes;
+    }
+
+    void RenderCommandList::Clear() {
+        m_Entries.clear();
+        m_Items.clear();
+        m_Retained.clear();
+        m_ObjectCount = 0;
+    }
+
+    void RenderCommandList::Push(uint64_t key, const RenderItem& item) {
+        m_Entries.push_back({key, static_cast<uint32_t>(m_Items.size())});
+        m_Items.push_back(item);
+    }
+
+    void RenderCommandList::Sort() {
+        m_Scratch.resize(m_Entries.size());
+        if (RadixSort(m_Entries.data(), m_Scratch.data(), m_Entries.size()) != m_Entries.data()) {
+            m_Entries.swap(m_Scratch);
+        }
+    }
+
+}
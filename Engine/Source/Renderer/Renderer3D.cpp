@@ -4,6 +4,7 @@
 
 #include "JFMEngine/Renderer/Renderer3D.h"
 #include "JFMEngine/Renderer/RenderCommand.h"
+#include "JFMEngine/Core/JobSystem.h"
 #include "JFMEngine/Utils//Log.h"
 #include <algorithm>
 
@@ -17,8 +18,12 @@ namespace JFM {
     float Renderer3D::s_Gamma = 2.2f;
 
     Renderer3DStats Renderer3D::s_Stats;
-    std::vector<RenderItem> Renderer3D::s_OpaqueQueue;
-    std::vector<RenderItem> Renderer3D::s_TransparentQueue;
+    RenderQueue Renderer3D::s_RenderQueue;
+    std::vector<CommandBuffer> Renderer3D::s_CommandBuffers;
+    uint32_t Renderer3D::s_CommandBufferCount = 0;
+    std::vector<RenderCommandList> Renderer3D::s_CommandLists;
+    uint32_t Renderer3D::s_CommandListCount = 0;
+    glm::vec4 Renderer3D::s_DepthPlane(0.0f);
 
     std::shared_ptr<Shader> Renderer3D::s_DefaultShader;
     std::shared_ptr<Shader> Renderer3D::s_ShadowShader;
@@ -28,46 +33,183 @@ namespace JFM {
 
     // 添加缺失的静态成员变量定义
     Camera Renderer3D::s_Camera(45.0f, 16.0f/9.0f, 0.1f, 100.0f);
-    std::vector<Light> Renderer3D::s_Lights;
+    FrameVector<Light> Renderer3D::s_Lights;
+
+    namespace {
+        // 每段至少的绘制数，太少时分段和调度的开销超过并行的收益
+        constexpr size_t MinDrawsPerSegment = 4096;
+
+        const UniformName s_ViewProjectionUniform("u_ViewProjectionMatrix");
+        const UniformName s_ViewPosUniform("u_ViewPos");
+        const UniformName s_ModelMatrixUniform("u_ModelMatrix");
+
+        struct SegmentStats {
+            uint32_t DrawCalls = 0;
+            uint32_t VertexCount = 0;
+            uint32_t IndexCount = 0;
+            RenderStateChanges StateChanges;
+        };
+
+        // 归并并记录一段；起始状态取该段之前的最后一个物体，结果与从头按顺序记录时相同
+        void RecordSegment(const RenderQueueView* queues, size_t queueCount, const RenderItem* previous,
+                           const glm::mat4& viewProjection, const glm::vec3& viewPosition,
+                           CommandBuffer& commands, SegmentStats& stats) {
+            commands.Clear();
+
+            // 着色器或材质与前一次绘制相同时不再重复绑定
+            Shader* shader = previous ? previous->Shader : nullptr;
+            const Material* material = previous ? previous->Material : nullptr;
+            const Mesh* mesh = previous ? previous->Mesh : nullptr;
+            MergeRenderQueues(queues, queueCount, [&](const RenderQueueEntry&, const RenderItem& item) {
+                if (item.Shader != shader) {
+                    shader = item.Shader;
+                    material = nullptr;
+                    stats.StateChanges.Shader++;
+                    if (shader) {
+                        commands.Record(Commands::BindShader{shader});
+                        commands.Record(Commands::SetMat4{shader, s_ViewProjectionUniform, viewProjection});
+                        commands.Record(Commands::SetFloat3{shader, s_ViewPosUniform, viewPosition});
+                    }
+                }
+                if (item.Material != material) {
+                    material = item.Material;
+                    stats.StateChanges.Material++;
+                    if (shader && material) {
+                        commands.Record(Commands::BindMaterial{shader, material->GetProperties()});
+                    }
+                }
+                if (item.Mesh != mesh) {
+                    mesh = item.Mesh;
+                    stats.StateChanges.Mesh++;
+                }
+                if (shader) {
+                    commands.Record(Commands::SetMat4{shader, s_ModelMatrixUniform, item.Transform});
+                }
+
+                uint32_t vertexCount = static_cast<uint32_t>(item.Mesh->Vertices.size());
+                uint32_t indexCount = static_cast<uint32_t>(item.Mesh->Indices.size());
+                commands.Record(Commands::DrawMesh{item.Mesh, indexCount, vertexCount});
+
+                stats.DrawCalls++;
+                stats.VertexCount += vertexCount;
+                stats.IndexCount += indexCount;
+            });
+        }
+
+        // 模型的每个网格生成一个排序键，RenderQueue和RenderCommandList共用；只读取BeginScene时设置的状态
+        // 调用方需先把模型和材质交给队列的Retain
+        template<typename Queue>
+        void PushModel(Queue& queue, Shader* shader, const glm::vec4& depthPlane, const Model& model,
+                       const glm::mat4& transform, const Material* material) {
+            // 以模型原点的深度排序，同一模型的网格深度相同
+            glm::vec3 position(transform[3]);
+            float depth = glm::dot(glm::vec3(depthPlane), position) + depthPlane.w;
+
+            RenderItem item;
+            item.Shader = shader;
+            item.Material = material;
+            item.Transform = transform;
+
+            uint32_t shaderID = shader ? shader->GetSortID() : 0;
+            uint32_t materialID = material ? material->GetSortID() : 0;
+            bool transparent = material && material->IsTransparent();
+
+            for (const auto& mesh : model.GetMeshes()) {
+                item.Mesh = mesh.get();
+                uint64_t key = transparent
+                    ? RenderSortKey::Transparent(RenderPass::Main, shaderID, materialID, mesh->GetSortID(), depth)
+                    : RenderSortKey::Opaque(RenderPass::Main, shaderID, materialID, mesh->GetSortID(), depth);
+                queue.Push(key, item);
+            }
+        }
+    }
 
     void Renderer3D::Init() {
         s_Stats = {};
-        s_OpaqueQueue.clear();
-        s_TransparentQueue.clear();
+        ResetFrameQueues();
         s_ShadowsEnabled = false;
         s_PostProcessingEnabled = false;
     }
 
     void Renderer3D::Shutdown() {
-        s_OpaqueQueue.clear();
-        s_TransparentQueue.clear();
+        ResetFrameQueues();
+    }
+
+    void Renderer3D::ResetFrameQueues() {
+        // 重新绑定到当前帧的内存，不能沿用上一帧的存储（可能已被帧分配器回收）
+        s_RenderQueue.Reset();
+        s_CommandListCount = 0;
+        s_CommandBufferCount = 0;
+        s_Lights = FrameVector<Light>();
     }
 
     void Renderer3D::BeginScene(const Camera& camera, const std::vector<Light>& lights) {
-        s_OpaqueQueue.clear();
-        s_TransparentQueue.clear();
+        ResetFrameQueues();
+        s_Lights.assign(lights.begin(), lights.end());
+
+        s_Camera = camera;
+        glm::vec3 forward = camera.GetForward() / camera.GetFarClip();
+        s_DepthPlane = glm::vec4(forward, -glm::dot(forward, camera.GetPosition()));
 
         // 重置统计信息
         s_Stats.DrawCalls = 0;
         s_Stats.VertexCount = 0;
         s_Stats.IndexCount = 0;
         s_Stats.ModelCount = 0;
+        s_Stats.StateChanges = {};
     }
 
     void Renderer3D::EndScene() {
-        // 渲染队列中的所有物体
-        for (const auto& item : s_OpaqueQueue) {
-            s_Stats.DrawCalls++;
-            s_Stats.ModelCount++;
+        // 主线程的队列和各提交列表分别排序
+        JobSystem& jobs = JobSystem::GetInstance();
+        s_RenderQueue.Sort();
+        jobs.ParallelFor(s_CommandListCount, 1, [](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                s_CommandLists[i].Sort();
+            }
+        });
+
+        FrameVector<RenderQueueView> queues;
+        queues.reserve(s_CommandListCount + 1);
+        queues.push_back(s_RenderQueue.GetView());
+        size_t drawCount = s_RenderQueue.GetSize();
+        for (uint32_t i = 0; i < s_CommandListCount; ++i) {
+            queues.push_back(s_CommandLists[i].GetView());
+            drawCount += s_CommandLists[i].GetSize();
+            s_Stats.ModelCount += s_CommandLists[i].GetObjectCount();
         }
 
-        for (const auto& item : s_TransparentQueue) {
-            s_Stats.DrawCalls++;
-            s_Stats.ModelCount++;
-        }
+        // 按键的范围分段，各段并行归并并记录到自己的命令缓冲
+        const size_t queueCount = queues.size();
+        const size_t segmentCount = std::max<size_t>(1, std::min(jobs.GetWorkerCount() + 1, drawCount / MinDrawsPerSegment));
+        FrameVector<RenderQueueView> segments(segmentCount * queueCount);
+        FrameVector<const RenderItem*> previous(segmentCount);
+        FrameVector<SegmentStats> segmentStats(segmentCount);
+        SplitRenderQueues(queues.data(), queueCount, segmentCount, segments.data(), previous.data());
 
-        s_OpaqueQueue.clear();
-        s_TransparentQueue.clear();
+        if (s_CommandBuffers.size() < segmentCount) {
+            s_CommandBuffers.resize(segmentCount);
+        }
+        s_CommandBufferCount = static_cast<uint32_t>(segmentCount);
+
+        const glm::mat4 viewProjection = s_Camera.GetViewProjectionMatrix();
+        const glm::vec3 viewPosition = s_Camera.GetPosition();
+        jobs.ParallelFor(segmentCount, 1, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                RecordSegment(&segments[s * queueCount], queueCount, previous[s], viewProjection, viewPosition,
+                              s_CommandBuffers[s], segmentStats[s]);
+            }
+        });
+
+        for (size_t s = 0; s < segmentCount; ++s) {
+            s_Stats.DrawCalls += segmentStats[s].DrawCalls;
+            s_Stats.VertexCount += segmentStats[s].VertexCount;
+            s_Stats.IndexCount += segmentStats[s].IndexCount;
+            s_Stats.StateChanges.Shader += segmentStats[s].StateChanges.Shader;
+            s_Stats.StateChanges.Material += segmentStats[s].StateChanges.Material;
+            s_Stats.StateChanges.Mesh += segmentStats[s].StateChanges.Mesh;
+            RenderCommand::Execute(s_CommandBuffers[s]);
+        }
     }
 
     void Renderer3D::Submit(const std::shared_ptr<Model>& model, const glm::mat4& transform) {
@@ -79,15 +221,31 @@ namespace JFM {
         if (!model) {
             return;
         }
+        s_RenderQueue.Retain(model);
+        s_RenderQueue.Retain(material);
+        PushModel(s_RenderQueue, s_DefaultShader.get(), s_DepthPlane, *model, transform, material.get());
+        s_Stats.ModelCount++;
+    }
 
-        RenderItem item;
-        item.Model = model;
-        item.Transform = transform;
-        item.Material = material;
-        item.DistanceToCamera = 0.0f; // 简化实现
+    void Renderer3D::PrepareCommandLists(uint32_t count) {
+        if (s_CommandLists.size() < count) {
+            s_CommandLists.resize(count);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            s_CommandLists[i].Clear();
+        }
+        s_CommandListCount = count;
+    }
 
-        // 简单地添加到不透明队列
-        s_OpaqueQueue.push_back(item);
+    void Renderer3D::Submit(RenderCommandList& list, const std::shared_ptr<Model>& model, const glm::mat4& transform,
+                           const std::shared_ptr<Material>& material) {
+        if (!model) {
+            return;
+        }
+        list.Retain(model);
+        list.Retain(material);
+        PushModel(list, s_DefaultShader.get(), s_DepthPlane, *model, transform, material.get());
+        list.AddObject();
     }
 
     void Renderer3D::EnableShadows(bool enable) {
@@ -140,7 +298,19 @@ namespace JFM {
     }
 
     void Renderer3D::DrawInstanced(const std::shared_ptr<Model>& model, const std::vector<glm::mat4>& transforms) {
-        // 简化实现 - 实际绘制逻辑需要在此实现
+        DrawInstanced(model, transforms.data(), transforms.size());
+    }
+
+    void Renderer3D::DrawInstanced(const std::shared_ptr<Model>& model, const glm::mat4* transforms, size_t count) {
+        // 逐个实例进入渲染队列，排序后同一网格的绘制相邻，状态只绑定一次
+        if (!model) {
+            return;
+        }
+        s_RenderQueue.Retain(model);
+        for (size_t i = 0; i < count; ++i) {
+            PushModel(s_RenderQueue, s_DefaultShader.get(), s_DepthPlane, *model, transforms[i], nullptr);
+        }
+        s_Stats.ModelCount += static_cast<uint32_t>(count);
     }
 
     void Renderer3D::SetSkybox(const std::shared_ptr<Texture>& skybox) {
@@ -4,6 +4,12 @@
 
 #include "JFMEngine/Renderer/RendererAPI.h"
 #include "JFMEngine/Renderer/OpenGLRendererAPI.h"
+#include "JFMEngine/Renderer/NullRendererAPI.h"
+#include "JFMEngine/Renderer/CommandBuffer.h"
+#include "JFMEngine/Renderer/RenderCommand.h"
+#include "JFMEngine/Renderer/Shader.h"
+#include "JFMEngine/Renderer/Mesh.h"
+#include "JFMEngine/Renderer/VertexArray.h"
 
 namespace JFM {
 
@@ -12,7 +18,7 @@ namespace JFM {
     std::unique_ptr<RendererAPI> RendererAPI::Create() {
         switch (s_API) {
             case RendererAPI::API::None:
-                return nullptr;
+                return std::make_unique<NullRendererAPI>();
             case RendererAPI::API::OpenGL:
                 return std::make_unique<OpenGLRendererAPI>();
             case RendererAPI::API::Vulkan:
@@ -28,4 +34,65 @@ namespace JFM {
         return nullptr;
     }
 
+    void RendererAPI::Execute(const CommandBuffer& commands) {
+        commands.ForEach([this](const CommandHeader& header) {
+            switch (header.Type) {
+                case CommandType::SetViewport: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::SetViewport>(header);
+                    SetViewport(command.X, command.Y, command.Width, command.Height);
+                    break;
+                }
+                case CommandType::SetClearColor:
+                    SetClearColor(CommandBuffer::GetCommand<Commands::SetClearColor>(header).Color);
+                    break;
+                case CommandType::Clear:
+                    Clear();
+                    break;
+                case CommandType::SetPolygonMode:
+                    SetPolygonMode(CommandBuffer::GetCommand<Commands::SetPolygonMode>(header).Mode);
+                    break;
+                case CommandType::BindShader:
+                    CommandBuffer::GetCommand<Commands::BindShader>(header).Shader->Bind();
+                    break;
+                case CommandType::SetFloat: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::SetFloat>(header);
+                    command.Shader->SetFloat(command.Name.GetString(), command.Value);
+                    break;
+                }
+                case CommandType::SetFloat3: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::SetFloat3>(header);
+                    command.Shader->SetFloat3(command.Name.GetString(), command.Value);
+                    break;
+                }
+                case CommandType::SetMat4: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::SetMat4>(header);
+                    command.Shader->SetMat4(command.Name.GetString(), command.Value);
+                    break;
+                }
+                case CommandType::BindMaterial: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::BindMaterial>(header);
+                    Material::Bind(*command.Shader, command.Properties);
+                    break;
+                }
+                case CommandType::DrawIndexed: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::DrawIndexed>(header);
+                    command.VertexArray->Bind();
+                    DrawIndexed(*command.VertexArray, command.IndexCount);
+                    break;
+                }
+                case CommandType::DrawArrays: {
+                    const auto& command = CommandBuffer::GetCommand<Commands::DrawArrays>(header);
+                    command.VertexArray->Bind();
+                    DrawArrays(*command.VertexArray, command.VertexCount);
+                    break;
+                }
+                case CommandType::DrawMesh:
+                    CommandBuffer::GetCommand<Commands::DrawMesh>(header).Mesh->Draw();
+                    break;
+                default:
+                    break;
+            }
+        });
+    }
+
 }
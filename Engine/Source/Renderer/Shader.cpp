@@ -5,9 +5,17 @@
 #include "JFMEngine/Renderer/Shader.h"
 #include "JFMEngine/Renderer/RendererAPI.h"
 #include "JFMEngine/Renderer/OpenGLShader.h"
+#include <atomic>
 
 namespace JFM {
 
+    namespace {
+        std::atomic<uint32_t> s_NextShaderSortID{1};
+    }
+
+    Shader::Shader() : m_SortID(s_NextShaderSortID++) {
+    }
+
     std::shared_ptr<Shader> Shader::Create(const std::string& filepath) {
         switch (RendererAPI::GetAPI()) {
             case RendererAPI::API::None:
@@ -2,7 +2,23 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <charconv>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
 #include <sys/stat.h>
+#ifdef _WIN32
+    #include <direct.h>
+    #include <io.h>
+    // Windows没有writev，用同样布局的结构逐段写出
+    struct iovec {
+        void* iov_base;
+        size_t iov_len;
+    };
+#else
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
 
 namespace JFM {
 
@@ -13,45 +29,96 @@ bool Log::s_Initialized = false;
 
 // ========== 格式化辅助函数实现 ==========
 
-void format_recursive(std::ostringstream& oss, const std::string& fmt, size_t& pos, size_t& arg_index) {
-    // 基础情况：没有更多参数，添加剩余文本
-    oss << fmt.substr(pos);
+namespace log_detail {
+
+std::ostringstream& thread_stream() {
+    thread_local std::ostringstream stream;
+    return stream;
+}
+
+void append_signed(std::string& out, long long value, bool hex) {
+    if (hex) {
+        append_unsigned(out, static_cast<unsigned long long>(value), true);
+        return;
+    }
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_unsigned(std::string& out, unsigned long long value, bool hex) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, hex ? 16 : 10);
+    out.append(buffer, result.ptr);
+}
+
+void append_float(std::string& out, double value) {
+    // 与ostream默认格式一致
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    out.append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+}
+
+void append_pointer(std::string& out, const void* value) {
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), "%p", value);
+    out.append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
 }
 
+} // namespace log_detail
+
 // ========== ConsoleSink 实现 ==========
 
 void ConsoleSink::log(const LogMessage& msg) {
-    if (!should_log(msg.level)) return;
+    log_batch(&msg, 1);
+}
 
+void ConsoleSink::log_batch(const LogMessage* msgs, size_t count) {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    // 整批拼接后一次写出，错误级别写到stderr
+    out_buffer_.clear();
+    err_buffer_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (!should_log(msgs[i].level)) continue;
+        format_line(msgs[i].level >= LogLevel::ERROR ? err_buffer_ : out_buffer_, msgs[i]);
+    }
+
+    if (!out_buffer_.empty()) {
+        std::cout.write(out_buffer_.data(), static_cast<std::streamsize>(out_buffer_.size()));
+        std::cout.flush();
+    }
+    if (!err_buffer_.empty()) {
+        std::cerr.write(err_buffer_.data(), static_cast<std::streamsize>(err_buffer_.size()));
+    }
+}
+
+void ConsoleSink::format_line(std::string& out, const LogMessage& msg) {
     // 获取时间戳
     auto time_t = std::chrono::system_clock::to_time_t(msg.timestamp);
     auto tm = *std::localtime(&time_t);
-
-    std::ostringstream oss;
+    char time_str[16];
+    std::strftime(time_str, sizeof(time_str), "%H:%M:%S", &tm);
 
     if (use_colors_) {
-        oss << get_color_code(msg.level);
+        out += get_color_code(msg.level);
     }
 
     // 格式: [时间] [级别] [日志器]: 消息
-    oss << "[" << std::put_time(&tm, "%H:%M:%S") << "] "
-        << "[" << get_level_string(msg.level) << "] "
-        << "[" << msg.logger_name << "]: "
-        << msg.message;
+    out += '[';
+    out += time_str;
+    out += "] [";
+    out += get_level_string(msg.level);
+    out += "] [";
+    out += msg.logger_name;
+    out += "]: ";
+    out += msg.message;
 
     if (use_colors_) {
-        oss << "\033[0m"; // 重置颜色
+        out += "\033[0m"; // 重置颜色
     }
 
-    oss << std::endl;
-
-    if (msg.level >= LogLevel::ERROR) {
-        std::cerr << oss.str();
-    } else {
-        std::cout << oss.str();
-    }
+    out += '\n';
 }
 
 std::string ConsoleSink::get_color_code(LogLevel level) {
@@ -78,10 +145,23 @@ std::string ConsoleSink::get_level_string(LogLevel level) {
     }
 }
 
-// ========== FileSink 实现 ==========
+// ========== BufferedFileSink 实现 ==========
+
+namespace {
+
+std::string get_file_level_string(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE:    return "TRACE";
+        case LogLevel::DEBUG:    return "DEBUG";
+        case LogLevel::INFO:     return "INFO ";
+        case LogLevel::WARN:     return "WARN ";
+        case LogLevel::ERROR:    return "ERROR";
+        case LogLevel::CRITICAL: return "CRIT ";
+        default:                 return "UNKN ";
+    }
+}
 
-FileSink::FileSink(const std::string& filename) {
-    // 确保目录存在
+void ensure_parent_directory(const std::string& filename) {
     size_t lastSlash = filename.find_last_of("/\\");
     if (lastSlash != std::string::npos) {
         std::string directory = filename.substr(0, lastSlash);
@@ -92,130 +172,228 @@ FileSink::FileSink(const std::string& filename) {
             mkdir(directory.c_str(), 0755);
         #endif
     }
+}
 
-    file_.open(filename, std::ios::app);
-    if (!file_.is_open()) {
-        throw std::runtime_error("Failed to open log file: " + filename);
+// 把多段数据写入文件，处理部分写入
+void write_all(int fd, iovec* parts, int count) {
+#ifdef _WIN32
+    for (int i = 0; i < count; ++i) {
+        _write(fd, parts[i].iov_base, static_cast<unsigned int>(parts[i].iov_len));
     }
+#else
+    while (count > 0) {
+        ssize_t written = ::writev(fd, parts, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        // 跳过已经完整写出的段
+        while (count > 0 && static_cast<size_t>(written) >= parts->iov_len) {
+            written -= static_cast<ssize_t>(parts->iov_len);
+            ++parts;
+            --count;
+        }
+        if (count > 0) {
+            parts->iov_base = static_cast<char*>(parts->iov_base) + written;
+            parts->iov_len -= static_cast<size_t>(written);
+        }
+    }
+#endif
 }
 
-FileSink::~FileSink() {
-    if (file_.is_open()) {
-        file_.close();
+} // namespace
+
+BufferedFileSink::BufferedFileSink(const std::string& filename, bool truncate)
+    : last_write_(std::chrono::steady_clock::now()) {
+    ensure_parent_directory(filename);
+    open_file(filename, truncate);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open log file: " + filename);
     }
+    buffer_.reserve(policy_.max_buffered_bytes + 1024);
 }
 
-void FileSink::log(const LogMessage& msg) {
-    if (!should_log(msg.level)) return;
+BufferedFileSink::~BufferedFileSink() {
+    write_buffer();
+    close_file();
+}
 
-    std::lock_guard<std::mutex> lock(mutex_);
+void BufferedFileSink::open_file(const std::string& filename, bool truncate) {
+    int flags = O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND);
+#ifdef _WIN32
+    fd_ = _open(filename.c_str(), flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd_ = ::open(filename.c_str(), flags | O_CLOEXEC, 0644);
+#endif
+}
 
-    if (!file_.is_open()) return;
+void BufferedFileSink::close_file() {
+    if (fd_ >= 0) {
+#ifdef _WIN32
+        _close(fd_);
+#else
+        ::close(fd_);
+#endif
+        fd_ = -1;
+    }
+}
 
-    // 获取时间戳
-    auto time_t = std::chrono::system_clock::to_time_t(msg.timestamp);
-    auto tm = *std::localtime(&time_t);
+void BufferedFileSink::set_flush_policy(const FlushPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+    buffer_.reserve(policy_.max_buffered_bytes + 1024);
+}
 
-    // 格式: [时间] [级别] [线程ID] [日志器]: 消息
-    file_ << "[" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "] "
-          << "[" << get_level_string(msg.level) << "] "
-          << "[" << msg.thread_id << "] "
-          << "[" << msg.logger_name << "]: "
-          << msg.message << std::endl;
+void BufferedFileSink::log(const LogMessage& msg) {
+    log_batch(&msg, 1);
 }
 
-void FileSink::flush() {
+void BufferedFileSink::log_batch(const LogMessage* msgs, size_t count) {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (file_.is_open()) {
-        file_.flush();
+
+    if (fd_ < 0) return;
+
+    bool urgent = false;
+    for (size_t i = 0; i < count; ++i) {
+        const LogMessage& msg = msgs[i];
+        if (!should_log(msg.level)) continue;
+
+        if (msg.message.size() >= policy_.max_buffered_bytes) {
+            // 超大消息不拷贝进缓冲，和缓冲内容一起用writev直接写出
+            write_large(msg);
+        } else {
+            append_message(msg);
+        }
+        urgent = urgent || msg.level >= policy_.flush_level;
     }
-}
 
-std::string FileSink::get_level_string(LogLevel level) {
-    switch (level) {
-        case LogLevel::TRACE:    return "TRACE";
-        case LogLevel::DEBUG:    return "DEBUG";
-        case LogLevel::INFO:     return "INFO ";
-        case LogLevel::WARN:     return "WARN ";
-        case LogLevel::ERROR:    return "ERROR";
-        case LogLevel::CRITICAL: return "CRIT ";
-        default:                 return "UNKN ";
+    if (urgent || buffer_.size() >= policy_.max_buffered_bytes ||
+        std::chrono::steady_clock::now() - last_write_ >= policy_.interval) {
+        write_buffer();
     }
 }
 
-// ========== RotatingFileSink 实现 ==========
+void BufferedFileSink::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_buffer();
+}
 
-RotatingFileSink::RotatingFileSink(const std::string& base_filename, size_t max_size, size_t max_files)
-    : base_filename_(base_filename), max_size_(max_size), max_files_(max_files), current_size_(0) {
+void BufferedFileSink::poll_flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!buffer_.empty() && std::chrono::steady_clock::now() - last_write_ >= policy_.interval) {
+        write_buffer();
+    }
+}
 
-    // 确保目录存在
-    size_t lastSlash = base_filename.find_last_of("/\\");
-    if (lastSlash != std::string::npos) {
-        std::string directory = base_filename.substr(0, lastSlash);
-        // 简化处理：尝试创建单级目录
-        #ifdef _WIN32
-            _mkdir(directory.c_str());
-        #else
-            mkdir(directory.c_str(), 0755);
-        #endif
+void BufferedFileSink::append_prefix(const LogMessage& msg) {
+    // 时间戳按秒缓存，同一秒内的消息不再调用localtime/strftime
+    auto time_t = std::chrono::system_clock::to_time_t(msg.timestamp);
+    if (time_t != cached_time_) {
+        auto tm = *std::localtime(&time_t);
+        std::strftime(cached_time_str_, sizeof(cached_time_str_), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_time_ = time_t;
     }
 
-    file_.open(base_filename_, std::ios::app);
-    if (!file_.is_open()) {
-        throw std::runtime_error("Failed to open rotating log file: " + base_filename_);
+    // 线程ID的文本表示同样缓存
+    if (cached_thread_str_.empty() || msg.thread_id != cached_thread_id_) {
+        std::ostringstream oss;
+        oss << msg.thread_id;
+        cached_thread_str_ = oss.str();
+        cached_thread_id_ = msg.thread_id;
     }
 
-    // 获取当前文件大小
-    file_.seekp(0, std::ios::end);
-    current_size_ = file_.tellp();
+    // 格式: [时间] [级别] [线程ID] [日志器]: 消息
+    prefix_.clear();
+    prefix_ += '[';
+    prefix_ += cached_time_str_;
+    prefix_ += "] [";
+    prefix_ += get_file_level_string(msg.level);
+    prefix_ += "] [";
+    prefix_ += cached_thread_str_;
+    prefix_ += "] [";
+    prefix_ += msg.logger_name;
+    prefix_ += "]: ";
 }
 
-RotatingFileSink::~RotatingFileSink() {
-    if (file_.is_open()) {
-        file_.close();
-    }
+void BufferedFileSink::append_message(const LogMessage& msg) {
+    append_prefix(msg);
+    buffer_ += prefix_;
+    buffer_ += msg.message;
+    buffer_ += '\n';
 }
 
-void RotatingFileSink::log(const LogMessage& msg) {
-    if (!should_log(msg.level)) return;
+void BufferedFileSink::write_buffer() {
+    last_write_ = std::chrono::steady_clock::now();
+    if (buffer_.empty() || fd_ < 0) return;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    before_write(buffer_.size());
 
-    if (!file_.is_open()) return;
+    iovec part{buffer_.data(), buffer_.size()};
+    write_all(fd_, &part, 1);
+    buffer_.clear();
+}
 
-    // 获取时间戳
-    auto time_t = std::chrono::system_clock::to_time_t(msg.timestamp);
-    auto tm = *std::localtime(&time_t);
+void BufferedFileSink::write_large(const LogMessage& msg) {
+    append_prefix(msg);
 
-    std::ostringstream oss;
-    oss << "[" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "] "
-        << "[" << get_level_string(msg.level) << "] "
-        << "[" << msg.thread_id << "] "
-        << "[" << msg.logger_name << "]: "
-        << msg.message << std::endl;
+    char newline = '\n';
+    iovec parts[4] = {
+        {buffer_.data(), buffer_.size()},
+        {prefix_.data(), prefix_.size()},
+        {const_cast<char*>(msg.message.data()), msg.message.size()},
+        {&newline, 1}
+    };
 
-    std::string log_line = oss.str();
+    before_write(buffer_.size() + prefix_.size() + msg.message.size() + 1);
+    if (fd_ < 0) return;
 
-    // 检查是否需要轮转
-    if (current_size_ + log_line.size() > max_size_) {
-        rotate_file();
+    write_all(fd_, parts, 4);
+    buffer_.clear();
+    last_write_ = std::chrono::steady_clock::now();
+}
+
+// ========== FileSink 实现 ==========
+
+FileSink::FileSink(const std::string& filename)
+    : BufferedFileSink(filename, false) {
+}
+
+// ========== RotatingFileSink 实现 ==========
+
+RotatingFileSink::RotatingFileSink(const std::string& base_filename, size_t max_size, size_t max_files)
+    : BufferedFileSink(base_filename, false),
+      base_filename_(base_filename), max_size_(max_size), max_files_(max_files), current_size_(0) {
+
+    // 获取当前文件大小
+    struct stat info{};
+    if (::stat(base_filename_.c_str(), &info) == 0) {
+        current_size_ = static_cast<size_t>(info.st_size);
     }
 
-    file_ << log_line;
-    current_size_ += log_line.size();
+    // 缓冲不超过单个文件的上限，避免一次写入就远超轮转大小
+    FlushPolicy policy = get_flush_policy();
+    if (policy.max_buffered_bytes > max_size_) {
+        policy.max_buffered_bytes = max_size_;
+        set_flush_policy(policy);
+    }
 }
 
-void RotatingFileSink::flush() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (file_.is_open()) {
-        file_.flush();
+RotatingFileSink::~RotatingFileSink() {
+    // 基类析构时before_write已不再分派到本类，剩余缓冲必须在这里写出才能按大小轮转
+    flush();
+}
+
+void RotatingFileSink::before_write(size_t bytes) {
+    // 按整批写入量判断是否需要轮转，不再逐条统计
+    if (current_size_ > 0 && current_size_ + bytes > max_size_) {
+        rotate_file();
     }
+    current_size_ += bytes;
 }
 
 void RotatingFileSink::rotate_file() {
-    if (file_.is_open()) {
-        file_.close();
-    }
+    close_file();
 
     // 轮转文件
     for (size_t i = max_files_ - 1; i > 0; --i) {
@@ -240,26 +418,18 @@ void RotatingFileSink::rotate_file() {
     }
 
     // 创建新文件
-    file_.open(base_filename_, std::ios::out);
+    open_file(base_filename_, true);
     current_size_ = 0;
 }
 
-std::string RotatingFileSink::get_level_string(LogLevel level) {
-    switch (level) {
-        case LogLevel::TRACE:    return "TRACE";
-        case LogLevel::DEBUG:    return "DEBUG";
-        case LogLevel::INFO:     return "INFO ";
-        case LogLevel::WARN:     return "WARN ";
-        case LogLevel::ERROR:    return "ERROR";
-        case LogLevel::CRITICAL: return "CRIT ";
-        default:                 return "UNKN ";
-    }
-}
-
 // ========== AsyncLogger 实现 ==========
 
 AsyncLogger::AsyncLogger(const std::string& name)
-    : name_(name), level_(LogLevel::TRACE), should_stop_(false) {
+    : name_(name), level_(LogLevel::TRACE), message_queue_(std::make_unique<LogQueue>()), should_stop_(false),
+      record_batch_(BatchSize), message_batch_(BatchSize) {
+    for (auto& msg : message_batch_) {
+        msg.logger_name = name_;
+    }
     worker_thread_ = std::thread(&AsyncLogger::worker_function, this);
 }
 
@@ -276,67 +446,125 @@ void AsyncLogger::add_sink(const std::shared_ptr<LogSink>& sink) {
     sinks_.push_back(sink);
 }
 
-void AsyncLogger::log(LogLevel level, const std::string& message) {
-    if (!should_log(level)) return;
-
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        message_queue_.emplace(level, name_, message);
+void AsyncLogger::enqueue_record(const LogRecord& record) {
+    while (!message_queue_->Enqueue(record)) {
+        if (overflow_policy_ == LogOverflowPolicy::Drop) {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            delete[] record.heap_args;
+            return;
+        }
+        // 队列满时让出CPU等待工作线程消费
+        queue_cv_.notify_one();
+        std::this_thread::yield();
     }
     queue_cv_.notify_one();
 }
 
+void AsyncLogger::log(LogLevel level, std::string_view message) {
+    // 已经格式化好的文本作为唯一参数写入记录
+    static constexpr BasicFormatString<std::string_view> text_format("{}");
+    log_deferred(level, text_format, message);
+}
+
 void AsyncLogger::flush() {
+    // 在工作线程内调用（如sink中记录日志）时无法等待自己
+    if (std::this_thread::get_id() != worker_thread_.get_id()) {
+        // 记下调用时刻的生产者位置，等待工作线程处理到该位置
+        size_t target = message_queue_->GetWritePosition();
+
+        flush_waiters_.fetch_add(1);
+        queue_cv_.notify_one();
+        {
+            std::unique_lock<std::mutex> lock(flush_mutex_);
+            flush_cv_.wait(lock, [this, target] {
+                return consumed_count_.load(std::memory_order_acquire) >= target;
+            });
+        }
+        flush_waiters_.fetch_sub(1);
+    }
+
     for (auto& sink : sinks_) {
         sink->flush();
     }
 }
 
-void AsyncLogger::trace(const std::string& message) {
+void AsyncLogger::trace(std::string_view message) {
     log(LogLevel::TRACE, message);
 }
 
-void AsyncLogger::debug(const std::string& message) {
+void AsyncLogger::debug(std::string_view message) {
     log(LogLevel::DEBUG, message);
 }
 
-void AsyncLogger::info(const std::string& message) {
+void AsyncLogger::info(std::string_view message) {
     log(LogLevel::INFO, message);
 }
 
-void AsyncLogger::warn(const std::string& message) {
+void AsyncLogger::warn(std::string_view message) {
     log(LogLevel::WARN, message);
 }
 
-void AsyncLogger::error(const std::string& message) {
+void AsyncLogger::error(std::string_view message) {
     log(LogLevel::ERROR, message);
 }
 
-void AsyncLogger::critical(const std::string& message) {
+void AsyncLogger::critical(std::string_view message) {
     log(LogLevel::CRITICAL, message);
 }
 
 void AsyncLogger::worker_function() {
-    while (!should_stop_) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        queue_cv_.wait(lock, [this] { return !message_queue_.empty() || should_stop_; });
-
-        while (!message_queue_.empty()) {
-            LogMessage msg = message_queue_.front();
-            message_queue_.pop();
-            lock.unlock();
-
-            // 将消息发送到所有sink
-            for (auto& sink : sinks_) {
-                try {
-                    sink->log(msg);
-                } catch (const std::exception& e) {
-                    // 如果日志输出失败，输出到stderr
-                    std::cerr << "Log sink error: " << e.what() << std::endl;
-                }
+    while (true) {
+        // 批量取出待处理记录，格式化后整批交给各个sink
+        size_t count = 0;
+        while ((count = message_queue_->DequeueBulk(record_batch_.data(), BatchSize)) > 0) {
+            dispatch_batch(count);
+            consumed_count_.fetch_add(count);
+
+            // 有线程在flush中等待时，每批处理完都唤醒它检查进度
+            if (flush_waiters_.load() > 0) {
+                std::lock_guard<std::mutex> lock(flush_mutex_);
+                flush_cv_.notify_all();
             }
+        }
 
-            lock.lock();
+        if (should_stop_) {
+            // 停止前队列已经清空
+            if (message_queue_->Empty()) {
+                break;
+            }
+            continue;
+        }
+
+        // 空闲时让sink按时间间隔刷新缓冲
+        for (auto& sink : sinks_) {
+            sink->poll_flush();
+        }
+
+        // 生产者不持锁通知，可能错过唤醒，因此使用超时等待兜底
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait_for(lock, std::chrono::milliseconds(10),
+            [this] { return !message_queue_->Empty() || should_stop_; });
+    }
+}
+
+void AsyncLogger::dispatch_batch(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const LogRecord& record = record_batch_[i];
+        LogMessage& msg = message_batch_[i];
+        msg.level = record.level;
+        msg.timestamp = record.timestamp;
+        msg.thread_id = record.thread_id;
+        msg.message.clear();
+        record.format(msg.message, record.fmt, record.args_data());
+        delete[] record.heap_args;
+    }
+
+    for (auto& sink : sinks_) {
+        try {
+            sink->log_batch(message_batch_.data(), count);
+        } catch (const std::exception& e) {
+            // 如果日志输出失败，输出到stderr
+            std::cerr << "Log sink error: " << e.what() << std::endl;
         }
     }
 }
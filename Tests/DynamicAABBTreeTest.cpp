@@ -0,0 +1,252 @@
+//
+// DynamicAABBTreeTest.cpp - 动态包围盒树和批量射线检测
+// 随机包围盒经过多轮MoveProxy移动、删除和重建后，重叠查询、球体查询和射线遍历与暴力结果一致；
+// 物理世界的RaycastBatch与逐个刚体求交的结果一致
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/DynamicAABBTree.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include "JFMEngine/Physics/PhysicsComponents.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr float DistanceTolerance = 1e-4f;
+
+    bool Contains(const AABB& outer, const AABB& inner) {
+        return outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z &&
+               outer.Max.x >= inner.Max.x && outer.Max.y >= inner.Max.y && outer.Max.z >= inner.Max.z;
+    }
+
+    AABB RandomBox(std::mt19937& rng, float range) {
+        std::uniform_real_distribution<float> position(-range, range);
+        std::uniform_real_distribution<float> size(0.1f, 2.0f);
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        glm::vec3 half(size(rng), size(rng), size(rng));
+        return AABB(center - half, center + half);
+    }
+
+    struct Proxy {
+        uint32_t Id = DynamicAABBTree::NullNode;
+        AABB Bounds;
+    };
+
+    // 以userData为下标的代理，Id为NullNode表示已删除
+    void CheckTree(const DynamicAABBTree& tree, const std::vector<Proxy>& proxies, std::mt19937& rng) {
+        size_t live = 0;
+        for (const Proxy& proxy : proxies) {
+            if (proxy.Id != DynamicAABBTree::NullNode) {
+                live++;
+                JFM_CHECK(Contains(tree.GetFatBounds(proxy.Id), proxy.Bounds));
+            }
+        }
+        JFM_CHECK(tree.GetProxyCount() == live);
+
+        // 重叠查询：不能漏掉与真实包围盒重叠的代理，报告的代理胖包围盒一定重叠
+        for (int q = 0; q < 50; ++q) {
+            AABB query = RandomBox(rng, 25.0f);
+            query.Min -= glm::vec3(2.0f);
+            query.Max += glm::vec3(2.0f);
+
+            std::vector<uint32_t> reported;
+            tree.Query(query, [&](uint32_t userData) {
+                reported.push_back(userData);
+                return true;
+            });
+            std::sort(reported.begin(), reported.end());
+            JFM_CHECK(std::adjacent_find(reported.begin(), reported.end()) == reported.end());
+
+            for (uint32_t userData : reported) {
+                JFM_CHECK(userData < proxies.size() && proxies[userData].Id != DynamicAABBTree::NullNode);
+                JFM_CHECK(tree.GetFatBounds(proxies[userData].Id).Intersects(query));
+            }
+            for (uint32_t i = 0; i < proxies.size(); ++i) {
+                if (proxies[i].Id != DynamicAABBTree::NullNode && proxies[i].Bounds.Intersects(query)) {
+                    JFM_CHECK(std::binary_search(reported.begin(), reported.end(), i));
+                }
+            }
+        }
+
+        // 球体查询：同样按真实包围盒检查不漏
+        std::uniform_real_distribution<float> position(-25.0f, 25.0f);
+        std::uniform_real_distribution<float> radius(0.5f, 6.0f);
+        for (int q = 0; q < 50; ++q) {
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            float r = radius(rng);
+            std::vector<uint32_t> reported;
+            tree.QuerySphere(center, r, [&](uint32_t userData) {
+                reported.push_back(userData);
+                return true;
+            });
+            std::sort(reported.begin(), reported.end());
+            for (uint32_t i = 0; i < proxies.size(); ++i) {
+                if (proxies[i].Id != DynamicAABBTree::NullNode &&
+                    PhysicsUtils::DistancePointToAABB(center, proxies[i].Bounds) <= r) {
+                    JFM_CHECK(std::binary_search(reported.begin(), reported.end(), i));
+                }
+            }
+        }
+
+        // 射线遍历：回调对真实包围盒求交并返回命中距离裁剪遍历，最近命中与暴力结果相同
+        for (int q = 0; q < 200; ++q) {
+            PhysicsUtils::Ray ray(glm::vec3(position(rng), position(rng), position(rng)),
+                                  glm::vec3(position(rng), position(rng), position(rng)), 60.0f);
+            uint32_t nearest = DynamicAABBTree::NullNode;
+            float nearestDistance = ray.MaxDistance;
+            tree.Raycast(ray.Origin, ray.Direction, ray.MaxDistance, [&](uint32_t userData, float maxDistance) {
+                float distance = 0.0f;
+                glm::vec3 normal;
+                if (!PhysicsUtils::RayIntersectsAABB(ray, proxies[userData].Bounds, distance, normal) || distance > maxDistance) {
+                    return maxDistance;
+                }
+                if (distance < nearestDistance) {
+                    nearest = userData;
+                    nearestDistance = distance;
+                }
+                return distance;
+            });
+
+            uint32_t expected = DynamicAABBTree::NullNode;
+            float expectedDistance = ray.MaxDistance;
+            for (uint32_t i = 0; i < proxies.size(); ++i) {
+                float distance = 0.0f;
+                glm::vec3 normal;
+                if (proxies[i].Id != DynamicAABBTree::NullNode &&
+                    PhysicsUtils::RayIntersectsAABB(ray, proxies[i].Bounds, distance, normal) &&
+                    distance <= ray.MaxDistance && distance < expectedDistance) {
+                    expected = i;
+                    expectedDistance = distance;
+                }
+            }
+
+            JFM_CHECK((nearest == DynamicAABBTree::NullNode) == (expected == DynamicAABBTree::NullNode));
+            if (expected != DynamicAABBTree::NullNode) {
+                JFM_CHECK(std::abs(nearestDistance - expectedDistance) < DistanceTolerance);
+            }
+        }
+    }
+
+    void TestTreeAgainstBruteForce() {
+        std::mt19937 rng(1);
+        DynamicAABBTree tree;
+        std::vector<Proxy> proxies(1000);
+        for (uint32_t i = 0; i < proxies.size(); ++i) {
+            proxies[i].Bounds = RandomBox(rng, 20.0f);
+            proxies[i].Id = tree.CreateProxy(proxies[i].Bounds, i);
+        }
+        CheckTree(tree, proxies, rng);
+
+        std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int round = 0; round < 20; ++round) {
+            for (uint32_t i = 0; i < proxies.size(); ++i) {
+                Proxy& proxy = proxies[i];
+                const float action = unit(rng);
+                if (proxy.Id == DynamicAABBTree::NullNode) {
+                    // 之前删除的代理重新加入
+                    if (action < 0.5f) {
+                        proxy.Bounds = RandomBox(rng, 20.0f);
+                        proxy.Id = tree.CreateProxy(proxy.Bounds, i);
+                    }
+                } else if (action < 0.03f) {
+                    tree.DestroyProxy(proxy.Id);
+                    proxy.Id = DynamicAABBTree::NullNode;
+                } else if (action < 0.10f) {
+                    // 瞬移到远处
+                    proxy.Bounds = RandomBox(rng, 20.0f);
+                    tree.MoveProxy(proxy.Id, proxy.Bounds);
+                } else if (action < 0.70f) {
+                    // 小幅移动，多数仍在胖包围盒内
+                    glm::vec3 displacement(step(rng), step(rng), step(rng));
+                    proxy.Bounds.Min += displacement;
+                    proxy.Bounds.Max += displacement;
+                    tree.MoveProxy(proxy.Id, proxy.Bounds, displacement);
+                }
+            }
+            CheckTree(tree, proxies, rng);
+        }
+    }
+
+    // 物理世界：刚体移动后查询树随之更新，批量射线与逐个刚体求交的最近命中相同
+    void TestRaycastBatch() {
+        PhysicsWorld3D world;
+        world.SetGravity(glm::vec3(0.0f));
+
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<float> size(0.2f, 3.0f);
+        std::uniform_real_distribution<float> velocity(-4.0f, 4.0f);
+        for (int i = 0; i < 400; ++i) {
+            auto body = std::make_shared<Rigidbody3D>();
+            if (i % 4 == 0) {
+                body->SetMass(0.0f);
+            }
+            body->SetCollider(std::make_shared<BoxCollider>(glm::vec3(size(rng), size(rng), size(rng))));
+            body->SetPosition(glm::vec3(position(rng), position(rng), position(rng)));
+            body->SetDrag(1.0f);
+            world.AddRigidbody(body);
+            if (i % 4 != 0) {
+                body->SetVelocity(glm::vec3(velocity(rng), velocity(rng), velocity(rng)));
+            }
+        }
+
+        std::vector<PhysicsUtils::Ray> rays;
+        for (int i = 0; i < 300; ++i) {
+            rays.emplace_back(glm::vec3(position(rng), position(rng), position(rng)),
+                              glm::vec3(position(rng), position(rng), position(rng)), 80.0f);
+        }
+        std::vector<PhysicsWorld3D::RaycastHit3D> hits(rays.size());
+
+        int hitCount = 0;
+        for (int frame = 0; frame < 10; ++frame) {
+            for (int step = 0; step < 6; ++step) {
+                world.Step();
+            }
+
+            world.RaycastBatch(rays.data(), rays.size(), hits.data());
+            const auto& bodies = world.GetRigidbodies();
+            for (size_t r = 0; r < rays.size(); ++r) {
+                std::shared_ptr<Rigidbody> expected;
+                float expectedDistance = rays[r].MaxDistance;
+                for (const auto& body : bodies) {
+                    float distance = 0.0f;
+                    glm::vec3 normal;
+                    if (PhysicsUtils::RayIntersectsBody(rays[r], *body, distance, normal) &&
+                        distance <= rays[r].MaxDistance && distance < expectedDistance) {
+                        expected = body;
+                        expectedDistance = distance;
+                    }
+                }
+
+                const PhysicsWorld3D::RaycastHit3D& hit = hits[r];
+                JFM_CHECK(hit.Hit == (expected != nullptr));
+                if (hit.Hit && expected) {
+                    JFM_CHECK(std::abs(hit.Distance - expectedDistance) < DistanceTolerance);
+                    // 距离相同的刚体可能不止一个，报告的刚体本身必须在该距离被击中
+                    float distance = 0.0f;
+                    glm::vec3 normal;
+                    JFM_CHECK(hit.Rigidbody != nullptr);
+                    JFM_CHECK(hit.Rigidbody == expected ||
+                              (PhysicsUtils::RayIntersectsBody(rays[r], *hit.Rigidbody, distance, normal) &&
+                               std::abs(distance - expectedDistance) < DistanceTolerance));
+                    hitCount++;
+                }
+            }
+        }
+        JFM_CHECK(hitCount > 100);
+    }
+
+}
+
+int main() {
+    TestTreeAgainstBruteForce();
+    TestRaycastBatch();
+    return JFM_TEST_RESULT();
+}
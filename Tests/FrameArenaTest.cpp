@@ -0,0 +1,132 @@
+//
+// FrameArenaTest.cpp - 帧分配器
+// 替换全局operator new统计分配次数，预热若干帧后，每帧的FrameArena和FrameVector都不应再访问堆；
+// 分配满足对齐要求；超出单块容量的帧在重置时合并内存块；在途帧的数据在后续帧中保持有效
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Core/FrameArena.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> s_HeapAllocations{0};
+}
+
+void* operator new(size_t size) {
+    s_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int WarmupFrames = 10;
+    constexpr int MeasuredFrames = 100;
+
+    // 模拟一帧的临时数据：逐个增长的容器、大块数组和单个对象
+    // 容器逐次扩容的旧缓冲不会释放，本帧用量超过默认块大小，会触发块合并
+    void SimulateFrame(FrameArena& arena, int frame) {
+        FrameVector<float> samples;
+        for (int i = 0; i < 20000; ++i) {
+            samples.push_back(static_cast<float>(i));
+        }
+        JFM_CHECK(samples[1234] == 1234.0f);
+
+        FrameVector<char> text(4096, 'x');
+        JFM_CHECK(text.back() == 'x');
+
+        FrameVector<uint64_t> keys;
+        keys.reserve(5000);
+        for (uint64_t i = 0; i < 5000; ++i) {
+            keys.push_back(i * 2654435761u);
+        }
+        JFM_CHECK(keys.size() == 5000);
+
+        int* value = arena.New<int>(frame);
+        JFM_CHECK(*value == frame);
+    }
+
+    void TestSteadyState() {
+        FrameArena& arena = FrameArena::GetInstance();
+        for (int frame = 0; frame < WarmupFrames; ++frame) {
+            arena.BeginFrame();
+            SimulateFrame(arena, frame);
+        }
+
+        const size_t chunksBefore = arena.GetStats().ChunkAllocations;
+        const size_t allocationsBefore = s_HeapAllocations.load();
+        for (int frame = 0; frame < MeasuredFrames; ++frame) {
+            arena.BeginFrame();
+            SimulateFrame(arena, frame);
+        }
+        const size_t heapAllocations = s_HeapAllocations.load() - allocationsBefore;
+
+        std::printf("FrameArenaTest: %zu heap allocations in %d steady-state frames\n", heapAllocations, MeasuredFrames);
+        JFM_CHECK(heapAllocations == 0);
+        JFM_CHECK(arena.GetStats().ChunkAllocations == chunksBefore);
+        JFM_CHECK(arena.GetStats().PeakBytes > FrameArena::DefaultChunkSize);
+    }
+
+    void TestAlignment() {
+        FrameArena& arena = FrameArena::GetInstance();
+        arena.BeginFrame();
+        for (size_t alignment : {1, 2, 8, 16, 64, 256}) {
+            // 先分配一个字节打乱偏移
+            arena.Allocate(1, 1);
+            void* memory = arena.Allocate(24, alignment);
+            JFM_CHECK(reinterpret_cast<uintptr_t>(memory) % alignment == 0);
+        }
+
+        // 大于剩余空间的分配落到新块上，同样满足对齐
+        void* large = arena.Allocate(FrameArena::DefaultChunkSize, 64);
+        JFM_CHECK(reinterpret_cast<uintptr_t>(large) % 64 == 0);
+    }
+
+    // 两个在途帧：上一帧的数据在本帧写入后仍然保持不变
+    void TestFramesInFlight() {
+        FrameArena& arena = FrameArena::GetInstance();
+        arena.SetFramesInFlight(2);
+
+        arena.BeginFrame();
+        int* previous = arena.AllocateArray<int>(1024);
+        for (int i = 0; i < 1024; ++i) {
+            previous[i] = i;
+        }
+
+        arena.BeginFrame();
+        int* current = arena.AllocateArray<int>(1024);
+        for (int i = 0; i < 1024; ++i) {
+            current[i] = -i;
+        }
+
+        bool intact = true;
+        for (int i = 0; i < 1024; ++i) {
+            intact = intact && previous[i] == i;
+        }
+        JFM_CHECK(intact);
+        JFM_CHECK(current != previous);
+    }
+
+}
+
+int main() {
+    TestSteadyState();
+    TestAlignment();
+    TestFramesInFlight();
+    return JFM_TEST_RESULT();
+}
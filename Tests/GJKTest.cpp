@@ -0,0 +1,164 @@
+//
+// GJKTest.cpp - GJK距离与EPA穿透深度
+// 球体与球体、盒子与盒子的距离、穿透深度和法线与解析解比较；
+// 物体连续移动时用SimplexCache热启动的结果与每次从头计算相同
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/GJK.h"
+#include <cmath>
+#include <random>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr float DistanceTolerance = 1e-3f;
+    constexpr float NormalTolerance = 1e-3f;
+
+    ConvexShape MakeSphere(const glm::vec3& center, float radius) {
+        ConvexShape shape;
+        shape.Type = ConvexShape::Kind::Point;
+        shape.Center = center;
+        shape.Radius = radius;
+        return shape;
+    }
+
+    ConvexShape MakeBox(const glm::vec3& center, const glm::vec3& halfExtents) {
+        ConvexShape shape;
+        shape.Type = ConvexShape::Kind::Box;
+        shape.Center = center;
+        shape.HalfExtents = halfExtents;
+        return shape;
+    }
+
+    bool Near(const glm::vec3& a, const glm::vec3& b, float tolerance) {
+        return glm::length(a - b) < tolerance;
+    }
+
+    // 球体：GJK只处理球心，球面之间的距离为核心距离减去两个半径，负值为穿透深度
+    void TestSphereSphere() {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> radius(0.1f, 1.5f);
+
+        int penetrating = 0;
+        for (int i = 0; i < 200; ++i) {
+            ConvexShape a = MakeSphere(glm::vec3(position(rng), position(rng), position(rng)), radius(rng));
+            ConvexShape b = MakeSphere(glm::vec3(position(rng), position(rng), position(rng)), radius(rng));
+            const glm::vec3 delta = b.Center - a.Center;
+            const float centerDistance = glm::length(delta);
+            if (centerDistance < 1e-3f) {
+                continue;
+            }
+
+            GJKResult result;
+            JFM_CHECK(GJK::Evaluate(a, b, 100.0f, result));
+            const float expected = centerDistance - a.Radius - b.Radius;
+            JFM_CHECK(std::abs(result.Distance - a.Radius - b.Radius - expected) < DistanceTolerance);
+            JFM_CHECK(Near(result.Normal, delta / centerDistance, NormalTolerance));
+            penetrating += expected < 0.0f ? 1 : 0;
+        }
+        // 随机样本中两种情况都要出现
+        JFM_CHECK(penetrating > 20 && penetrating < 180);
+    }
+
+    // 轴对齐盒子：分离时距离为各轴间隙组成的向量长度；重叠时穿透深度为各轴重叠量的最小值，法线沿该轴
+    void TestBoxBox() {
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<float> position(-1.5f, 1.5f);
+        std::uniform_real_distribution<float> extent(0.2f, 1.0f);
+
+        int separated = 0;
+        int penetrating = 0;
+        for (int i = 0; i < 500; ++i) {
+            ConvexShape a = MakeBox(glm::vec3(position(rng), position(rng), position(rng)),
+                                    glm::vec3(extent(rng), extent(rng), extent(rng)));
+            ConvexShape b = MakeBox(glm::vec3(position(rng), position(rng), position(rng)),
+                                    glm::vec3(extent(rng), extent(rng), extent(rng)));
+            const glm::vec3 delta = b.Center - a.Center;
+            const glm::vec3 gap = glm::abs(delta) - (a.HalfExtents + b.HalfExtents);
+
+            GJKResult result;
+            JFM_CHECK(GJK::Evaluate(a, b, 100.0f, result));
+
+            if (gap.x > 0.0f || gap.y > 0.0f || gap.z > 0.0f) {
+                const glm::vec3 separation = glm::max(gap, glm::vec3(0.0f));
+                JFM_CHECK(std::abs(result.Distance - glm::length(separation)) < DistanceTolerance);
+                // 法线与间隙方向一致
+                const glm::vec3 direction(std::copysign(separation.x, delta.x), std::copysign(separation.y, delta.y),
+                                          std::copysign(separation.z, delta.z));
+                const glm::vec3 expectedNormal = glm::normalize(direction);
+                JFM_CHECK(Near(result.Normal, expectedNormal, NormalTolerance));
+                separated++;
+                continue;
+            }
+
+            // 最小重叠轴不唯一时法线有多个正确答案，跳过
+            const glm::vec3 overlap = -gap;
+            int axis = 0;
+            for (int k = 1; k < 3; ++k) {
+                axis = overlap[k] < overlap[axis] ? k : axis;
+            }
+            bool unique = true;
+            for (int k = 0; k < 3; ++k) {
+                unique = unique && (k == axis || overlap[k] - overlap[axis] > 0.01f);
+            }
+            if (!unique || std::abs(delta[axis]) < 0.01f) {
+                continue;
+            }
+
+            glm::vec3 expectedNormal(0.0f);
+            expectedNormal[axis] = delta[axis] > 0.0f ? 1.0f : -1.0f;
+            JFM_CHECK(std::abs(result.Distance + overlap[axis]) < DistanceTolerance);
+            JFM_CHECK(Near(result.Normal, expectedNormal, NormalTolerance));
+            penetrating++;
+        }
+        JFM_CHECK(separated > 50);
+        JFM_CHECK(penetrating > 50);
+    }
+
+    // 盒子绕另一个盒子移动，穿过接触和重叠：热启动与冷启动的结果相同
+    void TestWarmStart() {
+        const ConvexShape fixed = MakeBox(glm::vec3(0.0f), glm::vec3(1.0f, 0.5f, 0.75f));
+        ConvexShape moving = MakeBox(glm::vec3(0.0f), glm::vec3(0.4f, 0.6f, 0.3f));
+        ConvexShape sphere = MakeSphere(glm::vec3(0.0f), 0.5f);
+
+        SimplexCache boxCache;
+        SimplexCache sphereCache;
+        int warmIterations = 0;
+        int coldIterations = 0;
+        for (int step = 0; step < 400; ++step) {
+            const float t = static_cast<float>(step) * 0.02f;
+            const glm::vec3 center(2.2f * std::cos(t), 0.9f * std::sin(1.7f * t), 1.6f * std::sin(t));
+            moving.Center = center;
+            sphere.Center = -center;
+
+            for (int pair = 0; pair < 2; ++pair) {
+                const ConvexShape& other = pair == 0 ? moving : sphere;
+                SimplexCache& cache = pair == 0 ? boxCache : sphereCache;
+
+                GJKResult cold;
+                GJKResult warm;
+                const bool coldHit = GJK::Evaluate(fixed, other, 100.0f, cold);
+                const bool warmHit = GJK::Evaluate(fixed, other, 100.0f, warm, &cache);
+                JFM_CHECK(coldHit && warmHit);
+                JFM_CHECK(std::abs(cold.Distance - warm.Distance) < DistanceTolerance);
+                // 最近点在接触面上可能不唯一，但距离和法线必须一致
+                JFM_CHECK(Near(cold.Normal, warm.Normal, NormalTolerance));
+                coldIterations += cold.Iterations;
+                warmIterations += warm.Iterations;
+            }
+        }
+        // 热启动不应比冷启动需要更多迭代
+        JFM_CHECK(warmIterations <= coldIterations);
+    }
+
+}
+
+int main() {
+    TestSphereSphere();
+    TestBoxBox();
+    TestWarmStart();
+    return JFM_TEST_RESULT();
+}
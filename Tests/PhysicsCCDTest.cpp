@@ -0,0 +1,64 @@
+//
+// PhysicsCCDTest.cpp - 连续碰撞检测
+// 半径5厘米的球以50~1000 m/s射向10厘米厚的静态薄墙，以60 Hz步进：
+// 开启连续碰撞检测时任何一步都不会穿过墙；关闭时高速的球会穿过，说明场景确实会隧穿
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include <algorithm>
+#include <memory>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr float WallThickness = 0.1f;
+    constexpr float SphereRadius = 0.05f;
+    constexpr float Slop = 0.01f;
+    constexpr int Steps = 120;
+
+    // 返回所有步中球心的最大x；墙的中心在原点，球从左侧射向墙
+    float Shoot(float speed, const glm::vec3& direction, bool continuous) {
+        PhysicsWorld3D world;
+        world.SetGravity(glm::vec3(0.0f));
+        world.SetTimeStep(1.0f / 60.0f);
+
+        auto wall = std::make_shared<Rigidbody3D>();
+        wall->SetMass(0.0f);
+        wall->SetCollider(std::make_shared<BoxCollider>(glm::vec3(WallThickness, 4.0f, 4.0f)));
+        world.AddRigidbody(wall);
+
+        auto sphere = std::make_shared<Rigidbody3D>();
+        sphere->SetCollider(std::make_shared<SphereCollider>(SphereRadius));
+        sphere->SetPosition(glm::vec3(-5.0f, 0.0f, 0.0f));
+        sphere->SetDrag(1.0f);
+        sphere->SetVelocity(glm::normalize(direction) * speed);
+        sphere->SetContinuousCollision(continuous);
+        world.AddRigidbody(sphere);
+
+        float maxX = sphere->GetPosition().x;
+        for (int step = 0; step < Steps; ++step) {
+            world.Step();
+            maxX = std::max(maxX, sphere->GetPosition().x);
+        }
+        return maxX;
+    }
+
+}
+
+int main() {
+    // 球面接触墙的左侧时球心的位置
+    const float limit = -WallThickness * 0.5f - SphereRadius + Slop;
+
+    for (float speed : { 50.0f, 300.0f, 1000.0f }) {
+        JFM_CHECK(Shoot(speed, glm::vec3(1.0f, 0.0f, 0.0f), true) < limit);
+        // 斜向射入，穿过墙的路径更长但每步位移仍远大于墙厚
+        JFM_CHECK(Shoot(speed, glm::vec3(1.0f, 0.2f, -0.3f), true) < limit);
+    }
+
+    // 对照：每步位移5米，是墙厚的50倍，离散检测会穿过
+    JFM_CHECK(Shoot(300.0f, glm::vec3(1.0f, 0.0f, 0.0f), false) > WallThickness);
+
+    return JFM_TEST_RESULT();
+}
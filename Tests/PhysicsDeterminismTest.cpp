@@ -0,0 +1,115 @@
+//
+// PhysicsDeterminismTest.cpp - 多线程求解的确定性
+// 同一场景在不同的JobSystem工作线程数下模拟相同步数，最终的ComputeStateHash必须一致；
+// 确定性模式下每一步的校验和序列也必须一致
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Core/JobSystem.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include <memory>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int ClusterCount = 40;
+    constexpr int BodiesPerCluster = 12;
+    constexpr int StepCount = 120;
+
+    // 把两个刚体拉向彼此的弹簧，只通过Rigidbody的setter修改所连接的刚体
+    class SpringJoint : public Joint {
+    public:
+        SpringJoint(std::shared_ptr<Rigidbody3D> bodyA, std::shared_ptr<Rigidbody3D> bodyB)
+            : Joint(SPRING, std::move(bodyA), std::move(bodyB)) {}
+
+        void UpdateConstraint(float deltaTime) override {
+            glm::vec3 impulse = (m_BodyB->GetPosition() - m_BodyA->GetPosition()) * (5.0f * deltaTime);
+            if (m_BodyA->GetInvMass() > 0.0f) {
+                m_BodyA->SetVelocity(m_BodyA->GetVelocity() + impulse);
+            }
+            if (m_BodyB->GetInvMass() > 0.0f) {
+                m_BodyB->SetVelocity(m_BodyB->GetVelocity() - impulse);
+            }
+        }
+    };
+
+    // 互相分开的若干堆物体，每堆是一个或多个模拟岛，部分物体之间用弹簧连接
+    void BuildScene(PhysicsWorld3D& world) {
+        auto ground = std::make_shared<Rigidbody3D>();
+        ground->SetMass(0.0f);
+        ground->SetCollider(std::make_shared<BoxCollider>(glm::vec3(400.0f, 1.0f, 400.0f)));
+        ground->SetPosition(glm::vec3(0.0f, -0.5f, 0.0f));
+        world.AddRigidbody(ground);
+
+        uint32_t seed = 7;
+        auto random = [&seed] {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 16777216.0f;
+        };
+
+        for (int cluster = 0; cluster < ClusterCount; ++cluster) {
+            glm::vec3 center((cluster % 8) * 12.0f - 48.0f, 0.0f, (cluster / 8) * 12.0f - 30.0f);
+            std::shared_ptr<Rigidbody3D> previous;
+            for (int i = 0; i < BodiesPerCluster; ++i) {
+                auto body = std::make_shared<Rigidbody3D>();
+                if (i % 2) {
+                    body->SetCollider(std::make_shared<SphereCollider>(0.3f + 0.2f * random()));
+                } else {
+                    body->SetCollider(std::make_shared<BoxCollider>(glm::vec3(0.5f + 0.5f * random())));
+                }
+                body->SetPosition(center + glm::vec3(random() * 2.0f - 1.0f, 1.0f + i * 1.1f, random() * 2.0f - 1.0f));
+                body->SetVelocity(glm::vec3(random() - 0.5f, 0.0f, random() - 0.5f));
+                world.AddRigidbody(body);
+
+                if (previous && i % 4 == 1) {
+                    world.AddJoint(std::make_shared<SpringJoint>(previous, body));
+                }
+                previous = body;
+            }
+        }
+    }
+
+    uint64_t Simulate(size_t workerCount, PhysicsStats& stats, std::vector<uint64_t>& checksums) {
+        JobSystem& jobs = JobSystem::GetInstance();
+        jobs.Shutdown();
+        jobs.Initialize(workerCount);
+
+        PhysicsWorld3D world;
+        world.SetDeterministic(true);
+        BuildScene(world);
+        checksums.clear();
+        for (int step = 0; step < StepCount; ++step) {
+            world.Step();
+            checksums.push_back(world.GetStepChecksum());
+        }
+        stats = world.GetStats();
+        JFM_CHECK(world.GetStepCount() == static_cast<uint64_t>(StepCount));
+        JFM_CHECK(world.GetStepChecksum() == world.ComputeStateHash());
+        return world.ComputeStateHash();
+    }
+
+}
+
+int main() {
+    PhysicsStats referenceStats;
+    std::vector<uint64_t> referenceChecksums;
+    const uint64_t reference = Simulate(0, referenceStats, referenceChecksums);
+    std::printf("PhysicsDeterminismTest: workers 0 hash %016llx islands %u\n",
+                static_cast<unsigned long long>(reference), referenceStats.IslandCount);
+    JFM_CHECK(referenceStats.IslandCount > 1);
+
+    for (size_t workers : {1, 2, 4, 8}) {
+        PhysicsStats stats;
+        std::vector<uint64_t> checksums;
+        const uint64_t hash = Simulate(workers, stats, checksums);
+        std::printf("PhysicsDeterminismTest: workers %zu hash %016llx\n", workers, static_cast<unsigned long long>(hash));
+        JFM_CHECK(hash == reference);
+        JFM_CHECK(stats.IslandCount == referenceStats.IslandCount);
+        JFM_CHECK(checksums == referenceChecksums);
+    }
+
+    JobSystem::GetInstance().Shutdown();
+    return JFM_TEST_RESULT();
+}
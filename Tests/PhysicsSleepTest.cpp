@@ -0,0 +1,119 @@
+//
+// PhysicsSleepTest.cpp - 休眠、唤醒和删除刚体
+// 检查醒着/休眠刚体的统计和活动列表的成员：全部休眠后活动列表为空，唤醒一个刚体只激活它所在的岛，
+// 删除刚体后活动列表不含失效的槽位，失去支撑的休眠刚体被唤醒
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int MaxSettleSteps = 600;
+
+    std::shared_ptr<Rigidbody3D> AddBox(PhysicsWorld3D& world, const glm::vec3& position) {
+        auto box = std::make_shared<Rigidbody3D>();
+        box->SetCollider(std::make_shared<BoxCollider>(glm::vec3(1.0f)));
+        box->SetPosition(position);
+        world.AddRigidbody(box);
+        return box;
+    }
+
+    // 活动列表中的刚体，按对象比较，与槽位的移动无关
+    bool ActiveBodiesAre(const PhysicsWorld3D& world, std::vector<const Rigidbody*> expected) {
+        const auto& bodies = world.GetRigidbodies();
+        std::vector<const Rigidbody*> active;
+        for (uint32_t slot : world.GetActiveBodies()) {
+            if (slot >= bodies.size()) {
+                return false;
+            }
+            active.push_back(bodies[slot].get());
+        }
+        std::sort(active.begin(), active.end());
+        std::sort(expected.begin(), expected.end());
+        return active == expected;
+    }
+
+    bool SettleUntilAsleep(PhysicsWorld3D& world, uint32_t dynamicBodies) {
+        for (int step = 0; step < MaxSettleSteps; ++step) {
+            world.Step();
+            if (world.GetStats().SleepingBodies == dynamicBodies) {
+                // 刚进入休眠的岛再同步一步包围盒，之后活动列表为空
+                world.Step();
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+int main() {
+    PhysicsWorld3D world;
+
+    auto ground = std::make_shared<Rigidbody3D>();
+    ground->SetMass(0.0f);
+    ground->SetCollider(std::make_shared<BoxCollider>(glm::vec3(100.0f, 1.0f, 100.0f)));
+    ground->SetPosition(glm::vec3(0.0f, -0.5f, 0.0f));
+    world.AddRigidbody(ground);
+
+    // 两个箱子叠成一个岛，另外两个各自成岛
+    auto stackBottom = AddBox(world, glm::vec3(0.0f, 0.5f, 0.0f));
+    auto stackTop = AddBox(world, glm::vec3(0.0f, 1.5f, 0.0f));
+    auto single = AddBox(world, glm::vec3(10.0f, 0.5f, 0.0f));
+    auto removed = AddBox(world, glm::vec3(20.0f, 0.5f, 0.0f));
+
+    // 全部休眠
+    JFM_CHECK(SettleUntilAsleep(world, 4));
+    JFM_CHECK(world.GetStats().AwakeBodies == 0);
+    JFM_CHECK(world.GetStats().SleepingBodies == 4);
+    JFM_CHECK(world.GetActiveBodies().empty());
+    JFM_CHECK(!stackBottom->IsAwake() && !stackTop->IsAwake() && !single->IsAwake() && !removed->IsAwake());
+
+    // 唤醒单独的箱子：激活列表记录它，下一步只有它所在的岛醒着
+    single->SetVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+    JFM_CHECK(single->IsAwake());
+    const auto& activated = world.GetRigidbodyStore().GetActivated();
+    JFM_CHECK(std::find(activated.begin(), activated.end(), world.GetRigidbodies().size() - 2) != activated.end());
+    world.Step();
+    JFM_CHECK(world.GetStats().AwakeBodies == 1);
+    JFM_CHECK(world.GetStats().SleepingBodies == 3);
+    JFM_CHECK(world.GetStats().ActiveBodies == 1);
+    JFM_CHECK(ActiveBodiesAre(world, {single.get()}));
+
+    // 唤醒上面的箱子，与它接触的下面的箱子随整个岛一起醒来
+    stackTop->SetVelocity(glm::vec3(0.0f, 0.1f, 0.0f));
+    world.Step();
+    JFM_CHECK(stackBottom->IsAwake() && stackTop->IsAwake());
+    JFM_CHECK(world.GetStats().AwakeBodies == 3);
+    JFM_CHECK(world.GetStats().SleepingBodies == 1);
+    JFM_CHECK(ActiveBodiesAre(world, {stackBottom.get(), stackTop.get(), single.get()}));
+
+    // 删除醒着的和休眠的刚体，最后一个槽位的刚体移入空出的槽位后仍在活动列表中
+    world.RemoveRigidbody(single);
+    world.RemoveRigidbody(removed);
+    JFM_CHECK(world.GetRigidbodies().size() == 3);
+    JFM_CHECK(ActiveBodiesAre(world, {stackBottom.get(), stackTop.get()}));
+    world.Step();
+    JFM_CHECK(world.GetStats().AwakeBodies == 2);
+    JFM_CHECK(world.GetStats().SleepingBodies == 0);
+    JFM_CHECK(ActiveBodiesAre(world, {stackBottom.get(), stackTop.get()}));
+
+    // 再次休眠后删除下面的箱子，失去支撑的箱子醒来并重新加入活动列表
+    JFM_CHECK(SettleUntilAsleep(world, 2));
+    JFM_CHECK(world.GetActiveBodies().empty());
+    world.RemoveRigidbody(stackBottom);
+    JFM_CHECK(stackTop->IsAwake());
+    world.Step();
+    JFM_CHECK(world.GetStats().AwakeBodies == 1);
+    JFM_CHECK(world.GetStats().SleepingBodies == 0);
+    JFM_CHECK(ActiveBodiesAre(world, {stackTop.get()}));
+    JFM_CHECK(stackTop->GetPosition().y < 1.5f);
+
+    return JFM_TEST_RESULT();
+}
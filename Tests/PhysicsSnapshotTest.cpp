@@ -0,0 +1,103 @@
+//
+// PhysicsSnapshotTest.cpp - 快照回滚后重新模拟
+// 回退到历史中的某一帧再继续模拟，每一步的校验和必须与第一次模拟时逐位一致
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include "JFMEngine/Physics/PhysicsSnapshot.h"
+#include <memory>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int BodyCount = 800;
+    constexpr int StepCount = 150;
+    constexpr uint32_t HistoryFrames = 60;
+
+    void BuildScene(PhysicsWorld3D& world) {
+        auto ground = std::make_shared<Rigidbody3D>();
+        ground->SetMass(0.0f);
+        ground->SetCollider(std::make_shared<BoxCollider>(glm::vec3(200.0f, 1.0f, 200.0f)));
+        ground->SetPosition(glm::vec3(0.0f, -0.5f, 0.0f));
+        world.AddRigidbody(ground);
+
+        uint32_t seed = 11;
+        auto random = [&seed] {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 16777216.0f;
+        };
+
+        for (int i = 0; i < BodyCount; ++i) {
+            auto body = std::make_shared<Rigidbody3D>();
+            if (i % 2) {
+                body->SetCollider(std::make_shared<SphereCollider>(0.3f + 0.2f * random()));
+            } else {
+                body->SetCollider(std::make_shared<BoxCollider>(glm::vec3(0.5f + 0.5f * random())));
+            }
+            body->SetPosition(glm::vec3(random() * 40.0f - 20.0f, 1.0f + random() * 8.0f, random() * 40.0f - 20.0f));
+            body->SetVelocity(glm::vec3(random() * 3.0f, 0.0f, random() * 3.0f));
+            world.AddRigidbody(body);
+        }
+    }
+
+    // 从当前帧继续模拟到StepCount，与第一次模拟的校验和逐步比较
+    bool Resimulate(PhysicsWorld3D& world, PhysicsHistory& history, const std::vector<uint64_t>& checksums) {
+        bool matches = true;
+        while (world.GetStepCount() < static_cast<uint64_t>(StepCount)) {
+            world.Step();
+            history.Record(world);
+            matches = matches && world.GetStepChecksum() == checksums[world.GetStepCount() - 1];
+        }
+        return matches;
+    }
+
+}
+
+int main() {
+    PhysicsWorld3D world;
+    world.SetDeterministic(true);
+    BuildScene(world);
+
+    PhysicsHistory history(HistoryFrames);
+    std::vector<uint64_t> checksums;
+    for (int step = 0; step < StepCount; ++step) {
+        world.Step();
+        history.Record(world);
+        checksums.push_back(world.GetStepChecksum());
+    }
+    JFM_CHECK(history.GetFrameCount() == HistoryFrames);
+
+    // 回退后恢复的帧成为最新一帧，步数和校验和都回到当时的值
+    for (uint32_t framesBack : {1u, 10u, HistoryFrames - 1}) {
+        JFM_CHECK(history.Rewind(world, framesBack));
+        const uint64_t step = world.GetStepCount();
+        JFM_CHECK(step == static_cast<uint64_t>(StepCount) - framesBack);
+        JFM_CHECK(world.GetStepChecksum() == checksums[step - 1]);
+        JFM_CHECK(world.ComputeStateHash() == checksums[step - 1]);
+
+        const bool matches = Resimulate(world, history, checksums);
+        std::printf("PhysicsSnapshotTest: rewind %u frames from step %d, resimulation %s\n",
+                    framesBack, StepCount, matches ? "matches" : "diverged");
+        JFM_CHECK(matches);
+    }
+
+    // 超出历史长度时失败，世界保持不变
+    const uint64_t hashBefore = world.ComputeStateHash();
+    JFM_CHECK(!history.Rewind(world, HistoryFrames));
+    JFM_CHECK(world.ComputeStateHash() == hashBefore);
+
+    // 直接保存和恢复单个快照
+    PhysicsSnapshot snapshot;
+    world.SaveSnapshot(snapshot);
+    for (int step = 0; step < 10; ++step) {
+        world.Step();
+    }
+    JFM_CHECK(world.RestoreSnapshot(snapshot));
+    JFM_CHECK(world.ComputeStateHash() == hashBefore);
+    JFM_CHECK(world.GetStepCount() == static_cast<uint64_t>(StepCount));
+
+    return JFM_TEST_RESULT();
+}
@@ -0,0 +1,95 @@
+//
+// PhysicsStackTest.cpp - 箱子堆叠的稳定性
+// 8个箱子叠在地面上，关闭休眠，分别用4次和8次速度迭代模拟10秒：
+// 堆叠稳定后不再下沉或水平漂移，穿透不超过允许值，速度保持接近0
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/Physics3D.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr int BoxCount = 8;
+    constexpr int SettleSteps = 120;    // 2秒
+    constexpr int MeasuredSteps = 480;  // 之后的8秒
+
+    // 稳定后各箱子的位置变化，以及相对理想静止位置的偏差
+    constexpr float MaxDrift = 0.01f;
+    constexpr float MaxSink = 0.05f;
+    constexpr float MaxSpeed = 0.05f;
+
+    void RunStack(int iterations) {
+        PhysicsWorld3D world;
+        world.SetSleepingEnabled(false);
+        world.SetSolverIterations(iterations);
+
+        auto ground = std::make_shared<Rigidbody3D>();
+        ground->SetMass(0.0f);
+        ground->SetCollider(std::make_shared<BoxCollider>(glm::vec3(100.0f, 1.0f, 100.0f)));
+        ground->SetPosition(glm::vec3(0.0f, -0.5f, 0.0f));
+        world.AddRigidbody(ground);
+
+        // 箱子之间留一点间隙，落下后形成堆叠
+        std::vector<std::shared_ptr<Rigidbody3D>> boxes;
+        for (int i = 0; i < BoxCount; ++i) {
+            auto box = std::make_shared<Rigidbody3D>();
+            box->SetCollider(std::make_shared<BoxCollider>(glm::vec3(1.0f)));
+            box->SetPosition(glm::vec3(0.0f, 0.5f + 1.01f * static_cast<float>(i), 0.0f));
+            world.AddRigidbody(box);
+            boxes.push_back(box);
+        }
+
+        for (int step = 0; step < SettleSteps; ++step) {
+            world.Step();
+        }
+
+        std::vector<glm::vec3> settled;
+        for (const auto& box : boxes) {
+            settled.push_back(box->GetPosition());
+        }
+
+        float maxDrift = 0.0f;
+        float maxSpeed = 0.0f;
+        for (int step = 0; step < MeasuredSteps; ++step) {
+            world.Step();
+            for (int i = 0; i < BoxCount; ++i) {
+                maxDrift = std::max(maxDrift, glm::length(boxes[i]->GetPosition() - settled[i]));
+                maxSpeed = std::max(maxSpeed, glm::length(boxes[i]->GetVelocity()));
+            }
+        }
+
+        float maxSink = 0.0f;
+        float maxHorizontal = 0.0f;
+        for (int i = 0; i < BoxCount; ++i) {
+            const glm::vec3 position = boxes[i]->GetPosition();
+            maxSink = std::max(maxSink, std::abs(position.y - (0.5f + static_cast<float>(i))));
+            maxHorizontal = std::max(maxHorizontal, std::sqrt(position.x * position.x + position.z * position.z));
+        }
+
+        std::printf("  %d iterations: drift %.5f  sink %.5f  horizontal %.5f  speed %.5f\n",
+                    iterations, maxDrift, maxSink, maxHorizontal, maxSpeed);
+        JFM_CHECK(maxDrift < MaxDrift);
+        JFM_CHECK(maxSink < MaxSink);
+        JFM_CHECK(maxHorizontal < MaxDrift);
+        JFM_CHECK(maxSpeed < MaxSpeed);
+
+        // 堆叠的顺序不变，相邻箱子之间的距离接近边长
+        for (int i = 1; i < BoxCount; ++i) {
+            const float gap = boxes[i]->GetPosition().y - boxes[i - 1]->GetPosition().y;
+            JFM_CHECK(std::abs(gap - 1.0f) < MaxSink);
+        }
+    }
+
+}
+
+int main() {
+    RunStack(4);
+    RunStack(8);
+    return JFM_TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+//
+// RecordingRendererAPITest.cpp - 命令流记录
+// 直接调用和执行命令缓冲都按顺序保存为相同格式的命令流；uniform名字按ID记录，不引用调用方的字符串
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Renderer/NullRendererAPI.h"
+#include "JFMEngine/Renderer/RenderCommand.h"
+#include "JFMEngine/Renderer/VertexArray.h"
+#include <string>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    // 没有索引缓冲的顶点数组，RecordingRendererAPI只比较地址
+    class TestVertexArray : public VertexArray {
+    public:
+        void Bind() const override {}
+        void Unbind() const override {}
+        void AddVertexBuffer(const std::shared_ptr<VertexBuffer>& /*vertexBuffer*/) override {}
+        void SetIndexBuffer(const std::shared_ptr<IndexBuffer>& /*indexBuffer*/) override {}
+        const std::vector<std::shared_ptr<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
+        const std::shared_ptr<IndexBuffer>& GetIndexBuffer() const override { return m_IndexBuffer; }
+
+    private:
+        std::vector<std::shared_ptr<VertexBuffer>> m_VertexBuffers;
+        std::shared_ptr<IndexBuffer> m_IndexBuffer;
+    };
+
+    // 伪对象：命令只保存地址，不访问对象
+    char s_Objects[2];
+    Shader* const s_Shader = reinterpret_cast<Shader*>(&s_Objects[0]);
+    const Mesh* const s_Mesh = reinterpret_cast<const Mesh*>(&s_Objects[1]);
+
+    std::vector<const CommandHeader*> Collect(const RecordingRendererAPI& api) {
+        std::vector<const CommandHeader*> headers;
+        api.ForEach([&](const CommandHeader& header) { headers.push_back(&header); });
+        return headers;
+    }
+
+    template<typename T>
+    const T* As(const CommandHeader* header) {
+        return header->Type == T::Type ? &CommandBuffer::GetCommand<T>(*header) : nullptr;
+    }
+
+    void TestUniformName() {
+        std::string source = "u_Test.value";
+        UniformName name(source.c_str());
+        source.assign("u_Other");
+
+        JFM_CHECK(name.GetString() == "u_Test.value");
+        JFM_CHECK(UniformName("u_Test.value") == name);
+        JFM_CHECK(UniformName(source.c_str()) != name);
+        JFM_CHECK(UniformName().GetString().empty());
+        JFM_CHECK(UniformName("") == UniformName());
+    }
+
+    void TestDirectCalls() {
+        RecordingRendererAPI api;
+        TestVertexArray vertexArray;
+        auto sharedVertexArray = std::make_shared<TestVertexArray>();
+
+        api.SetViewport(1, 2, 640, 480);
+        api.SetClearColor(glm::vec4(0.1f, 0.2f, 0.3f, 1.0f));
+        api.Clear();
+        api.SetPolygonMode(PolygonMode::Line);
+        api.DrawIndexed(vertexArray, 36);
+        api.DrawArrays(vertexArray, 3);
+        api.DrawIndexed(sharedVertexArray);  // 没有索引缓冲，不记录
+        api.DrawArrays(sharedVertexArray, 6);
+
+        JFM_CHECK(api.GetCommandCount() == 7);
+        JFM_CHECK(api.GetExecuteCount() == 0);
+        JFM_CHECK(api.GetCommandCount(CommandType::DrawArrays) == 2);
+        JFM_CHECK(api.GetCommandCount(CommandType::DrawIndexed) == 1);
+
+        const auto headers = Collect(api);
+        JFM_CHECK(headers.size() == 7);
+        if (headers.size() != 7) {
+            return;
+        }
+
+        const auto* viewport = As<Commands::SetViewport>(headers[0]);
+        JFM_CHECK(viewport && viewport->X == 1 && viewport->Y == 2 && viewport->Width == 640 && viewport->Height == 480);
+        const auto* clearColor = As<Commands::SetClearColor>(headers[1]);
+        JFM_CHECK(clearColor && clearColor->Color == glm::vec4(0.1f, 0.2f, 0.3f, 1.0f));
+        JFM_CHECK(headers[2]->Type == CommandType::Clear && headers[2]->Size == sizeof(CommandHeader));
+        const auto* polygonMode = As<Commands::SetPolygonMode>(headers[3]);
+        JFM_CHECK(polygonMode && polygonMode->Mode == PolygonMode::Line);
+        const auto* drawIndexed = As<Commands::DrawIndexed>(headers[4]);
+        JFM_CHECK(drawIndexed && drawIndexed->VertexArray == &vertexArray && drawIndexed->IndexCount == 36);
+        const auto* drawArrays = As<Commands::DrawArrays>(headers[5]);
+        JFM_CHECK(drawArrays && drawArrays->VertexArray == &vertexArray && drawArrays->VertexCount == 3);
+        const auto* sharedDrawArrays = As<Commands::DrawArrays>(headers[6]);
+        JFM_CHECK(sharedDrawArrays && sharedDrawArrays->VertexArray == sharedVertexArray.get() && sharedDrawArrays->VertexCount == 6);
+
+        api.Reset();
+        JFM_CHECK(api.GetCommandCount() == 0);
+        JFM_CHECK(api.GetCommands().empty());
+        JFM_CHECK(api.GetCommandCount(CommandType::DrawArrays) == 0);
+    }
+
+    void TestExecute() {
+        const glm::mat4 model(2.0f);
+        MaterialProperties properties;
+        properties.Shininess = 8.0f;
+        properties.Opacity = 0.5f;
+
+        CommandBuffer commands;
+        {
+            // 名字字符串在记录后释放，命令流中只有ID
+            std::string name = "u_ModelMatrix";
+            commands.Record(Commands::BindShader{s_Shader});
+            commands.Record(Commands::SetMat4{s_Shader, UniformName(name.c_str()), model});
+            commands.Record(Commands::SetFloat{s_Shader, UniformName("u_Exposure"), 1.5f});
+            commands.Record(Commands::SetFloat3{s_Shader, UniformName("u_ViewPos"), glm::vec3(1.0f, 2.0f, 3.0f)});
+            commands.Record(Commands::BindMaterial{s_Shader, properties});
+            commands.Record(Commands::DrawMesh{s_Mesh, 36, 24});
+        }
+
+        RecordingRendererAPI api;
+        api.Clear();
+        api.Execute(commands);
+        api.Execute(commands);
+
+        JFM_CHECK(api.GetExecuteCount() == 2);
+        JFM_CHECK(api.GetCommandCount() == 1 + 2 * commands.GetCommandCount());
+        JFM_CHECK(api.GetCommandCount(CommandType::DrawMesh) == 2);
+        JFM_CHECK(api.GetCommandCount(CommandType::SetMat4) == 2);
+        JFM_CHECK(api.GetCommands().size() == 1 + 2 * commands.GetSizeInWords());
+
+        const auto headers = Collect(api);
+        JFM_CHECK(headers.size() == 13);
+        if (headers.size() != 13) {
+            return;
+        }
+        JFM_CHECK(headers[0]->Type == CommandType::Clear);
+
+        // 两次执行的命令流相同
+        for (size_t pass = 0; pass < 2; ++pass) {
+            const CommandHeader* const* stream = &headers[1 + pass * 6];
+
+            const auto* bindShader = As<Commands::BindShader>(stream[0]);
+            JFM_CHECK(bindShader && bindShader->Shader == s_Shader);
+
+            const auto* setMat4 = As<Commands::SetMat4>(stream[1]);
+            JFM_CHECK(setMat4 && setMat4->Shader == s_Shader && setMat4->Value == model);
+            JFM_CHECK(setMat4 && setMat4->Name.GetString() == "u_ModelMatrix");
+
+            const auto* setFloat = As<Commands::SetFloat>(stream[2]);
+            JFM_CHECK(setFloat && setFloat->Name == UniformName("u_Exposure") && setFloat->Value == 1.5f);
+
+            const auto* setFloat3 = As<Commands::SetFloat3>(stream[3]);
+            JFM_CHECK(setFloat3 && setFloat3->Name.GetString() == "u_ViewPos" && setFloat3->Value == glm::vec3(1.0f, 2.0f, 3.0f));
+
+            const auto* bindMaterial = As<Commands::BindMaterial>(stream[4]);
+            JFM_CHECK(bindMaterial && bindMaterial->Shader == s_Shader);
+            JFM_CHECK(bindMaterial && bindMaterial->Properties.Shininess == 8.0f && bindMaterial->Properties.Opacity == 0.5f);
+
+            const auto* drawMesh = As<Commands::DrawMesh>(stream[5]);
+            JFM_CHECK(drawMesh && drawMesh->Mesh == s_Mesh && drawMesh->IndexCount == 36 && drawMesh->VertexCount == 24);
+        }
+    }
+
+}
+
+int main() {
+    TestUniformName();
+    TestDirectCalls();
+    TestExecute();
+    return JFM_TEST_RESULT();
+}
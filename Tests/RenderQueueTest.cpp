@@ -0,0 +1,327 @@
+//
+// RenderQueueTest.cpp - 排序键和渲染队列
+// 基数排序与std::stable_sort结果一致；排序后不透明物体在前并按状态合批、由近到远，
+// 半透明物体由远到近；状态切换计数；非法深度；队列保留提交对象的所有权；
+// 分段归并与整体归并结果一致；预热后每帧的Reset/Push/Sort不再访问堆
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Renderer/RenderQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace {
+    std::atomic<size_t> s_HeapAllocations{0};
+}
+
+void* operator new(size_t size) {
+    s_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+// std::stable_sort的临时缓冲使用nothrow版本，同样替换以与下面的delete配对
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    s_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+using namespace JFM;
+
+namespace {
+
+    // 伪对象：RenderQueue只比较地址，不访问对象
+    char s_Shaders[8];
+    char s_Materials[64];
+    char s_Meshes[128];
+
+    Shader* FakeShader(uint32_t index) { return reinterpret_cast<Shader*>(&s_Shaders[index]); }
+    const Material* FakeMaterial(uint32_t index) { return reinterpret_cast<const Material*>(&s_Materials[index]); }
+    const Mesh* FakeMesh(uint32_t index) { return reinterpret_cast<const Mesh*>(&s_Meshes[index]); }
+
+    struct Submission {
+        uint32_t Shader, Material, Mesh;
+        float Depth;
+        bool Transparent;
+    };
+
+    bool SameOrder(const RenderQueueEntry* a, const std::vector<RenderQueueEntry>& b) {
+        for (size_t i = 0; i < b.size(); ++i) {
+            if (a[i].Key != b[i].Key || a[i].Item != b[i].Item) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestRadixSort() {
+        std::mt19937_64 rng(3);
+        for (size_t count : {0, 1, 2, 100, 5000}) {
+            // 随机键、只有少数取值的键（大量相同，检验稳定性）和只有低字节不同的键
+            for (int pattern = 0; pattern < 3; ++pattern) {
+                std::vector<RenderQueueEntry> entries(count);
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t key = rng();
+                    if (pattern == 1) key %= 7;
+                    if (pattern == 2) key = (0xABCDull << 48) | (key & 0xFF);
+                    entries[i] = {key, static_cast<uint32_t>(i)};
+                }
+
+                std::vector<RenderQueueEntry> expected = entries;
+                std::stable_sort(expected.begin(), expected.end(),
+                                 [](const RenderQueueEntry& a, const RenderQueueEntry& b) { return a.Key < b.Key; });
+
+                std::vector<RenderQueueEntry> scratch(count);
+                const RenderQueueEntry* sorted = RadixSort(entries.data(), scratch.data(), count);
+                JFM_CHECK(SameOrder(sorted, expected));
+            }
+        }
+    }
+
+    void TestOrdering() {
+        FrameArena& arena = FrameArena::GetInstance();
+        arena.BeginFrame();
+
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Submission> submissions(20000);
+        for (Submission& s : submissions) {
+            s = {static_cast<uint32_t>(rng() % 8), static_cast<uint32_t>(rng() % 64), static_cast<uint32_t>(rng() % 128),
+                 unit(rng), false};
+            s.Transparent = s.Material % 8 == 0;
+        }
+
+        RenderQueue queue;
+        queue.Reset();
+        for (const Submission& s : submissions) {
+            RenderItem item;
+            item.Shader = FakeShader(s.Shader);
+            item.Material = FakeMaterial(s.Material);
+            item.Mesh = FakeMesh(s.Mesh);
+            uint64_t key = s.Transparent
+                ? RenderSortKey::Transparent(RenderPass::Main, s.Shader + 1, s.Material + 1, s.Mesh + 1, s.Depth)
+                : RenderSortKey::Opaque(RenderPass::Main, s.Shader + 1, s.Material + 1, s.Mesh + 1, s.Depth);
+            queue.Push(key, item);
+        }
+
+        const RenderStateChanges unsorted = queue.CountStateChanges();
+        std::vector<RenderQueueEntry> expected(queue.GetEntries().begin(), queue.GetEntries().end());
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const RenderQueueEntry& a, const RenderQueueEntry& b) { return a.Key < b.Key; });
+        queue.Sort();
+        JFM_CHECK(queue.GetSize() == expected.size());
+        JFM_CHECK(SameOrder(queue.GetEntries().data(), expected));
+
+        const auto& entries = queue.GetEntries();
+        size_t firstTransparent = 0;
+        while (firstTransparent < entries.size() && !RenderSortKey::IsTransparent(entries[firstTransparent].Key)) {
+            ++firstTransparent;
+        }
+
+        // 半透明物体全部在不透明物体之后，由远到近（允许24位量化误差）
+        for (size_t i = firstTransparent; i < entries.size(); ++i) {
+            JFM_CHECK(RenderSortKey::IsTransparent(entries[i].Key));
+            JFM_CHECK(submissions[entries[i].Item].Transparent);
+            if (i > firstTransparent) {
+                JFM_CHECK(submissions[entries[i].Item].Depth <= submissions[entries[i - 1].Item].Depth + 1e-6f);
+            }
+        }
+
+        // 不透明物体按状态分组，同一组内由近到远（允许16位量化误差），每个着色器只绑定一次
+        uint32_t opaqueShaderChanges = firstTransparent > 0 ? 1 : 0;
+        for (size_t i = 1; i < firstTransparent; ++i) {
+            const Submission& a = submissions[entries[i - 1].Item];
+            const Submission& b = submissions[entries[i].Item];
+            JFM_CHECK(!a.Transparent && !b.Transparent);
+            opaqueShaderChanges += a.Shader != b.Shader ? 1 : 0;
+            if (a.Shader == b.Shader && a.Material == b.Material && a.Mesh == b.Mesh) {
+                JFM_CHECK(b.Depth + 1e-4f >= a.Depth);
+            }
+        }
+        JFM_CHECK(opaqueShaderChanges <= 8);
+
+        const RenderStateChanges sorted = queue.CountStateChanges();
+        JFM_CHECK(sorted.Shader < unsorted.Shader);
+        JFM_CHECK(sorted.Material < unsorted.Material);
+        JFM_CHECK(sorted.Mesh < unsorted.Mesh);
+    }
+
+    void TestCountStateChanges() {
+        FrameArena::GetInstance().BeginFrame();
+        RenderQueue queue;
+        queue.Reset();
+
+        // 着色器切换后材质需要重新绑定，即使材质与之前相同
+        const uint32_t items[][3] = {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {1, 1, 1}};
+        uint64_t key = 0;
+        for (const auto& item : items) {
+            RenderItem renderItem;
+            renderItem.Shader = FakeShader(item[0]);
+            renderItem.Material = FakeMaterial(item[1]);
+            renderItem.Mesh = FakeMesh(item[2]);
+            queue.Push(key++, renderItem);
+        }
+        queue.Sort();
+
+        const RenderStateChanges changes = queue.CountStateChanges();
+        JFM_CHECK(changes.Shader == 2);
+        JFM_CHECK(changes.Material == 3);
+        JFM_CHECK(changes.Mesh == 2);
+    }
+
+    void TestInvalidDepth() {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        const float infinity = std::numeric_limits<float>::infinity();
+        JFM_CHECK(RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, nan) == RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, 0.0f));
+        JFM_CHECK(RenderSortKey::Transparent(RenderPass::Main, 1, 2, 3, nan) ==
+                  RenderSortKey::Transparent(RenderPass::Main, 1, 2, 3, 0.0f));
+        JFM_CHECK(RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, -infinity) == RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, 0.0f));
+        JFM_CHECK(RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, infinity) == RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, 1.0f));
+        JFM_CHECK(RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, 2.0f) == RenderSortKey::Opaque(RenderPass::Main, 1, 2, 3, 1.0f));
+    }
+
+    // 队列的条目和排序缓冲在帧内存上，预热后每帧不再申请堆内存或新的帧内存块
+    void TestSteadyStateAllocations() {
+        FrameArena& arena = FrameArena::GetInstance();
+        RenderQueue queue;
+        RenderItem item;
+        auto simulateFrame = [&] {
+            arena.BeginFrame();
+            queue.Reset();
+            for (uint32_t i = 0; i < 5000; ++i) {
+                uint64_t key = RenderSortKey::Opaque(RenderPass::Main, i % 7, i % 13, i % 31, (i % 100) / 100.0f);
+                queue.Push(key, item);
+            }
+            queue.Sort();
+            JFM_CHECK(queue.GetSize() == 5000);
+        };
+
+        for (int frame = 0; frame < 10; ++frame) {
+            simulateFrame();
+        }
+
+        const size_t chunksBefore = arena.GetStats().ChunkAllocations;
+        const size_t allocationsBefore = s_HeapAllocations.load();
+        for (int frame = 0; frame < 100; ++frame) {
+            simulateFrame();
+        }
+        JFM_CHECK(s_HeapAllocations.load() == allocationsBefore);
+        JFM_CHECK(arena.GetStats().ChunkAllocations == chunksBefore);
+    }
+
+    void TestRetain() {
+        FrameArena::GetInstance().BeginFrame();
+        RenderQueue queue;
+        queue.Reset();
+        RenderCommandList list;
+
+        // 提交临时对象后只有队列持有引用，清空前一直有效
+        std::weak_ptr<int> queued;
+        {
+            auto object = std::make_shared<int>(1);
+            queued = object;
+            queue.Retain(object);
+            queue.Retain(object);
+        }
+        JFM_CHECK(!queued.expired());
+        JFM_CHECK(queued.use_count() == 1);
+
+        queue.Reset();
+        JFM_CHECK(queued.expired());
+
+        auto object = std::make_shared<int>(2);
+        std::weak_ptr<int> listed = object;
+        list.Retain(object);
+        object.reset();
+        JFM_CHECK(!listed.expired());
+        list.Clear();
+        JFM_CHECK(listed.expired());
+    }
+
+    // 按归并顺序依次得到的元素，用地址区分键相同的元素
+    struct MergedEntry {
+        const RenderQueueEntry* Entry;
+        const RenderItem* Item;
+        bool operator==(const MergedEntry& other) const { return Entry == other.Entry && Item == other.Item; }
+    };
+
+    void TestSplitMerge() {
+        std::mt19937 rng(9);
+        for (size_t queueCount : {1, 3, 8}) {
+            // 键的取值很少，各队列之间和队列内部都有大量相同的键；部分队列为空
+            std::vector<RenderCommandList> lists(queueCount);
+            for (size_t q = 0; q < queueCount; ++q) {
+                const size_t count = q % 3 == 2 ? 0 : 500 + rng() % 2000;
+                for (size_t i = 0; i < count; ++i) {
+                    RenderItem item;
+                    item.Shader = FakeShader(rng() % 8);
+                    lists[q].Push(rng() % 300, item);
+                }
+                lists[q].Sort();
+            }
+
+            std::vector<RenderQueueView> views;
+            for (const RenderCommandList& list : lists) {
+                views.push_back(list.GetView());
+            }
+
+            std::vector<MergedEntry> expected;
+            MergeRenderQueues(views.data(), views.size(), [&](const RenderQueueEntry& entry, const RenderItem& item) {
+                expected.push_back({&entry, &item});
+            });
+
+            for (size_t segmentCount : {1, 2, 3, 4, 7, 16, 64, 1000}) {
+                std::vector<RenderQueueView> segments(segmentCount * queueCount);
+                std::vector<const RenderItem*> previous(segmentCount);
+                SplitRenderQueues(views.data(), queueCount, segmentCount, segments.data(), previous.data());
+
+                std::vector<MergedEntry> merged;
+                for (size_t segment = 0; segment < segmentCount; ++segment) {
+                    // 起始状态为整体归并中该段之前的最后一个元素
+                    JFM_CHECK(previous[segment] == (merged.empty() ? nullptr : merged.back().Item));
+
+                    const size_t begin = merged.size();
+                    MergeRenderQueues(&segments[segment * queueCount], queueCount,
+                                      [&](const RenderQueueEntry& entry, const RenderItem& item) {
+                                          merged.push_back({&entry, &item});
+                                      });
+
+                    // 键相同的元素不跨段
+                    if (begin > 0 && merged.size() > begin) {
+                        JFM_CHECK(merged[begin - 1].Entry->Key < merged[begin].Entry->Key);
+                    }
+                }
+                JFM_CHECK(merged == expected);
+            }
+        }
+    }
+
+}
+
+int main() {
+    TestRadixSort();
+    TestOrdering();
+    TestCountStateChanges();
+    TestInvalidDepth();
+    TestSteadyStateAllocations();
+    TestRetain();
+    TestSplitMerge();
+    return JFM_TEST_RESULT();
+}
@@ -0,0 +1,26 @@
+//
+// TestCommon.h - 测试用的断言宏
+//
+
+#pragma once
+
+#include <cstdio>
+
+namespace JFM::Test {
+    inline int& FailureCount() {
+        static int count = 0;
+        return count;
+    }
+}
+
+// 失败时打印位置并计数，不中断测试，main最后返回JFM_TEST_RESULT()
+#define JFM_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ::JFM::Test::FailureCount()++; \
+        } \
+    } while (0)
+
+#define JFM_TEST_RESULT() \
+    (::JFM::Test::FailureCount() == 0 ? (std::printf("passed\n"), 0) : (std::printf("%d check(s) failed\n", ::JFM::Test::FailureCount()), 1))
@@ -0,0 +1,286 @@
+//
+// TriangleBVHTest.cpp - 三角形BVH的序列化与查询
+// 序列化后加载得到相同的结构和查询结果；截断或损坏的数据被拒绝，不会越界或死循环；
+// 随机网格上的射线和包围盒查询与逐个三角形的暴力结果一致
+//
+
+#include "TestCommon.h"
+#include "JFMEngine/Physics/TriangleBVH.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace JFM;
+
+namespace {
+
+    constexpr float DistanceTolerance = 1e-4f;
+
+    struct TestMesh {
+        std::vector<glm::vec3> Vertices;
+        std::vector<uint32_t> Indices;
+    };
+
+    // 起伏的地形网格加上散落的随机三角形，既有规则结构也有大小不一的重叠三角形
+    TestMesh MakeRandomMesh(uint32_t seed) {
+        TestMesh mesh;
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> height(-1.0f, 1.0f);
+
+        constexpr uint32_t GridSize = 24;
+        for (uint32_t z = 0; z <= GridSize; ++z) {
+            for (uint32_t x = 0; x <= GridSize; ++x) {
+                mesh.Vertices.emplace_back(static_cast<float>(x) - 12.0f, height(rng), static_cast<float>(z) - 12.0f);
+            }
+        }
+        for (uint32_t z = 0; z < GridSize; ++z) {
+            for (uint32_t x = 0; x < GridSize; ++x) {
+                uint32_t i = z * (GridSize + 1) + x;
+                mesh.Indices.insert(mesh.Indices.end(), { i, i + GridSize + 1, i + 1, i + 1, i + GridSize + 1, i + GridSize + 2 });
+            }
+        }
+
+        std::uniform_real_distribution<float> position(-12.0f, 12.0f);
+        std::uniform_real_distribution<float> offset(-1.5f, 1.5f);
+        for (int t = 0; t < 600; ++t) {
+            glm::vec3 center(position(rng), position(rng) * 0.5f + 3.0f, position(rng));
+            uint32_t first = static_cast<uint32_t>(mesh.Vertices.size());
+            for (int v = 0; v < 3; ++v) {
+                mesh.Vertices.push_back(center + glm::vec3(offset(rng), offset(rng), offset(rng)));
+            }
+            mesh.Indices.insert(mesh.Indices.end(), { first, first + 1, first + 2 });
+        }
+        return mesh;
+    }
+
+    std::string SerializeToString(const TriangleBVH& bvh) {
+        std::ostringstream out(std::ios::binary);
+        bvh.Serialize(out);
+        return out.str();
+    }
+
+    bool DeserializeFromString(TriangleBVH& bvh, const std::string& data) {
+        std::istringstream in(data, std::ios::binary);
+        return bvh.Deserialize(in);
+    }
+
+    // 查询不会越界：射线和包围盒查询报告的三角形都在范围内
+    bool QueriesStayInRange(const TriangleBVH& bvh) {
+        bool valid = true;
+        MeshHit hit;
+        bvh.Raycast(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), 100.0f, hit);
+        bvh.Query(AABB(glm::vec3(-100.0f), glm::vec3(100.0f)), [&](uint32_t triangle) {
+            valid = valid && triangle < bvh.GetTriangleCount();
+            return true;
+        });
+        return valid;
+    }
+
+    void TestRoundTrip(const TestMesh& mesh) {
+        TriangleBVH bvh(mesh.Vertices, mesh.Indices);
+        const std::string data = SerializeToString(bvh);
+
+        TriangleBVH loaded;
+        JFM_CHECK(DeserializeFromString(loaded, data));
+        JFM_CHECK(loaded.GetTriangleCount() == bvh.GetTriangleCount());
+        JFM_CHECK(loaded.GetNodeCount() == bvh.GetNodeCount());
+        JFM_CHECK(loaded.GetBounds().Min == bvh.GetBounds().Min && loaded.GetBounds().Max == bvh.GetBounds().Max);
+        // 再次序列化得到完全相同的字节
+        JFM_CHECK(SerializeToString(loaded) == data);
+
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+        for (int i = 0; i < 500; ++i) {
+            glm::vec3 origin(position(rng), position(rng), position(rng));
+            glm::vec3 direction = glm::normalize(glm::vec3(position(rng), position(rng), position(rng)) - origin);
+            MeshHit expected, actual;
+            bool expectedHit = bvh.Raycast(origin, direction, 50.0f, expected);
+            bool actualHit = loaded.Raycast(origin, direction, 50.0f, actual);
+            JFM_CHECK(expectedHit == actualHit);
+            JFM_CHECK(!expectedHit || (expected.Triangle == actual.Triangle && expected.Distance == actual.Distance));
+        }
+
+        // 文件读写
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "jfm_triangle_bvh_test.bin";
+        JFM_CHECK(bvh.SaveToFile(path.string()));
+        TriangleBVH fromFile;
+        JFM_CHECK(fromFile.LoadFromFile(path.string()));
+        JFM_CHECK(SerializeToString(fromFile) == data);
+
+        // 截断的文件和不存在的文件
+        {
+            std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+            file.write(data.data(), static_cast<std::streamsize>(data.size() / 2));
+        }
+        JFM_CHECK(!fromFile.LoadFromFile(path.string()));
+        JFM_CHECK(fromFile.IsEmpty());
+        std::filesystem::remove(path);
+        JFM_CHECK(!fromFile.LoadFromFile(path.string()));
+    }
+
+    void TestRejectsCorruptData(const TestMesh& mesh) {
+        TriangleBVH bvh(mesh.Vertices, mesh.Indices);
+        const std::string data = SerializeToString(bvh);
+
+        // 每一种截断长度都被拒绝，加载失败后为空
+        std::mt19937 rng(4);
+        for (size_t length = 0; length < data.size(); length += 1 + rng() % 97) {
+            TriangleBVH loaded;
+            JFM_CHECK(!DeserializeFromString(loaded, data.substr(0, length)));
+            JFM_CHECK(loaded.IsEmpty());
+        }
+
+        // 头部：标识和版本
+        for (size_t offset : { size_t(0), size_t(4) }) {
+            std::string corrupt = data;
+            corrupt[offset] ^= 0x5A;
+            TriangleBVH loaded;
+            JFM_CHECK(!DeserializeFromString(loaded, corrupt));
+        }
+
+        // 数组长度超出数据：不应尝试分配巨大的内存
+        const size_t headerSize = sizeof(uint32_t) * 3 + sizeof(glm::vec3) * 3;
+        {
+            std::string corrupt = data;
+            const uint64_t huge = uint64_t(1) << 60;
+            std::memcpy(&corrupt[headerSize], &huge, sizeof(huge));
+            TriangleBVH loaded;
+            JFM_CHECK(!DeserializeFromString(loaded, corrupt));
+        }
+
+        // 节点数组在最后；把第一个节点的子节点指向自己形成环，或越界
+        const size_t nodesOffset = data.size() - bvh.GetNodeCount() * sizeof(TriangleBVH::Node);
+        for (uint32_t child : { 0u, static_cast<uint32_t>(bvh.GetNodeCount()) }) {
+            std::string corrupt = data;
+            std::memcpy(&corrupt[nodesOffset + offsetof(TriangleBVH::Node, Child)], &child, sizeof(child));
+            TriangleBVH loaded;
+            JFM_CHECK(!DeserializeFromString(loaded, corrupt));
+        }
+
+        // 三角形索引越界
+        {
+            std::string corrupt = data;
+            const size_t trianglesOffset = headerSize + sizeof(uint64_t) + mesh.Vertices.size() * sizeof(glm::vec3) + sizeof(uint64_t);
+            const uint32_t index = static_cast<uint32_t>(mesh.Vertices.size());
+            std::memcpy(&corrupt[trianglesOffset], &index, sizeof(index));
+            TriangleBVH loaded;
+            JFM_CHECK(!DeserializeFromString(loaded, corrupt));
+        }
+
+        // 随机改写字节：要么被拒绝，要么加载后的查询不越界
+        for (int trial = 0; trial < 2000; ++trial) {
+            std::string corrupt = data;
+            for (int k = 0; k < 4; ++k) {
+                corrupt[rng() % corrupt.size()] = static_cast<char>(rng());
+            }
+            TriangleBVH loaded;
+            if (DeserializeFromString(loaded, corrupt)) {
+                JFM_CHECK(QueriesStayInRange(loaded));
+            } else {
+                JFM_CHECK(loaded.IsEmpty());
+            }
+        }
+    }
+
+    // 射线与所有三角形逐个求交，取最近的命中
+    bool BruteForceRaycast(const TestMesh& mesh, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                           uint32_t& triangle, float& distance) {
+        bool found = false;
+        distance = maxDistance;
+        for (size_t t = 0; t < mesh.Indices.size() / 3; ++t) {
+            float d = 0.0f;
+            if (TriangleBVH::IntersectRayTriangle(origin, direction, mesh.Vertices[mesh.Indices[t * 3]],
+                                                  mesh.Vertices[mesh.Indices[t * 3 + 1]],
+                                                  mesh.Vertices[mesh.Indices[t * 3 + 2]], d) &&
+                d <= distance) {
+                found = true;
+                distance = d;
+                triangle = static_cast<uint32_t>(t);
+            }
+        }
+        return found;
+    }
+
+    void TestRaycastMatchesBruteForce(const TestMesh& mesh) {
+        TriangleBVH bvh(mesh.Vertices, mesh.Indices);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+
+        int hits = 0;
+        for (int i = 0; i < 2000; ++i) {
+            glm::vec3 origin(position(rng), position(rng) * 0.5f + 5.0f, position(rng));
+            glm::vec3 direction = glm::normalize(glm::vec3(position(rng), position(rng) - 5.0f, position(rng)) - origin);
+            const float maxDistance = 5.0f + std::abs(position(rng)) * 2.0f;
+
+            uint32_t expectedTriangle = 0;
+            float expectedDistance = 0.0f;
+            bool expectedHit = BruteForceRaycast(mesh, origin, direction, maxDistance, expectedTriangle, expectedDistance);
+            MeshHit hit;
+            bool actualHit = bvh.Raycast(origin, direction, maxDistance, hit);
+            JFM_CHECK(expectedHit == actualHit);
+            if (expectedHit && actualHit) {
+                JFM_CHECK(std::abs(hit.Distance - expectedDistance) < DistanceTolerance);
+                // 距离相同的三角形（共享的边）都是正确答案
+                if (hit.Triangle != expectedTriangle) {
+                    uint32_t t = hit.Triangle;
+                    float d = 0.0f;
+                    JFM_CHECK(TriangleBVH::IntersectRayTriangle(origin, direction, mesh.Vertices[mesh.Indices[t * 3]],
+                                                                mesh.Vertices[mesh.Indices[t * 3 + 1]],
+                                                                mesh.Vertices[mesh.Indices[t * 3 + 2]], d) &&
+                              std::abs(d - expectedDistance) < DistanceTolerance);
+                }
+                hits++;
+            }
+        }
+        JFM_CHECK(hits > 200);
+    }
+
+    void TestQueryMatchesBruteForce(const TestMesh& mesh) {
+        TriangleBVH bvh(mesh.Vertices, mesh.Indices);
+        std::mt19937 rng(6);
+        std::uniform_real_distribution<float> position(-14.0f, 14.0f);
+        std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+        const size_t triangleCount = mesh.Indices.size() / 3;
+        for (int i = 0; i < 500; ++i) {
+            glm::vec3 center(position(rng), position(rng) * 0.3f + 1.0f, position(rng));
+            glm::vec3 half(size(rng), size(rng), size(rng));
+            AABB bounds(center - half, center + half);
+
+            std::vector<uint32_t> reported;
+            bvh.Query(bounds, [&](uint32_t triangle) {
+                reported.push_back(bvh.GetOriginalTriangle(triangle));
+                return true;
+            });
+            std::sort(reported.begin(), reported.end());
+            JFM_CHECK(std::adjacent_find(reported.begin(), reported.end()) == reported.end());
+
+            // 量化的包围盒向外取整，查询结果可以多于精确结果，但不能漏掉
+            for (size_t t = 0; t < triangleCount; ++t) {
+                const glm::vec3& a = mesh.Vertices[mesh.Indices[t * 3]];
+                const glm::vec3& b = mesh.Vertices[mesh.Indices[t * 3 + 1]];
+                const glm::vec3& c = mesh.Vertices[mesh.Indices[t * 3 + 2]];
+                AABB triangleBounds(glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)));
+                if (triangleBounds.Intersects(bounds)) {
+                    JFM_CHECK(std::binary_search(reported.begin(), reported.end(), static_cast<uint32_t>(t)));
+                }
+            }
+        }
+    }
+
+}
+
+int main() {
+    const TestMesh mesh = MakeRandomMesh(1);
+    TestRoundTrip(mesh);
+    TestRejectsCorruptData(mesh);
+    TestRaycastMatchesBruteForce(mesh);
+    TestQueryMatchesBruteForce(mesh);
+    return JFM_TEST_RESULT();
+}